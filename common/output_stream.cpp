@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iomanip>
+#include <map>
 #include <sstream>
 #include <string>
 #include <unordered_set>
@@ -215,6 +216,53 @@ std::string ToStringShaderStage(SpvReflectShaderStageFlagBits stage) {
   return "???";
 }
 
+std::string ToStringShaderStageFlags(uint32_t stage_flags) {
+  std::string str;
+  for (uint32_t bit = 1; bit != 0; bit <<= 1) {
+    if ((stage_flags & bit) == 0) {
+      continue;
+    }
+    if (!str.empty()) {
+      str += "|";
+    }
+    str += ToStringShaderStage(static_cast<SpvReflectShaderStageFlagBits>(bit));
+  }
+  return str;
+}
+
+std::string ToStringModuleRebuildFlags(SpvReflectModuleRebuildFlags rebuild_flags) {
+  if (rebuild_flags == SPV_REFLECT_MODULE_REBUILD_NONE) {
+    return "NONE";
+  }
+  std::string str;
+  for (uint32_t bit = 1; bit != 0; bit <<= 1) {
+    if ((rebuild_flags & bit) == 0) {
+      continue;
+    }
+    if (!str.empty()) {
+      str += "|";
+    }
+    switch (bit) {
+      case SPV_REFLECT_MODULE_REBUILD_SHADER_MODULE:
+        str += "SHADER_MODULE";
+        break;
+      case SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE:
+        str += "PIPELINE_STATE";
+        break;
+      case SPV_REFLECT_MODULE_REBUILD_PIPELINE_LAYOUT:
+        str += "PIPELINE_LAYOUT";
+        break;
+      case SPV_REFLECT_MODULE_REBUILD_MATERIAL:
+        str += "MATERIAL";
+        break;
+      default:
+        str += "???";
+        break;
+    }
+  }
+  return str;
+}
+
 std::string ToStringSpvStorageClass(int storage_class) {
   switch (storage_class) {
     case SpvStorageClassUniformConstant:
@@ -1238,11 +1286,13 @@ void FormatTextLines(const std::vector<TextLine>& text_lines, const char* indent
   }
 
   // Output
+  std::stringstream ss;
   size_t n = text_lines.size();
   for (size_t i = 0; i < n; ++i) {
     auto& tl = text_lines[i];
 
-    std::stringstream ss;
+    ss.str(std::string());
+    ss.clear();
     if ((tl.text_line_flags == TEXT_LINE_TYPE_BLOCK_BEGIN) || (tl.text_line_flags == TEXT_LINE_TYPE_STRUCT_BEGIN) ||
         (tl.text_line_flags == TEXT_LINE_TYPE_REF_BEGIN)) {
       ss << indent;
@@ -1437,8 +1487,7 @@ void StreamWriteDescriptorBinding(std::ostream& os, const SpvReflectDescriptorBi
   os << t << "binding  : " << obj.binding << "\n";
   os << t << "type     : " << ToStringDescriptorType(obj.descriptor_type);
   os << " "
-     << "(" << ToStringResourceType(obj.resource_type) << ")"
-     << "\n";
+     << "(" << ToStringResourceType(obj.resource_type) << ")\n";
 
   // count
   os << t << "count    : " << obj.count << "\n";
@@ -1552,6 +1601,45 @@ void StreamWriteShaderModule(std::ostream& os, const SpvReflectShaderModule& obj
   }
 }
 
+OutputBuffer::OutputBuffer(std::ostream& os) : os_(os) { setp(buffer_, buffer_ + sizeof(buffer_)); }
+
+OutputBuffer::~OutputBuffer() { sync(); }
+
+OutputBuffer::int_type OutputBuffer::overflow(int_type ch) {
+  if (sync() != 0) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+std::streamsize OutputBuffer::xsputn(const char* s, std::streamsize n) {
+  // Anything that would not fit goes straight through once the pending bytes are out.
+  if (n > epptr() - pptr()) {
+    if (sync() != 0) {
+      return 0;
+    }
+    if (n >= static_cast<std::streamsize>(sizeof(buffer_))) {
+      os_.write(s, n);
+      return os_ ? n : 0;
+    }
+  }
+  std::copy(s, s + n, pptr());
+  pbump(static_cast<int>(n));
+  return n;
+}
+
+int OutputBuffer::sync() {
+  if (pptr() > pbase()) {
+    os_.write(pbase(), pptr() - pbase());
+    setp(buffer_, buffer_ + sizeof(buffer_));
+  }
+  return os_ ? 0 : -1;
+}
+
 // Avoid unused variable warning/error on Linux
 #ifndef NDEBUG
 #define USE_ASSERT(x) assert(x)
@@ -1559,7 +1647,10 @@ void StreamWriteShaderModule(std::ostream& os, const SpvReflectShaderModule& obj
 #define USE_ASSERT(x) ((void)(x))
 #endif
 
-void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers, std::ostream& os) {
+void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers, std::ostream& stream) {
+  OutputBuffer buffer(stream);
+  std::ostream os(&buffer);
+
   const char* t = "  ";
   const char* tt = "    ";
   const char* ttt = "      ";
@@ -1586,8 +1677,7 @@ void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers
     for (size_t i = 0; i < variables.size(); ++i) {
       auto p_var = variables[i];
       USE_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
-      os << tt << i << ":"
-         << "\n";
+      os << tt << i << ":\n";
       StreamWriteInterfaceVariable(os, *p_var, ttt);
       if (i < (count - 1)) {
         os << "\n";
@@ -1609,8 +1699,7 @@ void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers
     for (size_t i = 0; i < variables.size(); ++i) {
       auto p_var = variables[i];
       USE_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
-      os << tt << i << ":"
-         << "\n";
+      os << tt << i << ":\n";
       StreamWriteInterfaceVariable(os, *p_var, ttt);
       if (i < (count - 1)) {
         os << "\n";
@@ -1631,8 +1720,7 @@ void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers
     os << t << "Push constant blocks: " << count << "\n\n";
     for (size_t i = 0; i < push_constant_bocks.size(); ++i) {
       auto p_block = push_constant_bocks[i];
-      os << tt << i << ":"
-         << "\n";
+      os << tt << i << ":\n";
       StreamWritePushConstantsBlock(os, *p_block, flatten_cbuffers, ttt);
     }
   }
@@ -1658,8 +1746,7 @@ void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers
       auto p_binding = bindings[i];
       USE_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
       os << tt << "Binding"
-         << " " << p_binding->set << "." << p_binding->binding << ""
-         << "\n";
+         << " " << p_binding->set << "." << p_binding->binding << "\n";
       StreamWriteDescriptorBinding(os, *p_binding, true, flatten_cbuffers, ttt);
       if (i < (count - 1)) {
         os << "\n\n";
@@ -1734,12 +1821,500 @@ void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers
   }
 }
 
+void WriteDescriptorSetLayouts(const SpvReflectDescriptorSetLayouts& layouts, const std::vector<std::string>& module_names,
+                               const std::vector<const SpvReflectShaderModule*>& modules, std::ostream& stream) {
+  OutputBuffer buffer(stream);
+  std::ostream os(&buffer);
+
+  const char* t = "  ";
+  const char* tt = "    ";
+  const char* ttt = "      ";
+
+  os << "Descriptor set layouts: " << layouts.layout_count << "\n";
+  for (uint32_t i = 0; i < layouts.layout_count; ++i) {
+    const SpvReflectDescriptorSetLayout& layout = layouts.layouts[i];
+    os << "\n";
+    os << t << i << ":\n";
+    os << tt << "signature : 0x" << std::hex << std::setw(8) << std::setfill('0') << layout.signature << std::dec
+       << std::setfill(' ') << "\n";
+    os << tt << "bindings  : " << layout.binding_count << "\n";
+    for (uint32_t j = 0; j < layout.binding_count; ++j) {
+      const SpvReflectProgramBinding& binding = layout.bindings[j];
+      os << ttt << binding.binding << " : " << ToStringDescriptorType(binding.descriptor_type);
+      if (binding.count != 1) {
+        os << "[" << (binding.count == 0 ? std::string() : std::to_string(binding.count)) << "]";
+      }
+      os << " (" << ToStringShaderStageFlags(binding.stage_flags) << ")\n";
+    }
+  }
+
+  os << "\n";
+  os << "Descriptor set layout uses: " << layouts.use_count << "\n\n";
+  for (uint32_t i = 0; i < layouts.use_count; ++i) {
+    const SpvReflectDescriptorSetLayoutUse& use = layouts.uses[i];
+    const SpvReflectEntryPoint& entry_point = modules[use.module_index]->entry_points[use.entry_point_index];
+    os << t << module_names[use.module_index] << " : " << entry_point.name << " : set " << use.set << " -> layout "
+       << use.layout_index << "\n";
+  }
+
+  if (layouts.conflict_count > 0) {
+    os << "\n";
+    os << "Descriptor type conflicts: " << layouts.conflict_count << "\n\n";
+    for (uint32_t i = 0; i < layouts.conflict_count; ++i) {
+      const SpvReflectProgramConflict& conflict = layouts.conflicts[i];
+      os << t << "set " << conflict.set << ", binding " << conflict.binding << " : "
+         << ToStringDescriptorType(conflict.descriptor_type) << " and "
+         << ToStringDescriptorType(conflict.conflicting_descriptor_type) << " ("
+         << ToStringShaderStageFlags(conflict.conflicting_stage) << ")\n";
+    }
+  }
+}
+
+// Turns a reflected name into a C++ identifier, or fallback if it is empty.
+static std::string ToCppIdentifier(const char* name, const std::string& fallback) {
+  std::string identifier;
+  for (const char* p = (name != nullptr) ? name : ""; *p != '\0'; ++p) {
+    bool valid = ((*p >= 'a') && (*p <= 'z')) || ((*p >= 'A') && (*p <= 'Z')) || ((*p >= '0') && (*p <= '9')) || (*p == '_');
+    identifier += valid ? *p : '_';
+  }
+  if (identifier.empty()) {
+    identifier = fallback;
+  }
+  if ((identifier[0] >= '0') && (identifier[0] <= '9')) {
+    identifier = "_" + identifier;
+  }
+  return identifier;
+}
+
+static std::string ToCppScalarType(const SpvReflectBlockVariable& member) {
+  SpvReflectTypeFlags type_flags = (member.type_description != nullptr) ? member.type_description->type_flags : 0;
+  uint32_t width = member.numeric.scalar.width;
+  if (type_flags & SPV_REFLECT_TYPE_FLAG_REF) {
+    return "uint64_t";
+  }
+  if (type_flags & SPV_REFLECT_TYPE_FLAG_FLOAT) {
+    // There is no standard half type, so 16-bit floats are raw bits.
+    return (width == 64) ? "double" : ((width == 16) ? "uint16_t" : "float");
+  }
+  if (type_flags & SPV_REFLECT_TYPE_FLAG_INT) {
+    std::string type = member.numeric.scalar.signedness ? "int" : "uint";
+    return type + std::to_string((width == 8 || width == 16 || width == 64) ? width : 32) + "_t";
+  }
+  // Booleans are 32-bit in buffer layouts.
+  return "uint32_t";
+}
+
+// A member declaration: type, name, suffix.
+struct CppDeclaration {
+  std::string type;
+  std::string suffix;
+  uint32_t size;
+};
+
+static CppDeclaration PadCppElement(const CppDeclaration& element, uint32_t stride) {
+  if ((stride <= element.size) || (element.size == 0)) {
+    return element;
+  }
+  CppDeclaration padded = {};
+  padded.type = "struct { " + element.type + " value" + element.suffix + "; uint8_t pad[" + std::to_string(stride - element.size) +
+                "]; }";
+  padded.size = stride;
+  return padded;
+}
+
+struct CppStructWriter {
+  std::ostream& os;
+  std::vector<std::string> asserts;
+
+  // Returns the alignment of the written struct.
+  uint32_t WriteStruct(const SpvReflectBlockVariable& block, const std::string& name, const std::string& qualified_name,
+                       uint32_t size, uint32_t indent_level);
+};
+
+uint32_t CppStructWriter::WriteStruct(const SpvReflectBlockVariable& block, const std::string& name,
+                                      const std::string& qualified_name, uint32_t size, uint32_t indent_level) {
+  const std::string t0(2 * indent_level, ' ');
+  const std::string t1(2 * (indent_level + 1), ' ');
+  os << t0 << "struct " << name << " {\n";
+
+  std::vector<const SpvReflectBlockVariable*> members;
+  for (uint32_t i = 0; i < block.member_count; ++i) {
+    members.push_back(&block.members[i]);
+  }
+  std::stable_sort(members.begin(), members.end(),
+                   [](const SpvReflectBlockVariable* a, const SpvReflectBlockVariable* b) { return a->offset < b->offset; });
+
+  std::unordered_set<std::string> names;
+  std::map<uint32_t, std::string> struct_names;
+  std::map<uint32_t, uint32_t> struct_alignments;
+  uint32_t cursor = 0;
+  uint32_t pad_count = 0;
+  uint32_t alignment = 1;
+  for (size_t i = 0; i < members.size(); ++i) {
+    const SpvReflectBlockVariable& member = *members[i];
+    std::string member_name = ToCppIdentifier(member.name, "member" + std::to_string(i));
+    bool is_runtime_array = false;
+    uint32_t element_count = 1;
+    for (uint32_t j = 0; j < member.array.dims_count; ++j) {
+      is_runtime_array |= (member.array.dims[j] == SPV_REFLECT_ARRAY_DIM_RUNTIME);
+      element_count *= member.array.dims[j];
+    }
+    if (is_runtime_array || (member.offset < cursor)) {
+      os << t1 << "// " << member_name << " has no fixed C++ layout\n";
+      continue;
+    }
+    while (!names.insert(member_name).second) {
+      member_name += "_";
+    }
+
+    CppDeclaration element = {};
+    SpvReflectTypeFlags type_flags = (member.type_description != nullptr) ? member.type_description->type_flags : 0;
+    bool is_reference = (type_flags & SPV_REFLECT_TYPE_FLAG_REF) != 0;
+    if ((member.member_count > 0) && !is_reference) {
+      uint32_t type_id = (member.type_description != nullptr) ? member.type_description->id : 0;
+      uint32_t struct_size = (member.array.dims_count > 0) ? member.array.stride : member.padded_size;
+      auto it = struct_names.find(type_id);
+      if (it == struct_names.end()) {
+        const char* type_name = (member.type_description != nullptr) ? member.type_description->type_name : nullptr;
+        std::string struct_name = ToCppIdentifier(type_name, member_name + "_t");
+        while (!names.insert(struct_name).second) {
+          struct_name += "_";
+        }
+        struct_alignments[type_id] =
+            WriteStruct(member, struct_name, qualified_name + "::" + struct_name, struct_size, indent_level + 1);
+        it = struct_names.insert(std::make_pair(type_id, struct_name)).first;
+      }
+      element.type = it->second;
+      element.size = struct_size;
+      alignment = std::max(alignment, struct_alignments[type_id]);
+    } else if ((type_flags & SPV_REFLECT_TYPE_FLAG_MATRIX) && !is_reference) {
+      bool row_major = (member.decoration_flags & SPV_REFLECT_DECORATION_ROW_MAJOR) != 0;
+      uint32_t vector_count = row_major ? member.numeric.matrix.row_count : member.numeric.matrix.column_count;
+      uint32_t vector_length = row_major ? member.numeric.matrix.column_count : member.numeric.matrix.row_count;
+      uint32_t scalar_size = member.numeric.scalar.width / 8;
+      alignment = std::max(alignment, scalar_size);
+      CppDeclaration vector = {ToCppScalarType(member), "[" + std::to_string(vector_length) + "]", vector_length * scalar_size};
+      vector = PadCppElement(vector, member.numeric.matrix.stride);
+      element.type = vector.type;
+      element.suffix = "[" + std::to_string(vector_count) + "]" + vector.suffix;
+      element.size = vector_count * vector.size;
+    } else {
+      element.type = ToCppScalarType(member);
+      element.size = is_reference ? 8 : ((member.numeric.scalar.width > 0) ? member.numeric.scalar.width / 8 : 4);
+      alignment = std::max(alignment, element.size);
+      if ((type_flags & SPV_REFLECT_TYPE_FLAG_VECTOR) && !is_reference) {
+        element.suffix = "[" + std::to_string(member.numeric.vector.component_count) + "]";
+        element.size *= member.numeric.vector.component_count;
+      }
+    }
+
+    CppDeclaration declaration = element;
+    if (member.array.dims_count > 0) {
+      declaration = PadCppElement(element, member.array.stride);
+      std::string dims;
+      for (uint32_t j = 0; j < member.array.dims_count; ++j) {
+        dims += "[" + std::to_string(member.array.dims[j]) + "]";
+      }
+      declaration.suffix = dims + declaration.suffix;
+      declaration.size *= element_count;
+    }
+
+    if (member.offset > cursor) {
+      os << t1 << "uint8_t pad" << pad_count++ << "_[" << (member.offset - cursor) << "];\n";
+    }
+    os << t1 << declaration.type << " " << member_name << declaration.suffix << ";\n";
+    asserts.push_back("static_assert(offsetof(" + qualified_name + ", " + member_name + ") == " + std::to_string(member.offset) +
+                      ", \"" + qualified_name + "::" + member_name + " offset\");");
+    cursor = member.offset + declaration.size;
+  }
+  if (size > cursor) {
+    os << t1 << "uint8_t pad" << pad_count++ << "_[" << (size - cursor) << "];\n";
+  }
+  os << t0 << "};\n";
+  // C++ rounds the size up to the largest member alignment, e.g. for a push
+  // constant block that ends 4 bytes after a 64-bit member.
+  uint32_t struct_size = std::max(size, cursor);
+  struct_size = (struct_size + alignment - 1) / alignment * alignment;
+  asserts.push_back("static_assert(sizeof(" + qualified_name + ") == " + std::to_string(struct_size) + ", \"" + qualified_name +
+                    " size\");");
+  return alignment;
+}
+
+void WriteModuleDiff(const SpvReflectModuleDiff& diff, std::ostream& stream) {
+  OutputBuffer buffer(stream);
+  std::ostream os(&buffer);
+  const char* t = "  ";
+
+  static const char* const kChangeTypes[] = {"added", "removed", "modified"};
+  os << "Rebuild: " << ToStringModuleRebuildFlags(diff.rebuild_flags) << "\n";
+  os << "Changes: " << diff.change_count << "\n";
+  for (uint32_t i = 0; i < diff.change_count; ++i) {
+    const SpvReflectModuleChange& change = diff.changes[i];
+    const void* p_object = (change.p_new != nullptr) ? change.p_new : change.p_old;
+    os << t << kChangeTypes[change.type] << " ";
+    switch (change.object) {
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_ENTRY_POINT:
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_EXECUTION_MODES: {
+        bool modes = (change.object == SPV_REFLECT_MODULE_CHANGE_OBJECT_EXECUTION_MODES);
+        const auto* p_entry_point = static_cast<const SpvReflectEntryPoint*>(p_object);
+        os << (modes ? "execution modes of " : "entry point ") << change.entry_point << " ("
+           << ToStringShaderStage(p_entry_point->shader_stage) << ")";
+      } break;
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_DESCRIPTOR_BINDING: {
+        const auto* p_binding = static_cast<const SpvReflectDescriptorBinding*>(p_object);
+        os << "descriptor binding " << change.set << "." << change.binding << " "
+           << (p_binding->name != nullptr ? p_binding->name : "") << " (" << ToStringDescriptorType(p_binding->descriptor_type)
+           << ")";
+      } break;
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_BLOCK_MEMBER:
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_PUSH_CONSTANT_MEMBER: {
+        if (change.object == SPV_REFLECT_MODULE_CHANGE_OBJECT_BLOCK_MEMBER) {
+          os << "block member " << change.set << "." << change.binding;
+        } else {
+          os << "push constant member " << change.index;
+        }
+        os << " " << change.path;
+        const auto* p_old = static_cast<const SpvReflectFlatBlockMember*>(change.p_old);
+        const auto* p_new = static_cast<const SpvReflectFlatBlockMember*>(change.p_new);
+        if ((p_old != nullptr) && (p_new != nullptr)) {
+          os << " (offset " << p_old->absolute_offset << " -> " << p_new->absolute_offset << ", size " << p_old->size << " -> "
+             << p_new->size << ")";
+        } else {
+          const auto* p_member = (p_new != nullptr) ? p_new : p_old;
+          os << " (offset " << p_member->absolute_offset << ", size " << p_member->size << ")";
+        }
+      } break;
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_PUSH_CONSTANT_BLOCK: {
+        const auto* p_block = static_cast<const SpvReflectBlockVariable*>(p_object);
+        os << "push constant block " << change.index << " (offset " << p_block->offset << ", size " << p_block->size << ")";
+      } break;
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_INPUT_VARIABLE:
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_OUTPUT_VARIABLE: {
+        const auto* p_var = static_cast<const SpvReflectInterfaceVariable*>(p_object);
+        os << ((change.object == SPV_REFLECT_MODULE_CHANGE_OBJECT_INPUT_VARIABLE) ? "input " : "output ") << change.entry_point
+           << " location " << change.index << " " << (p_var->name != nullptr ? p_var->name : "") << " ("
+           << ToStringFormat(p_var->format) << ")";
+      } break;
+      case SPV_REFLECT_MODULE_CHANGE_OBJECT_SPECIALIZATION_CONSTANT: {
+        const auto* p_constant = static_cast<const SpvReflectSpecializationConstant*>(p_object);
+        os << "specialization constant " << change.index << " " << (p_constant->name != nullptr ? p_constant->name : "");
+      } break;
+    }
+    os << " [" << ToStringModuleRebuildFlags(change.rebuild_flags) << "]\n";
+  }
+}
+
+void WriteModuleStats(const SpvReflectShaderModule& module, std::ostream& stream) {
+  OutputBuffer buffer(stream);
+  std::ostream os(&buffer);
+
+  bool embedded = (module._internal->embedded_reflection_loaded != 0);
+  bool cached = (module._internal->cached_reflection_loaded != 0);
+  bool parsed = !embedded && !cached;
+  os << "reflection data     : " << (parsed ? "parsed" : (embedded ? "embedded" : "cached")) << "\n";
+  os << "SPIR-V words        : " << module._internal->spirv_word_count << "\n";
+  const uint32_t* p_code = spvReflectGetCode(&module);
+  if (p_code != nullptr) {
+    os << "id bound            : " << p_code[3] << "\n";
+  }
+  // Only known when the module was parsed
+  if (parsed) {
+    os << "id map              : " << (module._internal->hashed_id_map ? "hash table" : "dense table") << "\n";
+  }
+  os << "type descriptions   : " << module._internal->type_description_count << "\n";
+  os << "entry points        : " << module.entry_point_count << "\n";
+  os << "descriptor bindings : " << module.descriptor_binding_count << "\n";
+  os << "descriptor sets     : " << module.descriptor_set_count << "\n";
+  os << "push constant blocks: " << module.push_constant_block_count << "\n";
+  os << "spec constants      : " << module.spec_constant_count << "\n";
+}
+
+void WriteCppHeader(const SpvReflectShaderModule& module, const std::string& namespace_name, const std::string& source_name,
+                    std::ostream& stream) {
+  OutputBuffer buffer(stream);
+  std::ostream os(&buffer);
+
+  os << "// Generated by spirv-reflect --emit-cpp";
+  if (!source_name.empty()) {
+    os << " from " << source_name;
+  }
+  os << ". Do not edit.\n";
+  os << "#pragma once\n";
+  os << "\n";
+  os << "#include <cstddef>\n";
+  os << "#include <cstdint>\n";
+  os << "\n";
+  os << "#ifndef SPIRV_REFLECT_GENERATED_TYPES\n";
+  os << "#define SPIRV_REFLECT_GENERATED_TYPES\n";
+  os << "namespace spv_reflect_generated {\n";
+  os << "// descriptor_type and format use the VkDescriptorType and VkFormat values.\n";
+  os << "struct DescriptorBinding {\n";
+  os << "  uint32_t set;\n";
+  os << "  uint32_t binding;\n";
+  os << "  uint32_t descriptor_type;\n";
+  os << "  uint32_t count;\n";
+  os << "  const char* name;\n";
+  os << "};\n";
+  os << "struct PushConstantRange {\n";
+  os << "  uint32_t offset;\n";
+  os << "  uint32_t size;\n";
+  os << "  const char* name;\n";
+  os << "};\n";
+  os << "struct VertexAttribute {\n";
+  os << "  uint32_t location;\n";
+  os << "  uint32_t binding;\n";
+  os << "  uint32_t format;\n";
+  os << "  uint32_t offset;\n";
+  os << "};\n";
+  os << "struct SpecializationConstant {\n";
+  os << "  uint32_t constant_id;\n";
+  os << "  const char* name;\n";
+  os << "};\n";
+  os << "}  // namespace spv_reflect_generated\n";
+  os << "#endif\n";
+  os << "\n";
+  const std::string module_namespace = ToCppIdentifier(namespace_name.c_str(), "shader");
+  os << "namespace " << module_namespace << " {\n";
+
+  // Block layouts
+  CppStructWriter writer = {os, {}};
+  std::unordered_set<std::string> struct_names;
+  std::map<uint32_t, std::string> block_struct_names;
+  auto write_block = [&](const SpvReflectBlockVariable& block, const char* fallback_name) {
+    uint32_t type_id = (block.type_description != nullptr) ? block.type_description->id : 0;
+    if (block.member_count == 0 || block_struct_names.count(type_id) > 0) {
+      return;
+    }
+    const char* type_name = (block.type_description != nullptr) ? block.type_description->type_name : nullptr;
+    std::string name = ToCppIdentifier(type_name, ToCppIdentifier(fallback_name, "Block"));
+    while (!struct_names.insert(name).second) {
+      name += "_";
+    }
+    block_struct_names[type_id] = name;
+    os << "\n";
+    writer.WriteStruct(block, name, name, block.padded_size, 0);
+  };
+  for (uint32_t i = 0; i < module.descriptor_binding_count; ++i) {
+    const SpvReflectDescriptorBinding& binding = module.descriptor_bindings[i];
+    if (binding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+      write_block(binding.block, binding.name);
+    }
+  }
+  for (uint32_t i = 0; i < module.push_constant_block_count; ++i) {
+    write_block(module.push_constant_blocks[i], module.push_constant_blocks[i].name);
+  }
+  if (!writer.asserts.empty()) {
+    os << "\n";
+    for (const std::string& line : writer.asserts) {
+      os << line << "\n";
+    }
+  }
+
+  // Specialization constants are declared by the module, not per entry point.
+  os << "\n";
+  os << "constexpr uint32_t kSpecializationConstantCount = " << module.spec_constant_count << ";\n";
+  if (module.spec_constant_count > 0) {
+    os << "constexpr spv_reflect_generated::SpecializationConstant kSpecializationConstants[] = {\n";
+    for (uint32_t i = 0; i < module.spec_constant_count; ++i) {
+      const SpvReflectSpecializationConstant& constant = module.spec_constants[i];
+      os << "  {" << constant.constant_id << ", \"" << (constant.name != nullptr ? constant.name : "") << "\"},\n";
+    }
+    os << "};\n";
+  }
+
+  // Per entry point tables
+  std::unordered_set<std::string> entry_point_names;
+  for (uint32_t i = 0; i < module.entry_point_count; ++i) {
+    const SpvReflectEntryPoint& entry_point = module.entry_points[i];
+    std::string name = ToCppIdentifier(entry_point.name, "entry_point");
+    while (!entry_point_names.insert(name).second) {
+      name += "_";
+    }
+    os << "\n";
+    os << "namespace " << name << " {\n";
+    os << "constexpr const char* kName = \"" << entry_point.name << "\";\n";
+    os << "constexpr uint32_t kShaderStage = " << AsHexString(entry_point.shader_stage) << ";  // "
+       << ToStringShaderStage(entry_point.shader_stage) << "\n";
+
+    uint32_t binding_count = 0;
+    spvReflectEnumerateEntryPointDescriptorBindings(&module, entry_point.name, &binding_count, nullptr);
+    std::vector<SpvReflectDescriptorBinding*> bindings(binding_count);
+    spvReflectEnumerateEntryPointDescriptorBindings(&module, entry_point.name, &binding_count, bindings.data());
+    os << "constexpr uint32_t kDescriptorBindingCount = " << binding_count << ";\n";
+    if (binding_count > 0) {
+      os << "constexpr spv_reflect_generated::DescriptorBinding kDescriptorBindings[] = {\n";
+      for (const SpvReflectDescriptorBinding* p_binding : bindings) {
+        os << "  {" << p_binding->set << ", " << p_binding->binding << ", " << static_cast<uint32_t>(p_binding->descriptor_type)
+           << ", " << p_binding->count << ", \"" << (p_binding->name != nullptr ? p_binding->name : "") << "\"},  // "
+           << ToStringDescriptorType(p_binding->descriptor_type) << "\n";
+      }
+      os << "};\n";
+    }
+
+    os << "constexpr uint32_t kDescriptorSetCount = " << entry_point.descriptor_set_count << ";\n";
+    if (entry_point.descriptor_set_count > 0) {
+      os << "constexpr uint32_t kDescriptorSets[] = {";
+      for (uint32_t j = 0; j < entry_point.descriptor_set_count; ++j) {
+        os << (j > 0 ? ", " : "") << entry_point.descriptor_sets[j].set;
+      }
+      os << "};\n";
+    }
+
+    uint32_t push_constant_count = 0;
+    spvReflectEnumerateEntryPointPushConstantBlocks(&module, entry_point.name, &push_constant_count, nullptr);
+    std::vector<SpvReflectBlockVariable*> push_constants(push_constant_count);
+    spvReflectEnumerateEntryPointPushConstantBlocks(&module, entry_point.name, &push_constant_count, push_constants.data());
+    os << "constexpr uint32_t kPushConstantRangeCount = " << push_constant_count << ";\n";
+    if (push_constant_count > 0) {
+      os << "constexpr spv_reflect_generated::PushConstantRange kPushConstantRanges[] = {\n";
+      for (const SpvReflectBlockVariable* p_block : push_constants) {
+        os << "  {" << p_block->offset << ", " << p_block->size << ", \"" << (p_block->name != nullptr ? p_block->name : "")
+           << "\"},\n";
+      }
+      os << "};\n";
+    }
+
+    if (entry_point.shader_stage == SPV_REFLECT_SHADER_STAGE_VERTEX_BIT) {
+      SpvReflectVertexInputLayout layout = {};
+      if (spvReflectComputeVertexInputLayout(&module, entry_point.name, SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED, 0,
+                                             nullptr, &layout) == SPV_REFLECT_RESULT_SUCCESS) {
+        os << "constexpr uint32_t kVertexStride = " << (layout.binding_count > 0 ? layout.bindings[0].stride : 0) << ";\n";
+        os << "constexpr uint32_t kVertexAttributeCount = " << layout.attribute_count << ";\n";
+        if (layout.attribute_count > 0) {
+          os << "constexpr spv_reflect_generated::VertexAttribute kVertexAttributes[] = {\n";
+          for (uint32_t j = 0; j < layout.attribute_count; ++j) {
+            const SpvReflectVertexInputAttribute& attribute = layout.attributes[j];
+            os << "  {" << attribute.location << ", " << attribute.binding << ", " << static_cast<uint32_t>(attribute.format)
+               << ", " << attribute.offset << "},  // " << ToStringFormat(attribute.format) << "\n";
+          }
+          os << "};\n";
+        }
+      }
+    }
+    os << "}  // namespace " << name << "\n";
+  }
+
+  os << "\n";
+  os << "}  // namespace " << module_namespace << "\n";
+}
+
 //////////////////////////////////
 
 SpvReflectToYaml::SpvReflectToYaml(const SpvReflectShaderModule& shader_module, uint32_t verbosity)
     : sm_(shader_module), verbosity_(verbosity) {}
 
+const char* SpvReflectToYaml::Indent(uint32_t level) {
+  static const char kSpaces[] = "                                                                ";
+  static const uint32_t kMaxLevel = (sizeof(kSpaces) - 1) / 2;
+  assert(level <= kMaxLevel);
+  return kSpaces + 2 * (kMaxLevel - std::min(level, kMaxLevel));
+}
+
 void SpvReflectToYaml::WriteTypeDescription(std::ostream& os, const SpvReflectTypeDescription& td, uint32_t indent_level) {
+  // Types sharing the members of a struct type reach them more than once.
+  if (type_description_to_index_.find(&td) != type_description_to_index_.end()) {
+    return;
+  }
   // YAML anchors can only refer to points earlier in the doc, so child type
   // descriptions must be processed before the parent.
   if (!td.copied) {
@@ -1747,38 +2322,37 @@ void SpvReflectToYaml::WriteTypeDescription(std::ostream& os, const SpvReflectTy
       WriteTypeDescription(os, td.members[i], indent_level);
     }
   }
-  const std::string t0 = Indent(indent_level);
-  const std::string t1 = Indent(indent_level + 1);
-  const std::string t2 = Indent(indent_level + 2);
-  const std::string t3 = Indent(indent_level + 3);
-  const std::string t4 = Indent(indent_level + 4);
+  const char* t0 = Indent(indent_level);
+  const char* t1 = Indent(indent_level + 1);
+  const char* t2 = Indent(indent_level + 2);
+  const char* t3 = Indent(indent_level + 3);
 
   // Determine the index of this type within the shader module's list.
   uint32_t type_description_index = static_cast<uint32_t>(type_description_to_index_.size());
   type_description_to_index_[&td] = type_description_index;
 
-  os << t0 << "- &td" << type_description_index << std::endl;
+  os << t0 << "- &td" << type_description_index << "\n";
   // typedef struct SpvReflectTypeDescription {
   //   uint32_t                          id;
-  os << t1 << "id: " << td.id << std::endl;
+  os << t1 << "id: " << td.id << "\n";
   //   SpvOp                             op;
-  os << t1 << "op: " << td.op << std::endl;
+  os << t1 << "op: " << td.op << "\n";
   //   const char*                       type_name;
-  os << t1 << "type_name: " << SafeString(td.type_name) << std::endl;
+  os << t1 << "type_name: " << SafeString(td.type_name) << "\n";
   //   const char*                       struct_member_name;
-  os << t1 << "struct_member_name: " << SafeString(td.struct_member_name) << std::endl;
+  os << t1 << "struct_member_name: " << SafeString(td.struct_member_name) << "\n";
   //   SpvStorageClass                   storage_class;
-  os << t1 << "storage_class: " << td.storage_class << " # " << ToStringSpvStorageClass(td.storage_class) << std::endl;
+  os << t1 << "storage_class: " << td.storage_class << " # " << ToStringSpvStorageClass(td.storage_class) << "\n";
   //   SpvReflectTypeFlags               type_flags;
-  os << t1 << "type_flags: " << AsHexString(td.type_flags) << " # " << ToStringTypeFlags(td.type_flags) << std::endl;
+  os << t1 << "type_flags: " << AsHexString(td.type_flags) << " # " << ToStringTypeFlags(td.type_flags) << "\n";
   //   SpvReflectDecorationFlags         decoration_flags;
   os << t1 << "decoration_flags: " << AsHexString(td.decoration_flags) << " # " << ToStringDecorationFlags(td.decoration_flags)
-     << std::endl;
+     << "\n";
   //   struct Traits {
-  os << t1 << "traits:" << std::endl;
+  os << t1 << "traits:\n";
   //     SpvReflectNumericTraits         numeric;
   // typedef struct SpvReflectNumericTraits {
-  os << t2 << "numeric:" << std::endl;
+  os << t2 << "numeric:\n";
   //   struct Scalar {
   //     uint32_t                        width;
   //     uint32_t                        signedness;
@@ -1786,13 +2360,13 @@ void SpvReflectToYaml::WriteTypeDescription(std::ostream& os, const SpvReflectTy
   os << t3 << "scalar: { ";
   os << "width: " << td.traits.numeric.scalar.width << ", ";
   os << "signedness: " << td.traits.numeric.scalar.signedness;
-  os << " }" << std::endl;
+  os << " }\n";
   //   struct Vector {
   //     uint32_t                        component_count;
   //   } vector;
   os << t3 << "vector: { ";
   os << "component_count: " << td.traits.numeric.vector.component_count;
-  os << " }" << std::endl;
+  os << " }\n";
   //   struct Matrix {
   //     uint32_t                        column_count;
   //     uint32_t                        row_count;
@@ -1803,7 +2377,7 @@ void SpvReflectToYaml::WriteTypeDescription(std::ostream& os, const SpvReflectTy
   os << "row_count: " << td.traits.numeric.matrix.row_count << ", ";
   ;
   os << "stride: " << td.traits.numeric.matrix.stride;
-  os << " }" << std::endl;
+  os << " }\n";
   // } SpvReflectNumericTraits;
 
   //     SpvReflectImageTraits           image;
@@ -1824,7 +2398,7 @@ void SpvReflectToYaml::WriteTypeDescription(std::ostream& os, const SpvReflectTy
   // } SpvReflectImageTraits;
   os << " }"
      << " # dim=" << ToStringSpvDim(td.traits.image.dim) << " image_format=" << ToStringSpvImageFormat(td.traits.image.image_format)
-     << std::endl;
+     << "\n";
 
   //     SpvReflectArrayTraits           array;
   os << t2 << "array: { ";
@@ -1840,18 +2414,18 @@ void SpvReflectToYaml::WriteTypeDescription(std::ostream& os, const SpvReflectTy
   //   uint32_t                          stride; // Measured in bytes
   os << "stride: " << td.traits.array.stride;
   // } SpvReflectArrayTraits;
-  os << " }" << std::endl;
+  os << " }\n";
   //   } traits;
 
   //   uint32_t                          member_count;
-  os << t1 << "member_count: " << td.member_count << std::endl;
+  os << t1 << "member_count: " << td.member_count << "\n";
   //   struct SpvReflectTypeDescription* members;
-  os << t1 << "members:" << std::endl;
+  os << t1 << "members:\n";
   if (td.copied) {
-    os << t1 << "- [forward pointer]" << std::endl;
+    os << t1 << "- [forward pointer]\n";
   } else {
     for (uint32_t i_member = 0; i_member < td.member_count; ++i_member) {
-      os << t2 << "- *td" << type_description_to_index_[&(td.members[i_member])] << std::endl;
+      os << t2 << "- *td" << type_description_to_index_[&(td.members[i_member])] << "\n";
     }
   }
   // } SpvReflectTypeDescription;
@@ -1861,50 +2435,51 @@ void SpvReflectToYaml::WriteBlockVariable(std::ostream& os, const SpvReflectBloc
   if ((bv.flags & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY)) {
     return;  // catches recursive buffer references
   }
+  // Blocks of descriptor bindings can share their members.
+  if (block_variable_to_index_.find(&bv) != block_variable_to_index_.end()) {
+    return;
+  }
 
   for (uint32_t i = 0; i < bv.member_count; ++i) {
     WriteBlockVariable(os, bv.members[i], indent_level);
   }
 
-  const std::string t0 = Indent(indent_level);
-  const std::string t1 = Indent(indent_level + 1);
-  const std::string t2 = Indent(indent_level + 2);
-  const std::string t3 = Indent(indent_level + 3);
+  const char* t0 = Indent(indent_level);
+  const char* t1 = Indent(indent_level + 1);
+  const char* t2 = Indent(indent_level + 2);
 
-  assert(block_variable_to_index_.find(&bv) == block_variable_to_index_.end());
   uint32_t block_variable_index = static_cast<uint32_t>(block_variable_to_index_.size());
   block_variable_to_index_[&bv] = block_variable_index;
 
-  os << t0 << "- &bv" << block_variable_index << std::endl;
+  os << t0 << "- &bv" << block_variable_index << "\n";
   // typedef struct SpvReflectBlockVariable {
   //   const char*                       name;
-  os << t1 << "name: " << SafeString(bv.name) << std::endl;
+  os << t1 << "name: " << SafeString(bv.name) << "\n";
   //   uint32_t                          offset;           // Measured in bytes
-  os << t1 << "offset: " << bv.offset << std::endl;
+  os << t1 << "offset: " << bv.offset << "\n";
   //   uint32_t                          absolute_offset;  // Measured in bytes
-  os << t1 << "absolute_offset: " << bv.absolute_offset << std::endl;
+  os << t1 << "absolute_offset: " << bv.absolute_offset << "\n";
   //   uint32_t                          size;             // Measured in bytes
-  os << t1 << "size: " << bv.size << std::endl;
+  os << t1 << "size: " << bv.size << "\n";
   //   uint32_t                          padded_size;      // Measured in bytes
-  os << t1 << "padded_size: " << bv.padded_size << std::endl;
+  os << t1 << "padded_size: " << bv.padded_size << "\n";
   //   SpvReflectDecorationFlags         decoration_flags;
-  os << t1 << "decorations: " << AsHexString(bv.decoration_flags) << " # " << ToStringDecorationFlags(bv.decoration_flags)
-     << std::endl;
+  os << t1 << "decorations: " << AsHexString(bv.decoration_flags) << " # " << ToStringDecorationFlags(bv.decoration_flags) << "\n";
   //   SpvReflectNumericTraits           numeric;
   // typedef struct SpvReflectNumericTraits {
-  os << t1 << "numeric:" << std::endl;
+  os << t1 << "numeric:\n";
   //   struct Scalar {
   //     uint32_t                        width;
   //     uint32_t                        signedness;
   //   } scalar;
   os << t2 << "scalar: { ";
   os << "width: " << bv.numeric.scalar.width << ", ";
-  os << "signedness: " << bv.numeric.scalar.signedness << " }" << std::endl;
+  os << "signedness: " << bv.numeric.scalar.signedness << " }\n";
   //   struct Vector {
   //     uint32_t                        component_count;
   //   } vector;
   os << t2 << "vector: { ";
-  os << "component_count: " << bv.numeric.vector.component_count << " }" << std::endl;
+  os << "component_count: " << bv.numeric.vector.component_count << " }\n";
   //   struct Matrix {
   //     uint32_t                        column_count;
   //     uint32_t                        row_count;
@@ -1913,7 +2488,7 @@ void SpvReflectToYaml::WriteBlockVariable(std::ostream& os, const SpvReflectBloc
   os << t2 << "matrix: { ";
   os << "column_count: " << bv.numeric.matrix.column_count << ", ";
   os << "row_count: " << bv.numeric.matrix.row_count << ", ";
-  os << "stride: " << bv.numeric.matrix.stride << " }" << std::endl;
+  os << "stride: " << bv.numeric.matrix.stride << " }\n";
   // } SpvReflectNumericTraits;
 
   //     SpvReflectArrayTraits           array;
@@ -1930,31 +2505,31 @@ void SpvReflectToYaml::WriteBlockVariable(std::ostream& os, const SpvReflectBloc
   //   uint32_t                          stride; // Measured in bytes
   os << "stride: " << bv.array.stride;
   // } SpvReflectArrayTraits;
-  os << " }" << std::endl;
+  os << " }\n";
 
   //   SpvReflectVariableFlags           flags;
-  os << t1 << "flags: " << AsHexString(bv.flags) << " # " << ToStringVariableFlags(bv.flags) << std::endl;
+  os << t1 << "flags: " << AsHexString(bv.flags) << " # " << ToStringVariableFlags(bv.flags) << "\n";
 
   //   uint32_t                          member_count;
-  os << t1 << "member_count: " << bv.member_count << std::endl;
+  os << t1 << "member_count: " << bv.member_count << "\n";
   //   struct SpvReflectBlockVariable*   members;
-  os << t1 << "members:" << std::endl;
+  os << t1 << "members:\n";
   for (uint32_t i = 0; i < bv.member_count; ++i) {
     auto itor = block_variable_to_index_.find(&bv.members[i]);
     if (itor != block_variable_to_index_.end()) {
-      os << t2 << "- *bv" << itor->second << std::endl;
+      os << t2 << "- *bv" << itor->second << "\n";
     } else {
-      os << t2 << "- [recursive]" << std::endl;
+      os << t2 << "- [recursive]\n";
     }
   }
   if (verbosity_ >= 1) {
     //   SpvReflectTypeDescription*        type_description;
     if (bv.type_description == nullptr) {
-      os << t1 << "type_description:" << std::endl;
+      os << t1 << "type_description:\n";
     } else {
       auto itor = type_description_to_index_.find(bv.type_description);
       assert(itor != type_description_to_index_.end());
-      os << t1 << "type_description: *td" << itor->second << std::endl;
+      os << t1 << "type_description: *td" << itor->second << "\n";
     }
   }
   // } SpvReflectBlockVariable;
@@ -1968,10 +2543,8 @@ void SpvReflectToYaml::WriteDescriptorBinding(std::ostream& os, const SpvReflect
     }
   }
 
-  const std::string t0 = Indent(indent_level);
-  const std::string t1 = Indent(indent_level + 1);
-  const std::string t2 = Indent(indent_level + 2);
-  const std::string t3 = Indent(indent_level + 3);
+  const char* t0 = Indent(indent_level);
+  const char* t1 = Indent(indent_level + 1);
 
   // A binding's UAV binding later may appear later in the table than the
   // binding itself, in which case we've already output entries for both
@@ -1979,7 +2552,7 @@ void SpvReflectToYaml::WriteDescriptorBinding(std::ostream& os, const SpvReflect
   {
     auto itor = descriptor_binding_to_index_.find(&db);
     if (itor != descriptor_binding_to_index_.end()) {
-      os << t0 << "- *db" << itor->second << std::endl;
+      os << t0 << "- *db" << itor->second << "\n";
       return;
     }
   }
@@ -1987,25 +2560,25 @@ void SpvReflectToYaml::WriteDescriptorBinding(std::ostream& os, const SpvReflect
   uint32_t descriptor_binding_index = static_cast<uint32_t>(descriptor_binding_to_index_.size());
   descriptor_binding_to_index_[&db] = descriptor_binding_index;
 
-  os << t0 << "- &db" << descriptor_binding_index << std::endl;
+  os << t0 << "- &db" << descriptor_binding_index << "\n";
   // typedef struct SpvReflectDescriptorBinding {
   //   uint32_t                            spirv_id;
-  os << t1 << "spirv_id: " << db.spirv_id << std::endl;
+  os << t1 << "spirv_id: " << db.spirv_id << "\n";
   //   const char*                         name;
-  os << t1 << "name: " << SafeString(db.name) << std::endl;
+  os << t1 << "name: " << SafeString(db.name) << "\n";
   //   uint32_t                            binding;
-  os << t1 << "binding: " << db.binding << std::endl;
+  os << t1 << "binding: " << db.binding << "\n";
   //   uint32_t                            input_attachment_index;
-  os << t1 << "input_attachment_index: " << db.input_attachment_index << std::endl;
+  os << t1 << "input_attachment_index: " << db.input_attachment_index << "\n";
   //   uint32_t                            set;
-  os << t1 << "set: " << db.set << std::endl;
+  os << t1 << "set: " << db.set << "\n";
   //   SpvReflectDecorationFlags           decoration_flags;
   os << t1 << "decoration_flags: " << AsHexString(db.decoration_flags) << " # " << ToStringDecorationFlags(db.decoration_flags)
-     << std::endl;
+     << "\n";
   //   SpvReflectDescriptorType            descriptor_type;
-  os << t1 << "descriptor_type: " << db.descriptor_type << " # " << ToStringDescriptorType(db.descriptor_type) << std::endl;
+  os << t1 << "descriptor_type: " << db.descriptor_type << " # " << ToStringDescriptorType(db.descriptor_type) << "\n";
   //   SpvReflectResourceType              resource_type;
-  os << t1 << "resource_type: " << db.resource_type << " # " << ToStringResourceType(db.resource_type) << std::endl;
+  os << t1 << "resource_type: " << db.resource_type << " # " << ToStringResourceType(db.resource_type) << "\n";
   //   SpvReflectImageTraits           image;
   os << t1 << "image: { ";
   // typedef struct SpvReflectImageTraits {
@@ -2023,13 +2596,13 @@ void SpvReflectToYaml::WriteDescriptorBinding(std::ostream& os, const SpvReflect
   os << "image_format: " << db.image.image_format;
   // } SpvReflectImageTraits;
   os << " }"
-     << " # dim=" << ToStringSpvDim(db.image.dim) << " image_format=" << ToStringSpvImageFormat(db.image.image_format) << std::endl;
+     << " # dim=" << ToStringSpvDim(db.image.dim) << " image_format=" << ToStringSpvImageFormat(db.image.image_format) << "\n";
 
   //   SpvReflectBlockVariable             block;
   {
     auto itor = block_variable_to_index_.find(&db.block);
     assert(itor != block_variable_to_index_.end());
-    os << t1 << "block: *bv" << itor->second << " # " << SafeString(db.block.name) << std::endl;
+    os << t1 << "block: *bv" << itor->second << " # " << SafeString(db.block.name) << "\n";
   }
   //   SpvReflectBindingArrayTraits        array;
   os << t1 << "array: { ";
@@ -2042,20 +2615,20 @@ void SpvReflectToYaml::WriteDescriptorBinding(std::ostream& os, const SpvReflect
     os << db.array.dims[i_dim] << ",";
   }
   // } SpvReflectBindingArrayTraits;
-  os << "] }" << std::endl;
+  os << "] }\n";
 
   //   uint32_t                            accessed;
-  os << t1 << "accessed: " << db.accessed << std::endl;
+  os << t1 << "accessed: " << db.accessed << "\n";
 
   //   uint32_t                            uav_counter_id;
-  os << t1 << "uav_counter_id: " << db.uav_counter_id << std::endl;
+  os << t1 << "uav_counter_id: " << db.uav_counter_id << "\n";
   //   struct SpvReflectDescriptorBinding* uav_counter_binding;
   if (db.uav_counter_binding == nullptr) {
-    os << t1 << "uav_counter_binding:" << std::endl;
+    os << t1 << "uav_counter_binding:\n";
   } else {
     auto itor = descriptor_binding_to_index_.find(db.uav_counter_binding);
     assert(itor != descriptor_binding_to_index_.end());
-    os << t1 << "uav_counter_binding: *db" << itor->second << " # " << SafeString(db.uav_counter_binding->name) << std::endl;
+    os << t1 << "uav_counter_binding: *db" << itor->second << " # " << SafeString(db.uav_counter_binding->name) << "\n";
   }
 
   if (db.byte_address_buffer_offset_count > 0) {
@@ -2072,11 +2645,11 @@ void SpvReflectToYaml::WriteDescriptorBinding(std::ostream& os, const SpvReflect
   if (verbosity_ >= 1) {
     //   SpvReflectTypeDescription*        type_description;
     if (db.type_description == nullptr) {
-      os << t1 << "type_description:" << std::endl;
+      os << t1 << "type_description:\n";
     } else {
       auto itor = type_description_to_index_.find(db.type_description);
       assert(itor != type_description_to_index_.end());
-      os << t1 << "type_description: *td" << itor->second << std::endl;
+      os << t1 << "type_description: *td" << itor->second << "\n";
     }
   }
   //   struct {
@@ -2084,10 +2657,10 @@ void SpvReflectToYaml::WriteDescriptorBinding(std::ostream& os, const SpvReflect
   //     uint32_t                        set;
   //   } word_offset;
   os << t1 << "word_offset: { binding: " << db.word_offset.binding;
-  os << ", set: " << db.word_offset.set << " }" << std::endl;
+  os << ", set: " << db.word_offset.set << " }\n";
 
   if (db.user_type != SPV_REFLECT_USER_TYPE_INVALID) {
-    os << t1 << "user_type: " << ToStringUserType(db.user_type) << std::endl;
+    os << t1 << "user_type: " << ToStringUserType(db.user_type) << "\n";
   }
   // } SpvReflectDescriptorBinding;
 }
@@ -2098,29 +2671,28 @@ void SpvReflectToYaml::WriteInterfaceVariable(std::ostream& os, const SpvReflect
     WriteInterfaceVariable(os, iv.members[i], indent_level);
   }
 
-  const std::string t0 = Indent(indent_level);
-  const std::string t1 = Indent(indent_level + 1);
-  const std::string t2 = Indent(indent_level + 2);
-  const std::string t3 = Indent(indent_level + 3);
+  const char* t0 = Indent(indent_level);
+  const char* t1 = Indent(indent_level + 1);
+  const char* t2 = Indent(indent_level + 2);
 
   uint32_t interface_variable_index = static_cast<uint32_t>(interface_variable_to_index_.size());
   interface_variable_to_index_[&iv] = interface_variable_index;
 
   // typedef struct SpvReflectInterfaceVariable {
-  os << t0 << "- &iv" << interface_variable_index << std::endl;
+  os << t0 << "- &iv" << interface_variable_index << "\n";
   //   uint32_t                            spirv_id;
-  os << t1 << "spirv_id: " << iv.spirv_id << std::endl;
+  os << t1 << "spirv_id: " << iv.spirv_id << "\n";
   //   const char*                         name;
-  os << t1 << "name: " << SafeString(iv.name) << std::endl;
+  os << t1 << "name: " << SafeString(iv.name) << "\n";
   //   uint32_t                            location;
-  os << t1 << "location: " << iv.location << std::endl;
+  os << t1 << "location: " << iv.location << "\n";
   //   SpvStorageClass                     storage_class;
-  os << t1 << "storage_class: " << iv.storage_class << " # " << ToStringSpvStorageClass(iv.storage_class) << std::endl;
+  os << t1 << "storage_class: " << iv.storage_class << " # " << ToStringSpvStorageClass(iv.storage_class) << "\n";
   //   const char*                         semantic;
-  os << t1 << "semantic: " << SafeString(iv.semantic) << std::endl;
+  os << t1 << "semantic: " << SafeString(iv.semantic) << "\n";
   //   SpvReflectDecorationFlags           decoration_flags;
   os << t1 << "decoration_flags: " << AsHexString(iv.decoration_flags) << " # " << ToStringDecorationFlags(iv.decoration_flags)
-     << std::endl;
+     << "\n";
   //   SpvBuiltIn                          built_in;
   os << t1 << "built_in: ";
   if (iv.decoration_flags & SPV_REFLECT_DECORATION_BLOCK) {
@@ -2133,22 +2705,22 @@ void SpvReflectToYaml::WriteInterfaceVariable(std::ostream& os, const SpvReflect
   } else {
     os << iv.built_in;
   }
-  os << " # " << ToStringSpvBuiltIn(iv, false) << std::endl;
+  os << " # " << ToStringSpvBuiltIn(iv, false) << "\n";
   //   SpvReflectNumericTraits             numeric;
   // typedef struct SpvReflectNumericTraits {
-  os << t1 << "numeric:" << std::endl;
+  os << t1 << "numeric:\n";
   //   struct Scalar {
   //     uint32_t                        width;
   //     uint32_t                        signedness;
   //   } scalar;
   os << t2 << "scalar: { ";
   os << "width: " << iv.numeric.scalar.width << ", ";
-  os << "signedness: " << iv.numeric.scalar.signedness << " }" << std::endl;
+  os << "signedness: " << iv.numeric.scalar.signedness << " }\n";
   //   struct Vector {
   //     uint32_t                        component_count;
   //   } vector;
   os << t2 << "vector: { ";
-  os << "component_count: " << iv.numeric.vector.component_count << " }" << std::endl;
+  os << "component_count: " << iv.numeric.vector.component_count << " }\n";
   //   struct Matrix {
   //     uint32_t                        column_count;
   //     uint32_t                        row_count;
@@ -2157,7 +2729,7 @@ void SpvReflectToYaml::WriteInterfaceVariable(std::ostream& os, const SpvReflect
   os << t2 << "matrix: { ";
   os << "column_count: " << iv.numeric.matrix.column_count << ", ";
   os << "row_count: " << iv.numeric.matrix.row_count << ", ";
-  os << "stride: " << iv.numeric.matrix.stride << " }" << std::endl;
+  os << "stride: " << iv.numeric.matrix.stride << " }\n";
   // } SpvReflectNumericTraits;
 
   //     SpvReflectArrayTraits           array;
@@ -2174,36 +2746,36 @@ void SpvReflectToYaml::WriteInterfaceVariable(std::ostream& os, const SpvReflect
   //   uint32_t                          stride; // Measured in bytes
   os << "stride: " << iv.array.stride;
   // } SpvReflectArrayTraits;
-  os << " }" << std::endl;
+  os << " }\n";
 
   //   uint32_t                            member_count;
-  os << t1 << "member_count: " << iv.member_count << std::endl;
+  os << t1 << "member_count: " << iv.member_count << "\n";
   //   struct SpvReflectInterfaceVariable* members;
-  os << t1 << "members:" << std::endl;
+  os << t1 << "members:\n";
   for (uint32_t i = 0; i < iv.member_count; ++i) {
     auto itor = interface_variable_to_index_.find(&iv.members[i]);
     assert(itor != interface_variable_to_index_.end());
-    os << t2 << "- *iv" << itor->second << " # " << SafeString(iv.members[i].name) << std::endl;
+    os << t2 << "- *iv" << itor->second << " # " << SafeString(iv.members[i].name) << "\n";
   }
 
   //   SpvReflectFormat                    format;
-  os << t1 << "format: " << iv.format << " # " << ToStringFormat(iv.format) << std::endl;
+  os << t1 << "format: " << iv.format << " # " << ToStringFormat(iv.format) << "\n";
 
   if (verbosity_ >= 1) {
     //   SpvReflectTypeDescription*        type_description;
     if (!iv.type_description) {
-      os << t1 << "type_description:" << std::endl;
+      os << t1 << "type_description:\n";
     } else {
       auto itor = type_description_to_index_.find(iv.type_description);
       assert(itor != type_description_to_index_.end());
-      os << t1 << "type_description: *td" << itor->second << std::endl;
+      os << t1 << "type_description: *td" << itor->second << "\n";
     }
   }
 
   //   struct {
   //     uint32_t                        location;
   //   } word_offset;
-  os << t1 << "word_offset: { location: " << iv.word_offset.location << " }" << std::endl;
+  os << t1 << "word_offset: { location: " << iv.word_offset.location << " }\n";
 
   // } SpvReflectInterfaceVariable;
 }
@@ -2244,23 +2816,27 @@ void SpvReflectToYaml::WriteInterfaceVariableTypes(std::ostream& os, const SpvRe
   }
 }
 
-void SpvReflectToYaml::Write(std::ostream& os) {
+void SpvReflectToYaml::Write(std::ostream& stream) {
   if (!sm_._internal) {
     return;
   }
 
+  OutputBuffer buffer(stream);
+  std::ostream os(&buffer);
+
   uint32_t indent_level = 0;
-  const std::string t0 = Indent(indent_level);
-  const std::string t1 = Indent(indent_level + 1);
-  const std::string t2 = Indent(indent_level + 2);
-  const std::string t3 = Indent(indent_level + 3);
+  const char* t0 = Indent(indent_level);
+  const char* t1 = Indent(indent_level + 1);
+  const char* t2 = Indent(indent_level + 2);
+  const char* t3 = Indent(indent_level + 3);
 
-  os << "%YAML 1.1" << std::endl;
-  os << "---" << std::endl;
+  os << "%YAML 1.1\n";
+  os << "---\n";
 
   type_description_to_index_.clear();
+  type_description_to_index_.reserve(sm_._internal->type_description_count);
   if (verbosity_ >= 2) {
-    os << t0 << "all_type_descriptions:" << std::endl;
+    os << t0 << "all_type_descriptions:\n";
     // Write the entire internal type_description table; all type descriptions
     // are reachable from there, though most of them are purely internal & not
     // referenced by any of the public-facing structures.
@@ -2268,7 +2844,7 @@ void SpvReflectToYaml::Write(std::ostream& os) {
       WriteTypeDescription(os, sm_._internal->type_descriptions[i], indent_level + 1);
     }
   } else if (verbosity_ >= 1) {
-    os << t0 << "all_type_descriptions:" << std::endl;
+    os << t0 << "all_type_descriptions:\n";
     // Iterate through all public-facing structures and write any type
     // descriptions we find (and their children).
     for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
@@ -2303,7 +2879,7 @@ void SpvReflectToYaml::Write(std::ostream& os) {
   }
 
   block_variable_to_index_.clear();
-  os << t0 << "all_block_variables:" << std::endl;
+  os << t0 << "all_block_variables:\n";
   for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
     WriteBlockVariable(os, sm_.descriptor_bindings[i].block, indent_level + 1);
   }
@@ -2312,13 +2888,14 @@ void SpvReflectToYaml::Write(std::ostream& os) {
   }
 
   descriptor_binding_to_index_.clear();
-  os << t0 << "all_descriptor_bindings:" << std::endl;
+  descriptor_binding_to_index_.reserve(sm_.descriptor_binding_count);
+  os << t0 << "all_descriptor_bindings:\n";
   for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
     WriteDescriptorBinding(os, sm_.descriptor_bindings[i], indent_level + 1);
   }
 
   interface_variable_to_index_.clear();
-  os << t0 << "all_interface_variables:" << std::endl;
+  os << t0 << "all_interface_variables:\n";
   for (uint32_t i = 0; i < sm_.input_variable_count; ++i) {
     WriteInterfaceVariable(os, *sm_.input_variables[i], indent_level + 1);
   }
@@ -2327,125 +2904,125 @@ void SpvReflectToYaml::Write(std::ostream& os) {
   }
 
   // struct SpvReflectShaderModule {
-  os << t0 << "module:" << std::endl;
+  os << t0 << "module:\n";
   // uint16_t                          generator;
-  os << t1 << "generator: " << sm_.generator << " # " << ToStringGenerator(sm_.generator) << std::endl;
+  os << t1 << "generator: " << sm_.generator << " # " << ToStringGenerator(sm_.generator) << "\n";
   // const char*                       entry_point_name;
-  os << t1 << "entry_point_name: " << SafeString(sm_.entry_point_name) << std::endl;
+  os << t1 << "entry_point_name: " << SafeString(sm_.entry_point_name) << "\n";
   // uint32_t                          entry_point_id;
-  os << t1 << "entry_point_id: " << sm_.entry_point_id << std::endl;
+  os << t1 << "entry_point_id: " << sm_.entry_point_id << "\n";
   // SpvSourceLanguage                 source_language;
-  os << t1 << "source_language: " << sm_.source_language << " # " << ToStringSpvSourceLanguage(sm_.source_language) << std::endl;
+  os << t1 << "source_language: " << sm_.source_language << " # " << ToStringSpvSourceLanguage(sm_.source_language) << "\n";
   // uint32_t                          source_language_version;
-  os << t1 << "source_language_version: " << sm_.source_language_version << std::endl;
+  os << t1 << "source_language_version: " << sm_.source_language_version << "\n";
   // SpvExecutionModel                 spirv_execution_model;
   os << t1 << "spirv_execution_model: " << sm_.spirv_execution_model << " # "
-     << ToStringSpvExecutionModel(sm_.spirv_execution_model) << std::endl;
+     << ToStringSpvExecutionModel(sm_.spirv_execution_model) << "\n";
   // SpvShaderStageFlagBits             shader_stage;
-  os << t1 << "shader_stage: " << AsHexString(sm_.shader_stage) << " # " << ToStringShaderStage(sm_.shader_stage) << std::endl;
+  os << t1 << "shader_stage: " << AsHexString(sm_.shader_stage) << " # " << ToStringShaderStage(sm_.shader_stage) << "\n";
   // uint32_t                          descriptor_binding_count;
-  os << t1 << "descriptor_binding_count: " << sm_.descriptor_binding_count << std::endl;
+  os << t1 << "descriptor_binding_count: " << sm_.descriptor_binding_count << "\n";
   // SpvReflectDescriptorBinding*      descriptor_bindings;
-  os << t1 << "descriptor_bindings:" << std::endl;
+  os << t1 << "descriptor_bindings:\n";
   for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
     auto itor = descriptor_binding_to_index_.find(&sm_.descriptor_bindings[i]);
     assert(itor != descriptor_binding_to_index_.end());
-    os << t2 << "- *db" << itor->second << " # " << SafeString(sm_.descriptor_bindings[i].name) << std::endl;
+    os << t2 << "- *db" << itor->second << " # " << SafeString(sm_.descriptor_bindings[i].name) << "\n";
   }
   // uint32_t                          descriptor_set_count;
-  os << t1 << "descriptor_set_count: " << sm_.descriptor_set_count << std::endl;
+  os << t1 << "descriptor_set_count: " << sm_.descriptor_set_count << "\n";
   // SpvReflectDescriptorSet descriptor_sets[SPV_REFLECT_MAX_DESCRIPTOR_SETS];
-  os << t1 << "descriptor_sets:" << std::endl;
+  os << t1 << "descriptor_sets:\n";
   for (uint32_t i_set = 0; i_set < sm_.descriptor_set_count; ++i_set) {
     // typedef struct SpvReflectDescriptorSet {
     const auto& dset = sm_.descriptor_sets[i_set];
     //   uint32_t                          set;
     os << t1 << "- "
-       << "set: " << dset.set << std::endl;
+       << "set: " << dset.set << "\n";
     //   uint32_t                          binding_count;
-    os << t2 << "binding_count: " << dset.binding_count << std::endl;
+    os << t2 << "binding_count: " << dset.binding_count << "\n";
     //   SpvReflectDescriptorBinding**     bindings;
-    os << t2 << "bindings:" << std::endl;
+    os << t2 << "bindings:\n";
     for (uint32_t i_binding = 0; i_binding < dset.binding_count; ++i_binding) {
       auto itor = descriptor_binding_to_index_.find(dset.bindings[i_binding]);
       assert(itor != descriptor_binding_to_index_.end());
-      os << t3 << "- *db" << itor->second << " # " << SafeString(dset.bindings[i_binding]->name) << std::endl;
+      os << t3 << "- *db" << itor->second << " # " << SafeString(dset.bindings[i_binding]->name) << "\n";
     }
     // } SpvReflectDescriptorSet;
   }
   // uint32_t                          input_variable_count;
   os << t1 << "input_variable_count: " << sm_.input_variable_count << ",\n";
   // SpvReflectInterfaceVariable*      input_variables;
-  os << t1 << "input_variables:" << std::endl;
+  os << t1 << "input_variables:\n";
   for (uint32_t i = 0; i < sm_.input_variable_count; ++i) {
     auto itor = interface_variable_to_index_.find(sm_.input_variables[i]);
     assert(itor != interface_variable_to_index_.end());
-    os << t2 << "- *iv" << itor->second << " # " << SafeString(sm_.input_variables[i]->name) << std::endl;
+    os << t2 << "- *iv" << itor->second << " # " << SafeString(sm_.input_variables[i]->name) << "\n";
   }
   // uint32_t                          output_variable_count;
   os << t1 << "output_variable_count: " << sm_.output_variable_count << ",\n";
   // SpvReflectInterfaceVariable*      output_variables;
-  os << t1 << "output_variables:" << std::endl;
+  os << t1 << "output_variables:\n";
   for (uint32_t i = 0; i < sm_.output_variable_count; ++i) {
     auto itor = interface_variable_to_index_.find(sm_.output_variables[i]);
     assert(itor != interface_variable_to_index_.end());
-    os << t2 << "- *iv" << itor->second << " # " << SafeString(sm_.output_variables[i]->name) << std::endl;
+    os << t2 << "- *iv" << itor->second << " # " << SafeString(sm_.output_variables[i]->name) << "\n";
   }
   // uint32_t                          push_constant_count;
   os << t1 << "push_constant_count: " << sm_.push_constant_block_count << ",\n";
   // SpvReflectBlockVariable*          push_constants;
-  os << t1 << "push_constants:" << std::endl;
+  os << t1 << "push_constants:\n";
   for (uint32_t i = 0; i < sm_.push_constant_block_count; ++i) {
     auto itor = block_variable_to_index_.find(&sm_.push_constant_blocks[i]);
     assert(itor != block_variable_to_index_.end());
-    os << t2 << "- *bv" << itor->second << " # " << SafeString(sm_.push_constant_blocks[i].name) << std::endl;
+    os << t2 << "- *bv" << itor->second << " # " << SafeString(sm_.push_constant_blocks[i].name) << "\n";
   }
 
   // uint32_t                            spec_constant_count;
   os << t1 << "specialization_constant_count: " << sm_.spec_constant_count << ",\n";
   // SpvReflectSpecializationConstant*   spec_constants;
-  os << t1 << "specialization_constants:" << std::endl;
+  os << t1 << "specialization_constants:\n";
   for (uint32_t i = 0; i < sm_.spec_constant_count; ++i) {
-    os << t3 << "- name: " << SafeString(sm_.spec_constants[i].name) << std::endl;
-    os << t3 << "  spirv_id: " << sm_.spec_constants[i].spirv_id << std::endl;
-    os << t3 << "  constant_id: " << sm_.spec_constants[i].constant_id << std::endl;
+    os << t3 << "- name: " << SafeString(sm_.spec_constants[i].name) << "\n";
+    os << t3 << "  spirv_id: " << sm_.spec_constants[i].spirv_id << "\n";
+    os << t3 << "  constant_id: " << sm_.spec_constants[i].constant_id << "\n";
   }
 
   // SPV_EXT_descriptor_heap: per-entry-point distinct heap access patterns.
-  os << "entry_point_heap_accesses:" << std::endl;
+  os << "entry_point_heap_accesses:\n";
   for (uint32_t ep = 0; ep < sm_.entry_point_count; ++ep) {
     const SpvReflectEntryPoint& e = sm_.entry_points[ep];
-    os << t1 << "- entry: " << SafeString(e.name) << std::endl;
-    os << t1 << "  resource_heap_access_count: " << e.resource_heap_access_count << std::endl;
-    os << t1 << "  resource_heap_accesses:" << std::endl;
+    os << t1 << "- entry: " << SafeString(e.name) << "\n";
+    os << t1 << "  resource_heap_access_count: " << e.resource_heap_access_count << "\n";
+    os << t1 << "  resource_heap_accesses:\n";
     for (uint32_t i = 0; i < e.resource_heap_access_count; ++i) {
       const SpvReflectEntryPointResourceHeapAccess& a = e.resource_heap_accesses[i];
-      os << t3 << "- heap_name: " << SafeString(a.heap_name) << std::endl;
-      os << t3 << "  runtime_array_type_id: " << a.runtime_array_type_id << std::endl;
+      os << t3 << "- heap_name: " << SafeString(a.heap_name) << "\n";
+      os << t3 << "  runtime_array_type_id: " << a.runtime_array_type_id << "\n";
       os << t3 << "  stride: " << a.stride;
       if (a.stride == UINT32_MAX) os << " # UNSPECIFIED";
-      os << std::endl;
-      os << t3 << "  descriptor_type: " << a.descriptor_type << " # " << ToStringDescriptorType(a.descriptor_type) << std::endl;
+      os << "\n";
+      os << t3 << "  descriptor_type: " << a.descriptor_type << " # " << ToStringDescriptorType(a.descriptor_type) << "\n";
       if (a.type_description != nullptr) {
         auto itor = type_description_to_index_.find(a.type_description);
         if (itor != type_description_to_index_.end()) {
-          os << t3 << "  type_description: *td" << itor->second << std::endl;
+          os << t3 << "  type_description: *td" << itor->second << "\n";
         }
       }
     }
-    os << t1 << "  sampler_heap_access_count: " << e.sampler_heap_access_count << std::endl;
-    os << t1 << "  sampler_heap_accesses:" << std::endl;
+    os << t1 << "  sampler_heap_access_count: " << e.sampler_heap_access_count << "\n";
+    os << t1 << "  sampler_heap_accesses:\n";
     for (uint32_t i = 0; i < e.sampler_heap_access_count; ++i) {
       const SpvReflectEntryPointSamplerHeapAccess& a = e.sampler_heap_accesses[i];
-      os << t3 << "- heap_name: " << SafeString(a.heap_name) << std::endl;
-      os << t3 << "  runtime_array_type_id: " << a.runtime_array_type_id << std::endl;
+      os << t3 << "- heap_name: " << SafeString(a.heap_name) << "\n";
+      os << t3 << "  runtime_array_type_id: " << a.runtime_array_type_id << "\n";
       os << t3 << "  stride: " << a.stride;
       if (a.stride == UINT32_MAX) os << " # UNSPECIFIED";
-      os << std::endl;
+      os << "\n";
       if (a.type_description != nullptr) {
         auto itor = type_description_to_index_.find(a.type_description);
         if (itor != type_description_to_index_.end()) {
-          os << t3 << "  type_description: *td" << itor->second << std::endl;
+          os << t3 << "  type_description: *td" << itor->second << "\n";
         }
       }
     }
@@ -2453,33 +3030,614 @@ void SpvReflectToYaml::Write(std::ostream& os) {
 
   if (verbosity_ >= 2) {
     // struct Internal {
-    os << t1 << "_internal:" << std::endl;
+    os << t1 << "_internal:\n";
     if (sm_._internal) {
       //   size_t                          spirv_size;
-      os << t2 << "spirv_size: " << sm_._internal->spirv_size << std::endl;
+      os << t2 << "spirv_size: " << sm_._internal->spirv_size << "\n";
       //   uint32_t*                       spirv_code;
       os << t2 << "spirv_code: [";
       for (size_t i = 0; i < sm_._internal->spirv_word_count; ++i) {
         if ((i % 6) == 0) {
-          os << std::endl << t3;
+          os << "\n" << t3;
         }
         os << AsHexString(sm_._internal->spirv_code[i]) << ",";
       }
-      os << "]" << std::endl;
+      os << "]\n";
       //   uint32_t                        spirv_word_count;
-      os << t2 << "spirv_word_count: " << sm_._internal->spirv_word_count << std::endl;
+      os << t2 << "spirv_word_count: " << sm_._internal->spirv_word_count << "\n";
       //   size_t                          type_description_count;
-      os << t2 << "type_description_count: " << sm_._internal->type_description_count << std::endl;
+      os << t2 << "type_description_count: " << sm_._internal->type_description_count << "\n";
       //   SpvReflectTypeDescription*      type_descriptions;
-      os << t2 << "type_descriptions:" << std::endl;
+      os << t2 << "type_descriptions:\n";
       for (uint32_t i = 0; i < sm_._internal->type_description_count; ++i) {
         auto itor = type_description_to_index_.find(&sm_._internal->type_descriptions[i]);
         assert(itor != type_description_to_index_.end());
-        os << t3 << "- *td" << itor->second << std::endl;
+        os << t3 << "- *td" << itor->second << "\n";
       }
     }
     // } * _internal;
   }
 
-  os << "..." << std::endl;
+  os << "...\n";
+}
+
+//////////////////////////////////
+
+void JsonWriter::BeginObject() {
+  BeginValue();
+  os_ << '{';
+  assert(depth_ < kMaxDepth);
+  has_value_[depth_++] = false;
+}
+
+void JsonWriter::EndObject() {
+  assert(depth_ > 0);
+  --depth_;
+  os_ << '}';
+}
+
+void JsonWriter::BeginArray() {
+  BeginValue();
+  os_ << '[';
+  assert(depth_ < kMaxDepth);
+  has_value_[depth_++] = false;
+}
+
+void JsonWriter::EndArray() {
+  assert(depth_ > 0);
+  --depth_;
+  os_ << ']';
+}
+
+void JsonWriter::Key(const char* key) {
+  BeginValue();
+  WriteQuoted(key);
+  os_ << ':';
+  after_key_ = true;
+}
+
+void JsonWriter::Null() {
+  BeginValue();
+  os_ << "null";
+}
+
+void JsonWriter::Int(int64_t value) {
+  BeginValue();
+  os_ << value;
+}
+
+void JsonWriter::Uint(uint64_t value) {
+  BeginValue();
+  os_ << value;
+}
+
+void JsonWriter::String(const char* str) {
+  BeginValue();
+  if (str == nullptr) {
+    os_ << "null";
+    return;
+  }
+  WriteQuoted(str);
+}
+
+void JsonWriter::BeginValue() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (depth_ > 0) {
+    if (has_value_[depth_ - 1]) {
+      os_ << ',';
+    }
+    has_value_[depth_ - 1] = true;
+  }
+}
+
+void JsonWriter::WriteQuoted(const char* str) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  os_ << '"';
+  // Copy runs of characters that need no escaping in one write.
+  const char* run = str;
+  for (const char* p = str; *p != '\0'; ++p) {
+    unsigned char c = static_cast<unsigned char>(*p);
+    if ((c >= 0x20) && (c != '"') && (c != '\\')) {
+      continue;
+    }
+    os_.write(run, p - run);
+    run = p + 1;
+    switch (c) {
+      case '"':
+        os_ << "\\\"";
+        break;
+      case '\\':
+        os_ << "\\\\";
+        break;
+      case '\n':
+        os_ << "\\n";
+        break;
+      case '\r':
+        os_ << "\\r";
+        break;
+      case '\t':
+        os_ << "\\t";
+        break;
+      default:
+        os_ << "\\u00" << kHexDigits[c >> 4] << kHexDigits[c & 0xF];
+        break;
+    }
+  }
+  os_ << run << '"';
+}
+
+static void WriteJsonNumericTraits(JsonWriter& json, const SpvReflectNumericTraits& numeric) {
+  json.Key("numeric");
+  json.BeginObject();
+  json.Key("scalar");
+  json.BeginObject();
+  json.UintField("width", numeric.scalar.width);
+  json.UintField("signedness", numeric.scalar.signedness);
+  json.EndObject();
+  json.Key("vector");
+  json.BeginObject();
+  json.UintField("component_count", numeric.vector.component_count);
+  json.EndObject();
+  json.Key("matrix");
+  json.BeginObject();
+  json.UintField("column_count", numeric.matrix.column_count);
+  json.UintField("row_count", numeric.matrix.row_count);
+  json.UintField("stride", numeric.matrix.stride);
+  json.EndObject();
+  json.EndObject();
+}
+
+static void WriteJsonImageTraits(JsonWriter& json, const SpvReflectImageTraits& image) {
+  json.Key("image");
+  json.BeginObject();
+  json.IntField("dim", image.dim);
+  json.UintField("depth", image.depth);
+  json.UintField("arrayed", image.arrayed);
+  json.UintField("ms", image.ms);
+  json.UintField("sampled", image.sampled);
+  json.IntField("image_format", image.image_format);
+  json.EndObject();
+}
+
+static void WriteJsonArrayTraits(JsonWriter& json, const SpvReflectArrayTraits& array) {
+  json.Key("array");
+  json.BeginObject();
+  json.Key("dims");
+  json.BeginArray();
+  for (uint32_t i_dim = 0; i_dim < array.dims_count; ++i_dim) {
+    json.Uint(array.dims[i_dim]);
+  }
+  json.EndArray();
+  json.UintField("stride", array.stride);
+  json.EndObject();
+}
+
+template <typename T>
+static void WriteJsonIndex(JsonWriter& json, const std::unordered_map<const T*, uint32_t>& object_to_index, const T* object) {
+  auto itor = (object != nullptr) ? object_to_index.find(object) : object_to_index.end();
+  if (itor == object_to_index.end()) {
+    json.Null();
+  } else {
+    json.Uint(itor->second);
+  }
+}
+
+SpvReflectToJson::SpvReflectToJson(const SpvReflectShaderModule& shader_module, uint32_t verbosity)
+    : sm_(shader_module), verbosity_(verbosity) {}
+
+void SpvReflectToJson::WriteTypeDescriptionIndex(JsonWriter& json, const SpvReflectTypeDescription* td) {
+  if (verbosity_ >= 1) {
+    json.Key("type_description");
+    WriteJsonIndex(json, type_description_to_index_, td);
+  }
+}
+
+void SpvReflectToJson::WriteTypeDescription(JsonWriter& json, const SpvReflectTypeDescription& td) {
+  if (type_description_to_index_.find(&td) != type_description_to_index_.end()) {
+    return;
+  }
+  // Members are written first, as in the YAML output.
+  if (!td.copied) {
+    for (uint32_t i = 0; i < td.member_count; ++i) {
+      WriteTypeDescription(json, td.members[i]);
+    }
+  }
+
+  uint32_t type_description_index = static_cast<uint32_t>(type_description_to_index_.size());
+  type_description_to_index_[&td] = type_description_index;
+
+  json.BeginObject();
+  json.UintField("id", td.id);
+  json.IntField("op", td.op);
+  json.StringField("type_name", td.type_name);
+  json.StringField("struct_member_name", td.struct_member_name);
+  json.IntField("storage_class", td.storage_class);
+  json.UintField("type_flags", td.type_flags);
+  json.UintField("decoration_flags", td.decoration_flags);
+  json.Key("traits");
+  json.BeginObject();
+  WriteJsonNumericTraits(json, td.traits.numeric);
+  WriteJsonImageTraits(json, td.traits.image);
+  WriteJsonArrayTraits(json, td.traits.array);
+  json.EndObject();
+  // A forward pointer's members belong to the type it points to.
+  json.Key("members");
+  if (td.copied) {
+    json.Null();
+  } else {
+    json.BeginArray();
+    for (uint32_t i = 0; i < td.member_count; ++i) {
+      WriteJsonIndex(json, type_description_to_index_, &td.members[i]);
+    }
+    json.EndArray();
+  }
+  json.EndObject();
+}
+
+void SpvReflectToJson::WriteBlockVariable(JsonWriter& json, const SpvReflectBlockVariable& bv) {
+  if ((bv.flags & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY)) {
+    return;  // catches recursive buffer references
+  }
+  // Blocks of descriptor bindings can share their members.
+  if (block_variable_to_index_.find(&bv) != block_variable_to_index_.end()) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < bv.member_count; ++i) {
+    WriteBlockVariable(json, bv.members[i]);
+  }
+
+  uint32_t block_variable_index = static_cast<uint32_t>(block_variable_to_index_.size());
+  block_variable_to_index_[&bv] = block_variable_index;
+
+  json.BeginObject();
+  json.StringField("name", bv.name);
+  json.UintField("offset", bv.offset);
+  json.UintField("absolute_offset", bv.absolute_offset);
+  json.UintField("size", bv.size);
+  json.UintField("padded_size", bv.padded_size);
+  json.UintField("decoration_flags", bv.decoration_flags);
+  WriteJsonNumericTraits(json, bv.numeric);
+  WriteJsonArrayTraits(json, bv.array);
+  json.UintField("flags", bv.flags);
+  // Recursive buffer references are null.
+  json.Key("members");
+  json.BeginArray();
+  for (uint32_t i = 0; i < bv.member_count; ++i) {
+    WriteJsonIndex(json, block_variable_to_index_, &bv.members[i]);
+  }
+  json.EndArray();
+  WriteTypeDescriptionIndex(json, bv.type_description);
+  json.EndObject();
+}
+
+void SpvReflectToJson::WriteDescriptorBinding(JsonWriter& json, const SpvReflectDescriptorBinding& db) {
+  // A binding's UAV counter is written first, so it may already be in the table.
+  if (descriptor_binding_to_index_.find(&db) != descriptor_binding_to_index_.end()) {
+    return;
+  }
+  if (db.uav_counter_binding != nullptr) {
+    WriteDescriptorBinding(json, *(db.uav_counter_binding));
+  }
+
+  uint32_t descriptor_binding_index = static_cast<uint32_t>(descriptor_binding_to_index_.size());
+  descriptor_binding_to_index_[&db] = descriptor_binding_index;
+
+  json.BeginObject();
+  json.UintField("spirv_id", db.spirv_id);
+  json.StringField("name", db.name);
+  json.UintField("binding", db.binding);
+  json.UintField("input_attachment_index", db.input_attachment_index);
+  json.UintField("set", db.set);
+  json.UintField("decoration_flags", db.decoration_flags);
+  json.IntField("descriptor_type", db.descriptor_type);
+  json.IntField("resource_type", db.resource_type);
+  WriteJsonImageTraits(json, db.image);
+  json.Key("block");
+  WriteJsonIndex(json, block_variable_to_index_, &db.block);
+  json.Key("array");
+  json.BeginObject();
+  json.Key("dims");
+  json.BeginArray();
+  for (uint32_t i_dim = 0; i_dim < db.array.dims_count; ++i_dim) {
+    json.Uint(db.array.dims[i_dim]);
+  }
+  json.EndArray();
+  json.EndObject();
+  json.UintField("accessed", db.accessed);
+  json.UintField("uav_counter_id", db.uav_counter_id);
+  json.Key("uav_counter_binding");
+  WriteJsonIndex(json, descriptor_binding_to_index_, db.uav_counter_binding);
+  json.Key("byte_address_buffer_offsets");
+  json.BeginArray();
+  for (uint32_t i = 0; i < db.byte_address_buffer_offset_count; ++i) {
+    json.Uint(db.byte_address_buffer_offsets[i]);
+  }
+  json.EndArray();
+  WriteTypeDescriptionIndex(json, db.type_description);
+  json.Key("word_offset");
+  json.BeginObject();
+  json.UintField("binding", db.word_offset.binding);
+  json.UintField("set", db.word_offset.set);
+  json.EndObject();
+  json.Key("user_type");
+  if (db.user_type == SPV_REFLECT_USER_TYPE_INVALID) {
+    json.Null();
+  } else {
+    json.String(ToStringUserType(db.user_type).c_str());
+  }
+  json.EndObject();
+}
+
+void SpvReflectToJson::WriteInterfaceVariable(JsonWriter& json, const SpvReflectInterfaceVariable& iv) {
+  for (uint32_t i = 0; i < iv.member_count; ++i) {
+    assert(interface_variable_to_index_.find(&iv.members[i]) == interface_variable_to_index_.end());
+    WriteInterfaceVariable(json, iv.members[i]);
+  }
+
+  uint32_t interface_variable_index = static_cast<uint32_t>(interface_variable_to_index_.size());
+  interface_variable_to_index_[&iv] = interface_variable_index;
+
+  json.BeginObject();
+  json.UintField("spirv_id", iv.spirv_id);
+  json.StringField("name", iv.name);
+  json.UintField("location", iv.location);
+  json.IntField("storage_class", iv.storage_class);
+  json.StringField("semantic", iv.semantic);
+  json.UintField("decoration_flags", iv.decoration_flags);
+  // Block members carry their own built_in.
+  json.IntField("built_in", iv.built_in);
+  WriteJsonNumericTraits(json, iv.numeric);
+  WriteJsonArrayTraits(json, iv.array);
+  json.Key("members");
+  json.BeginArray();
+  for (uint32_t i = 0; i < iv.member_count; ++i) {
+    WriteJsonIndex(json, interface_variable_to_index_, &iv.members[i]);
+  }
+  json.EndArray();
+  json.IntField("format", iv.format);
+  WriteTypeDescriptionIndex(json, iv.type_description);
+  json.Key("word_offset");
+  json.BeginObject();
+  json.UintField("location", iv.word_offset.location);
+  json.EndObject();
+  json.EndObject();
+}
+
+void SpvReflectToJson::WriteBlockVariableTypes(JsonWriter& json, const SpvReflectBlockVariable& bv) {
+  if (bv.type_description != nullptr) {
+    WriteTypeDescription(json, *bv.type_description);
+  }
+
+  if (bv.flags & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY) {
+    return;
+  }
+  for (uint32_t i = 0; i < bv.member_count; ++i) {
+    WriteBlockVariableTypes(json, bv.members[i]);
+  }
+}
+
+void SpvReflectToJson::WriteDescriptorBindingTypes(JsonWriter& json, const SpvReflectDescriptorBinding& db) {
+  WriteBlockVariableTypes(json, db.block);
+
+  if (db.uav_counter_binding) {
+    WriteDescriptorBindingTypes(json, *(db.uav_counter_binding));
+  }
+
+  if (db.type_description != nullptr) {
+    WriteTypeDescription(json, *db.type_description);
+  }
+}
+
+void SpvReflectToJson::WriteInterfaceVariableTypes(JsonWriter& json, const SpvReflectInterfaceVariable& iv) {
+  if (iv.type_description != nullptr) {
+    WriteTypeDescription(json, *iv.type_description);
+  }
+
+  for (uint32_t i = 0; i < iv.member_count; ++i) {
+    WriteInterfaceVariableTypes(json, iv.members[i]);
+  }
+}
+
+void SpvReflectToJson::Write(std::ostream& stream) {
+  if (!sm_._internal) {
+    return;
+  }
+
+  OutputBuffer buffer(stream);
+  std::ostream os(&buffer);
+  JsonWriter json(os);
+
+  json.BeginObject();
+  json.UintField("schema_version", kSchemaVersion);
+
+  type_description_to_index_.clear();
+  type_description_to_index_.reserve(sm_._internal->type_description_count);
+  if (verbosity_ >= 2) {
+    json.Key("type_descriptions");
+    json.BeginArray();
+    for (size_t i = 0; i < sm_._internal->type_description_count; ++i) {
+      WriteTypeDescription(json, sm_._internal->type_descriptions[i]);
+    }
+    json.EndArray();
+  } else if (verbosity_ >= 1) {
+    json.Key("type_descriptions");
+    json.BeginArray();
+    for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
+      WriteDescriptorBindingTypes(json, sm_.descriptor_bindings[i]);
+    }
+    for (uint32_t i = 0; i < sm_.push_constant_block_count; ++i) {
+      WriteBlockVariableTypes(json, sm_.push_constant_blocks[i]);
+    }
+    for (uint32_t i = 0; i < sm_.input_variable_count; ++i) {
+      WriteInterfaceVariableTypes(json, *sm_.input_variables[i]);
+    }
+    for (uint32_t i = 0; i < sm_.output_variable_count; ++i) {
+      WriteInterfaceVariableTypes(json, *sm_.output_variables[i]);
+    }
+    for (uint32_t ep = 0; ep < sm_.entry_point_count; ++ep) {
+      const SpvReflectEntryPoint& e = sm_.entry_points[ep];
+      for (uint32_t i = 0; i < e.resource_heap_access_count; ++i) {
+        if (e.resource_heap_accesses[i].type_description != nullptr) {
+          WriteTypeDescription(json, *e.resource_heap_accesses[i].type_description);
+        }
+      }
+      for (uint32_t i = 0; i < e.sampler_heap_access_count; ++i) {
+        if (e.sampler_heap_accesses[i].type_description != nullptr) {
+          WriteTypeDescription(json, *e.sampler_heap_accesses[i].type_description);
+        }
+      }
+    }
+    json.EndArray();
+  }
+
+  block_variable_to_index_.clear();
+  json.Key("block_variables");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
+    WriteBlockVariable(json, sm_.descriptor_bindings[i].block);
+  }
+  for (uint32_t i = 0; i < sm_.push_constant_block_count; ++i) {
+    WriteBlockVariable(json, sm_.push_constant_blocks[i]);
+  }
+  json.EndArray();
+
+  descriptor_binding_to_index_.clear();
+  descriptor_binding_to_index_.reserve(sm_.descriptor_binding_count);
+  json.Key("descriptor_bindings");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
+    WriteDescriptorBinding(json, sm_.descriptor_bindings[i]);
+  }
+  json.EndArray();
+
+  interface_variable_to_index_.clear();
+  json.Key("interface_variables");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.input_variable_count; ++i) {
+    WriteInterfaceVariable(json, *sm_.input_variables[i]);
+  }
+  for (uint32_t i = 0; i < sm_.output_variable_count; ++i) {
+    WriteInterfaceVariable(json, *sm_.output_variables[i]);
+  }
+  json.EndArray();
+
+  json.Key("module");
+  json.BeginObject();
+  json.UintField("generator", sm_.generator);
+  json.StringField("entry_point_name", sm_.entry_point_name);
+  json.UintField("entry_point_id", sm_.entry_point_id);
+  json.IntField("source_language", sm_.source_language);
+  json.UintField("source_language_version", sm_.source_language_version);
+  json.IntField("spirv_execution_model", sm_.spirv_execution_model);
+  json.UintField("shader_stage", sm_.shader_stage);
+  json.Key("descriptor_bindings");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.descriptor_binding_count; ++i) {
+    WriteJsonIndex(json, descriptor_binding_to_index_, &sm_.descriptor_bindings[i]);
+  }
+  json.EndArray();
+  json.Key("descriptor_sets");
+  json.BeginArray();
+  for (uint32_t i_set = 0; i_set < sm_.descriptor_set_count; ++i_set) {
+    const auto& dset = sm_.descriptor_sets[i_set];
+    json.BeginObject();
+    json.UintField("set", dset.set);
+    json.Key("bindings");
+    json.BeginArray();
+    for (uint32_t i_binding = 0; i_binding < dset.binding_count; ++i_binding) {
+      WriteJsonIndex<SpvReflectDescriptorBinding>(json, descriptor_binding_to_index_, dset.bindings[i_binding]);
+    }
+    json.EndArray();
+    json.EndObject();
+  }
+  json.EndArray();
+  json.Key("input_variables");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.input_variable_count; ++i) {
+    WriteJsonIndex<SpvReflectInterfaceVariable>(json, interface_variable_to_index_, sm_.input_variables[i]);
+  }
+  json.EndArray();
+  json.Key("output_variables");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.output_variable_count; ++i) {
+    WriteJsonIndex<SpvReflectInterfaceVariable>(json, interface_variable_to_index_, sm_.output_variables[i]);
+  }
+  json.EndArray();
+  json.Key("push_constants");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.push_constant_block_count; ++i) {
+    WriteJsonIndex(json, block_variable_to_index_, &sm_.push_constant_blocks[i]);
+  }
+  json.EndArray();
+  json.Key("specialization_constants");
+  json.BeginArray();
+  for (uint32_t i = 0; i < sm_.spec_constant_count; ++i) {
+    json.BeginObject();
+    json.StringField("name", sm_.spec_constants[i].name);
+    json.UintField("spirv_id", sm_.spec_constants[i].spirv_id);
+    json.UintField("constant_id", sm_.spec_constants[i].constant_id);
+    json.EndObject();
+  }
+  json.EndArray();
+  if (verbosity_ >= 2) {
+    json.Key("internal");
+    json.BeginObject();
+    json.UintField("spirv_size", sm_._internal->spirv_size);
+    json.Key("spirv_code");
+    json.BeginArray();
+    for (size_t i = 0; i < sm_._internal->spirv_word_count; ++i) {
+      json.Uint(sm_._internal->spirv_code[i]);
+    }
+    json.EndArray();
+    json.Key("type_descriptions");
+    json.BeginArray();
+    for (size_t i = 0; i < sm_._internal->type_description_count; ++i) {
+      WriteJsonIndex(json, type_description_to_index_, &sm_._internal->type_descriptions[i]);
+    }
+    json.EndArray();
+    json.EndObject();
+  }
+  json.EndObject();
+
+  // SPV_EXT_descriptor_heap: per-entry-point distinct heap access patterns.
+  json.Key("entry_point_heap_accesses");
+  json.BeginArray();
+  for (uint32_t ep = 0; ep < sm_.entry_point_count; ++ep) {
+    const SpvReflectEntryPoint& e = sm_.entry_points[ep];
+    json.BeginObject();
+    json.StringField("entry", e.name);
+    json.Key("resource_heap_accesses");
+    json.BeginArray();
+    for (uint32_t i = 0; i < e.resource_heap_access_count; ++i) {
+      const SpvReflectEntryPointResourceHeapAccess& a = e.resource_heap_accesses[i];
+      json.BeginObject();
+      json.StringField("heap_name", a.heap_name);
+      json.UintField("runtime_array_type_id", a.runtime_array_type_id);
+      json.UintField("stride", a.stride);
+      json.IntField("descriptor_type", a.descriptor_type);
+      WriteTypeDescriptionIndex(json, a.type_description);
+      json.EndObject();
+    }
+    json.EndArray();
+    json.Key("sampler_heap_accesses");
+    json.BeginArray();
+    for (uint32_t i = 0; i < e.sampler_heap_access_count; ++i) {
+      const SpvReflectEntryPointSamplerHeapAccess& a = e.sampler_heap_accesses[i];
+      json.BeginObject();
+      json.StringField("heap_name", a.heap_name);
+      json.UintField("runtime_array_type_id", a.runtime_array_type_id);
+      json.UintField("stride", a.stride);
+      WriteTypeDescriptionIndex(json, a.type_description);
+      json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+  }
+  json.EndArray();
+  json.EndObject();
+  os << "\n";
 }
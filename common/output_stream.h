@@ -1,9 +1,11 @@
 #ifndef SPIRV_REFLECT_OUTPUT_STREAM_H
 #define SPIRV_REFLECT_OUTPUT_STREAM_H
 
-#include <map>
 #include <ostream>
+#include <streambuf>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "spirv_reflect.h"
 
@@ -16,6 +18,7 @@ std::string ToStringSpvImageFormat(SpvImageFormat fmt);
 
 std::string ToStringGenerator(SpvReflectGenerator generator);
 std::string ToStringShaderStage(SpvReflectShaderStageFlagBits stage);
+std::string ToStringShaderStageFlags(uint32_t stage_flags);
 std::string ToStringResourceType(SpvReflectResourceType type);
 std::string ToStringDescriptorType(SpvReflectDescriptorType value);
 std::string ToStringTypeFlags(SpvReflectTypeFlags type_flags);
@@ -25,9 +28,46 @@ std::string ToStringDescriptorType(SpvReflectDescriptorType value);
 std::string ToStringFormat(SpvReflectFormat fmt);
 std::string ToStringComponentType(const SpvReflectTypeDescription& type, uint32_t member_decoration_flags);
 std::string ToStringType(SpvSourceLanguage src_lang, const SpvReflectTypeDescription& type);
+std::string ToStringModuleRebuildFlags(SpvReflectModuleRebuildFlags rebuild_flags);
+
+// Collects writes in a fixed buffer and forwards them to the wrapped stream in
+// large chunks, so the writers below never pay for per-line flushes or
+// virtual calls into the destination stream.
+class OutputBuffer : public std::streambuf {
+ public:
+  explicit OutputBuffer(std::ostream& os);
+  ~OutputBuffer() override;
+
+ protected:
+  int_type overflow(int_type ch) override;
+  std::streamsize xsputn(const char* s, std::streamsize n) override;
+  int sync() override;
+
+ private:
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+  std::ostream& os_;
+  char buffer_[16384];
+};
 
 // std::ostream& operator<<(std::ostream& os, const spv_reflect::ShaderModule& obj);
 void WriteReflection(const spv_reflect::ShaderModule& obj, bool flatten_cbuffers, std::ostream& os);
+// module_names and modules are parallel to the modules the layouts were created from.
+void WriteDescriptorSetLayouts(const SpvReflectDescriptorSetLayouts& layouts, const std::vector<std::string>& module_names,
+                               const std::vector<const SpvReflectShaderModule*>& modules, std::ostream& os);
+
+// One line per change, each with the objects it requires to be rebuilt.
+void WriteModuleDiff(const SpvReflectModuleDiff& diff, std::ostream& os);
+
+// One line per statistic of the module, including how it was reflected.
+void WriteModuleStats(const SpvReflectShaderModule& module, std::ostream& os);
+
+// Writes a header with the module's block layouts as C++ structs, checked
+// with static_assert, and constexpr binding, push constant, vertex input and
+// specialization constant tables per entry point.
+void WriteCppHeader(const SpvReflectShaderModule& module, const std::string& namespace_name, const std::string& source_name,
+                    std::ostream& os);
 
 class SpvReflectToYaml {
  public:
@@ -42,12 +82,24 @@ class SpvReflectToYaml {
   }
 
  private:
-  void Write(std::ostream& os);
+  void Write(std::ostream& stream);
 
   SpvReflectToYaml(const SpvReflectToYaml&) = delete;
   SpvReflectToYaml(const SpvReflectToYaml&&) = delete;
-  static std::string Indent(uint32_t level) { return std::string(2 * level, ' '); }
-  static std::string SafeString(const char* str) { return str ? (std::string("\"") + str + "\"") : ""; }
+  // Quoted string, or nothing if null; streamed without building a temporary.
+  struct QuotedString {
+    const char* str;
+  };
+  friend std::ostream& operator<<(std::ostream& os, QuotedString quoted) {
+    if (quoted.str) {
+      os << '"' << quoted.str << '"';
+    }
+    return os;
+  }
+
+  // Returns a pointer into a shared run of spaces.
+  static const char* Indent(uint32_t level);
+  static QuotedString SafeString(const char* str) { return QuotedString{str}; }
   void WriteTypeDescription(std::ostream& os, const SpvReflectTypeDescription& td, uint32_t indent_level);
   void WriteBlockVariable(std::ostream& os, const SpvReflectBlockVariable& bv, uint32_t indent_level);
   void WriteDescriptorBinding(std::ostream& os, const SpvReflectDescriptorBinding& db, uint32_t indent_level);
@@ -61,10 +113,98 @@ class SpvReflectToYaml {
 
   const SpvReflectShaderModule& sm_;
   uint32_t verbosity_ = 0;
-  std::map<const SpvReflectTypeDescription*, uint32_t> type_description_to_index_;
-  std::map<const SpvReflectBlockVariable*, uint32_t> block_variable_to_index_;
-  std::map<const SpvReflectDescriptorBinding*, uint32_t> descriptor_binding_to_index_;
-  std::map<const SpvReflectInterfaceVariable*, uint32_t> interface_variable_to_index_;
+  std::unordered_map<const SpvReflectTypeDescription*, uint32_t> type_description_to_index_;
+  std::unordered_map<const SpvReflectBlockVariable*, uint32_t> block_variable_to_index_;
+  std::unordered_map<const SpvReflectDescriptorBinding*, uint32_t> descriptor_binding_to_index_;
+  std::unordered_map<const SpvReflectInterfaceVariable*, uint32_t> interface_variable_to_index_;
+};
+
+// Streams JSON text without building a document: values are written as they
+// are added and commas are placed from a fixed-depth nesting stack.
+class JsonWriter {
+ public:
+  explicit JsonWriter(std::ostream& os) : os_(os) {}
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+  void Key(const char* key);
+  void Null();
+  void Int(int64_t value);
+  void Uint(uint64_t value);
+  // Writes null if str is null.
+  void String(const char* str);
+
+  void IntField(const char* key, int64_t value) {
+    Key(key);
+    Int(value);
+  }
+  void UintField(const char* key, uint64_t value) {
+    Key(key);
+    Uint(value);
+  }
+  void StringField(const char* key, const char* str) {
+    Key(key);
+    String(str);
+  }
+
+ private:
+  JsonWriter(const JsonWriter&) = delete;
+  JsonWriter& operator=(const JsonWriter&) = delete;
+  void BeginValue();
+  void WriteQuoted(const char* str);
+
+  static const uint32_t kMaxDepth = 32;
+  std::ostream& os_;
+  bool has_value_[kMaxDepth] = {};
+  uint32_t depth_ = 0;
+  bool after_key_ = false;
+};
+
+// Writes the same content as SpvReflectToYaml at each verbosity level as one
+// JSON object, for tools that want a fast parser instead of a YAML one.
+//
+// The top-level "type_descriptions" (verbosity >= 1), "block_variables",
+// "descriptor_bindings" and "interface_variables" arrays replace the YAML
+// anchors; every reference to one of their objects is an integer index into
+// the array, or null where YAML writes an empty value. Enums and flags are
+// integers and element counts are implied by array lengths. "schema_version"
+// only changes if an existing field changes meaning; new fields may be added.
+class SpvReflectToJson {
+ public:
+  static const uint32_t kSchemaVersion = 1;
+
+  explicit SpvReflectToJson(const SpvReflectShaderModule& shader_module, uint32_t verbosity = 0);
+
+  friend std::ostream& operator<<(std::ostream& os, SpvReflectToJson& to_json) {
+    to_json.Write(os);
+    return os;
+  }
+
+ private:
+  void Write(std::ostream& stream);
+
+  SpvReflectToJson(const SpvReflectToJson&) = delete;
+  SpvReflectToJson(const SpvReflectToJson&&) = delete;
+  void WriteTypeDescription(JsonWriter& json, const SpvReflectTypeDescription& td);
+  void WriteBlockVariable(JsonWriter& json, const SpvReflectBlockVariable& bv);
+  void WriteDescriptorBinding(JsonWriter& json, const SpvReflectDescriptorBinding& db);
+  void WriteInterfaceVariable(JsonWriter& json, const SpvReflectInterfaceVariable& iv);
+  void WriteTypeDescriptionIndex(JsonWriter& json, const SpvReflectTypeDescription* td);
+
+  // Write all SpvReflectTypeDescription objects reachable from the specified objects, if they haven't been
+  // written already.
+  void WriteBlockVariableTypes(JsonWriter& json, const SpvReflectBlockVariable& bv);
+  void WriteDescriptorBindingTypes(JsonWriter& json, const SpvReflectDescriptorBinding& db);
+  void WriteInterfaceVariableTypes(JsonWriter& json, const SpvReflectInterfaceVariable& iv);
+
+  const SpvReflectShaderModule& sm_;
+  uint32_t verbosity_ = 0;
+  std::unordered_map<const SpvReflectTypeDescription*, uint32_t> type_description_to_index_;
+  std::unordered_map<const SpvReflectBlockVariable*, uint32_t> block_variable_to_index_;
+  std::unordered_map<const SpvReflectDescriptorBinding*, uint32_t> descriptor_binding_to_index_;
+  std::unordered_map<const SpvReflectInterfaceVariable*, uint32_t> interface_variable_to_index_;
 };
 
 #endif
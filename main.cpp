@@ -26,6 +26,9 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "common/output_stream.h"
 #include "examples/arg_parser.h"
@@ -43,8 +46,12 @@ void PrintUsage() {
             << " --help                   Display this message" << std::endl
             << " -o,--output              Print output to file. [default: stdout]" << std::endl
             << " -y,--yaml                Format output as YAML. [default: disabled]" << std::endl
-            << " -v VERBOSITY             Specify output verbosity (YAML output "
-               "only):"
+            << " -j,--json                Format output as JSON, with the same content "
+               "as YAML."
+            << std::endl
+            << "                          [default: disabled]" << std::endl
+            << " -v VERBOSITY             Specify output verbosity (YAML and JSON "
+               "output only):"
             << std::endl
             << "                          0: shader info, block variables, interface "
                "variables,"
@@ -73,9 +80,157 @@ void PrintUsage() {
             << std::endl
             << "-fcb,--flatten_cbuffers   Flatten constant buffers on non-YAML "
                "output."
+            << std::endl
+            << "-l,--layouts              Prints the distinct descriptor set layouts "
+               "used by all given"
+            << std::endl
+            << "                          modules and the layout each entry point's "
+               "sets map to."
+            << std::endl
+            << "-cpp,--emit-cpp           Prints a C++ header with the uniform and push "
+               "constant block"
+            << std::endl
+            << "                          layouts as structs and constexpr tables of "
+               "each entry point's"
+            << std::endl
+            << "                          bindings, push constants and vertex inputs." << std::endl
+            << "-d,--diff                 Compares two modules, old and new, and prints "
+               "what changed and"
+            << std::endl
+            << "                          what has to be rebuilt because of it." << std::endl
+            << "-er,--embed-reflection    Writes the SPIR-V with its reflection data embedded "
+               "to the given"
+            << std::endl
+            << "                          file, so that SPIRV-Reflect loads it instead of "
+               "parsing the"
+            << std::endl
+            << "                          SPIR-V." << std::endl
+            << "-cd,--cache-dir           Keeps the reflection data of each module in the "
+               "given directory"
+            << std::endl
+            << "                          and loads it from there when the same module is "
+               "reflected again."
+            << std::endl
+            << "-st,--stats               Prints statistics of the module and how it was "
+               "reflected."
             << std::endl;
 }
 
+// =================================================================================================
+// ReadSpirvFile()
+// =================================================================================================
+bool ReadSpirvFile(const std::string& path, std::vector<uint8_t>* p_data) {
+  std::ifstream spv_ifstream(path.c_str(), std::ios::binary);
+  if (!spv_ifstream.is_open()) {
+    std::cerr << "ERROR: could not open '" << path << "' for reading" << std::endl;
+    return false;
+  }
+
+  spv_ifstream.seekg(0, std::ios::end);
+  size_t size = static_cast<size_t>(spv_ifstream.tellg());
+  spv_ifstream.seekg(0, std::ios::beg);
+
+  p_data->resize(size);
+  spv_ifstream.read((char*)p_data->data(), size);
+  return true;
+}
+
+// =================================================================================================
+// PrintDescriptorSetLayouts()
+// =================================================================================================
+int PrintDescriptorSetLayouts(const std::vector<std::string>& input_spv_paths, const char* cache_dir) {
+  if (input_spv_paths.empty()) {
+    std::cerr << "ERROR: no SPIR-V file specified" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::unique_ptr<spv_reflect::ShaderModule>> reflections;
+  std::vector<const SpvReflectShaderModule*> modules;
+  for (const std::string& input_spv_path : input_spv_paths) {
+    std::vector<uint8_t> spv_data;
+    if (!ReadSpirvFile(input_spv_path, &spv_data)) {
+      return EXIT_FAILURE;
+    }
+    reflections.emplace_back(
+        new spv_reflect::ShaderModule(spv_data.size(), spv_data.data(), SPV_REFLECT_MODULE_FLAG_NONE, cache_dir));
+    if (reflections.back()->GetResult() != SPV_REFLECT_RESULT_SUCCESS) {
+      std::cerr << "ERROR: could not process '" << input_spv_path << "' (is it a valid SPIR-V bytecode?)" << std::endl;
+      return EXIT_FAILURE;
+    }
+    modules.push_back(&reflections.back()->GetShaderModule());
+  }
+
+  SpvReflectDescriptorSetLayouts layouts = {};
+  SpvReflectResult result =
+      spvReflectCreateDescriptorSetLayouts(static_cast<uint32_t>(modules.size()), modules.data(), &layouts);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    std::cerr << "ERROR: could not compute descriptor set layouts" << std::endl;
+    return EXIT_FAILURE;
+  }
+  WriteDescriptorSetLayouts(layouts, input_spv_paths, modules, std::cout);
+  spvReflectDestroyDescriptorSetLayouts(&layouts);
+  return EXIT_SUCCESS;
+}
+
+// =================================================================================================
+// PrintModuleDiff()
+// =================================================================================================
+int PrintModuleDiff(const std::vector<std::string>& input_spv_paths, const char* cache_dir) {
+  if (input_spv_paths.size() != 2) {
+    std::cerr << "ERROR: --diff needs an old and a new SPIR-V file" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::unique_ptr<spv_reflect::ShaderModule>> reflections;
+  for (const std::string& input_spv_path : input_spv_paths) {
+    std::vector<uint8_t> spv_data;
+    if (!ReadSpirvFile(input_spv_path, &spv_data)) {
+      return EXIT_FAILURE;
+    }
+    reflections.emplace_back(
+        new spv_reflect::ShaderModule(spv_data.size(), spv_data.data(), SPV_REFLECT_MODULE_FLAG_NONE, cache_dir));
+    if (reflections.back()->GetResult() != SPV_REFLECT_RESULT_SUCCESS) {
+      std::cerr << "ERROR: could not process '" << input_spv_path << "' (is it a valid SPIR-V bytecode?)" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  SpvReflectModuleDiff diff = {};
+  SpvReflectResult result =
+      spvReflectDiffShaderModules(&reflections[0]->GetShaderModule(), &reflections[1]->GetShaderModule(), &diff);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    std::cerr << "ERROR: could not compare the modules" << std::endl;
+    return EXIT_FAILURE;
+  }
+  WriteModuleDiff(diff, std::cout);
+  spvReflectDestroyModuleDiff(&diff);
+  return EXIT_SUCCESS;
+}
+
+// =================================================================================================
+// WriteEmbeddedReflection()
+// =================================================================================================
+int WriteEmbeddedReflection(const std::vector<uint8_t>& spv_data, const std::string& output_spv_path) {
+  size_t embedded_size = 0;
+  SpvReflectResult result = spvReflectEmbedReflection(spv_data.size(), spv_data.data(), &embedded_size, nullptr);
+  std::vector<uint8_t> embedded_data(embedded_size);
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = spvReflectEmbedReflection(spv_data.size(), spv_data.data(), &embedded_size, embedded_data.data());
+  }
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    std::cerr << "ERROR: could not embed reflection data (is it a valid SPIR-V bytecode?)" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream spv_ofstream(output_spv_path.c_str(), std::ios::binary);
+  if (!spv_ofstream.is_open()) {
+    std::cerr << "ERROR: could not open '" << output_spv_path << "' for writing" << std::endl;
+    return EXIT_FAILURE;
+  }
+  spv_ofstream.write((const char*)embedded_data.data(), embedded_data.size());
+  return spv_ofstream.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 // =================================================================================================
 // main()
 // =================================================================================================
@@ -84,11 +239,18 @@ int main(int argn, char** argv) {
   arg_parser.AddFlag("h", "help", "");
   arg_parser.AddOptionString("o", "output", "");
   arg_parser.AddFlag("y", "yaml", "");
+  arg_parser.AddFlag("j", "json", "");
   arg_parser.AddOptionInt("v", "verbosity", "", 0);
   arg_parser.AddFlag("e", "entrypoint", "");
   arg_parser.AddFlag("s", "stage", "");
   arg_parser.AddFlag("f", "file", "");
   arg_parser.AddFlag("fcb", "flatten_cbuffers", "");
+  arg_parser.AddFlag("l", "layouts", "");
+  arg_parser.AddFlag("cpp", "emit-cpp", "");
+  arg_parser.AddFlag("d", "diff", "");
+  arg_parser.AddOptionString("er", "embed-reflection", "");
+  arg_parser.AddOptionString("cd", "cache-dir", "");
+  arg_parser.AddFlag("st", "stats", "");
   arg_parser.AddFlag("ci", "ci", "");  // Not advertised
   if (!arg_parser.Parse(argn, argv, std::cerr)) {
     PrintUsage();
@@ -105,6 +267,7 @@ int main(int argn, char** argv) {
   FILE* output_fp = output_file.empty() ? NULL : freopen(output_file.c_str(), "w", stdout);
 
   bool output_as_yaml = arg_parser.GetFlag("y", "yaml");
+  bool output_as_json = arg_parser.GetFlag("j", "json");
 
   int yaml_verbosity = 0;
   arg_parser.GetInt("v", "verbosity", &yaml_verbosity);
@@ -113,25 +276,37 @@ int main(int argn, char** argv) {
   bool print_shader_stage = arg_parser.GetFlag("s", "stage");
   bool print_source_file = arg_parser.GetFlag("f", "file");
   bool flatten_cbuffers = arg_parser.GetFlag("fcb", "flatten_cbuffers");
+  bool emit_cpp = arg_parser.GetFlag("cpp", "emit-cpp");
+  bool print_stats = arg_parser.GetFlag("st", "stats");
   bool ci_mode = arg_parser.GetFlag("ci", "ci");
 
+  std::string cache_dir_path;
+  const char* cache_dir = arg_parser.GetString("cd", "cache-dir", &cache_dir_path) ? cache_dir_path.c_str() : nullptr;
+
+  if (arg_parser.GetFlag("l", "layouts")) {
+    int exit_code = PrintDescriptorSetLayouts(arg_parser.GetArgs(), cache_dir);
+    if (output_fp) {
+      fclose(output_fp);
+    }
+    return exit_code;
+  }
+
+  if (arg_parser.GetFlag("d", "diff")) {
+    int exit_code = PrintModuleDiff(arg_parser.GetArgs(), cache_dir);
+    if (output_fp) {
+      fclose(output_fp);
+    }
+    return exit_code;
+  }
+
   std::string input_spv_path;
   std::vector<uint8_t> spv_data;
 
   // Get SPIR-V data/input
   if (arg_parser.GetArg(0, &input_spv_path)) {
-    std::ifstream spv_ifstream(input_spv_path.c_str(), std::ios::binary);
-    if (!spv_ifstream.is_open()) {
-      std::cerr << "ERROR: could not open '" << input_spv_path << "' for reading" << std::endl;
+    if (!ReadSpirvFile(input_spv_path, &spv_data)) {
       return EXIT_FAILURE;
     }
-
-    spv_ifstream.seekg(0, std::ios::end);
-    size_t size = static_cast<size_t>(spv_ifstream.tellg());
-    spv_ifstream.seekg(0, std::ios::beg);
-
-    spv_data.resize(size);
-    spv_ifstream.read((char*)spv_data.data(), size);
   } else {
     uint8_t buffer[4096];
     size_t bytes_read = fread(buffer, 1, sizeof(buffer), stdin);
@@ -145,9 +320,14 @@ int main(int argn, char** argv) {
     }
   }
 
+  std::string embedded_spv_path;
+  if (arg_parser.GetString("er", "embed-reflection", &embedded_spv_path)) {
+    return WriteEmbeddedReflection(spv_data, embedded_spv_path);
+  }
+
   // run reflection with input
   {
-    spv_reflect::ShaderModule reflection(spv_data.size(), spv_data.data());
+    spv_reflect::ShaderModule reflection(spv_data.size(), spv_data.data(), SPV_REFLECT_MODULE_FLAG_NONE, cache_dir);
     if (reflection.GetResult() != SPV_REFLECT_RESULT_SUCCESS) {
       std::cerr << "ERROR: could not process '" << input_spv_path << "' (is it a valid SPIR-V bytecode?)" << std::endl;
       return EXIT_FAILURE;
@@ -162,7 +342,18 @@ int main(int argn, char** argv) {
       return EXIT_SUCCESS;
     }
 
-    if (print_entry_point || print_shader_stage || print_source_file) {
+    if (emit_cpp) {
+      // Name the namespace after the file, e.g. "shader.vert.spv" -> "shader_vert".
+      std::string namespace_name = input_spv_path.substr(input_spv_path.find_last_of("/\\") + 1);
+      const std::string extension = ".spv";
+      if ((namespace_name.size() > extension.size()) &&
+          (namespace_name.compare(namespace_name.size() - extension.size(), extension.size(), extension) == 0)) {
+        namespace_name.resize(namespace_name.size() - extension.size());
+      }
+      WriteCppHeader(reflection.GetShaderModule(), namespace_name, input_spv_path, std::cout);
+    } else if (print_stats) {
+      WriteModuleStats(reflection.GetShaderModule(), std::cout);
+    } else if (print_entry_point || print_shader_stage || print_source_file) {
       size_t printed_count = 0;
       if (print_entry_point || print_shader_stage) {
         for (uint32_t i = 0; i < reflection.GetEntryPointCount(); ++i) {
@@ -193,7 +384,10 @@ int main(int argn, char** argv) {
 
       std::cout << std::endl;
     } else {
-      if (output_as_yaml) {
+      if (output_as_json) {
+        SpvReflectToJson jsonizer(reflection.GetShaderModule(), yaml_verbosity);
+        std::cout << jsonizer;
+      } else if (output_as_yaml) {
         SpvReflectToYaml yamlizer(reflection.GetShaderModule(), yaml_verbosity);
         std::cout << yamlizer;
       } else {
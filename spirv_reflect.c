@@ -18,6 +18,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <string.h>
 
 #if defined(WIN32)
@@ -28,6 +29,23 @@
 #include <stdlib.h>
 #endif
 
+// File access for spvReflectCreateShaderModuleCached
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7) || defined(__APPLE_CC__)
 #define FALLTHROUGH __attribute__((fallthrough))
 #else
@@ -57,8 +75,12 @@ enum {
 
 enum {
   MAX_NODE_NAME_LENGTH                 = 1024,
-  // Number of unique PhysicalStorageBuffer structs tracked to detect recursion
-  MAX_RECURSIVE_PHYSICAL_POINTER_CHECK = 128,
+  // Result ids are hashed instead of indexed once the id bound is more than
+  // this many times the instruction count
+  SPARSE_ID_BOUND_RATIO                = 8,
+  // Stage interface variables are expanded to their components up to this
+  // location
+  MAX_INTERFACE_LOCATION               = 4096,
 };
 
 enum {
@@ -142,6 +164,9 @@ typedef struct SpvReflectPrvNode {
   uint32_t                        member_count;
   const char**                    member_names;
   SpvReflectPrvDecorations*       member_decorations;
+  // Set by ParseTypes once the type description of a struct is complete and
+  // can share its members with the other type descriptions of the struct.
+  bool                            members_shareable;
 } SpvReflectPrvNode;
 
 typedef struct SpvReflectPrvString {
@@ -204,6 +229,26 @@ typedef struct SpvReflectPrvPhysicalPointerStruct {
     SpvReflectBlockVariable* p_var;
 } SpvReflectPrvPhysicalPointerStruct;
 
+// First block whose layout was computed for a type in a layout context.
+// Later blocks of that type and context copy its members and sizes.
+typedef struct SpvReflectPrvBlockLayout {
+  const SpvReflectTypeDescription* p_type;
+  bool                             is_parent_rta;
+  const SpvReflectBlockVariable*   p_block;
+} SpvReflectPrvBlockLayout;
+
+// Maps pointers into a previous module's SPIR-V onto the same bytes of new
+// SPIR-V whose debug, annotation and type/global sections are identical, but
+// may start word_delta words later.
+typedef struct SpvReflectPrvRebase {
+  uintptr_t                       old_begin;
+  uintptr_t                       old_end;
+  uintptr_t                       new_begin;
+  uint32_t                        old_annotations_begin;
+  uint32_t                        old_annotations_end;
+  int64_t                         word_delta;
+} SpvReflectPrvRebase;
+
 typedef struct SpvReflectPrvParser {
   size_t                          spirv_word_count;
   uint32_t*                       spirv_code;
@@ -217,8 +262,12 @@ typedef struct SpvReflectPrvParser {
   SpvReflectPrvNode*              nodes;
   // Maps a result id to (node index + 1); 0 means "no node". Sized by the id
   // bound from the SPIR-V header so FindNode() is O(1) instead of O(node_count).
+  // NULL if the id bound is sparse, in which case node_table is an open
+  // addressing table of (node index + 1) by result id, sized by node count.
   uint32_t                        id_bound;
   uint32_t*                       node_index_by_id;
+  uint32_t                        node_table_capacity;
+  uint32_t*                       node_table;
   uint32_t                        entry_point_count;
   uint32_t                        capability_count;
   uint32_t                        function_count;
@@ -231,11 +280,28 @@ typedef struct SpvReflectPrvParser {
   uint32_t                        push_constant_count;
   uint32_t                        spec_constant_count;
 
-  SpvReflectTypeDescription*      physical_pointer_check[MAX_RECURSIVE_PHYSICAL_POINTER_CHECK];
+  // Buffer reference types being parsed, which detects recursion, with an
+  // open addressing table of (index + 1) by type id.
+  SpvReflectTypeDescription**     physical_pointer_check;
   uint32_t                        physical_pointer_count;
+  uint32_t                        physical_pointer_capacity;
+  uint32_t*                       physical_pointer_table;
+  uint32_t                        physical_pointer_table_capacity;
 
   SpvReflectPrvPhysicalPointerStruct* physical_pointer_structs;
   uint32_t                            physical_pointer_struct_count;
+
+  // Layouts of the blocks parsed so far, with an open addressing table of
+  // (index + 1) by type id.
+  SpvReflectPrvBlockLayout*       block_layouts;
+  uint32_t                        block_layout_count;
+  uint32_t*                       block_layout_table;
+  uint32_t                        block_layout_table_capacity;
+
+  // Set by spvReflectUpdateShaderModule when the type descriptions and block
+  // layouts of the previous module are taken over instead of parsed.
+  SpvReflectShaderModule*         p_previous_module;
+  SpvReflectPrvRebase             previous_rebase;
 } SpvReflectPrvParser;
 // clang-format on
 
@@ -308,6 +374,76 @@ static bool SearchSortedUint32(const uint32_t* arr, size_t size, uint32_t target
   return false;
 }
 
+//
+// Hashing helpers for the lookup indices built at module creation. The
+// indices are open addressing tables with linear probing whose slots hold
+// (element index + 1), so 0 marks an empty slot. Elements are inserted in
+// array order and never removed, which means a probe sequence visits equal
+// keys in array order and lookups return the same element a linear scan would.
+//
+static uint32_t HashUint32(uint32_t value) {
+  value ^= value >> 16;
+  value *= 0x7feb352dU;
+  value ^= value >> 15;
+  value *= 0x846ca68bU;
+  value ^= value >> 16;
+  return value;
+}
+
+// FNV-1a
+static uint32_t HashString(const char* str) {
+  uint32_t hash = 0x811c9dc5U;
+  for (; *str != 0; ++str) {
+    hash ^= (uint8_t)(*str);
+    hash *= 0x01000193U;
+  }
+  return hash;
+}
+
+static uint32_t HashStringLength(const char* str, size_t length) {
+  uint32_t hash = 0x811c9dc5U;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= (uint8_t)(str[i]);
+    hash *= 0x01000193U;
+  }
+  return hash;
+}
+
+// Returns a power of two capacity that keeps the load factor at or below 1/2.
+static uint32_t HashTableCapacity(uint32_t count) {
+  if (count == 0) {
+    return 0;
+  }
+  uint32_t capacity = 8;
+  while (capacity < 2 * count) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+static void HashTableInsert(uint32_t* table, uint32_t capacity, uint32_t hash, uint32_t index) {
+  uint32_t mask = capacity - 1;
+  uint32_t slot = hash & mask;
+  while (table[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  table[slot] = index + 1;
+}
+
+// Returns p_array, grown if needed so it can hold count + 1 elements, or NULL
+// if the allocation fails. p_array is left untouched on failure.
+static void* GrowArray(void* p_array, uint32_t* p_capacity, uint32_t count, size_t element_size) {
+  if (count < *p_capacity) {
+    return p_array;
+  }
+  uint32_t capacity = (*p_capacity == 0) ? 4 : 2 * (*p_capacity);
+  void* p_new_array = realloc(p_array, capacity * element_size);
+  if (IsNotNull(p_new_array)) {
+    *p_capacity = capacity;
+  }
+  return p_new_array;
+}
+
 static SpvReflectResult IntersectSortedAccessedVariable(const SpvReflectPrvAccessedVariable* p_arr0, size_t arr0_size,
                                                         const uint32_t* p_arr1, size_t arr1_size, uint32_t** pp_res,
                                                         size_t* res_size) {
@@ -554,8 +690,33 @@ static SpvReflectPrvNode* FindNode(SpvReflectPrvParser* p_parser, uint32_t resul
   if (result_id == 0 || result_id >= p_parser->id_bound) {
     return NULL;
   }
-  uint32_t index_plus_one = p_parser->node_index_by_id[result_id];
-  return index_plus_one ? &(p_parser->nodes[index_plus_one - 1]) : NULL;
+  if (IsNotNull(p_parser->node_index_by_id)) {
+    uint32_t index_plus_one = p_parser->node_index_by_id[result_id];
+    return index_plus_one ? &(p_parser->nodes[index_plus_one - 1]) : NULL;
+  }
+  uint32_t mask = p_parser->node_table_capacity - 1;
+  for (uint32_t slot = HashUint32(result_id) & mask; p_parser->node_table[slot] != 0; slot = (slot + 1) & mask) {
+    SpvReflectPrvNode* p_node = &(p_parser->nodes[p_parser->node_table[slot] - 1]);
+    if (p_node->result_id == result_id) {
+      return p_node;
+    }
+  }
+  return NULL;
+}
+
+// Makes the node at node_index the one FindNode() returns for its result id.
+static void RegisterNode(SpvReflectPrvParser* p_parser, uint32_t node_index) {
+  uint32_t result_id = p_parser->nodes[node_index].result_id;
+  if (IsNotNull(p_parser->node_index_by_id)) {
+    p_parser->node_index_by_id[result_id] = node_index + 1;
+    return;
+  }
+  uint32_t mask = p_parser->node_table_capacity - 1;
+  uint32_t slot = HashUint32(result_id) & mask;
+  while ((p_parser->node_table[slot] != 0) && (p_parser->nodes[p_parser->node_table[slot] - 1].result_id != result_id)) {
+    slot = (slot + 1) & mask;
+  }
+  p_parser->node_table[slot] = node_index + 1;
 }
 
 static SpvReflectTypeDescription* FindType(SpvReflectShaderModule* p_module, uint32_t type_id) {
@@ -700,6 +861,8 @@ static void DestroyParser(SpvReflectPrvParser* p_parser) {
 
     SafeFree(p_parser->nodes);
     SafeFree(p_parser->node_index_by_id);
+    SafeFree(p_parser->node_table);
+    p_parser->node_table_capacity = 0;
     p_parser->id_bound = 0;
     SafeFree(p_parser->strings);
     SafeFree(p_parser->source_embedded);
@@ -709,6 +872,10 @@ static void DestroyParser(SpvReflectPrvParser* p_parser) {
     if (IsNotNull(p_parser->physical_pointer_structs)) {
       SafeFree(p_parser->physical_pointer_structs);
     }
+    SafeFree(p_parser->physical_pointer_check);
+    SafeFree(p_parser->physical_pointer_table);
+    SafeFree(p_parser->block_layouts);
+    SafeFree(p_parser->block_layout_table);
     p_parser->node_count = 0;
   }
 }
@@ -748,14 +915,23 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
   if (IsNull(p_parser->nodes)) {
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
-  // Allocate the result id -> node lookup table. Word 3 of the header is the id bound.
+  // Allocate the result id -> node lookup table. Word 3 of the header is the id bound,
+  // which can be far larger than the ids in use.
   p_parser->id_bound = p_spirv[3];
   if (p_parser->id_bound == 0) {
     return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_ID_REFERENCE;
   }
-  p_parser->node_index_by_id = (uint32_t*)calloc(p_parser->id_bound, sizeof(*(p_parser->node_index_by_id)));
-  if (IsNull(p_parser->node_index_by_id)) {
-    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  if (p_parser->id_bound / SPARSE_ID_BOUND_RATIO > node_count) {
+    p_parser->node_table_capacity = HashTableCapacity(node_count);
+    p_parser->node_table = (uint32_t*)calloc(p_parser->node_table_capacity, sizeof(*(p_parser->node_table)));
+    if (IsNull(p_parser->node_table)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+  } else {
+    p_parser->node_index_by_id = (uint32_t*)calloc(p_parser->id_bound, sizeof(*(p_parser->node_index_by_id)));
+    if (IsNull(p_parser->node_index_by_id)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
   }
   // Mark all nodes with an invalid state
   for (uint32_t i = 0; i < node_count; ++i) {
@@ -1120,7 +1296,7 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
     // OpTypeForwardPointer whose result id is re-assigned to the OpTypePointer
     // above, so overwriting is what we want.
     if (p_node->result_id != 0 && p_node->result_id < p_parser->id_bound) {
-      p_parser->node_index_by_id[p_node->result_id] = node_index + 1;
+      RegisterNode(p_parser, node_index);
     }
 
     if (p_node->is_type) {
@@ -1890,6 +2066,67 @@ static SpvReflectResult EnumerateAllUniforms(SpvReflectShaderModule* p_module, s
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
+static const SpvReflectTypeDescription* FindPhysicalPointer(const SpvReflectPrvParser* p_parser, uint32_t type_id) {
+  if (p_parser->physical_pointer_count == 0) {
+    return NULL;
+  }
+  uint32_t mask = p_parser->physical_pointer_table_capacity - 1;
+  for (uint32_t slot = HashUint32(type_id) & mask; p_parser->physical_pointer_table[slot] != 0; slot = (slot + 1) & mask) {
+    const SpvReflectTypeDescription* p_type = p_parser->physical_pointer_check[p_parser->physical_pointer_table[slot] - 1];
+    if (p_type->id == type_id) {
+      return p_type;
+    }
+  }
+  return NULL;
+}
+
+static SpvReflectResult AddPhysicalPointer(SpvReflectPrvParser* p_parser, SpvReflectTypeDescription* p_type) {
+  uint32_t capacity = p_parser->physical_pointer_capacity;
+  void* p_types = GrowArray(p_parser->physical_pointer_check, &capacity, p_parser->physical_pointer_count,
+                            sizeof(*p_parser->physical_pointer_check));
+  if (IsNull(p_types)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_parser->physical_pointer_check = (SpvReflectTypeDescription**)p_types;
+  if (capacity != p_parser->physical_pointer_capacity) {
+    // Rebuild the table for the grown array
+    uint32_t table_capacity = HashTableCapacity(capacity);
+    uint32_t* table = (uint32_t*)calloc(table_capacity, sizeof(*table));
+    if (IsNull(table)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+    for (uint32_t i = 0; i < p_parser->physical_pointer_count; ++i) {
+      HashTableInsert(table, table_capacity, HashUint32(p_parser->physical_pointer_check[i]->id), i);
+    }
+    SafeFree(p_parser->physical_pointer_table);
+    p_parser->physical_pointer_table = table;
+    p_parser->physical_pointer_table_capacity = table_capacity;
+    p_parser->physical_pointer_capacity = capacity;
+  }
+  p_parser->physical_pointer_check[p_parser->physical_pointer_count] = p_type;
+  HashTableInsert(p_parser->physical_pointer_table, p_parser->physical_pointer_table_capacity, HashUint32(p_type->id),
+                  p_parser->physical_pointer_count);
+  ++p_parser->physical_pointer_count;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static void ClearPhysicalPointers(SpvReflectPrvParser* p_parser) {
+  if (p_parser->physical_pointer_count > 0) {
+    size_t table_size = p_parser->physical_pointer_table_capacity * sizeof(*p_parser->physical_pointer_table);
+    memset(p_parser->physical_pointer_table, 0, table_size);
+    p_parser->physical_pointer_count = 0;
+  }
+}
+
+// The type description of a struct type owns its members. Pointers, arrays
+// and members of the struct parsed after it share them instead of holding a
+// copy of the whole member tree, so a shared array belongs to an earlier
+// type description and type trees stay free of cycles.
+static bool SharesStructMembers(const SpvReflectTypeDescription* p_type) {
+  const SpvReflectTypeDescription* p_struct = p_type->struct_type_description;
+  return IsNotNull(p_struct) && (p_struct != p_type) && IsNotNull(p_type->members) && (p_type->members == p_struct->members);
+}
+
 static SpvReflectResult ParseType(SpvReflectPrvParser* p_parser, SpvReflectPrvNode* p_node,
                                   SpvReflectPrvDecorations* p_struct_member_decorations, SpvReflectShaderModule* p_module,
                                   SpvReflectTypeDescription* p_type) {
@@ -1898,17 +2135,22 @@ static SpvReflectResult ParseType(SpvReflectPrvParser* p_parser, SpvReflectPrvNo
   if (p_node->member_count > 0) {
     p_type->struct_type_description = FindType(p_module, p_node->result_id);
     p_type->member_count = p_node->member_count;
-    p_type->members = (SpvReflectTypeDescription*)calloc(p_type->member_count, sizeof(*(p_type->members)));
-    if (IsNotNull(p_type->members)) {
-      // Mark all members types with an invalid state
-      for (size_t i = 0; i < p_type->members->member_count; ++i) {
-        SpvReflectTypeDescription* p_member_type = &(p_type->members[i]);
-        p_member_type->id = (uint32_t)INVALID_VALUE;
-        p_member_type->op = (SpvOp)INVALID_VALUE;
-        p_member_type->storage_class = INVALID_VALUE;
-      }
+    if (p_node->members_shareable && IsNotNull(p_type->struct_type_description) && (p_type->struct_type_description != p_type)) {
+      // Parsed with the struct type
+      p_type->members = p_type->struct_type_description->members;
     } else {
-      result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+      p_type->members = (SpvReflectTypeDescription*)calloc(p_type->member_count, sizeof(*(p_type->members)));
+      if (IsNotNull(p_type->members)) {
+        // Mark all members types with an invalid state
+        for (size_t i = 0; i < p_type->members->member_count; ++i) {
+          SpvReflectTypeDescription* p_member_type = &(p_type->members[i]);
+          p_member_type->id = (uint32_t)INVALID_VALUE;
+          p_member_type->op = (SpvOp)INVALID_VALUE;
+          p_member_type->storage_class = INVALID_VALUE;
+        }
+      } else {
+        result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+      }
     }
   }
 
@@ -2075,6 +2317,9 @@ static SpvReflectResult ParseType(SpvReflectPrvParser* p_parser, SpvReflectPrvNo
       case SpvOpTypeStruct: {
         p_type->type_flags |= SPV_REFLECT_TYPE_FLAG_STRUCT;
         p_type->type_flags |= SPV_REFLECT_TYPE_FLAG_EXTERNAL_BLOCK;
+        if (SharesStructMembers(p_type)) {
+          break;
+        }
         uint32_t word_index = 2;
         uint32_t member_index = 0;
         for (; word_index < p_node->word_count; ++word_index, ++member_index) {
@@ -2120,34 +2365,28 @@ static SpvReflectResult ParseType(SpvReflectPrvParser* p_parser, SpvReflectPrvNo
           break;
         }
 
-        bool found_recursion = false;
         if (p_type->storage_class == SpvStorageClassPhysicalStorageBuffer) {
           // Need to make sure we haven't started an infinite recursive loop
-          for (uint32_t i = 0; i < p_parser->physical_pointer_count; i++) {
-            if (p_type->id == p_parser->physical_pointer_check[i]->id) {
-              found_recursion = true;
-              memcpy(p_type, p_parser->physical_pointer_check[i], sizeof(SpvReflectTypeDescription));
-              p_type->copied = 1;
-              return SPV_REFLECT_RESULT_SUCCESS;
-            }
+          const SpvReflectTypeDescription* p_parsed = FindPhysicalPointer(p_parser, p_type->id);
+          if (IsNotNull(p_parsed)) {
+            memcpy(p_type, p_parsed, sizeof(SpvReflectTypeDescription));
+            p_type->copied = 1;
+            return SPV_REFLECT_RESULT_SUCCESS;
           }
-          if (!found_recursion && p_next_node->op == SpvOpTypeStruct) {
+          if (p_next_node->op == SpvOpTypeStruct) {
             p_parser->physical_pointer_struct_count++;
-            p_parser->physical_pointer_check[p_parser->physical_pointer_count] = p_type;
-            p_parser->physical_pointer_count++;
-            if (p_parser->physical_pointer_count >= MAX_RECURSIVE_PHYSICAL_POINTER_CHECK) {
-              return SPV_REFLECT_RESULT_ERROR_SPIRV_MAX_RECURSIVE_EXCEEDED;
+            result = AddPhysicalPointer(p_parser, p_type);
+            if (result != SPV_REFLECT_RESULT_SUCCESS) {
+              break;
             }
           }
         }
 
-        if (!found_recursion) {
-          if (p_next_node->op == SpvOpTypeStruct) {
-            p_type->struct_type_description = FindType(p_module, p_next_node->result_id);
-          }
-
-          result = ParseType(p_parser, p_next_node, NULL, p_module, p_type);
+        if (p_next_node->op == SpvOpTypeStruct) {
+          p_type->struct_type_description = FindType(p_module, p_next_node->result_id);
         }
+
+        result = ParseType(p_parser, p_next_node, NULL, p_module, p_type);
       } break;
 
       case SpvOpTypeAccelerationStructureKHR: {
@@ -2200,11 +2439,16 @@ static SpvReflectResult ParseTypes(SpvReflectPrvParser* p_parser, SpvReflectShad
     }
 
     SpvReflectTypeDescription* p_type = &(p_module->_internal->type_descriptions[type_index]);
-    p_parser->physical_pointer_count = 0;
+    ClearPhysicalPointers(p_parser);
+    uint32_t physical_pointer_struct_count = p_parser->physical_pointer_struct_count;
     SpvReflectResult result = ParseType(p_parser, p_node, NULL, p_module, p_type);
     if (result != SPV_REFLECT_RESULT_SUCCESS) {
       return result;
     }
+    // Members that reach buffer reference structs depend on the pointers
+    // being parsed above them, and are counted for each copy
+    p_node->members_shareable = (p_node->op == SpvOpTypeStruct) &&
+                                (p_parser->physical_pointer_struct_count == physical_pointer_struct_count);
     ++type_index;
   }
 
@@ -2219,6 +2463,46 @@ static SpvReflectResult ParseTypes(SpvReflectPrvParser* p_parser, SpvReflectShad
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
+static const char* RebaseString(const SpvReflectPrvRebase* p_rebase, const char* str) {
+  uintptr_t address = (uintptr_t)str;
+  if (IsNull(str) || (address < p_rebase->old_begin) || (address >= p_rebase->old_end)) {
+    return str;
+  }
+  return (const char*)(p_rebase->new_begin + (address - p_rebase->old_begin) + (uintptr_t)(p_rebase->word_delta * SPIRV_WORD_SIZE));
+}
+
+static void RebaseTypeDescription(const SpvReflectPrvRebase* p_rebase, SpvReflectTypeDescription* p_type) {
+  p_type->type_name = RebaseString(p_rebase, p_type->type_name);
+  p_type->struct_member_name = RebaseString(p_rebase, p_type->struct_member_name);
+  // Copies share their members with the type they were copied from, and
+  // shared members are rebased with their struct type.
+  if (p_type->copied || SharesStructMembers(p_type)) {
+    return;
+  }
+  for (uint32_t i = 0; (i < p_type->member_count) && IsNotNull(p_type->members); ++i) {
+    RebaseTypeDescription(p_rebase, &p_type->members[i]);
+  }
+}
+
+// Takes over the previous module's type descriptions, which ParseTypes would
+// rebuild identically from the same type and global section.
+static SpvReflectResult AdoptPreviousTypes(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
+  SpvReflectShaderModule* p_previous = p_parser->p_previous_module;
+  if (p_previous->_internal->type_description_count != p_parser->type_count) {
+    p_parser->p_previous_module = NULL;
+    return ParseTypes(p_parser, p_module);
+  }
+
+  p_module->_internal->type_description_count = p_previous->_internal->type_description_count;
+  p_module->_internal->type_descriptions = p_previous->_internal->type_descriptions;
+  p_previous->_internal->type_description_count = 0;
+  p_previous->_internal->type_descriptions = NULL;
+  for (size_t i = 0; i < p_module->_internal->type_description_count; ++i) {
+    RebaseTypeDescription(&p_parser->previous_rebase, &p_module->_internal->type_descriptions[i]);
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
 static SpvReflectResult ParseCapabilities(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
   if (p_parser->capability_count == 0) {
     return SPV_REFLECT_RESULT_SUCCESS;
@@ -2427,6 +2711,111 @@ static SpvReflectResult ParseDescriptorBindings(SpvReflectPrvParser* p_parser, S
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
+static uint32_t HashDescriptorBindingNumber(uint32_t binding_number, uint32_t set_number) {
+  return HashUint32(binding_number ^ HashUint32(set_number));
+}
+
+// (Re)builds the (set, binding) index; needed whenever binding or set numbers change.
+static void IndexDescriptorBindingNumbers(SpvReflectShaderModule* p_module) {
+  uint32_t capacity = p_module->_internal->descriptor_binding_index_capacity;
+  uint32_t* table = p_module->_internal->descriptor_binding_index_by_number;
+  if (capacity == 0) {
+    return;
+  }
+  memset(table, 0, capacity * sizeof(*table));
+  for (uint32_t i = 0; i < p_module->descriptor_binding_count; ++i) {
+    const SpvReflectDescriptorBinding* p_descriptor = &p_module->descriptor_bindings[i];
+    HashTableInsert(table, capacity, HashDescriptorBindingNumber(p_descriptor->binding, p_descriptor->set), i);
+  }
+}
+
+static SpvReflectResult ParseDescriptorBindingIndex(SpvReflectShaderModule* p_module) {
+  uint32_t capacity = HashTableCapacity(p_module->descriptor_binding_count);
+  if (capacity == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+
+  p_module->_internal->descriptor_binding_index_by_number = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+  p_module->_internal->descriptor_binding_index_by_id = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+  p_module->_internal->descriptor_binding_index_by_name = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+  if (IsNull(p_module->_internal->descriptor_binding_index_by_number) || IsNull(p_module->_internal->descriptor_binding_index_by_id) ||
+      IsNull(p_module->_internal->descriptor_binding_index_by_name)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_module->_internal->descriptor_binding_index_capacity = capacity;
+
+  IndexDescriptorBindingNumbers(p_module);
+  for (uint32_t i = 0; i < p_module->descriptor_binding_count; ++i) {
+    const SpvReflectDescriptorBinding* p_descriptor = &p_module->descriptor_bindings[i];
+    HashTableInsert(p_module->_internal->descriptor_binding_index_by_id, capacity, HashUint32(p_descriptor->spirv_id), i);
+    if (IsNotNull(p_descriptor->name)) {
+      HashTableInsert(p_module->_internal->descriptor_binding_index_by_name, capacity, HashString(p_descriptor->name), i);
+    }
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+// Returns the first binding with the given numbers, optionally restricted to
+// the bindings statically used by p_entry.
+static SpvReflectDescriptorBinding* FindDescriptorBindingByNumber(const SpvReflectShaderModule* p_module, uint32_t binding_number,
+                                                                  uint32_t set_number, const SpvReflectEntryPoint* p_entry) {
+  uint32_t capacity = p_module->_internal->descriptor_binding_index_capacity;
+  if (capacity == 0) {
+    return NULL;
+  }
+  const uint32_t* table = p_module->_internal->descriptor_binding_index_by_number;
+  uint32_t mask = capacity - 1;
+  for (uint32_t slot = HashDescriptorBindingNumber(binding_number, set_number) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+    SpvReflectDescriptorBinding* p_descriptor = &p_module->descriptor_bindings[table[slot] - 1];
+    if ((p_descriptor->binding != binding_number) || (p_descriptor->set != set_number)) {
+      continue;
+    }
+    if (IsNull(p_entry) || SearchSortedUint32(p_entry->used_uniforms, p_entry->used_uniform_count, p_descriptor->spirv_id)) {
+      return p_descriptor;
+    }
+  }
+  return NULL;
+}
+
+static SpvReflectDescriptorBinding* FindDescriptorBindingById(const SpvReflectShaderModule* p_module, uint32_t spirv_id) {
+  uint32_t capacity = p_module->_internal->descriptor_binding_index_capacity;
+  if (capacity == 0) {
+    return NULL;
+  }
+  const uint32_t* table = p_module->_internal->descriptor_binding_index_by_id;
+  uint32_t mask = capacity - 1;
+  for (uint32_t slot = HashUint32(spirv_id) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+    SpvReflectDescriptorBinding* p_descriptor = &p_module->descriptor_bindings[table[slot] - 1];
+    if (p_descriptor->spirv_id == spirv_id) {
+      return p_descriptor;
+    }
+  }
+  return NULL;
+}
+
+// Returns the first binding with the given name, optionally restricted to a
+// descriptor type; pass INVALID_VALUE to match any type.
+static SpvReflectDescriptorBinding* FindDescriptorBindingByName(const SpvReflectShaderModule* p_module, const char* name,
+                                                                SpvReflectDescriptorType descriptor_type) {
+  uint32_t capacity = p_module->_internal->descriptor_binding_index_capacity;
+  if (capacity == 0) {
+    return NULL;
+  }
+  const uint32_t* table = p_module->_internal->descriptor_binding_index_by_name;
+  uint32_t mask = capacity - 1;
+  for (uint32_t slot = HashString(name) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+    SpvReflectDescriptorBinding* p_descriptor = &p_module->descriptor_bindings[table[slot] - 1];
+    if (((int)descriptor_type != (int)INVALID_VALUE) && (p_descriptor->descriptor_type != descriptor_type)) {
+      continue;
+    }
+    if (strcmp(p_descriptor->name, name) == 0) {
+      return p_descriptor;
+    }
+  }
+  return NULL;
+}
+
 static SpvReflectResult ParseDescriptorType(SpvReflectShaderModule* p_module) {
   if (p_module->descriptor_binding_count == 0) {
     return SPV_REFLECT_RESULT_SUCCESS;
@@ -2568,16 +2957,10 @@ static SpvReflectResult ParseUAVCounterBindings(SpvReflectShaderModule* p_module
     SpvReflectDescriptorBinding* p_counter_descriptor = NULL;
     // Use UAV counter buffer id if present...
     if (p_descriptor->uav_counter_id != UINT32_MAX) {
-      for (uint32_t counter_descriptor_index = 0; counter_descriptor_index < p_module->descriptor_binding_count;
-           ++counter_descriptor_index) {
-        SpvReflectDescriptorBinding* p_test_counter_descriptor = &(p_module->descriptor_bindings[counter_descriptor_index]);
-        if (p_test_counter_descriptor->descriptor_type != SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
-          continue;
-        }
-        if (p_descriptor->uav_counter_id == p_test_counter_descriptor->spirv_id) {
-          p_counter_descriptor = p_test_counter_descriptor;
-          break;
-        }
+      SpvReflectDescriptorBinding* p_test_counter_descriptor = FindDescriptorBindingById(p_module, p_descriptor->uav_counter_id);
+      if (IsNotNull(p_test_counter_descriptor) &&
+          p_test_counter_descriptor->descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+        p_counter_descriptor = p_test_counter_descriptor;
       }
     }
     // ...otherwise use old @count convention.
@@ -2610,17 +2993,7 @@ static SpvReflectResult ParseUAVCounterBindings(SpvReflectShaderModule* p_module
       strcat(name, k_count_tag);
 #endif
 
-      for (uint32_t counter_descriptor_index = 0; counter_descriptor_index < p_module->descriptor_binding_count;
-           ++counter_descriptor_index) {
-        SpvReflectDescriptorBinding* p_test_counter_descriptor = &(p_module->descriptor_bindings[counter_descriptor_index]);
-        if (p_test_counter_descriptor->descriptor_type != SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
-          continue;
-        }
-        if (p_test_counter_descriptor->name && strcmp(name, p_test_counter_descriptor->name) == 0) {
-          p_counter_descriptor = p_test_counter_descriptor;
-          break;
-        }
-      }
+      p_counter_descriptor = FindDescriptorBindingByName(p_module, name, SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER);
 
       if (allocated) {
         free(name);
@@ -2694,13 +3067,9 @@ static SpvReflectResult ParseDescriptorBlockVariable(SpvReflectPrvParser* p_pars
           }
         }
 
-        // Need to make sure we haven't started an infinite recursive loop
-        for (uint32_t i = 0; i < p_parser->physical_pointer_count; i++) {
-          if (p_member_type->id == p_parser->physical_pointer_check[i]->id) {
-            found_recursion = true;
-            break;  // still need to fill in p_member_type values
-          }
-        }
+        // Need to make sure we haven't started an infinite recursive loop,
+        // but still fill in p_member_type values
+        found_recursion = IsNotNull(FindPhysicalPointer(p_parser, p_member_type->id));
         if (!found_recursion) {
           SpvReflectTypeDescription* struct_type = FindType(p_module, p_member_type->id);
           // could be pointer directly to non-struct type here
@@ -2710,10 +3079,9 @@ static SpvReflectResult ParseDescriptorBlockVariable(SpvReflectPrvParser* p_pars
             p_parser->physical_pointer_structs[p_parser->physical_pointer_struct_count].p_var = p_member_var;
             p_parser->physical_pointer_struct_count++;
 
-            p_parser->physical_pointer_check[p_parser->physical_pointer_count] = p_member_type;
-            p_parser->physical_pointer_count++;
-            if (p_parser->physical_pointer_count >= MAX_RECURSIVE_PHYSICAL_POINTER_CHECK) {
-              return SPV_REFLECT_RESULT_ERROR_SPIRV_MAX_RECURSIVE_EXCEEDED;
+            SpvReflectResult result = AddPhysicalPointer(p_parser, p_member_type);
+            if (result != SPV_REFLECT_RESULT_SUCCESS) {
+              return result;
             }
           }
         }
@@ -3117,70 +3485,354 @@ static SpvReflectResult ParseDescriptorBlockVariableUsage(SpvReflectPrvParser* p
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-static SpvReflectResult ParseDescriptorBlocks(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
-  if (p_module->descriptor_binding_count == 0) {
-    return SPV_REFLECT_RESULT_SUCCESS;
+static void RebaseBlockVariableMembers(const SpvReflectPrvRebase* p_rebase, SpvReflectBlockVariable* p_var) {
+  for (uint32_t i = 0; i < p_var->member_count; ++i) {
+    SpvReflectBlockVariable* p_member_var = &p_var->members[i];
+    p_member_var->name = RebaseString(p_rebase, p_member_var->name);
+    uint32_t word_offset = p_member_var->word_offset.offset;
+    if ((word_offset >= p_rebase->old_annotations_begin) && (word_offset < p_rebase->old_annotations_end)) {
+      p_member_var->word_offset.offset = (uint32_t)(word_offset + p_rebase->word_delta);
+    }
+    // Usage is analyzed again from the new function bodies.
+    p_member_var->flags |= SPV_REFLECT_VARIABLE_FLAGS_UNUSED;
+    RebaseBlockVariableMembers(p_rebase, p_member_var);
   }
+}
 
-  p_parser->physical_pointer_struct_count = 0;
-
-  for (uint32_t descriptor_index = 0; descriptor_index < p_module->descriptor_binding_count; ++descriptor_index) {
-    SpvReflectDescriptorBinding* p_descriptor = &(p_module->descriptor_bindings[descriptor_index]);
-    SpvReflectTypeDescription* p_type = p_descriptor->type_description;
-    if ((p_descriptor->descriptor_type != SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER) &&
-        (p_descriptor->descriptor_type != SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER)) {
-      continue;
+// Same result as ParseDescriptorBlockVariable, with the member tree moved
+// out of p_previous.
+static void AdoptBlockVariable(const SpvReflectPrvRebase* p_rebase, SpvReflectTypeDescription* p_type,
+                               SpvReflectBlockVariable* p_previous, SpvReflectBlockVariable* p_var) {
+  p_var->member_count = p_previous->member_count;
+  p_var->members = p_previous->members;
+  p_previous->member_count = 0;
+  p_previous->members = NULL;
+  RebaseBlockVariableMembers(p_rebase, p_var);
+  for (uint32_t i = 0; i < p_var->member_count; ++i) {
+    if (p_var->members[i].decoration_flags & SPV_REFLECT_DECORATION_NON_WRITABLE) {
+      p_var->decoration_flags |= SPV_REFLECT_DECORATION_NON_WRITABLE;
+      break;
     }
+  }
+  p_var->name = p_type->type_name;
+  p_var->type_description = p_type;
+}
 
-    // Mark UNUSED
-    p_descriptor->block.flags |= SPV_REFLECT_VARIABLE_FLAGS_UNUSED;
-    p_parser->physical_pointer_count = 0;
-    // Parse descriptor block
-    SpvReflectResult result = ParseDescriptorBlockVariable(p_parser, p_module, p_type, &p_descriptor->block);
-    if (result != SPV_REFLECT_RESULT_SUCCESS) {
-      return result;
+// Forgets the block layouts and makes room for block_count of them.
+static SpvReflectResult ResetBlockLayouts(SpvReflectPrvParser* p_parser, uint32_t block_count) {
+  SafeFree(p_parser->block_layouts);
+  SafeFree(p_parser->block_layout_table);
+  p_parser->block_layout_count = 0;
+  p_parser->block_layout_table_capacity = 0;
+  p_parser->block_layouts = (SpvReflectPrvBlockLayout*)calloc(block_count, sizeof(*p_parser->block_layouts));
+  p_parser->block_layout_table = (uint32_t*)calloc(HashTableCapacity(block_count), sizeof(*p_parser->block_layout_table));
+  if (IsNull(p_parser->block_layouts) || IsNull(p_parser->block_layout_table)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_parser->block_layout_table_capacity = HashTableCapacity(block_count);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static const SpvReflectBlockVariable* FindBlockLayout(const SpvReflectPrvParser* p_parser, const SpvReflectTypeDescription* p_type,
+                                                      bool is_parent_rta) {
+  if (p_parser->block_layout_count == 0) {
+    return NULL;
+  }
+  uint32_t mask = p_parser->block_layout_table_capacity - 1;
+  for (uint32_t slot = HashUint32(p_type->id) & mask; p_parser->block_layout_table[slot] != 0; slot = (slot + 1) & mask) {
+    const SpvReflectPrvBlockLayout* p_layout = &p_parser->block_layouts[p_parser->block_layout_table[slot] - 1];
+    if ((p_layout->p_type == p_type) && (p_layout->is_parent_rta == is_parent_rta)) {
+      return p_layout->p_block;
     }
+  }
+  return NULL;
+}
 
-    for (uint32_t access_chain_index = 0; access_chain_index < p_parser->access_chain_count; ++access_chain_index) {
-      SpvReflectPrvAccessChain* p_access_chain = &(p_parser->access_chains[access_chain_index]);
-      // Skip any access chains that aren't touching this descriptor block
-      if (p_descriptor->spirv_id != p_access_chain->base_id) {
-        continue;
-      }
-      result = ParseDescriptorBlockVariableUsage(p_parser, p_module, p_access_chain, 0, (SpvOp)INVALID_VALUE, &p_descriptor->block);
+static void AddBlockLayout(SpvReflectPrvParser* p_parser, const SpvReflectTypeDescription* p_type, bool is_parent_rta,
+                           const SpvReflectBlockVariable* p_block) {
+  SpvReflectPrvBlockLayout* p_layout = &p_parser->block_layouts[p_parser->block_layout_count];
+  p_layout->p_type = p_type;
+  p_layout->is_parent_rta = is_parent_rta;
+  p_layout->p_block = p_block;
+  HashTableInsert(p_parser->block_layout_table, p_parser->block_layout_table_capacity, HashUint32(p_type->id),
+                  p_parser->block_layout_count);
+  ++p_parser->block_layout_count;
+}
+
+static SpvReflectResult CopyBlockVariableMembers(const SpvReflectBlockVariable* p_source, SpvReflectBlockVariable* p_var) {
+  p_var->members = (SpvReflectBlockVariable*)calloc(p_source->member_count, sizeof(*p_var->members));
+  if (IsNull(p_var->members)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_var->member_count = p_source->member_count;
+  for (uint32_t i = 0; i < p_var->member_count; ++i) {
+    SpvReflectBlockVariable* p_member_var = &p_var->members[i];
+    *p_member_var = p_source->members[i];
+    // Usage is analyzed for each block.
+    p_member_var->flags |= SPV_REFLECT_VARIABLE_FLAGS_UNUSED;
+    p_member_var->member_count = 0;
+    p_member_var->members = NULL;
+    if (p_source->members[i].member_count > 0) {
+      SpvReflectResult result = CopyBlockVariableMembers(&p_source->members[i], p_member_var);
       if (result != SPV_REFLECT_RESULT_SUCCESS) {
         return result;
       }
     }
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
 
-    p_descriptor->block.name = p_descriptor->name;
+// Same result as ParseDescriptorBlockVariable followed by
+// ParseDescriptorBlockVariableSizes, copied from p_layout, a block of the same
+// type whose sizes were computed in the same context.
+static SpvReflectResult CopyBlockLayout(const SpvReflectBlockVariable* p_layout, SpvReflectTypeDescription* p_type,
+                                        SpvReflectBlockVariable* p_var) {
+  SpvReflectResult result = CopyBlockVariableMembers(p_layout, p_var);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    return result;
+  }
+  p_var->decoration_flags |= (p_layout->decoration_flags & SPV_REFLECT_DECORATION_NON_WRITABLE);
+  p_var->name = p_type->type_name;
+  p_var->type_description = p_type;
+  p_var->size = p_layout->size;
+  p_var->padded_size = p_layout->padded_size;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
 
-    bool is_parent_rta = (p_descriptor->descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER);
-    result = ParseDescriptorBlockVariableSizes(p_parser, p_module, true, false, is_parent_rta, &p_descriptor->block);
-    if (result != SPV_REFLECT_RESULT_SUCCESS) {
-      return result;
-    }
+static void SafeFreeBlockVariables(SpvReflectBlockVariable* p_block) {
+  if (IsNull(p_block)) {
+    return;
+  }
 
-    if (is_parent_rta) {
-      p_descriptor->block.size = 0;
-      p_descriptor->block.padded_size = 0;
+  // We share pointers to Physical Pointer structs and don't want to double free
+  if (p_block->flags & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY) {
+    return;
+  }
+
+  if (IsNotNull(p_block->members)) {
+    for (size_t i = 0; i < p_block->member_count; ++i) {
+      SpvReflectBlockVariable* p_member = &p_block->members[i];
+      SafeFreeBlockVariables(p_member);
     }
+
+    SafeFree(p_block->members);
+    p_block->members = NULL;
   }
+}
 
-  return SPV_REFLECT_RESULT_SUCCESS;
+static bool OwnsBlockMembers(const SpvReflectShaderModule* p_module, uint32_t descriptor_index) {
+  const uint32_t* p_owners = p_module->_internal->descriptor_binding_block_owners;
+  return IsNull(p_owners) || (p_owners[descriptor_index] == descriptor_index);
 }
 
-static SpvReflectResult ParseFormat(const SpvReflectTypeDescription* p_type, SpvReflectFormat* p_format) {
-  SpvReflectResult result = SPV_REFLECT_RESULT_ERROR_INTERNAL_ERROR;
-  bool signedness = (p_type->traits.numeric.scalar.signedness != 0);
-  uint32_t bit_width = p_type->traits.numeric.scalar.width;
-  if (p_type->type_flags & SPV_REFLECT_TYPE_FLAG_VECTOR) {
-    uint32_t component_count = p_type->traits.numeric.vector.component_count;
-    if (p_type->type_flags & SPV_REFLECT_TYPE_FLAG_FLOAT) {
-      switch (bit_width) {
-        case 16: {
-          switch (component_count) {
-            case 2:
+// Returns true if the count block variables at p_a and p_b are the same,
+// down to their members. Buffer reference copies are never the same, since
+// their members belong to another block variable.
+static bool BlockVariablesEqual(const SpvReflectBlockVariable* p_a, const SpvReflectBlockVariable* p_b, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    const SpvReflectBlockVariable* p_var_a = &p_a[i];
+    const SpvReflectBlockVariable* p_var_b = &p_b[i];
+    if (((p_var_a->flags | p_var_b->flags) & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY) ||
+        (p_var_a->spirv_id != p_var_b->spirv_id) || (p_var_a->name != p_var_b->name) || (p_var_a->offset != p_var_b->offset) ||
+        (p_var_a->absolute_offset != p_var_b->absolute_offset) || (p_var_a->size != p_var_b->size) ||
+        (p_var_a->padded_size != p_var_b->padded_size) || (p_var_a->decoration_flags != p_var_b->decoration_flags) ||
+        (memcmp(&p_var_a->numeric, &p_var_b->numeric, sizeof(p_var_a->numeric)) != 0) ||
+        (memcmp(&p_var_a->array, &p_var_b->array, sizeof(p_var_a->array)) != 0) || (p_var_a->flags != p_var_b->flags) ||
+        (p_var_a->member_count != p_var_b->member_count) || (p_var_a->type_description != p_var_b->type_description) ||
+        (p_var_a->word_offset.offset != p_var_b->word_offset.offset)) {
+      return false;
+    }
+    if (!BlockVariablesEqual(p_var_a->members, p_var_b->members, p_var_a->member_count)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint32_t BlockStructId(const SpvReflectBlockVariable* p_block) {
+  const SpvReflectTypeDescription* p_type = p_block->type_description;
+  if (IsNull(p_block->members) || IsNull(p_type)) {
+    return (uint32_t)INVALID_VALUE;
+  }
+  if (IsNotNull(p_type->struct_type_description)) {
+    return p_type->struct_type_description->id;
+  }
+  return (p_type->op == SpvOpTypeStruct) ? p_type->id : (uint32_t)INVALID_VALUE;
+}
+
+// Lets the blocks of descriptor bindings share one members array if they are
+// the same, such as those of many storage buffers of one struct type. Only
+// blocks of the same struct type id are compared. Fills in
+// descriptor_binding_block_owners.
+static SpvReflectResult InternDescriptorBlocks(SpvReflectShaderModule* p_module) {
+  uint32_t binding_count = p_module->descriptor_binding_count;
+  uint32_t capacity = HashTableCapacity(binding_count);
+  uint32_t* p_owners = (uint32_t*)calloc(binding_count, sizeof(*p_owners));
+  uint32_t* table = (uint32_t*)calloc(capacity, sizeof(*table));
+  if (IsNull(p_owners) || IsNull(table)) {
+    SafeFree(p_owners);
+    SafeFree(table);
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_module->_internal->descriptor_binding_block_owners = p_owners;
+
+  uint32_t mask = capacity - 1;
+  for (uint32_t i = 0; i < binding_count; ++i) {
+    p_owners[i] = i;
+    SpvReflectBlockVariable* p_block = &p_module->descriptor_bindings[i].block;
+    uint32_t struct_id = BlockStructId(p_block);
+    if (struct_id == (uint32_t)INVALID_VALUE) {
+      continue;
+    }
+    uint32_t slot = HashUint32(struct_id) & mask;
+    for (; table[slot] != 0; slot = (slot + 1) & mask) {
+      const SpvReflectBlockVariable* p_owner = &p_module->descriptor_bindings[table[slot] - 1].block;
+      if ((BlockStructId(p_owner) == struct_id) && (p_owner->member_count == p_block->member_count) &&
+          BlockVariablesEqual(p_owner->members, p_block->members, p_block->member_count)) {
+        break;
+      }
+    }
+    if (table[slot] == 0) {
+      table[slot] = i + 1;
+      continue;
+    }
+    SafeFreeBlockVariables(p_block);
+    p_block->members = p_module->descriptor_bindings[table[slot] - 1].block.members;
+    p_owners[i] = table[slot] - 1;
+  }
+
+  SafeFree(table);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+// Finds the descriptor bindings whose blocks own the members of each block,
+// which is the first binding with the same members.
+static SpvReflectResult FindDescriptorBlockOwners(const SpvReflectShaderModule* p_module, uint32_t* p_owners) {
+  uint32_t binding_count = p_module->descriptor_binding_count;
+  uint32_t capacity = HashTableCapacity(binding_count);
+  uint32_t* table = (uint32_t*)calloc(Max(capacity, 1), sizeof(*table));
+  if (IsNull(table)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+
+  uint32_t mask = capacity - 1;
+  for (uint32_t i = 0; i < binding_count; ++i) {
+    p_owners[i] = i;
+    const SpvReflectBlockVariable* p_members = p_module->descriptor_bindings[i].block.members;
+    if (IsNull(p_members)) {
+      continue;
+    }
+    uint64_t address = (uint64_t)(uintptr_t)p_members;
+    uint32_t slot = HashUint32((uint32_t)(address ^ (address >> 32))) & mask;
+    while ((table[slot] != 0) && (p_module->descriptor_bindings[table[slot] - 1].block.members != p_members)) {
+      slot = (slot + 1) & mask;
+    }
+    if (table[slot] == 0) {
+      table[slot] = i + 1;
+    } else {
+      p_owners[i] = table[slot] - 1;
+    }
+  }
+
+  SafeFree(table);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult ParseDescriptorBlocks(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
+  if (p_module->descriptor_binding_count == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+
+  p_parser->physical_pointer_struct_count = 0;
+  SpvReflectResult result = ResetBlockLayouts(p_parser, p_module->descriptor_binding_count);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    return result;
+  }
+
+  for (uint32_t descriptor_index = 0; descriptor_index < p_module->descriptor_binding_count; ++descriptor_index) {
+    SpvReflectDescriptorBinding* p_descriptor = &(p_module->descriptor_bindings[descriptor_index]);
+    SpvReflectTypeDescription* p_type = p_descriptor->type_description;
+    if ((p_descriptor->descriptor_type != SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER) &&
+        (p_descriptor->descriptor_type != SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER)) {
+      continue;
+    }
+
+    // Mark UNUSED
+    p_descriptor->block.flags |= SPV_REFLECT_VARIABLE_FLAGS_UNUSED;
+    ClearPhysicalPointers(p_parser);
+    // Parse descriptor block, or take over the identical one parsed for the
+    // previous module
+    SpvReflectDescriptorBinding* p_previous = NULL;
+    if (IsNotNull(p_parser->p_previous_module) && (descriptor_index < p_parser->p_previous_module->descriptor_binding_count)) {
+      p_previous = &p_parser->p_previous_module->descriptor_bindings[descriptor_index];
+      if ((p_previous->spirv_id != p_descriptor->spirv_id) || (p_previous->block.type_description != p_type) ||
+          !OwnsBlockMembers(p_parser->p_previous_module, descriptor_index)) {
+        p_previous = NULL;
+      }
+    }
+    bool is_parent_rta = (p_descriptor->descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    const SpvReflectBlockVariable* p_layout = NULL;
+    uint32_t physical_pointer_struct_count = p_parser->physical_pointer_struct_count;
+    if (IsNotNull(p_previous)) {
+      AdoptBlockVariable(&p_parser->previous_rebase, p_type, &p_previous->block, &p_descriptor->block);
+    } else {
+      p_layout = FindBlockLayout(p_parser, p_type, is_parent_rta);
+      if (IsNotNull(p_layout)) {
+        result = CopyBlockLayout(p_layout, p_type, &p_descriptor->block);
+      } else {
+        result = ParseDescriptorBlockVariable(p_parser, p_module, p_type, &p_descriptor->block);
+      }
+    }
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      return result;
+    }
+
+    for (uint32_t access_chain_index = 0; access_chain_index < p_parser->access_chain_count; ++access_chain_index) {
+      SpvReflectPrvAccessChain* p_access_chain = &(p_parser->access_chains[access_chain_index]);
+      // Skip any access chains that aren't touching this descriptor block
+      if (p_descriptor->spirv_id != p_access_chain->base_id) {
+        continue;
+      }
+      result = ParseDescriptorBlockVariableUsage(p_parser, p_module, p_access_chain, 0, (SpvOp)INVALID_VALUE, &p_descriptor->block);
+      if (result != SPV_REFLECT_RESULT_SUCCESS) {
+        return result;
+      }
+    }
+
+    p_descriptor->block.name = p_descriptor->name;
+
+    if (IsNotNull(p_layout)) {
+      continue;
+    }
+    result = ParseDescriptorBlockVariableSizes(p_parser, p_module, true, false, is_parent_rta, &p_descriptor->block);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      return result;
+    }
+
+    if (is_parent_rta) {
+      p_descriptor->block.size = 0;
+      p_descriptor->block.padded_size = 0;
+    }
+    // Blocks that reach buffer reference structs keep their own layout
+    if ((p_descriptor->block.member_count > 0) && (p_parser->physical_pointer_struct_count == physical_pointer_struct_count)) {
+      AddBlockLayout(p_parser, p_type, is_parent_rta, &p_descriptor->block);
+    }
+  }
+
+  return InternDescriptorBlocks(p_module);
+}
+
+static SpvReflectResult ParseFormat(const SpvReflectTypeDescription* p_type, SpvReflectFormat* p_format) {
+  SpvReflectResult result = SPV_REFLECT_RESULT_ERROR_INTERNAL_ERROR;
+  bool signedness = (p_type->traits.numeric.scalar.signedness != 0);
+  uint32_t bit_width = p_type->traits.numeric.scalar.width;
+  if (p_type->type_flags & SPV_REFLECT_TYPE_FLAG_VECTOR) {
+    uint32_t component_count = p_type->traits.numeric.vector.component_count;
+    if (p_type->type_flags & SPV_REFLECT_TYPE_FLAG_FLOAT) {
+      switch (bit_width) {
+        case 16: {
+          switch (component_count) {
+            case 2:
               *p_format = SPV_REFLECT_FORMAT_R16G16_SFLOAT;
               break;
             case 3:
@@ -3344,6 +3996,7 @@ static SpvReflectResult ParseInterfaceVariable(SpvReflectPrvParser* p_parser,
     // Apply member decoration values to struct members
     p_var->location = p_type_node_decorations->location.value;
     p_var->component = p_type_node_decorations->component.value;
+    p_var->word_offset.location = p_type_node_decorations->location.word_offset;
   }
 
   p_var->built_in = p_type_node_decorations->built_in;
@@ -3673,9 +4326,15 @@ static SpvReflectResult ParseFunctionParameterAccess(SpvReflectPrvParser* p_pars
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module,
-                                                     SpvReflectEntryPoint* p_entry, size_t uniform_count, uint32_t* uniforms,
-                                                     size_t push_constant_count, uint32_t* push_constants) {
+// Computes the uniforms and push constants statically used by an entry point.
+// Only the entry point itself is written, so this may run concurrently for
+// different entry points. The sorted accesses are returned in
+// |pp_used_accesses| so that ParseStaticallyUsedBindings() can apply them to
+// the module's descriptor bindings afterwards.
+static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_parser, SpvReflectEntryPoint* p_entry,
+                                                     size_t uniform_count, uint32_t* uniforms, size_t push_constant_count,
+                                                     uint32_t* push_constants, SpvReflectPrvAccessedVariable** pp_used_accesses,
+                                                     uint32_t* p_used_access_count) {
   // Find function with the right id
   SpvReflectPrvFunction* p_func = NULL;
   for (size_t i = 0; i < p_parser->function_count; ++i) {
@@ -3772,6 +4431,21 @@ static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_pars
     return result;
   }
 
+  p_entry->used_uniform_count = (uint32_t)used_uniform_count;
+  p_entry->used_push_constant_count = (uint32_t)used_push_constant_count;
+
+  *pp_used_accesses = p_used_accesses;
+  *p_used_access_count = used_acessed_count;
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+// Marks the descriptor bindings touched by an entry point's accesses as
+// accessed and collects their ByteAddressBuffer offsets. Bindings are shared
+// between entry points, so this must be called serially.
+static SpvReflectResult ParseStaticallyUsedBindings(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module,
+                                                    SpvReflectPrvAccessedVariable* p_used_accesses, uint32_t used_acessed_count) {
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
   for (uint32_t i = 0; i < p_module->descriptor_binding_count; ++i) {
     SpvReflectDescriptorBinding* p_binding = &p_module->descriptor_bindings[i];
     uint32_t byte_address_buffer_offset_count = 0;
@@ -3783,7 +4457,6 @@ static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_pars
           result =
               ParseFunctionParameterAccess(p_parser, p_var->function_id, p_var->function_parameter_index, &p_binding->accessed);
           if (result != SPV_REFLECT_RESULT_SUCCESS) {
-            SafeFree(p_used_accesses);
             return result;
           }
         } else {
@@ -3814,7 +4487,6 @@ static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_pars
       }
 
       if (IsNull(p_binding->byte_address_buffer_offsets)) {
-        SafeFree(p_used_accesses);
         return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
       }
 
@@ -3822,7 +4494,6 @@ static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_pars
         if (p_used_accesses[j].variable_ptr == p_binding->spirv_id) {
           result = ParseByteAddressBuffer(p_parser, p_used_accesses[j].p_node, p_binding);
           if (result != SPV_REFLECT_RESULT_SUCCESS) {
-            SafeFree(p_used_accesses);
             return result;
           }
         }
@@ -3837,11 +4508,6 @@ static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_pars
     }
   }
 
-  SafeFree(p_used_accesses);
-
-  p_entry->used_uniform_count = (uint32_t)used_uniform_count;
-  p_entry->used_push_constant_count = (uint32_t)used_push_constant_count;
-
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
@@ -3862,6 +4528,27 @@ typedef struct SpvReflectPrvHeapAccess {
   uint32_t                          access_chain_id;
 } SpvReflectPrvHeapAccess;
 
+static SpvReflectResult ParseEntryPointIndex(SpvReflectShaderModule* p_module) {
+  uint32_t capacity = HashTableCapacity(p_module->entry_point_count);
+  if (capacity == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+
+  p_module->_internal->entry_point_index_by_name = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+  if (IsNull(p_module->_internal->entry_point_index_by_name)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_module->_internal->entry_point_index_capacity = capacity;
+
+  for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
+    if (IsNotNull(p_module->entry_points[i].name)) {
+      HashTableInsert(p_module->_internal->entry_point_index_by_name, capacity, HashString(p_module->entry_points[i].name), i);
+    }
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
 static SpvReflectResult ParseEntryPointHeapAccesses(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
   uint32_t heap_var_count = 0;
   for (size_t i = 0; i < p_parser->node_count; ++i) {
@@ -4126,7 +4813,303 @@ static SpvReflectResult ParseEntryPointHeapAccesses(SpvReflectPrvParser* p_parse
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-static SpvReflectResult ParseEntryPoints(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
+// Per-entry-point work item for ParseEntryPoints(). A task only writes to its
+// own entry point and to the fields below, which lets the tasks of different
+// entry points run concurrently on a caller-provided scheduler.
+typedef struct SpvReflectPrvEntryPointTask {
+  SpvReflectPrvNode*                p_node;
+  SpvReflectEntryPoint*             p_entry_point;
+  SpvReflectPrvAccessedVariable*    used_accesses;
+  uint32_t                          used_access_count;
+  SpvReflectResult                  result;
+} SpvReflectPrvEntryPointTask;
+
+typedef struct SpvReflectPrvEntryPointTasks {
+  SpvReflectPrvParser*              p_parser;
+  SpvReflectShaderModule*           p_module;
+  size_t                            uniform_count;
+  uint32_t*                         uniforms;
+  size_t                            push_constant_count;
+  uint32_t*                         push_constants;
+  SpvReflectPrvEntryPointTask*      tasks;
+} SpvReflectPrvEntryPointTasks;
+
+static SpvReflectResult ParseEntryPoint(SpvReflectPrvEntryPointTasks* p_tasks, SpvReflectPrvEntryPointTask* p_task) {
+  SpvReflectPrvParser* p_parser = p_tasks->p_parser;
+  SpvReflectPrvNode* p_node = p_task->p_node;
+  SpvReflectEntryPoint* p_entry_point = p_task->p_entry_point;
+
+  // Name length is required to calculate next operand
+  uint32_t name_start_word_offset = 3;
+  uint32_t name_length_with_terminator = 0;
+  SpvReflectResult result =
+      ReadStr(p_parser, p_node->word_offset + name_start_word_offset, 0, p_node->word_count, &name_length_with_terminator, NULL);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    return result;
+  }
+  p_entry_point->name = (const char*)(p_parser->spirv_code + p_node->word_offset + name_start_word_offset);
+
+  uint32_t name_word_count = RoundUp(name_length_with_terminator, SPIRV_WORD_SIZE) / SPIRV_WORD_SIZE;
+  uint32_t interface_variable_count = (p_node->word_count - (name_start_word_offset + name_word_count));
+  uint32_t* p_interface_variables = NULL;
+  if (interface_variable_count > 0) {
+    p_interface_variables = (uint32_t*)calloc(interface_variable_count, sizeof(*(p_interface_variables)));
+    if (IsNull(p_interface_variables)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+  }
+
+  for (uint32_t var_index = 0; var_index < interface_variable_count; ++var_index) {
+    uint32_t offset = name_start_word_offset + name_word_count + var_index;
+    result = ReadU32(p_parser, p_node->word_offset + offset, &p_interface_variables[var_index]);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      SafeFree(p_interface_variables);
+      return result;
+    }
+  }
+
+  result = ParseInterfaceVariables(p_parser, p_tasks->p_module, p_entry_point, interface_variable_count, p_interface_variables);
+  SafeFree(p_interface_variables);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    return result;
+  }
+
+  return ParseStaticallyUsedResources(p_parser, p_entry_point, p_tasks->uniform_count, p_tasks->uniforms,
+                                      p_tasks->push_constant_count, p_tasks->push_constants, &p_task->used_accesses,
+                                      &p_task->used_access_count);
+}
+
+static void RunEntryPointTask(void* p_task_data, uint32_t task_index) {
+  SpvReflectPrvEntryPointTasks* p_tasks = (SpvReflectPrvEntryPointTasks*)p_task_data;
+  SpvReflectPrvEntryPointTask* p_task = &p_tasks->tasks[task_index];
+  p_task->result = ParseEntryPoint(p_tasks, p_task);
+}
+
+// Collects the descriptor bindings and push constant blocks statically used by
+// each entry point, in module order, so enumerating them is a copy.
+static SpvReflectResult ParseEntryPointResources(SpvReflectShaderModule* p_module) {
+  uint32_t entry_point_count = p_module->entry_point_count;
+  p_module->_internal->entry_point_descriptor_binding_offsets = (uint32_t*)calloc(entry_point_count + 1, sizeof(uint32_t));
+  p_module->_internal->entry_point_push_constant_block_offsets = (uint32_t*)calloc(entry_point_count + 1, sizeof(uint32_t));
+  if (IsNull(p_module->_internal->entry_point_descriptor_binding_offsets) ||
+      IsNull(p_module->_internal->entry_point_push_constant_block_offsets)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  uint32_t* binding_offsets = p_module->_internal->entry_point_descriptor_binding_offsets;
+  uint32_t* block_offsets = p_module->_internal->entry_point_push_constant_block_offsets;
+
+  for (uint32_t i = 0; i < entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    binding_offsets[i + 1] = binding_offsets[i];
+    for (uint32_t j = 0; j < p_module->descriptor_binding_count; ++j) {
+      if (SearchSortedUint32(p_entry->used_uniforms, p_entry->used_uniform_count, p_module->descriptor_bindings[j].spirv_id)) {
+        ++binding_offsets[i + 1];
+      }
+    }
+    block_offsets[i + 1] = block_offsets[i];
+    for (uint32_t j = 0; j < p_module->push_constant_block_count; ++j) {
+      if (SearchSortedUint32(p_entry->used_push_constants, p_entry->used_push_constant_count,
+                             p_module->push_constant_blocks[j].spirv_id)) {
+        ++block_offsets[i + 1];
+      }
+    }
+  }
+
+  if (binding_offsets[entry_point_count] > 0) {
+    p_module->_internal->entry_point_descriptor_bindings =
+        (SpvReflectDescriptorBinding**)calloc(binding_offsets[entry_point_count], sizeof(SpvReflectDescriptorBinding*));
+    if (IsNull(p_module->_internal->entry_point_descriptor_bindings)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+  }
+  if (block_offsets[entry_point_count] > 0) {
+    p_module->_internal->entry_point_push_constant_blocks =
+        (SpvReflectBlockVariable**)calloc(block_offsets[entry_point_count], sizeof(SpvReflectBlockVariable*));
+    if (IsNull(p_module->_internal->entry_point_push_constant_blocks)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+  }
+
+  for (uint32_t i = 0; i < entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    SpvReflectDescriptorBinding** pp_bindings = p_module->_internal->entry_point_descriptor_bindings + binding_offsets[i];
+    for (uint32_t j = 0; j < p_module->descriptor_binding_count; ++j) {
+      if (SearchSortedUint32(p_entry->used_uniforms, p_entry->used_uniform_count, p_module->descriptor_bindings[j].spirv_id)) {
+        *(pp_bindings++) = &p_module->descriptor_bindings[j];
+      }
+    }
+    SpvReflectBlockVariable** pp_blocks = p_module->_internal->entry_point_push_constant_blocks + block_offsets[i];
+    for (uint32_t j = 0; j < p_module->push_constant_block_count; ++j) {
+      if (SearchSortedUint32(p_entry->used_push_constants, p_entry->used_push_constant_count,
+                             p_module->push_constant_blocks[j].spirv_id)) {
+        *(pp_blocks++) = &p_module->push_constant_blocks[j];
+      }
+    }
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+// Each entry point owns four hash tables in entry_point_variable_index, in the
+// order input by location, input by semantic, output by location and output by
+// semantic. Variables are inserted last to first so a lookup returns the last
+// match, like the linear scans these tables replace.
+static uint32_t* GetEntryPointVariableIndex(const SpvReflectShaderModule* p_module, const SpvReflectEntryPoint* p_entry,
+                                            bool output, bool semantic, uint32_t* p_capacity) {
+  uint32_t entry_point_index = (uint32_t)(p_entry - p_module->entry_points);
+  uint32_t input_capacity = HashTableCapacity(p_entry->input_variable_count);
+  uint32_t output_capacity = HashTableCapacity(p_entry->output_variable_count);
+  uint32_t offset = p_module->_internal->entry_point_variable_index_offsets[entry_point_index];
+  if (output) {
+    offset += 2 * input_capacity;
+  }
+  *p_capacity = output ? output_capacity : input_capacity;
+  if (*p_capacity == 0) {
+    return NULL;
+  }
+  if (semantic) {
+    offset += *p_capacity;
+  }
+  return p_module->_internal->entry_point_variable_index + offset;
+}
+
+static bool HasInterfaceLocation(const SpvReflectInterfaceVariable* p_var) {
+  return ((p_var->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) == 0) && (p_var->location != (uint32_t)INVALID_VALUE);
+}
+
+// Variables without a Component decoration start at component 0.
+static uint32_t InterfaceLocationKey(const SpvReflectInterfaceVariable* p_var) {
+  uint32_t component = (p_var->component == (uint32_t)INVALID_VALUE) ? 0 : (p_var->component & 3);
+  return (p_var->location << 2) | component;
+}
+
+// Insertion sort: the tables are small and stay nearly sorted when a single
+// location changes.
+static void SortEntryPointLocationTable(uint32_t* p_table, uint32_t count, SpvReflectInterfaceVariable* const* pp_variables) {
+  for (uint32_t i = 1; i < count; ++i) {
+    uint32_t index = p_table[i];
+    uint32_t key = InterfaceLocationKey(pp_variables[index]);
+    uint32_t j = i;
+    while ((j > 0) && (InterfaceLocationKey(pp_variables[p_table[j - 1]]) > key)) {
+      p_table[j] = p_table[j - 1];
+      --j;
+    }
+    p_table[j] = index;
+  }
+}
+
+static void IndexEntryPointVariableLocations(SpvReflectShaderModule* p_module) {
+  const uint32_t* location_offsets = p_module->_internal->entry_point_location_table_offsets;
+  for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    uint32_t* p_table = p_module->_internal->entry_point_location_table;
+    SortEntryPointLocationTable(p_table + location_offsets[2 * i], location_offsets[2 * i + 1] - location_offsets[2 * i],
+                                p_entry->input_variables);
+    SortEntryPointLocationTable(p_table + location_offsets[2 * i + 1],
+                                location_offsets[2 * i + 2] - location_offsets[2 * i + 1], p_entry->output_variables);
+  }
+
+  for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    uint32_t capacity = 0;
+    uint32_t* table = GetEntryPointVariableIndex(p_module, p_entry, false, false, &capacity);
+    if (capacity > 0) {
+      memset(table, 0, capacity * sizeof(*table));
+    }
+    for (uint32_t j = p_entry->input_variable_count; j > 0; --j) {
+      HashTableInsert(table, capacity, HashUint32(p_entry->input_variables[j - 1]->location), j - 1);
+    }
+    table = GetEntryPointVariableIndex(p_module, p_entry, true, false, &capacity);
+    if (capacity > 0) {
+      memset(table, 0, capacity * sizeof(*table));
+    }
+    for (uint32_t j = p_entry->output_variable_count; j > 0; --j) {
+      HashTableInsert(table, capacity, HashUint32(p_entry->output_variables[j - 1]->location), j - 1);
+    }
+  }
+}
+
+static SpvReflectResult ParseEntryPointVariableIndex(SpvReflectShaderModule* p_module) {
+  uint32_t entry_point_count = p_module->entry_point_count;
+  p_module->_internal->entry_point_variable_index_offsets = (uint32_t*)calloc(entry_point_count + 1, sizeof(uint32_t));
+  if (IsNull(p_module->_internal->entry_point_variable_index_offsets)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  uint32_t* offsets = p_module->_internal->entry_point_variable_index_offsets;
+  for (uint32_t i = 0; i < entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    offsets[i + 1] = offsets[i] + 2 * HashTableCapacity(p_entry->input_variable_count) +
+                     2 * HashTableCapacity(p_entry->output_variable_count);
+  }
+  p_module->_internal->entry_point_location_table_offsets = (uint32_t*)calloc(2 * entry_point_count + 1, sizeof(uint32_t));
+  if (IsNull(p_module->_internal->entry_point_location_table_offsets)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  uint32_t* location_offsets = p_module->_internal->entry_point_location_table_offsets;
+  for (uint32_t i = 0; i < entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    location_offsets[2 * i + 1] = location_offsets[2 * i];
+    for (uint32_t j = 0; j < p_entry->input_variable_count; ++j) {
+      location_offsets[2 * i + 1] += HasInterfaceLocation(p_entry->input_variables[j]) ? 1 : 0;
+    }
+    location_offsets[2 * i + 2] = location_offsets[2 * i + 1];
+    for (uint32_t j = 0; j < p_entry->output_variable_count; ++j) {
+      location_offsets[2 * i + 2] += HasInterfaceLocation(p_entry->output_variables[j]) ? 1 : 0;
+    }
+  }
+  p_module->_internal->entry_point_location_table =
+      (uint32_t*)calloc(Max(location_offsets[2 * entry_point_count], 1), sizeof(uint32_t));
+  if (IsNull(p_module->_internal->entry_point_location_table)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  uint32_t* p_location_table = p_module->_internal->entry_point_location_table;
+  for (uint32_t i = 0; i < entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    for (uint32_t j = 0; j < p_entry->input_variable_count; ++j) {
+      if (HasInterfaceLocation(p_entry->input_variables[j])) {
+        *(p_location_table++) = j;
+      }
+    }
+    for (uint32_t j = 0; j < p_entry->output_variable_count; ++j) {
+      if (HasInterfaceLocation(p_entry->output_variables[j])) {
+        *(p_location_table++) = j;
+      }
+    }
+  }
+
+  if (offsets[entry_point_count] == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+  p_module->_internal->entry_point_variable_index = (uint32_t*)calloc(offsets[entry_point_count], sizeof(uint32_t));
+  if (IsNull(p_module->_internal->entry_point_variable_index)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+
+  IndexEntryPointVariableLocations(p_module);
+  for (uint32_t i = 0; i < entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    uint32_t capacity = 0;
+    uint32_t* table = GetEntryPointVariableIndex(p_module, p_entry, false, true, &capacity);
+    for (uint32_t j = p_entry->input_variable_count; j > 0; --j) {
+      const char* semantic = p_entry->input_variables[j - 1]->semantic;
+      if (IsNotNull(semantic)) {
+        HashTableInsert(table, capacity, HashString(semantic), j - 1);
+      }
+    }
+    table = GetEntryPointVariableIndex(p_module, p_entry, true, true, &capacity);
+    for (uint32_t j = p_entry->output_variable_count; j > 0; --j) {
+      const char* semantic = p_entry->output_variables[j - 1]->semantic;
+      if (IsNotNull(semantic)) {
+        HashTableInsert(table, capacity, HashString(semantic), j - 1);
+      }
+    }
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult ParseEntryPoints(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module,
+                                         const SpvReflectTaskScheduler* p_scheduler) {
   if (p_parser->entry_point_count == 0) {
     return SPV_REFLECT_RESULT_SUCCESS;
   }
@@ -4137,28 +5120,37 @@ static SpvReflectResult ParseEntryPoints(SpvReflectPrvParser* p_parser, SpvRefle
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
 
-  SpvReflectResult result;
-  size_t uniform_count = 0;
-  uint32_t* uniforms = NULL;
-  if ((result = EnumerateAllUniforms(p_module, &uniform_count, &uniforms)) != SPV_REFLECT_RESULT_SUCCESS) {
-    return result;
+  SpvReflectPrvEntryPointTasks entry_point_tasks;
+  memset(&entry_point_tasks, 0, sizeof(entry_point_tasks));
+  entry_point_tasks.p_parser = p_parser;
+  entry_point_tasks.p_module = p_module;
+  entry_point_tasks.tasks =
+      (SpvReflectPrvEntryPointTask*)calloc(p_module->entry_point_count, sizeof(*(entry_point_tasks.tasks)));
+  if (IsNull(entry_point_tasks.tasks)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
-  size_t push_constant_count = 0;
-  uint32_t* push_constants = NULL;
-  if ((result = EnumerateAllPushConstants(p_module, &push_constant_count, &push_constants)) != SPV_REFLECT_RESULT_SUCCESS) {
-    return result;
+
+  SpvReflectResult result =
+      EnumerateAllUniforms(p_module, &entry_point_tasks.uniform_count, &entry_point_tasks.uniforms);
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = EnumerateAllPushConstants(p_module, &entry_point_tasks.push_constant_count, &entry_point_tasks.push_constants);
   }
 
-  size_t entry_point_index = 0;
-  for (size_t i = 0; entry_point_index < p_parser->entry_point_count && i < p_parser->node_count; ++i) {
+  // Read the fixed entry point operands serially; everything that follows
+  // only depends on the entry point's own instruction.
+  uint32_t entry_point_index = 0;
+  for (size_t i = 0; result == SPV_REFLECT_RESULT_SUCCESS && entry_point_index < p_parser->entry_point_count && i < p_parser->node_count;
+       ++i) {
     SpvReflectPrvNode* p_node = &(p_parser->nodes[i]);
     if (p_node->op != SpvOpEntryPoint) {
       continue;
     }
 
     SpvReflectEntryPoint* p_entry_point = &(p_module->entry_points[entry_point_index]);
-    CHECKED_READU32_CAST(p_parser, p_node->word_offset + 1, SpvExecutionModel, p_entry_point->spirv_execution_model);
-    CHECKED_READU32(p_parser, p_node->word_offset + 2, p_entry_point->id);
+    uint32_t execution_model = (uint32_t)INVALID_VALUE;
+    IF_READU32(result, p_parser, p_node->word_offset + 1, execution_model);
+    IF_READU32(result, p_parser, p_node->word_offset + 2, p_entry_point->id);
+    p_entry_point->spirv_execution_model = (SpvExecutionModel)execution_model;
 
     switch (p_entry_point->spirv_execution_model) {
       default:
@@ -4213,52 +5205,45 @@ static SpvReflectResult ParseEntryPoints(SpvReflectPrvParser* p_parser, SpvRefle
         break;
     }
 
+    entry_point_tasks.tasks[entry_point_index].p_node = p_node;
+    entry_point_tasks.tasks[entry_point_index].p_entry_point = p_entry_point;
     ++entry_point_index;
+  }
 
-    // Name length is required to calculate next operand
-    uint32_t name_start_word_offset = 3;
-    uint32_t name_length_with_terminator = 0;
-    result =
-        ReadStr(p_parser, p_node->word_offset + name_start_word_offset, 0, p_node->word_count, &name_length_with_terminator, NULL);
-    if (result != SPV_REFLECT_RESULT_SUCCESS) {
-      return result;
-    }
-    p_entry_point->name = (const char*)(p_parser->spirv_code + p_node->word_offset + name_start_word_offset);
-
-    uint32_t name_word_count = RoundUp(name_length_with_terminator, SPIRV_WORD_SIZE) / SPIRV_WORD_SIZE;
-    uint32_t interface_variable_count = (p_node->word_count - (name_start_word_offset + name_word_count));
-    uint32_t* p_interface_variables = NULL;
-    if (interface_variable_count > 0) {
-      p_interface_variables = (uint32_t*)calloc(interface_variable_count, sizeof(*(p_interface_variables)));
-      if (IsNull(p_interface_variables)) {
-        return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    if (IsNotNull(p_scheduler) && IsNotNull(p_scheduler->parallel_for) && entry_point_index > 1) {
+      p_scheduler->parallel_for(p_scheduler->p_user_data, entry_point_index, RunEntryPointTask, &entry_point_tasks);
+    } else {
+      for (uint32_t task_index = 0; task_index < entry_point_index; ++task_index) {
+        RunEntryPointTask(&entry_point_tasks, task_index);
       }
     }
+  }
 
-    for (uint32_t var_index = 0; var_index < interface_variable_count; ++var_index) {
-      uint32_t var_result_id = (uint32_t)INVALID_VALUE;
-      uint32_t offset = name_start_word_offset + name_word_count + var_index;
-      CHECKED_READU32(p_parser, p_node->word_offset + offset, var_result_id);
-      p_interface_variables[var_index] = var_result_id;
-    }
-
-    result = ParseInterfaceVariables(p_parser, p_module, p_entry_point, interface_variable_count, p_interface_variables);
-    if (result != SPV_REFLECT_RESULT_SUCCESS) {
-      return result;
+  // Apply the accesses to the shared descriptor bindings in entry point order
+  // so the result does not depend on how the tasks were scheduled.
+  for (uint32_t task_index = 0; task_index < entry_point_index; ++task_index) {
+    SpvReflectPrvEntryPointTask* p_task = &entry_point_tasks.tasks[task_index];
+    if (result == SPV_REFLECT_RESULT_SUCCESS) {
+      result = p_task->result;
     }
-    SafeFree(p_interface_variables);
-
-    result = ParseStaticallyUsedResources(p_parser, p_module, p_entry_point, uniform_count, uniforms, push_constant_count,
-                                          push_constants);
-    if (result != SPV_REFLECT_RESULT_SUCCESS) {
-      return result;
+    if (result == SPV_REFLECT_RESULT_SUCCESS && p_task->used_access_count > 0) {
+      result = ParseStaticallyUsedBindings(p_parser, p_module, p_task->used_accesses, p_task->used_access_count);
     }
+    SafeFree(p_task->used_accesses);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseEntryPointResources(p_module);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseEntryPointVariableIndex(p_module);
   }
 
-  SafeFree(uniforms);
-  SafeFree(push_constants);
-
-  return SPV_REFLECT_RESULT_SUCCESS;
+  SafeFree(entry_point_tasks.tasks);
+  SafeFree(entry_point_tasks.uniforms);
+  SafeFree(entry_point_tasks.push_constants);
+
+  return result;
 }
 
 static SpvReflectResult ParseExecutionModes(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
@@ -4414,6 +5399,10 @@ static SpvReflectResult ParsePushConstantBlocks(SpvReflectPrvParser* p_parser, S
   }
 
   p_parser->physical_pointer_struct_count = 0;
+  SpvReflectResult result = ResetBlockLayouts(p_parser, p_module->push_constant_block_count);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    return result;
+  }
   uint32_t push_constant_index = 0;
   for (size_t i = 0; i < p_parser->node_count; ++i) {
     SpvReflectPrvNode* p_node = &(p_parser->nodes[i]);
@@ -4446,8 +5435,26 @@ static SpvReflectResult ParsePushConstantBlocks(SpvReflectPrvParser* p_parser, S
 
     SpvReflectBlockVariable* p_push_constant = &p_module->push_constant_blocks[push_constant_index];
     p_push_constant->spirv_id = p_node->result_id;
-    p_parser->physical_pointer_count = 0;
-    SpvReflectResult result = ParseDescriptorBlockVariable(p_parser, p_module, p_type, p_push_constant);
+    ClearPhysicalPointers(p_parser);
+    SpvReflectBlockVariable* p_previous = NULL;
+    if (IsNotNull(p_parser->p_previous_module) && (push_constant_index < p_parser->p_previous_module->push_constant_block_count)) {
+      p_previous = &p_parser->p_previous_module->push_constant_blocks[push_constant_index];
+      if ((p_previous->spirv_id != p_push_constant->spirv_id) || (p_previous->type_description != p_type)) {
+        p_previous = NULL;
+      }
+    }
+    const SpvReflectBlockVariable* p_layout = NULL;
+    uint32_t physical_pointer_struct_count = p_parser->physical_pointer_struct_count;
+    if (IsNotNull(p_previous)) {
+      AdoptBlockVariable(&p_parser->previous_rebase, p_type, p_previous, p_push_constant);
+    } else {
+      p_layout = FindBlockLayout(p_parser, p_type, true);
+      if (IsNotNull(p_layout)) {
+        result = CopyBlockLayout(p_layout, p_type, p_push_constant);
+      } else {
+        result = ParseDescriptorBlockVariable(p_parser, p_module, p_type, p_push_constant);
+      }
+    }
     if (result != SPV_REFLECT_RESULT_SUCCESS) {
       return result;
     }
@@ -4467,9 +5474,14 @@ static SpvReflectResult ParsePushConstantBlocks(SpvReflectPrvParser* p_parser, S
     }
 
     p_push_constant->name = p_node->name;
-    result = ParseDescriptorBlockVariableSizes(p_parser, p_module, true, false, true, p_push_constant);
-    if (result != SPV_REFLECT_RESULT_SUCCESS) {
-      return result;
+    if (IsNull(p_layout)) {
+      result = ParseDescriptorBlockVariableSizes(p_parser, p_module, true, false, true, p_push_constant);
+      if (result != SPV_REFLECT_RESULT_SUCCESS) {
+        return result;
+      }
+      if ((p_push_constant->member_count > 0) && (p_parser->physical_pointer_struct_count == physical_pointer_struct_count)) {
+        AddBlockLayout(p_parser, p_type, true, p_push_constant);
+      }
     }
 
     // Get minimum offset for whole Push Constant block
@@ -4486,6 +5498,11 @@ static SpvReflectResult ParsePushConstantBlocks(SpvReflectPrvParser* p_parser, S
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
+// Default values of OpSpecConstantTrue and OpSpecConstantFalse. During external
+// specialization, Boolean values are true if non-zero and false if zero.
+static uint32_t spec_constant_true_value = 1;
+static uint32_t spec_constant_false_value = 0;
+
 static SpvReflectResult ParseSpecConstants(SpvReflectPrvParser* p_parser, SpvReflectShaderModule* p_module) {
   if (p_parser->spec_constant_count > 0) {
     p_module->spec_constants = (SpvReflectSpecializationConstant*)calloc(p_parser->spec_constant_count, sizeof(*p_module->spec_constants));
@@ -4509,9 +5526,6 @@ static SpvReflectResult ParseSpecConstants(SpvReflectPrvParser* p_parser, SpvRef
           // If being used for a OpSpecConstantComposite (ex. LocalSizeId), there won't be a name
           p_spec_constant->name = target_node->name;
 
-          // During external specialization, Boolean values are true if non-zero and false if zero.
-          static uint32_t true_value = 1;
-          static uint32_t false_value = 0;
           switch (target_node->op) {
             default:
               // Unexpected, since Spec states:
@@ -4520,11 +5534,11 @@ static SpvReflectResult ParseSpecConstants(SpvReflectPrvParser* p_parser, SpvRef
               return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_INSTRUCTION;
             case SpvOpSpecConstantTrue:
               p_spec_constant->default_value_size = sizeof(uint32_t);
-              p_spec_constant->default_value = &true_value;
+              p_spec_constant->default_value = &spec_constant_true_value;
               break;
             case SpvOpSpecConstantFalse:
               p_spec_constant->default_value_size = sizeof(uint32_t);
-              p_spec_constant->default_value = &false_value;
+              p_spec_constant->default_value = &spec_constant_false_value;
               break;
             case SpvOpSpecConstant:
               p_spec_constant->default_value_size = (target_node->word_count - 3) * sizeof(uint32_t);
@@ -4719,1291 +5733,6131 @@ static SpvReflectResult SynchronizeDescriptorSets(SpvReflectShaderModule* p_modu
   return result;
 }
 
-static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const void* p_code, SpvReflectShaderModule* p_module) {
-  // Initialize all module fields to zero
-  memset(p_module, 0, sizeof(*p_module));
+// Logical sections of a module, in the order the SPIR-V spec lays them out.
+enum {
+  SPV_REFLECT_PRV_SECTION_PREAMBLE,      // Header, capabilities, extensions, imports, memory model
+  SPV_REFLECT_PRV_SECTION_ENTRY_POINTS,  // Entry points and execution modes
+  SPV_REFLECT_PRV_SECTION_DEBUG,         // Strings, sources and names
+  SPV_REFLECT_PRV_SECTION_ANNOTATIONS,   // Decorations
+  SPV_REFLECT_PRV_SECTION_GLOBALS,       // Types, constants and global variables
+  SPV_REFLECT_PRV_SECTION_FUNCTIONS,
+  SPV_REFLECT_PRV_SECTION_COUNT
+};
 
-  // Allocate module internals
-#ifdef __cplusplus
-  p_module->_internal = (SpvReflectShaderModule::Internal*)calloc(1, sizeof(*(p_module->_internal)));
-#else
-  p_module->_internal = calloc(1, sizeof(*(p_module->_internal)));
-#endif
-  if (IsNull(p_module->_internal)) {
-    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
-  }
-  // Copy flags
-  p_module->_internal->module_flags = flags;
-  // Figure out if we need to copy the SPIR-V code or not
-  if (flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) {
-    // Set internal size and pointer to args passed in
-    p_module->_internal->spirv_size = size;
-#if defined(__cplusplus)
-    p_module->_internal->spirv_code = const_cast<uint32_t*>(static_cast<const uint32_t*>(p_code));  // cast that const away
-#else
-    p_module->_internal->spirv_code = (void*)p_code;  // cast that const away
-#endif
-    p_module->_internal->spirv_word_count = (uint32_t)(size / SPIRV_WORD_SIZE);
-  } else {
-    // Allocate SPIR-V code storage
-    p_module->_internal->spirv_size = size;
-    p_module->_internal->spirv_code = (uint32_t*)calloc(1, p_module->_internal->spirv_size);
-    p_module->_internal->spirv_word_count = (uint32_t)(size / SPIRV_WORD_SIZE);
-    if (IsNull(p_module->_internal->spirv_code)) {
-      SafeFree(p_module->_internal);
-      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
-    }
-    // Copy SPIR-V to code storage
-    memcpy(p_module->_internal->spirv_code, p_code, size);
+static uint32_t ModuleSectionOfOp(SpvOp op) {
+  switch (op) {
+    case SpvOpCapability:
+    case SpvOpExtension:
+    case SpvOpExtInstImport:
+    case SpvOpMemoryModel:
+      return SPV_REFLECT_PRV_SECTION_PREAMBLE;
+    case SpvOpEntryPoint:
+    case SpvOpExecutionMode:
+    case SpvOpExecutionModeId:
+      return SPV_REFLECT_PRV_SECTION_ENTRY_POINTS;
+    case SpvOpString:
+    case SpvOpSourceExtension:
+    case SpvOpSource:
+    case SpvOpSourceContinued:
+    case SpvOpName:
+    case SpvOpMemberName:
+    case SpvOpModuleProcessed:
+      return SPV_REFLECT_PRV_SECTION_DEBUG;
+    case SpvOpDecorate:
+    case SpvOpMemberDecorate:
+    case SpvOpDecorationGroup:
+    case SpvOpGroupDecorate:
+    case SpvOpGroupMemberDecorate:
+    case SpvOpDecorateId:
+    case SpvOpDecorateString:
+    case SpvOpMemberDecorateString:
+      return SPV_REFLECT_PRV_SECTION_ANNOTATIONS;
+    case SpvOpFunction:
+      return SPV_REFLECT_PRV_SECTION_FUNCTIONS;
+    default:
+      return SPV_REFLECT_PRV_SECTION_GLOBALS;
   }
+}
 
-  // Initialize everything to zero
-  SpvReflectPrvParser parser;
-  memset(&parser, 0, sizeof(SpvReflectPrvParser));
+// FNV-1a over words, continuing from hash
+static uint64_t HashWordsUpdate(uint64_t hash, const uint32_t* p_words, uint32_t word_count) {
+  for (uint32_t i = 0; i < word_count; ++i) {
+    hash ^= p_words[i];
+    hash *= 0x00000100000001b3ULL;
+  }
+  return hash;
+}
 
-  // Create parser
-  SpvReflectResult result = CreateParser(p_module->_internal->spirv_size, p_module->_internal->spirv_code, &parser);
+static uint64_t HashWords(const uint32_t* p_words, uint32_t word_count) {
+  return HashWordsUpdate(0xcbf29ce484222325ULL, p_words, word_count);
+}
 
-  // Generator
-  {
-    const uint32_t* p_ptr = (const uint32_t*)p_module->_internal->spirv_code;
-    p_module->generator = (SpvReflectGenerator)((*(p_ptr + 2) & 0xFFFF0000) >> 16);
+// Splits the module into its logical sections and hashes each of them. An
+// instruction that belongs to an earlier section than the one being read
+// (e.g. OpLine in a function) stays in the current one.
+static SpvReflectResult HashModuleSections(SpvReflectShaderModule* p_module) {
+  const uint32_t* p_code = p_module->_internal->spirv_code;
+  uint32_t word_count = p_module->_internal->spirv_word_count;
+  uint32_t* p_offsets = p_module->_internal->section_offsets;
+  p_module->_internal->section_hashes_valid = 0;
+  if (word_count < SPIRV_STARTING_WORD_INDEX) {
+    return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_CODE_SIZE;
   }
 
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseNodes(&parser);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
-  }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseStrings(&parser);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  uint32_t section = SPV_REFLECT_PRV_SECTION_PREAMBLE;
+  p_offsets[SPV_REFLECT_PRV_SECTION_PREAMBLE] = 0;
+  uint32_t word_index = SPIRV_STARTING_WORD_INDEX;
+  while (word_index < word_count) {
+    uint32_t instruction_word_count = p_code[word_index] >> 16;
+    if ((instruction_word_count == 0) || (instruction_word_count > word_count - word_index)) {
+      return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_INSTRUCTION;
+    }
+    uint32_t op_section = ModuleSectionOfOp((SpvOp)(p_code[word_index] & 0xFFFF));
+    for (; section < op_section; ++section) {
+      p_offsets[section + 1] = word_index;
+    }
+    word_index += instruction_word_count;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseSource(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  for (; section < SPV_REFLECT_PRV_SECTION_COUNT; ++section) {
+    p_offsets[section + 1] = word_count;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseFunctions(&parser);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+
+  for (uint32_t i = 0; i < SPV_REFLECT_PRV_SECTION_COUNT; ++i) {
+    p_module->_internal->section_hashes[i] = HashWords(p_code + p_offsets[i], p_offsets[i + 1] - p_offsets[i]);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseMemberCounts(&parser);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  p_module->_internal->section_hashes_valid = 1;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+// Called after decoration operands are edited in place.
+static void RehashModuleAnnotations(SpvReflectShaderModule* p_module) {
+  if (p_module->_internal->section_hashes_valid) {
+    const uint32_t* p_offsets = p_module->_internal->section_offsets;
+    p_module->_internal->section_hashes[SPV_REFLECT_PRV_SECTION_ANNOTATIONS] =
+        HashWords(p_module->_internal->spirv_code + p_offsets[SPV_REFLECT_PRV_SECTION_ANNOTATIONS],
+                  p_offsets[SPV_REFLECT_PRV_SECTION_GLOBALS] - p_offsets[SPV_REFLECT_PRV_SECTION_ANNOTATIONS]);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseNames(&parser);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+}
+
+static bool ModuleSectionsEqual(const SpvReflectShaderModule* p_a, const SpvReflectShaderModule* p_b, uint32_t first_section,
+                                uint32_t last_section) {
+  if (!p_a->_internal->section_hashes_valid || !p_b->_internal->section_hashes_valid) {
+    return false;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseDecorations(&parser);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  for (uint32_t i = first_section; i <= last_section; ++i) {
+    uint32_t a_count = p_a->_internal->section_offsets[i + 1] - p_a->_internal->section_offsets[i];
+    uint32_t b_count = p_b->_internal->section_offsets[i + 1] - p_b->_internal->section_offsets[i];
+    if ((a_count != b_count) || (p_a->_internal->section_hashes[i] != p_b->_internal->section_hashes[i])) {
+      return false;
+    }
   }
+  return true;
+}
 
-  // Start of reflection data parsing
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    p_module->source_language = parser.source_language;
-    p_module->source_language_version = parser.source_language_version;
-
-    // Zero out descriptor set data
-    p_module->descriptor_set_count = 0;
-    memset(p_module->descriptor_sets, 0, SPV_REFLECT_MAX_DESCRIPTOR_SETS * sizeof(*p_module->descriptor_sets));
-    // Initialize descriptor set numbers
-    for (uint32_t set_number = 0; set_number < SPV_REFLECT_MAX_DESCRIPTOR_SETS; ++set_number) {
-      p_module->descriptor_sets[set_number].set = (uint32_t)INVALID_VALUE;
-    }
+// The previous module's types and block layouts carry over if everything
+// they are parsed from is unchanged. PhysicalStorageBuffer pointers are
+// excluded, since their block members are shared between variables.
+static bool CanAdoptPreviousModule(const SpvReflectShaderModule* p_previous, const SpvReflectShaderModule* p_module) {
+  // Names of a detached module cannot be rebased into the new code
+  if (IsNull(p_previous->_internal->spirv_code)) {
+    return false;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseTypes(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  if (!ModuleSectionsEqual(p_previous, p_module, SPV_REFLECT_PRV_SECTION_DEBUG, SPV_REFLECT_PRV_SECTION_GLOBALS)) {
+    return false;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseDescriptorBindings(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  for (size_t i = 0; i < p_previous->_internal->type_description_count; ++i) {
+    if (p_previous->_internal->type_descriptions[i].storage_class == SpvStorageClassPhysicalStorageBuffer) {
+      return false;
+    }
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseDescriptorType(p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  return true;
+}
+
+static void InitPreviousRebase(const SpvReflectShaderModule* p_previous, const SpvReflectShaderModule* p_module,
+                               SpvReflectPrvRebase* p_rebase) {
+  p_rebase->old_begin = (uintptr_t)p_previous->_internal->spirv_code;
+  p_rebase->old_end = p_rebase->old_begin + p_previous->_internal->spirv_word_count * SPIRV_WORD_SIZE;
+  p_rebase->new_begin = (uintptr_t)p_module->_internal->spirv_code;
+  p_rebase->old_annotations_begin = p_previous->_internal->section_offsets[SPV_REFLECT_PRV_SECTION_ANNOTATIONS];
+  p_rebase->old_annotations_end = p_previous->_internal->section_offsets[SPV_REFLECT_PRV_SECTION_GLOBALS];
+  p_rebase->word_delta = (int64_t)p_module->_internal->section_offsets[SPV_REFLECT_PRV_SECTION_DEBUG] -
+                         (int64_t)p_previous->_internal->section_offsets[SPV_REFLECT_PRV_SECTION_DEBUG];
+}
+
+//
+// SHA-256
+//
+// Snapshots are checked with a strong digest, since they are loaded from
+// files that anyone who can write SPIR-V or a shared cache directory can
+// craft.
+//
+typedef struct SpvReflectPrvSha256 {
+  uint32_t                        state[8];
+  uint64_t                        size;
+  uint8_t                         block[64];
+} SpvReflectPrvSha256;
+
+static const uint32_t sha256_round_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+    0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
+    0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static uint32_t RotateRight(uint32_t value, uint32_t count) { return (value >> count) | (value << (32 - count)); }
+
+static void Sha256Block(SpvReflectPrvSha256* p_sha, const uint8_t* p_block) {
+  uint32_t w[64];
+  for (uint32_t i = 0; i < 16; ++i) {
+    w[i] = ((uint32_t)p_block[4 * i] << 24) | ((uint32_t)p_block[4 * i + 1] << 16) | ((uint32_t)p_block[4 * i + 2] << 8) |
+           (uint32_t)p_block[4 * i + 3];
+  }
+  for (uint32_t i = 16; i < 64; ++i) {
+    uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+  uint32_t v[8];
+  memcpy(v, p_sha->state, sizeof(v));
+  for (uint32_t i = 0; i < 64; ++i) {
+    uint32_t s1 = RotateRight(v[4], 6) ^ RotateRight(v[4], 11) ^ RotateRight(v[4], 25);
+    uint32_t choice = (v[4] & v[5]) ^ (~v[4] & v[6]);
+    uint32_t t1 = v[7] + s1 + choice + sha256_round_constants[i] + w[i];
+    uint32_t s0 = RotateRight(v[0], 2) ^ RotateRight(v[0], 13) ^ RotateRight(v[0], 22);
+    uint32_t majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+    memmove(v + 1, v, 7 * sizeof(*v));
+    v[4] += t1;
+    v[0] = t1 + s0 + majority;
+  }
+  for (uint32_t i = 0; i < 8; ++i) {
+    p_sha->state[i] += v[i];
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseUAVCounterBindings(p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+}
+
+static void Sha256Init(SpvReflectPrvSha256* p_sha) {
+  static const uint32_t initial_state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  memcpy(p_sha->state, initial_state, sizeof(initial_state));
+  p_sha->size = 0;
+}
+
+static void Sha256Update(SpvReflectPrvSha256* p_sha, const void* p_data, size_t size) {
+  if (size == 0) {
+    return;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseDescriptorBlocks(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  const uint8_t* p_in = (const uint8_t*)p_data;
+  size_t used = (size_t)(p_sha->size % sizeof(p_sha->block));
+  p_sha->size += size;
+  if (used > 0) {
+    size_t fill = sizeof(p_sha->block) - used;
+    fill = (fill < size) ? fill : size;
+    memcpy(p_sha->block + used, p_in, fill);
+    p_in += fill;
+    size -= fill;
+    if (used + fill < sizeof(p_sha->block)) {
+      return;
+    }
+    Sha256Block(p_sha, p_sha->block);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParsePushConstantBlocks(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  for (; size >= sizeof(p_sha->block); p_in += sizeof(p_sha->block), size -= sizeof(p_sha->block)) {
+    Sha256Block(p_sha, p_in);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseSpecConstants(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  if (size > 0) {
+    memcpy(p_sha->block, p_in, size);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseEntryPoints(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+}
+
+static void Sha256Final(SpvReflectPrvSha256* p_sha, uint8_t* p_digest) {
+  uint64_t bit_count = p_sha->size * 8;
+  uint8_t padding[72] = {0x80};
+  size_t used = (size_t)(p_sha->size % sizeof(p_sha->block));
+  Sha256Update(p_sha, padding, ((used < 56) ? 56 : 120) - used);
+  uint8_t length[8];
+  for (uint32_t i = 0; i < 8; ++i) {
+    length[i] = (uint8_t)(bit_count >> (56 - 8 * i));
+  }
+  Sha256Update(p_sha, length, sizeof(length));
+  for (uint32_t i = 0; i < 8; ++i) {
+    p_digest[4 * i] = (uint8_t)(p_sha->state[i] >> 24);
+    p_digest[4 * i + 1] = (uint8_t)(p_sha->state[i] >> 16);
+    p_digest[4 * i + 2] = (uint8_t)(p_sha->state[i] >> 8);
+    p_digest[4 * i + 3] = (uint8_t)p_sha->state[i];
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseEntryPointHeapAccesses(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+}
+
+//
+// Embedded reflection
+//
+// spvReflectEmbedReflection stores a snapshot of a module's reflection data
+// in the SPIR-V it describes. A snapshot is a header and a body of little
+// endian words. The body lists the allocations the module owns, the
+// "regions", in the order spvReflectDestroyShaderModule frees them and
+// starting with the module itself, as the kind and element count of each,
+// followed by the elements of every region, field by field. A pointer is
+// stored as the region and element it points at, or as a byte offset into
+// the SPIR-V for names and default values, so a snapshot does not depend on
+// the struct layouts of the build that wrote it. The lookup indices in
+// _internal are rebuilt instead of stored.
+//
+// The header holds a SHA-256 digest of the SPIR-V, the header and the body,
+// so a snapshot that was damaged, or written for other code, is never
+// loaded. Every field is also checked as it is read: enums against their
+// ranges, counts against the arrays their pointers name, and word offsets
+// against the SPIR-V words they locate. The regions are then collected
+// again from the loaded module and compared with the loaded ones, which
+// checks that each one is owned exactly once and that block members fit in
+// their blocks.
+//
+#define SPV_REFLECT_PRV_SNAPSHOT_MAGIC              0x4C465253  // "SRFL"
+// Must change whenever the snapshot format or what the parser stores in the
+// reflection data does. The SnapshotFormat test fails until it is updated.
+#define SPV_REFLECT_PRV_SNAPSHOT_VERSION            5
+// Magic, version, code word count, body word count and the digest
+#define SPV_REFLECT_PRV_SNAPSHOT_HEADER_WORD_COUNT  12
+#define SPV_REFLECT_PRV_SNAPSHOT_DIGEST_SIZE        32
+// Bounds the recursion into members
+#define SPV_REFLECT_PRV_SNAPSHOT_MAX_DEPTH          1024
+// Pointer targets that are not regions, which are stored as their index + 1
+#define SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL        0
+#define SPV_REFLECT_PRV_SNAPSHOT_TARGET_CODE        UINT32_MAX
+#define SPV_REFLECT_PRV_SNAPSHOT_TARGET_TRUE_VALUE  (UINT32_MAX - 1)
+#define SPV_REFLECT_PRV_SNAPSHOT_TARGET_FALSE_VALUE (UINT32_MAX - 2)
+
+#define SPV_REFLECT_PRV_EMBEDDED_SET_NAME           "NonSemantic.SPIRV-Reflect"
+#define SPV_REFLECT_PRV_EMBEDDED_EXTENSION_NAME     "SPV_KHR_non_semantic_info"
+#define SPV_REFLECT_PRV_EMBEDDED_INSTRUCTION        1
+// Base64 characters per OpString; a multiple of 4 so each one decodes on its own.
+#define SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE         65536
+
+enum SpvReflectPrvSnapshotRegionKind {
+  SPV_REFLECT_PRV_REGION_MODULE,
+  SPV_REFLECT_PRV_REGION_WORDS,
+  SPV_REFLECT_PRV_REGION_STRING,
+  SPV_REFLECT_PRV_REGION_CAPABILITIES,
+  SPV_REFLECT_PRV_REGION_TYPES,
+  SPV_REFLECT_PRV_REGION_BLOCKS,
+  SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES,
+  SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS,
+  SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDINGS,
+  SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDING_POINTERS,
+  SPV_REFLECT_PRV_REGION_DESCRIPTOR_SETS,
+  SPV_REFLECT_PRV_REGION_ENTRY_POINTS,
+  SPV_REFLECT_PRV_REGION_SPEC_CONSTANTS,
+  SPV_REFLECT_PRV_REGION_RESOURCE_HEAP_ACCESSES,
+  SPV_REFLECT_PRV_REGION_SAMPLER_HEAP_ACCESSES,
+  SPV_REFLECT_PRV_REGION_KIND_COUNT  // Also the kind of what no region holds
+};
+
+enum SpvReflectPrvSnapshotMode {
+  SPV_REFLECT_PRV_SNAPSHOT_WRITE,
+  SPV_REFLECT_PRV_SNAPSHOT_READ,
+  SPV_REFLECT_PRV_SNAPSHOT_FIND_CODE  // Only records the pointers into the code
+};
+
+typedef struct SpvReflectPrvSnapshotRegion {
+  uint8_t*                        p_data;
+  uint32_t                        size;
+  uint32_t                        kind;
+} SpvReflectPrvSnapshotRegion;
+
+typedef struct SpvReflectPrvSnapshotAddress {
+  uintptr_t                       address;
+  uint32_t                        region;
+} SpvReflectPrvSnapshotAddress;
+
+// A pointer into the code, and the bytes it uses, with a string's NUL.
+typedef struct SpvReflectPrvSnapshotCodeReference {
+  void*                           p_field;
+  uint32_t                        offset;
+  uint32_t                        size;
+} SpvReflectPrvSnapshotCodeReference;
+
+// Writes the regions of a module, reads them back, or finds the pointers
+// into the code. Reading collects the regions again to compare them with
+// the loaded ones.
+typedef struct SpvReflectPrvSnapshot {
+  uint32_t                            mode;
+  SpvReflectResult                    result;
+  const uint8_t*                      p_code;
+  size_t                              code_size;
+  uint32_t                            region_count;
+  uint32_t                            region_capacity;
+  uint32_t                            region_cursor;
+  SpvReflectPrvSnapshotRegion*        regions;
+  SpvReflectPrvSnapshotAddress*       sorted_regions;
+  uint8_t*                            p_out;
+  const uint8_t*                      p_in;
+  uint32_t                            word_count;
+  uint32_t                            word_capacity;
+  uint32_t                            word_cursor;
+  uint32_t                            code_reference_count;
+  uint32_t                            code_reference_capacity;
+  SpvReflectPrvSnapshotCodeReference* code_references;
+} SpvReflectPrvSnapshot;
+
+// Locations of a payload written by spvReflectEmbedReflection, as word offsets.
+typedef struct SpvReflectPrvEmbeddedReflection {
+  uint32_t                        import_offset;       // OpExtInstImport
+  uint32_t                        instruction_offset;  // OpExtInst
+  uint32_t                        chunk_count;
+  uint32_t*                       chunk_offsets;       // OpStrings, in payload order
+} SpvReflectPrvEmbeddedReflection;
+
+static size_t SnapshotElementSize(uint32_t kind) {
+  switch (kind) {
+    case SPV_REFLECT_PRV_REGION_MODULE:
+      return sizeof(SpvReflectShaderModule);
+    case SPV_REFLECT_PRV_REGION_WORDS:
+      return sizeof(uint32_t);
+    case SPV_REFLECT_PRV_REGION_CAPABILITIES:
+      return sizeof(SpvReflectCapability);
+    case SPV_REFLECT_PRV_REGION_TYPES:
+      return sizeof(SpvReflectTypeDescription);
+    case SPV_REFLECT_PRV_REGION_BLOCKS:
+      return sizeof(SpvReflectBlockVariable);
+    case SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES:
+      return sizeof(SpvReflectInterfaceVariable);
+    case SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDINGS:
+      return sizeof(SpvReflectDescriptorBinding);
+    case SPV_REFLECT_PRV_REGION_DESCRIPTOR_SETS:
+      return sizeof(SpvReflectDescriptorSet);
+    case SPV_REFLECT_PRV_REGION_ENTRY_POINTS:
+      return sizeof(SpvReflectEntryPoint);
+    case SPV_REFLECT_PRV_REGION_SPEC_CONSTANTS:
+      return sizeof(SpvReflectSpecializationConstant);
+    case SPV_REFLECT_PRV_REGION_RESOURCE_HEAP_ACCESSES:
+      return sizeof(SpvReflectEntryPointResourceHeapAccess);
+    case SPV_REFLECT_PRV_REGION_SAMPLER_HEAP_ACCESSES:
+      return sizeof(SpvReflectEntryPointSamplerHeapAccess);
+    case SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS:
+    case SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDING_POINTERS:
+      return sizeof(void*);
+    default:
+      return 1;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseCapabilities(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+}
+
+static void SnapshotFail(SpvReflectPrvSnapshot* p_snapshot, SpvReflectResult result) {
+  if (p_snapshot->result == SPV_REFLECT_RESULT_SUCCESS) {
+    p_snapshot->result = result;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS && p_module->entry_point_count > 0) {
-    SpvReflectEntryPoint* p_entry = &(p_module->entry_points[0]);
-    p_module->entry_point_name = p_entry->name;
-    p_module->entry_point_id = p_entry->id;
-    p_module->spirv_execution_model = p_entry->spirv_execution_model;
-    p_module->shader_stage = p_entry->shader_stage;
-    p_module->input_variable_count = p_entry->input_variable_count;
-    p_module->input_variables = p_entry->input_variables;
-    p_module->output_variable_count = p_entry->output_variable_count;
-    p_module->output_variables = p_entry->output_variables;
-    p_module->interface_variable_count = p_entry->interface_variable_count;
-    p_module->interface_variables = p_entry->interface_variables;
+}
+
+// Checks a value that was read. What the parser stores is written as it is,
+// so a module with values newer than spirv.h is parsed instead of loaded.
+static void SnapshotCheck(SpvReflectPrvSnapshot* p_snapshot, bool valid) {
+  if ((p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) && !valid) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = DisambiguateStorageBufferSrvUav(p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+}
+
+// Registers an allocation of the module. Returns true if it holds elements
+// that should be walked.
+static bool SnapshotAddRegion(SpvReflectPrvSnapshot* p_snapshot, const void* p_data, uint64_t size, uint32_t kind) {
+  if (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS) {
+    return false;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = SynchronizeDescriptorSets(p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  if (size > UINT32_MAX) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED);
+    return false;
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
-    result = ParseExecutionModes(&parser, p_module);
-    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  if (p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) {
+    const SpvReflectPrvSnapshotRegion* p_region = NULL;
+    if (p_snapshot->region_cursor < p_snapshot->region_count) {
+      p_region = &p_snapshot->regions[p_snapshot->region_cursor];
+    }
+    if (IsNull(p_region) || (p_region->p_data != p_data) || (p_region->size != size) || (p_region->kind != kind)) {
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+      return false;
+    }
+    ++p_snapshot->region_cursor;
+    return true;
   }
 
-  // Destroy module if parse was not successful
-  if (result != SPV_REFLECT_RESULT_SUCCESS) {
-    spvReflectDestroyShaderModule(p_module);
+  void* p_regions =
+      GrowArray(p_snapshot->regions, &p_snapshot->region_capacity, p_snapshot->region_count, sizeof(*p_snapshot->regions));
+  if (IsNull(p_regions)) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED);
+    return false;
   }
+  p_snapshot->regions = (SpvReflectPrvSnapshotRegion*)p_regions;
+  SpvReflectPrvSnapshotRegion* p_region = &p_snapshot->regions[p_snapshot->region_count++];
+  p_region->p_data = (uint8_t*)p_data;
+  p_region->size = (uint32_t)size;
+  p_region->kind = kind;
+  return true;
+}
 
-  DestroyParser(&parser);
-
-  return result;
+// A NULL array must be empty, or whatever walks the module would follow it.
+static bool SnapshotAddArray(SpvReflectPrvSnapshot* p_snapshot, const void* p_array, uint32_t count, size_t element_size,
+                             uint32_t kind) {
+  if (IsNull(p_array)) {
+    if (count > 0) {
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+    }
+    return false;
+  }
+  return SnapshotAddRegion(p_snapshot, p_array, (uint64_t)count * element_size, kind);
 }
 
-SpvReflectResult spvReflectCreateShaderModule(size_t size, const void* p_code, SpvReflectShaderModule* p_module) {
-  return CreateShaderModule(0, size, p_code, p_module);
+static void SnapshotAddStringRegion(SpvReflectPrvSnapshot* p_snapshot, const char* p_string) {
+  if (IsNull(p_string) || (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS)) {
+    return;
+  }
+  // A loaded string was checked to end exactly at the end of its region
+  size_t size = 0;
+  if (p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) {
+    if (p_snapshot->region_cursor < p_snapshot->region_count) {
+      size = p_snapshot->regions[p_snapshot->region_cursor].size;
+    }
+  } else {
+    size = strlen(p_string) + 1;
+  }
+  SnapshotAddRegion(p_snapshot, p_string, size, SPV_REFLECT_PRV_REGION_STRING);
 }
 
-SpvReflectResult spvReflectCreateShaderModule2(uint32_t flags, size_t size, const void* p_code, SpvReflectShaderModule* p_module) {
-  return CreateShaderModule(flags, size, p_code, p_module);
+static bool SnapshotEnterMember(SpvReflectPrvSnapshot* p_snapshot, uint32_t depth) {
+  if (depth > SPV_REFLECT_PRV_SNAPSHOT_MAX_DEPTH) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED);
+    return false;
+  }
+  return true;
 }
 
-SpvReflectResult spvReflectGetShaderModule(size_t size, const void* p_code, SpvReflectShaderModule* p_module) {
-  return spvReflectCreateShaderModule(size, p_code, p_module);
+// Returns true if p_type shares the members of a struct type, which must be
+// one of the first type_index module types and have as many members.
+static bool SnapshotSharesStructMembers(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectShaderModule* p_module,
+                                        size_t type_index, const SpvReflectTypeDescription* p_type) {
+  if (!SharesStructMembers(p_type)) {
+    return false;
+  }
+  uintptr_t offset = (uintptr_t)p_type->struct_type_description - (uintptr_t)p_module->_internal->type_descriptions;
+  if ((offset % sizeof(*p_type) != 0) || (offset / sizeof(*p_type) >= type_index) ||
+      (p_type->member_count != p_type->struct_type_description->member_count)) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+  }
+  return true;
 }
 
-static void SafeFreeTypes(SpvReflectTypeDescription* p_type) {
-  if (IsNull(p_type) || p_type->copied) {
+// Follows the ownership rules of SafeFreeTypes. type_index is the index of
+// the module type p_type belongs to.
+static void CollectTypeRegions(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectShaderModule* p_module, size_t type_index,
+                               const SpvReflectTypeDescription* p_type, uint32_t depth) {
+  if (p_type->copied || SnapshotSharesStructMembers(p_snapshot, p_module, type_index, p_type) ||
+      !SnapshotEnterMember(p_snapshot, depth)) {
     return;
   }
-
-  if (IsNotNull(p_type->members)) {
-    for (size_t i = 0; i < p_type->member_count; ++i) {
-      SpvReflectTypeDescription* p_member = &p_type->members[i];
-      SafeFreeTypes(p_member);
+  if (SnapshotAddArray(p_snapshot, p_type->members, p_type->member_count, sizeof(*p_type->members),
+                       SPV_REFLECT_PRV_REGION_TYPES)) {
+    for (uint32_t i = 0; i < p_type->member_count; ++i) {
+      CollectTypeRegions(p_snapshot, p_module, type_index, &p_type->members[i], depth + 1);
     }
-
-    SafeFree(p_type->members);
-    p_type->members = NULL;
   }
 }
 
-static void SafeFreeBlockVariables(SpvReflectBlockVariable* p_block) {
-  if (IsNull(p_block)) {
+// Follows the ownership rules of SafeFreeBlockVariables. Only members copy
+// the blocks they point at. A loaded member must fit in its block, unless
+// the block is a pointer whose members describe what it points at.
+static void CollectBlockVariableRegions(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectBlockVariable* p_block, uint32_t depth) {
+  bool copy = (p_block->flags & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY) != 0;
+  SnapshotCheck(p_snapshot, !copy || (depth > 0));
+  if (copy || !SnapshotEnterMember(p_snapshot, depth)) {
     return;
   }
+  if (SnapshotAddArray(p_snapshot, p_block->members, p_block->member_count, sizeof(*p_block->members),
+                       SPV_REFLECT_PRV_REGION_BLOCKS)) {
+    bool pointer = IsNotNull(p_block->type_description) && (p_block->type_description->op == SpvOpTypePointer);
+    for (uint32_t i = 0; i < p_block->member_count; ++i) {
+      const SpvReflectBlockVariable* p_member = &p_block->members[i];
+      SnapshotCheck(p_snapshot, pointer || (p_block->size == 0) || ((uint64_t)p_member->offset + p_member->size <= p_block->size));
+      CollectBlockVariableRegions(p_snapshot, p_member, depth + 1);
+    }
+  }
+}
 
-  // We share pointers to Physical Pointer structs and don't want to double free
-  if (p_block->flags & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY) {
+static void CollectInterfaceVariableRegions(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectInterfaceVariable* p_variable,
+                                            uint32_t depth) {
+  if (!SnapshotEnterMember(p_snapshot, depth)) {
     return;
   }
-
-  if (IsNotNull(p_block->members)) {
-    for (size_t i = 0; i < p_block->member_count; ++i) {
-      SpvReflectBlockVariable* p_member = &p_block->members[i];
-      SafeFreeBlockVariables(p_member);
+  if (SnapshotAddArray(p_snapshot, p_variable->members, p_variable->member_count, sizeof(*p_variable->members),
+                       SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES)) {
+    for (uint32_t i = 0; i < p_variable->member_count; ++i) {
+      CollectInterfaceVariableRegions(p_snapshot, &p_variable->members[i], depth + 1);
     }
-
-    SafeFree(p_block->members);
-    p_block->members = NULL;
   }
 }
 
-static void SafeFreeInterfaceVariable(SpvReflectInterfaceVariable* p_interface) {
-  if (IsNull(p_interface)) {
-    return;
+// Loaded input and output variables must be distinct top level variables of
+// the entry point in its order, since members are walked from them.
+static void CollectInterfaceVariablePointerRegion(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectEntryPoint* p_entry,
+                                                  SpvReflectInterfaceVariable* const* pp_variables, uint32_t count,
+                                                  SpvStorageClass storage_class) {
+  if (SnapshotAddArray(p_snapshot, pp_variables, count, sizeof(*pp_variables),
+                       SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS)) {
+    for (uint32_t i = 0; i < count; ++i) {
+      const SpvReflectInterfaceVariable* p_variable = pp_variables[i];
+      SnapshotCheck(p_snapshot, (p_variable >= p_entry->interface_variables) &&
+                                    (p_variable < p_entry->interface_variables + p_entry->interface_variable_count) &&
+                                    ((i == 0) || (pp_variables[i - 1] < p_variable)));
+      if (p_snapshot->result == SPV_REFLECT_RESULT_SUCCESS) {
+        SnapshotCheck(p_snapshot, p_variable->storage_class == storage_class);
+      }
+    }
   }
+}
 
-  if (IsNotNull(p_interface->members)) {
-    for (size_t i = 0; i < p_interface->member_count; ++i) {
-      SpvReflectInterfaceVariable* p_member = &p_interface->members[i];
-      SafeFreeInterfaceVariable(p_member);
+// Loaded bindings must be in the set that lists them.
+static void CollectDescriptorSetRegions(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectDescriptorSet* p_set) {
+  if (SnapshotAddArray(p_snapshot, p_set->bindings, p_set->binding_count, sizeof(*p_set->bindings),
+                       SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDING_POINTERS)) {
+    for (uint32_t i = 0; i < p_set->binding_count; ++i) {
+      SnapshotCheck(p_snapshot, p_set->bindings[i]->set == p_set->set);
     }
-
-    SafeFree(p_interface->members);
-    p_interface->members = NULL;
   }
 }
 
-void spvReflectDestroyShaderModule(SpvReflectShaderModule* p_module) {
-  if (IsNull(p_module->_internal)) {
-    return;
+// Loaded ids must be sorted, since they are binary searched.
+static void CollectSortedIdRegion(SpvReflectPrvSnapshot* p_snapshot, const uint32_t* p_ids, uint32_t count) {
+  if (SnapshotAddArray(p_snapshot, p_ids, count, sizeof(*p_ids), SPV_REFLECT_PRV_REGION_WORDS)) {
+    for (uint32_t i = 1; i < count; ++i) {
+      SnapshotCheck(p_snapshot, p_ids[i - 1] < p_ids[i]);
+    }
   }
+}
 
-  SafeFree(p_module->source_source);
+// Mirrors spvReflectDestroyShaderModule.
+static void CollectModuleRegions(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectShaderModule* p_module) {
+  SnapshotAddRegion(p_snapshot, p_module, sizeof(*p_module), SPV_REFLECT_PRV_REGION_MODULE);
+  SnapshotAddStringRegion(p_snapshot, p_module->source_source);
 
-  // Descriptor set bindings
-  for (size_t i = 0; i < p_module->descriptor_set_count; ++i) {
-    SpvReflectDescriptorSet* p_set = &p_module->descriptor_sets[i];
-    free(p_set->bindings);
+  if (p_module->descriptor_set_count > SPV_REFLECT_MAX_DESCRIPTOR_SETS) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+    return;
   }
-
-  // Descriptor binding blocks
-  for (size_t i = 0; i < p_module->descriptor_binding_count; ++i) {
-    SpvReflectDescriptorBinding* p_descriptor = &p_module->descriptor_bindings[i];
-    if (IsNotNull(p_descriptor->byte_address_buffer_offsets)) {
-      SafeFree(p_descriptor->byte_address_buffer_offsets);
-    }
-    SafeFreeBlockVariables(&p_descriptor->block);
+  for (uint32_t i = 0; i < p_module->descriptor_set_count; ++i) {
+    CollectDescriptorSetRegions(p_snapshot, &p_module->descriptor_sets[i]);
+  }
+
+  if (SnapshotAddArray(p_snapshot, p_module->descriptor_bindings, p_module->descriptor_binding_count,
+                       sizeof(*p_module->descriptor_bindings), SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDINGS)) {
+    // Found from the members again, since a loaded module has no owners yet
+    uint32_t* p_owners = (uint32_t*)calloc(Max(p_module->descriptor_binding_count, 1), sizeof(*p_owners));
+    if (IsNull(p_owners) || (FindDescriptorBlockOwners(p_module, p_owners) != SPV_REFLECT_RESULT_SUCCESS)) {
+      SafeFree(p_owners);
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED);
+      return;
+    }
+    for (uint32_t i = 0; i < p_module->descriptor_binding_count; ++i) {
+      const SpvReflectDescriptorBinding* p_binding = &p_module->descriptor_bindings[i];
+      SnapshotAddArray(p_snapshot, p_binding->byte_address_buffer_offsets, p_binding->byte_address_buffer_offset_count,
+                       sizeof(*p_binding->byte_address_buffer_offsets), SPV_REFLECT_PRV_REGION_WORDS);
+      // Counters are storage buffers without counters of their own
+      const SpvReflectDescriptorBinding* p_counter = p_binding->uav_counter_binding;
+      SnapshotCheck(p_snapshot, IsNull(p_counter) || ((p_counter->descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER) &&
+                                                      IsNull(p_counter->uav_counter_binding)));
+      if (p_owners[i] == i) {
+        CollectBlockVariableRegions(p_snapshot, &p_binding->block, 0);
+      } else if ((p_binding->block.member_count != p_module->descriptor_bindings[p_owners[i]].block.member_count) ||
+                 (p_binding->block.flags & SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY)) {
+        SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+      }
+    }
+    SafeFree(p_owners);
+  }
+
+  if (SnapshotAddArray(p_snapshot, p_module->entry_points, p_module->entry_point_count, sizeof(*p_module->entry_points),
+                       SPV_REFLECT_PRV_REGION_ENTRY_POINTS)) {
+    for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
+      const SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+      if (SnapshotAddArray(p_snapshot, p_entry->interface_variables, p_entry->interface_variable_count,
+                           sizeof(*p_entry->interface_variables), SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES)) {
+        for (uint32_t j = 0; j < p_entry->interface_variable_count; ++j) {
+          CollectInterfaceVariableRegions(p_snapshot, &p_entry->interface_variables[j], 0);
+        }
+      }
+      if (SnapshotAddArray(p_snapshot, p_entry->descriptor_sets, p_entry->descriptor_set_count, sizeof(*p_entry->descriptor_sets),
+                           SPV_REFLECT_PRV_REGION_DESCRIPTOR_SETS)) {
+        for (uint32_t j = 0; j < p_entry->descriptor_set_count; ++j) {
+          CollectDescriptorSetRegions(p_snapshot, &p_entry->descriptor_sets[j]);
+        }
+      }
+      CollectInterfaceVariablePointerRegion(p_snapshot, p_entry, p_entry->input_variables, p_entry->input_variable_count,
+                                            SpvStorageClassInput);
+      CollectInterfaceVariablePointerRegion(p_snapshot, p_entry, p_entry->output_variables, p_entry->output_variable_count,
+                                            SpvStorageClassOutput);
+      CollectSortedIdRegion(p_snapshot, p_entry->used_uniforms, p_entry->used_uniform_count);
+      CollectSortedIdRegion(p_snapshot, p_entry->used_push_constants, p_entry->used_push_constant_count);
+      SnapshotAddArray(p_snapshot, p_entry->execution_modes, p_entry->execution_mode_count, sizeof(*p_entry->execution_modes),
+                       SPV_REFLECT_PRV_REGION_WORDS);
+      SnapshotAddArray(p_snapshot, p_entry->resource_heap_accesses, p_entry->resource_heap_access_count,
+                       sizeof(*p_entry->resource_heap_accesses), SPV_REFLECT_PRV_REGION_RESOURCE_HEAP_ACCESSES);
+      SnapshotAddArray(p_snapshot, p_entry->sampler_heap_accesses, p_entry->sampler_heap_access_count,
+                       sizeof(*p_entry->sampler_heap_accesses), SPV_REFLECT_PRV_REGION_SAMPLER_HEAP_ACCESSES);
+    }
+  }
+  if (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS) {
+    return;
+  }
+  // The module shares the variables of its first entry point
+  if (p_module->entry_point_count > 0) {
+    const SpvReflectEntryPoint* p_entry = &p_module->entry_points[0];
+    if ((p_module->input_variables != p_entry->input_variables) ||
+        (p_module->input_variable_count != p_entry->input_variable_count) ||
+        (p_module->output_variables != p_entry->output_variables) ||
+        (p_module->output_variable_count != p_entry->output_variable_count) ||
+        (p_module->interface_variables != p_entry->interface_variables) ||
+        (p_module->interface_variable_count != p_entry->interface_variable_count)) {
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+      return;
+    }
+  } else if ((p_module->input_variable_count > 0) || (p_module->output_variable_count > 0) ||
+             (p_module->interface_variable_count > 0)) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+    return;
   }
-  SafeFree(p_module->descriptor_bindings);
 
-  // Entry points
-  for (size_t i = 0; i < p_module->entry_point_count; ++i) {
-    SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
-    for (size_t j = 0; j < p_entry->interface_variable_count; j++) {
-      SafeFreeInterfaceVariable(&p_entry->interface_variables[j]);
-    }
-    for (uint32_t j = 0; j < p_entry->descriptor_set_count; ++j) {
-      SafeFree(p_entry->descriptor_sets[j].bindings);
+  SnapshotAddArray(p_snapshot, p_module->capabilities, p_module->capability_count, sizeof(*p_module->capabilities),
+                   SPV_REFLECT_PRV_REGION_CAPABILITIES);
+  SnapshotAddArray(p_snapshot, p_module->spec_constants, p_module->spec_constant_count, sizeof(*p_module->spec_constants),
+                   SPV_REFLECT_PRV_REGION_SPEC_CONSTANTS);
+
+  if (SnapshotAddArray(p_snapshot, p_module->push_constant_blocks, p_module->push_constant_block_count,
+                       sizeof(*p_module->push_constant_blocks), SPV_REFLECT_PRV_REGION_BLOCKS)) {
+    for (uint32_t i = 0; i < p_module->push_constant_block_count; ++i) {
+      CollectBlockVariableRegions(p_snapshot, &p_module->push_constant_blocks[i], 0);
     }
-    SafeFree(p_entry->descriptor_sets);
-    SafeFree(p_entry->input_variables);
-    SafeFree(p_entry->output_variables);
-    SafeFree(p_entry->interface_variables);
-    SafeFree(p_entry->used_uniforms);
-    SafeFree(p_entry->used_push_constants);
-    SafeFree(p_entry->execution_modes);
-    SafeFree(p_entry->resource_heap_accesses);
-    SafeFree(p_entry->sampler_heap_accesses);
   }
-  SafeFree(p_module->capabilities);
-  SafeFree(p_module->entry_points);
-  SafeFree(p_module->spec_constants);
 
-  // Push constants
-  for (size_t i = 0; i < p_module->push_constant_block_count; ++i) {
-    SafeFreeBlockVariables(&p_module->push_constant_blocks[i]);
+  if (p_module->_internal->type_description_count > UINT32_MAX) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED);
+    return;
   }
-  SafeFree(p_module->push_constant_blocks);
-
-  // Type infos
-  for (size_t i = 0; i < p_module->_internal->type_description_count; ++i) {
-    SpvReflectTypeDescription* p_type = &p_module->_internal->type_descriptions[i];
-    if (IsNotNull(p_type->members)) {
-      SafeFreeTypes(p_type);
+  uint32_t type_count = (uint32_t)p_module->_internal->type_description_count;
+  const SpvReflectTypeDescription* p_types = p_module->_internal->type_descriptions;
+  if (SnapshotAddArray(p_snapshot, p_types, type_count, sizeof(*p_types), SPV_REFLECT_PRV_REGION_TYPES)) {
+    for (uint32_t i = 0; i < type_count; ++i) {
+      // The members of top level types are owned even if they are copies,
+      // which the parser only makes of members
+      const SpvReflectTypeDescription* p_type = &p_types[i];
+      SnapshotCheck(p_snapshot, !p_type->copied);
+      if (!SnapshotSharesStructMembers(p_snapshot, p_module, i, p_type) &&
+          SnapshotAddArray(p_snapshot, p_type->members, p_type->member_count, sizeof(*p_type->members),
+                           SPV_REFLECT_PRV_REGION_TYPES) &&
+          !p_type->copied) {
+        for (uint32_t j = 0; j < p_type->member_count; ++j) {
+          CollectTypeRegions(p_snapshot, p_module, i, &p_type->members[j], 1);
+        }
+      }
     }
-    SafeFree(p_type->members);
   }
-  SafeFree(p_module->_internal->type_descriptions);
+}
 
-  // Free SPIR-V code if there was a copy
-  if ((p_module->_internal->module_flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) == 0) {
-    SafeFree(p_module->_internal->spirv_code);
-  }
-  // Free internal
-  SafeFree(p_module->_internal);
+static int SortCompareSnapshotAddress(const void* a, const void* b) {
+  const SpvReflectPrvSnapshotAddress* p_a = (const SpvReflectPrvSnapshotAddress*)a;
+  const SpvReflectPrvSnapshotAddress* p_b = (const SpvReflectPrvSnapshotAddress*)b;
+  return (p_a->address < p_b->address) ? -1 : ((p_a->address > p_b->address) ? 1 : 0);
 }
 
-uint32_t spvReflectGetCodeSize(const SpvReflectShaderModule* p_module) {
-  if (IsNull(p_module)) {
-    return 0;
+// Sorts the collected regions by address, to find what pointers point at.
+static void SortSnapshotRegions(SpvReflectPrvSnapshot* p_snapshot) {
+  if (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS) {
+    return;
   }
-
-  return (uint32_t)(p_module->_internal->spirv_size);
+  p_snapshot->sorted_regions =
+      (SpvReflectPrvSnapshotAddress*)calloc(p_snapshot->region_count, sizeof(*p_snapshot->sorted_regions));
+  if (IsNull(p_snapshot->sorted_regions)) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED);
+    return;
+  }
+  for (uint32_t i = 0; i < p_snapshot->region_count; ++i) {
+    p_snapshot->sorted_regions[i].address = (uintptr_t)p_snapshot->regions[i].p_data;
+    p_snapshot->sorted_regions[i].region = i;
+  }
+  qsort(p_snapshot->sorted_regions, p_snapshot->region_count, sizeof(*p_snapshot->sorted_regions), SortCompareSnapshotAddress);
 }
 
-const uint32_t* spvReflectGetCode(const SpvReflectShaderModule* p_module) {
-  if (IsNull(p_module)) {
-    return NULL;
+// Returns the region that contains address, or INVALID_VALUE.
+static uint32_t FindSnapshotRegion(const SpvReflectPrvSnapshot* p_snapshot, uintptr_t address) {
+  uint32_t lo = 0;
+  uint32_t hi = p_snapshot->region_count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (p_snapshot->sorted_regions[mid].address <= address) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
-
-  return p_module->_internal->spirv_code;
+  if (lo == 0) {
+    return (uint32_t)INVALID_VALUE;
+  }
+  const SpvReflectPrvSnapshotAddress* p_start = &p_snapshot->sorted_regions[lo - 1];
+  return (address - p_start->address <= p_snapshot->regions[p_start->region].size) ? p_start->region : (uint32_t)INVALID_VALUE;
 }
 
-const SpvReflectEntryPoint* spvReflectGetEntryPoint(const SpvReflectShaderModule* p_module, const char* entry_point) {
-  if (IsNull(p_module) || IsNull(entry_point)) {
-    return NULL;
-  }
+static void StoreLittleEndian(uint8_t* p_out, uint32_t value) {
+  p_out[0] = (uint8_t)value;
+  p_out[1] = (uint8_t)(value >> 8);
+  p_out[2] = (uint8_t)(value >> 16);
+  p_out[3] = (uint8_t)(value >> 24);
+}
 
-  for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
-    if (strcmp(p_module->entry_points[i].name, entry_point) == 0) {
-      return &p_module->entry_points[i];
-    }
-  }
-  return NULL;
+static uint32_t LoadLittleEndian(const uint8_t* p_in) {
+  return (uint32_t)p_in[0] | ((uint32_t)p_in[1] << 8) | ((uint32_t)p_in[2] << 16) | ((uint32_t)p_in[3] << 24);
 }
 
-SpvReflectResult spvReflectEnumerateDescriptorBindings(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                       SpvReflectDescriptorBinding** pp_bindings) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+// Writes *p_value, or reads it.
+static void SnapshotWord(SpvReflectPrvSnapshot* p_snapshot, uint32_t* p_value) {
+  if (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS) {
+    return;
   }
-
-  if (IsNotNull(pp_bindings)) {
-    if (*p_count != p_module->descriptor_binding_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+  if (p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_WRITE) {
+    void* p_out = GrowArray(p_snapshot->p_out, &p_snapshot->word_capacity, p_snapshot->word_count, sizeof(uint32_t));
+    if (IsNull(p_out)) {
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED);
+      return;
     }
-
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectDescriptorBinding* p_bindings = (SpvReflectDescriptorBinding*)&p_module->descriptor_bindings[index];
-      pp_bindings[index] = p_bindings;
+    p_snapshot->p_out = (uint8_t*)p_out;
+    StoreLittleEndian(p_snapshot->p_out + (size_t)p_snapshot->word_count++ * sizeof(uint32_t), *p_value);
+  } else if (p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) {
+    if (p_snapshot->word_cursor >= p_snapshot->word_count) {
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+      return;
     }
-  } else {
-    *p_count = p_module->descriptor_binding_count;
+    *p_value = LoadLittleEndian(p_snapshot->p_in + (size_t)p_snapshot->word_cursor++ * sizeof(uint32_t));
   }
+}
 
-  return SPV_REFLECT_RESULT_SUCCESS;
+// Writes or reads a field that is not a uint32_t, such as an enum.
+#define SNAPSHOT_FIELD(p_snapshot, type, field)                \
+  do {                                                         \
+    uint32_t value = (uint32_t)(field);                        \
+    SnapshotWord((p_snapshot), &value);                        \
+    if ((p_snapshot)->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) { \
+      (field) = (type)value;                                   \
+    }                                                          \
+  } while (0)
+
+static bool IsSnapshotRegionTarget(const SpvReflectPrvSnapshot* p_snapshot, uint32_t target) {
+  return (target != SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL) && (target <= p_snapshot->region_count);
 }
 
-SpvReflectResult spvReflectEnumerateEntryPointDescriptorBindings(const SpvReflectShaderModule* p_module, const char* entry_point,
-                                                                 uint32_t* p_count, SpvReflectDescriptorBinding** pp_bindings) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static uint32_t SnapshotElementCount(const SpvReflectPrvSnapshot* p_snapshot, uint32_t target) {
+  const SpvReflectPrvSnapshotRegion* p_region = &p_snapshot->regions[target - 1];
+  return (uint32_t)(p_region->size / SnapshotElementSize(p_region->kind));
+}
+
+// Writes or reads the pointer stored at p_field, which must be NULL, point
+// at an element of a region of the given kind, or at the end of an empty
+// one, or for names and default values, into the code or at a boolean spec
+// constant value. Returns its target, with the element index or code byte
+// offset in *p_index.
+static uint32_t SnapshotPointer(SpvReflectPrvSnapshot* p_snapshot, void* p_field, uint32_t kind, uint32_t* p_index) {
+  uint32_t target = SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL;
+  uint32_t index = 0;
+  if (p_snapshot->mode != SPV_REFLECT_PRV_SNAPSHOT_READ) {
+    const uint8_t* p_target = NULL;
+    memcpy(&p_target, p_field, sizeof(p_target));
+    uintptr_t address = (uintptr_t)p_target;
+    uintptr_t code_begin = (uintptr_t)p_snapshot->p_code;
+    if (IsNull(p_target)) {
+      target = SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL;
+    } else if ((address >= code_begin) && (address - code_begin < p_snapshot->code_size)) {
+      target = SPV_REFLECT_PRV_SNAPSHOT_TARGET_CODE;
+      index = (uint32_t)(address - code_begin);
+    } else if (p_target == (const uint8_t*)&spec_constant_true_value) {
+      target = SPV_REFLECT_PRV_SNAPSHOT_TARGET_TRUE_VALUE;
+    } else if (p_target == (const uint8_t*)&spec_constant_false_value) {
+      target = SPV_REFLECT_PRV_SNAPSHOT_TARGET_FALSE_VALUE;
+    } else {
+      uint32_t region = FindSnapshotRegion(p_snapshot, address);
+      const SpvReflectPrvSnapshotRegion* p_region = (region < p_snapshot->region_count) ? &p_snapshot->regions[region] : NULL;
+      size_t offset = IsNotNull(p_region) ? (size_t)(address - (uintptr_t)p_region->p_data) : 0;
+      if (IsNull(p_region) || (p_region->kind != kind) || ((offset % SnapshotElementSize(kind)) != 0) ||
+          ((offset == p_region->size) && (offset > 0))) {
+        SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+        return SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL;
+      }
+      target = region + 1;
+      index = (uint32_t)(offset / SnapshotElementSize(kind));
+    }
+  }
+
+  SnapshotWord(p_snapshot, &target);
+  if (IsSnapshotRegionTarget(p_snapshot, target) || (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_CODE)) {
+    SnapshotWord(p_snapshot, &index);
+  }
+  *p_index = index;
+  if ((p_snapshot->mode != SPV_REFLECT_PRV_SNAPSHOT_READ) || (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS)) {
+    return target;
+  }
+
+  const uint8_t* p_resolved = NULL;
+  bool valid = true;
+  if (IsSnapshotRegionTarget(p_snapshot, target)) {
+    const SpvReflectPrvSnapshotRegion* p_region = &p_snapshot->regions[target - 1];
+    valid = (p_region->kind == kind) && ((index < SnapshotElementCount(p_snapshot, target)) || (index == 0));
+    p_resolved = p_region->p_data + (size_t)index * SnapshotElementSize(kind);
+  } else if (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_CODE) {
+    valid = index < p_snapshot->code_size;
+    p_resolved = p_snapshot->p_code + index;
+  } else if (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_TRUE_VALUE) {
+    p_resolved = (const uint8_t*)&spec_constant_true_value;
+  } else if (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_FALSE_VALUE) {
+    p_resolved = (const uint8_t*)&spec_constant_false_value;
+  } else {
+    valid = (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL);
   }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  if (!valid) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+    return SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL;
   }
+  memcpy(p_field, &p_resolved, sizeof(p_resolved));
+  return target;
+}
 
-  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-  if (IsNull(p_entry)) {
-    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+// An array pointer must be NULL and the array empty, or point at the start
+// of a region of count elements.
+static void SnapshotArray(SpvReflectPrvSnapshot* p_snapshot, void* p_field, uint32_t count, uint32_t kind) {
+  uint32_t index = 0;
+  uint32_t target = SnapshotPointer(p_snapshot, p_field, kind, &index);
+  if (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS) {
+    return;
   }
-
-  uint32_t count = 0;
-  for (uint32_t i = 0; i < p_module->descriptor_binding_count; ++i) {
-    bool found = SearchSortedUint32(p_entry->used_uniforms, p_entry->used_uniform_count, p_module->descriptor_bindings[i].spirv_id);
-    if (found) {
-      if (IsNotNull(pp_bindings)) {
-        if (count >= *p_count) {
-          return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-        }
-        pp_bindings[count++] = (SpvReflectDescriptorBinding*)&p_module->descriptor_bindings[i];
-      } else {
-        ++count;
-      }
+  if (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL) {
+    if (count > 0) {
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
     }
+  } else if (!IsSnapshotRegionTarget(p_snapshot, target) || (index != 0) || (SnapshotElementCount(p_snapshot, target) != count)) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
   }
-  if (IsNotNull(pp_bindings)) {
-    if (count != *p_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
+}
+
+static void SnapshotElement(SpvReflectPrvSnapshot* p_snapshot, void* p_field, uint32_t kind, bool required) {
+  uint32_t index = 0;
+  uint32_t target = SnapshotPointer(p_snapshot, p_field, kind, &index);
+  if (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL) {
+    SnapshotCheck(p_snapshot, !required);
   } else {
-    *p_count = count;
+    SnapshotCheck(p_snapshot, IsSnapshotRegionTarget(p_snapshot, target) && (index < SnapshotElementCount(p_snapshot, target)));
   }
-  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-SpvReflectResult spvReflectEnumerateDescriptorSets(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                   SpvReflectDescriptorSet** pp_sets) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static void SnapshotAddCodeReference(SpvReflectPrvSnapshot* p_snapshot, void* p_field, uint32_t offset, uint32_t size) {
+  if ((p_snapshot->mode != SPV_REFLECT_PRV_SNAPSHOT_FIND_CODE) || (p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS)) {
+    return;
   }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  void* p_references = GrowArray(p_snapshot->code_references, &p_snapshot->code_reference_capacity,
+                                 p_snapshot->code_reference_count, sizeof(*p_snapshot->code_references));
+  if (IsNull(p_references)) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED);
+    return;
   }
+  p_snapshot->code_references = (SpvReflectPrvSnapshotCodeReference*)p_references;
+  SpvReflectPrvSnapshotCodeReference* p_reference = &p_snapshot->code_references[p_snapshot->code_reference_count++];
+  p_reference->p_field = p_field;
+  p_reference->offset = offset;
+  p_reference->size = size;
+}
 
-  if (IsNotNull(pp_sets)) {
-    if (*p_count != p_module->descriptor_set_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
-
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectDescriptorSet* p_set = (SpvReflectDescriptorSet*)&p_module->descriptor_sets[index];
-      pp_sets[index] = p_set;
+// A string points into the code, or at the start of a string region.
+static void SnapshotString(SpvReflectPrvSnapshot* p_snapshot, const char** p_field) {
+  uint32_t offset = 0;
+  uint32_t target = SnapshotPointer(p_snapshot, (void*)p_field, SPV_REFLECT_PRV_REGION_STRING, &offset);
+  if ((p_snapshot->result != SPV_REFLECT_RESULT_SUCCESS) || (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_NULL)) {
+    return;
+  }
+  if (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_CODE) {
+    const char* p_end = (const char*)memchr(*p_field, 0, p_snapshot->code_size - offset);
+    SnapshotCheck(p_snapshot, IsNotNull(p_end));
+    if (IsNotNull(p_end)) {
+      SnapshotAddCodeReference(p_snapshot, (void*)p_field, offset, (uint32_t)(p_end - *p_field) + 1);
     }
   } else {
-    *p_count = p_module->descriptor_set_count;
+    SnapshotCheck(p_snapshot, IsSnapshotRegionTarget(p_snapshot, target) && (offset == 0));
   }
-
-  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-SpvReflectResult spvReflectEnumerateEntryPointDescriptorSets(const SpvReflectShaderModule* p_module, const char* entry_point,
-                                                             uint32_t* p_count, SpvReflectDescriptorSet** pp_sets) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
-
-  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-  if (IsNull(p_entry)) {
-    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+// A default value points into the code or at a boolean value. No region
+// holds default values.
+static void SnapshotDefaultValue(SpvReflectPrvSnapshot* p_snapshot, SpvReflectSpecializationConstant* p_spec_constant) {
+  SnapshotWord(p_snapshot, &p_spec_constant->default_value_size);
+  uint32_t size = p_spec_constant->default_value_size;
+  uint32_t offset = 0;
+  uint32_t target = SnapshotPointer(p_snapshot, &p_spec_constant->default_value, SPV_REFLECT_PRV_REGION_KIND_COUNT, &offset);
+  if (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_CODE) {
+    SnapshotCheck(p_snapshot, size <= p_snapshot->code_size - offset);
+    SnapshotAddCodeReference(p_snapshot, &p_spec_constant->default_value, offset, size);
+  } else if ((target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_TRUE_VALUE) || (target == SPV_REFLECT_PRV_SNAPSHOT_TARGET_FALSE_VALUE)) {
+    SnapshotCheck(p_snapshot, size <= sizeof(spec_constant_true_value));
   }
+}
 
-  if (IsNotNull(pp_sets)) {
-    if (*p_count != p_entry->descriptor_set_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
+// A word offset is 0 or locates its value in the code.
+static void SnapshotWordOffset(SpvReflectPrvSnapshot* p_snapshot, uint32_t* p_word_offset, uint32_t value) {
+  SnapshotWord(p_snapshot, p_word_offset);
+  uint32_t word_offset = *p_word_offset;
+  SnapshotCheck(p_snapshot, (word_offset == 0) || ((word_offset < p_snapshot->code_size / SPIRV_WORD_SIZE) &&
+                                                   (((const uint32_t*)p_snapshot->p_code)[word_offset] == value)));
+}
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectDescriptorSet* p_set = (SpvReflectDescriptorSet*)&p_entry->descriptor_sets[index];
-      pp_sets[index] = p_set;
-    }
-  } else {
-    *p_count = p_entry->descriptor_set_count;
-  }
+static bool IsValidSnapshotImage(const SpvReflectImageTraits* p_image) {
+  bool valid_dim = ((uint32_t)p_image->dim <= (uint32_t)SpvDimSubpassData) || (p_image->dim == SpvDimTileImageDataEXT);
+  return valid_dim && ((uint32_t)p_image->image_format <= (uint32_t)SpvImageFormatR64i) && (p_image->depth <= 2) &&
+         (p_image->arrayed <= 1) && (p_image->ms <= 1) && (p_image->sampled <= 2);
+}
 
-  return SPV_REFLECT_RESULT_SUCCESS;
+static bool IsValidSnapshotDescriptorType(SpvReflectDescriptorType descriptor_type) {
+  return ((uint32_t)descriptor_type <= (uint32_t)SPV_REFLECT_DESCRIPTOR_TYPE_INPUT_ATTACHMENT) ||
+         (descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR);
 }
 
-SpvReflectResult spvReflectEnumerateInterfaceVariables(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                       SpvReflectInterfaceVariable** pp_variables) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static bool IsValidSnapshotFormat(SpvReflectFormat format) {
+  uint32_t value = (uint32_t)format;
+  if (format == SPV_REFLECT_FORMAT_UNDEFINED) {
+    return true;
   }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  if ((value < (uint32_t)SPV_REFLECT_FORMAT_R16_UINT) || (value > (uint32_t)SPV_REFLECT_FORMAT_R64G64B64A64_SFLOAT)) {
+    return false;
   }
+  // The 16-bit rows skip the normalized and scaled formats
+  uint32_t row_stride = (uint32_t)(SPV_REFLECT_FORMAT_R16G16_UINT - SPV_REFLECT_FORMAT_R16_UINT);
+  return (value >= (uint32_t)SPV_REFLECT_FORMAT_R32_UINT) || (((value - (uint32_t)SPV_REFLECT_FORMAT_R16_UINT) % row_stride) < 3);
+}
 
-  if (IsNotNull(pp_variables)) {
-    if (*p_count != p_module->interface_variable_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
+// 0 for an unknown execution model, or a single stage.
+static bool IsValidSnapshotShaderStage(SpvReflectShaderStageFlagBits shader_stage) {
+  uint32_t value = (uint32_t)shader_stage;
+  return ((value & (value - 1)) == 0) && (value <= (uint32_t)SPV_REFLECT_SHADER_STAGE_CALLABLE_BIT_KHR);
+}
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectInterfaceVariable* p_var = &p_module->interface_variables[index];
-      pp_variables[index] = p_var;
-    }
-  } else {
-    *p_count = p_module->interface_variable_count;
-  }
+static void SnapshotNumericTraits(SpvReflectPrvSnapshot* p_snapshot, SpvReflectNumericTraits* p_numeric) {
+  SnapshotWord(p_snapshot, &p_numeric->scalar.width);
+  SnapshotWord(p_snapshot, &p_numeric->scalar.signedness);
+  SnapshotWord(p_snapshot, &p_numeric->vector.component_count);
+  SnapshotWord(p_snapshot, &p_numeric->matrix.column_count);
+  SnapshotWord(p_snapshot, &p_numeric->matrix.row_count);
+  SnapshotWord(p_snapshot, &p_numeric->matrix.stride);
+  SnapshotCheck(p_snapshot, (p_numeric->scalar.signedness <= 1) && (p_numeric->vector.component_count <= 16) &&
+                                (p_numeric->matrix.column_count <= 4) && (p_numeric->matrix.row_count <= 4));
+}
 
-  return SPV_REFLECT_RESULT_SUCCESS;
+static void SnapshotImageTraits(SpvReflectPrvSnapshot* p_snapshot, SpvReflectImageTraits* p_image) {
+  SNAPSHOT_FIELD(p_snapshot, SpvDim, p_image->dim);
+  SnapshotWord(p_snapshot, &p_image->depth);
+  SnapshotWord(p_snapshot, &p_image->arrayed);
+  SnapshotWord(p_snapshot, &p_image->ms);
+  SnapshotWord(p_snapshot, &p_image->sampled);
+  SNAPSHOT_FIELD(p_snapshot, SpvImageFormat, p_image->image_format);
+  SnapshotCheck(p_snapshot, IsValidSnapshotImage(p_image));
 }
 
-SpvReflectResult spvReflectEnumerateEntryPointInterfaceVariables(const SpvReflectShaderModule* p_module, const char* entry_point,
-                                                                 uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+// Only the used dimensions are stored, so the others must be 0.
+static bool SnapshotDims(SpvReflectPrvSnapshot* p_snapshot, uint32_t* p_dims_count, uint32_t* p_dims, uint32_t* p_spec_ids) {
+  SnapshotWord(p_snapshot, p_dims_count);
+  uint32_t dims_count = *p_dims_count;
+  if (dims_count > SPV_REFLECT_MAX_ARRAY_DIMS) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+    return false;
   }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  for (uint32_t i = 0; i < SPV_REFLECT_MAX_ARRAY_DIMS; ++i) {
+    if (i < dims_count) {
+      SnapshotWord(p_snapshot, &p_dims[i]);
+      if (IsNotNull(p_spec_ids)) {
+        SnapshotWord(p_snapshot, &p_spec_ids[i]);
+      }
+    } else if ((p_dims[i] != 0) || (IsNotNull(p_spec_ids) && (p_spec_ids[i] != 0))) {
+      SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+    }
   }
+  return true;
+}
 
-  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-  if (IsNull(p_entry)) {
-    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-  }
+static void SnapshotArrayTraits(SpvReflectPrvSnapshot* p_snapshot, SpvReflectArrayTraits* p_array) {
+  SnapshotDims(p_snapshot, &p_array->dims_count, p_array->dims, p_array->spec_constant_op_ids);
+  SnapshotWord(p_snapshot, &p_array->stride);
+}
 
-  if (IsNotNull(pp_variables)) {
-    if (*p_count != p_entry->interface_variable_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
+static void SnapshotTypeDescription(SpvReflectPrvSnapshot* p_snapshot, SpvReflectTypeDescription* p_type) {
+  SnapshotWord(p_snapshot, &p_type->id);
+  SNAPSHOT_FIELD(p_snapshot, SpvOp, p_type->op);
+  SnapshotString(p_snapshot, &p_type->type_name);
+  SnapshotString(p_snapshot, &p_type->struct_member_name);
+  SNAPSHOT_FIELD(p_snapshot, int, p_type->storage_class);
+  SnapshotWord(p_snapshot, &p_type->type_flags);
+  SnapshotWord(p_snapshot, &p_type->decoration_flags);
+  SnapshotNumericTraits(p_snapshot, &p_type->traits.numeric);
+  SnapshotImageTraits(p_snapshot, &p_type->traits.image);
+  SnapshotArrayTraits(p_snapshot, &p_type->traits.array);
+  SnapshotElement(p_snapshot, &p_type->struct_type_description, SPV_REFLECT_PRV_REGION_TYPES, false);
+  SnapshotWord(p_snapshot, &p_type->copied);
+  SnapshotWord(p_snapshot, &p_type->member_count);
+  SnapshotArray(p_snapshot, &p_type->members, p_type->member_count, SPV_REFLECT_PRV_REGION_TYPES);
+  SnapshotCheck(p_snapshot, p_type->copied <= 1);
+}
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectInterfaceVariable* p_var = &p_entry->interface_variables[index];
-      pp_variables[index] = p_var;
-    }
-  } else {
-    *p_count = p_entry->interface_variable_count;
-  }
+static void SnapshotBlockVariable(SpvReflectPrvSnapshot* p_snapshot, SpvReflectBlockVariable* p_block) {
+  SnapshotWord(p_snapshot, &p_block->spirv_id);
+  SnapshotString(p_snapshot, &p_block->name);
+  SnapshotWord(p_snapshot, &p_block->offset);
+  SnapshotWord(p_snapshot, &p_block->absolute_offset);
+  SnapshotWord(p_snapshot, &p_block->size);
+  SnapshotWord(p_snapshot, &p_block->padded_size);
+  SnapshotWord(p_snapshot, &p_block->decoration_flags);
+  SnapshotNumericTraits(p_snapshot, &p_block->numeric);
+  SnapshotArrayTraits(p_snapshot, &p_block->array);
+  SnapshotWord(p_snapshot, &p_block->flags);
+  SnapshotWord(p_snapshot, &p_block->member_count);
+  SnapshotArray(p_snapshot, &p_block->members, p_block->member_count, SPV_REFLECT_PRV_REGION_BLOCKS);
+  SnapshotElement(p_snapshot, &p_block->type_description, SPV_REFLECT_PRV_REGION_TYPES, false);
+  SnapshotWordOffset(p_snapshot, &p_block->word_offset.offset, p_block->offset);
+  uint32_t known_flags = SPV_REFLECT_VARIABLE_FLAGS_UNUSED | SPV_REFLECT_VARIABLE_FLAGS_PHYSICAL_POINTER_COPY;
+  SnapshotCheck(p_snapshot, (p_block->size <= p_block->padded_size) && ((p_block->flags & ~known_flags) == 0));
+}
 
-  return SPV_REFLECT_RESULT_SUCCESS;
+static void SnapshotInterfaceVariable(SpvReflectPrvSnapshot* p_snapshot, SpvReflectInterfaceVariable* p_variable) {
+  SnapshotWord(p_snapshot, &p_variable->spirv_id);
+  SnapshotString(p_snapshot, &p_variable->name);
+  SnapshotWord(p_snapshot, &p_variable->location);
+  SnapshotWord(p_snapshot, &p_variable->component);
+  SNAPSHOT_FIELD(p_snapshot, SpvStorageClass, p_variable->storage_class);
+  SnapshotString(p_snapshot, &p_variable->semantic);
+  SnapshotWord(p_snapshot, &p_variable->decoration_flags);
+  SNAPSHOT_FIELD(p_snapshot, int, p_variable->built_in);
+  SnapshotNumericTraits(p_snapshot, &p_variable->numeric);
+  SnapshotArrayTraits(p_snapshot, &p_variable->array);
+  SnapshotWord(p_snapshot, &p_variable->member_count);
+  SnapshotArray(p_snapshot, &p_variable->members, p_variable->member_count, SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES);
+  SNAPSHOT_FIELD(p_snapshot, SpvReflectFormat, p_variable->format);
+  SnapshotElement(p_snapshot, &p_variable->type_description, SPV_REFLECT_PRV_REGION_TYPES, false);
+  SnapshotWordOffset(p_snapshot, &p_variable->word_offset.location, p_variable->location);
+  SnapshotCheck(p_snapshot, IsValidSnapshotFormat(p_variable->format));
 }
 
-SpvReflectResult spvReflectEnumerateInputVariables(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                   SpvReflectInterfaceVariable** pp_variables) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
+static void SnapshotDescriptorBinding(SpvReflectPrvSnapshot* p_snapshot, SpvReflectDescriptorBinding* p_binding) {
+  SnapshotWord(p_snapshot, &p_binding->spirv_id);
+  SnapshotString(p_snapshot, &p_binding->name);
+  SnapshotWord(p_snapshot, &p_binding->binding);
+  SnapshotWord(p_snapshot, &p_binding->input_attachment_index);
+  SnapshotWord(p_snapshot, &p_binding->set);
+  SNAPSHOT_FIELD(p_snapshot, SpvReflectDescriptorType, p_binding->descriptor_type);
+  SNAPSHOT_FIELD(p_snapshot, SpvReflectResourceType, p_binding->resource_type);
+  SnapshotImageTraits(p_snapshot, &p_binding->image);
+  SnapshotBlockVariable(p_snapshot, &p_binding->block);
+  SnapshotDims(p_snapshot, &p_binding->array.dims_count, p_binding->array.dims, NULL);
+  SnapshotWord(p_snapshot, &p_binding->count);
+  SnapshotWord(p_snapshot, &p_binding->accessed);
+  SnapshotWord(p_snapshot, &p_binding->uav_counter_id);
+  SnapshotElement(p_snapshot, &p_binding->uav_counter_binding, SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDINGS, false);
+  SnapshotWord(p_snapshot, &p_binding->byte_address_buffer_offset_count);
+  SnapshotArray(p_snapshot, &p_binding->byte_address_buffer_offsets, p_binding->byte_address_buffer_offset_count,
+                SPV_REFLECT_PRV_REGION_WORDS);
+  SnapshotElement(p_snapshot, &p_binding->type_description, SPV_REFLECT_PRV_REGION_TYPES, false);
+  SnapshotWordOffset(p_snapshot, &p_binding->word_offset.binding, p_binding->binding);
+  SnapshotWordOffset(p_snapshot, &p_binding->word_offset.set, p_binding->set);
+  SnapshotWord(p_snapshot, &p_binding->decoration_flags);
+  SNAPSHOT_FIELD(p_snapshot, SpvReflectUserType, p_binding->user_type);
+  SnapshotCheck(p_snapshot, IsValidSnapshotDescriptorType(p_binding->descriptor_type) &&
+                                (((uint32_t)p_binding->resource_type & ~(uint32_t)0xF) == 0) && (p_binding->accessed <= 1) &&
+                                ((uint32_t)p_binding->user_type <= (uint32_t)SPV_REFLECT_USER_TYPE_TEXTURE_CUBE_ARRAY));
+}
 
-  if (IsNotNull(pp_variables)) {
-    if (*p_count != p_module->input_variable_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
+static void SnapshotDescriptorSet(SpvReflectPrvSnapshot* p_snapshot, SpvReflectDescriptorSet* p_set) {
+  SnapshotWord(p_snapshot, &p_set->set);
+  SnapshotWord(p_snapshot, &p_set->binding_count);
+  SnapshotArray(p_snapshot, &p_set->bindings, p_set->binding_count, SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDING_POINTERS);
+}
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectInterfaceVariable* p_var = p_module->input_variables[index];
-      pp_variables[index] = p_var;
-    }
-  } else {
-    *p_count = p_module->input_variable_count;
+static void SnapshotEntryPoint(SpvReflectPrvSnapshot* p_snapshot, SpvReflectEntryPoint* p_entry) {
+  SnapshotString(p_snapshot, &p_entry->name);
+  SnapshotWord(p_snapshot, &p_entry->id);
+  SNAPSHOT_FIELD(p_snapshot, SpvExecutionModel, p_entry->spirv_execution_model);
+  SNAPSHOT_FIELD(p_snapshot, SpvReflectShaderStageFlagBits, p_entry->shader_stage);
+  SnapshotWord(p_snapshot, &p_entry->input_variable_count);
+  SnapshotArray(p_snapshot, &p_entry->input_variables, p_entry->input_variable_count,
+                SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS);
+  SnapshotWord(p_snapshot, &p_entry->output_variable_count);
+  SnapshotArray(p_snapshot, &p_entry->output_variables, p_entry->output_variable_count,
+                SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS);
+  SnapshotWord(p_snapshot, &p_entry->interface_variable_count);
+  SnapshotArray(p_snapshot, &p_entry->interface_variables, p_entry->interface_variable_count,
+                SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES);
+  SnapshotWord(p_snapshot, &p_entry->descriptor_set_count);
+  SnapshotArray(p_snapshot, &p_entry->descriptor_sets, p_entry->descriptor_set_count, SPV_REFLECT_PRV_REGION_DESCRIPTOR_SETS);
+  SnapshotWord(p_snapshot, &p_entry->used_uniform_count);
+  SnapshotArray(p_snapshot, &p_entry->used_uniforms, p_entry->used_uniform_count, SPV_REFLECT_PRV_REGION_WORDS);
+  SnapshotWord(p_snapshot, &p_entry->used_push_constant_count);
+  SnapshotArray(p_snapshot, &p_entry->used_push_constants, p_entry->used_push_constant_count, SPV_REFLECT_PRV_REGION_WORDS);
+  SnapshotWord(p_snapshot, &p_entry->execution_mode_count);
+  SnapshotArray(p_snapshot, &p_entry->execution_modes, p_entry->execution_mode_count, SPV_REFLECT_PRV_REGION_WORDS);
+  SnapshotWord(p_snapshot, &p_entry->local_size.x);
+  SnapshotWord(p_snapshot, &p_entry->local_size.y);
+  SnapshotWord(p_snapshot, &p_entry->local_size.z);
+  SnapshotWord(p_snapshot, &p_entry->invocations);
+  SnapshotWord(p_snapshot, &p_entry->output_vertices);
+  SnapshotWord(p_snapshot, &p_entry->resource_heap_access_count);
+  SnapshotArray(p_snapshot, &p_entry->resource_heap_accesses, p_entry->resource_heap_access_count,
+                SPV_REFLECT_PRV_REGION_RESOURCE_HEAP_ACCESSES);
+  SnapshotWord(p_snapshot, &p_entry->sampler_heap_access_count);
+  SnapshotArray(p_snapshot, &p_entry->sampler_heap_accesses, p_entry->sampler_heap_access_count,
+                SPV_REFLECT_PRV_REGION_SAMPLER_HEAP_ACCESSES);
+  SnapshotCheck(p_snapshot, IsValidSnapshotShaderStage(p_entry->shader_stage));
+}
+
+// The generator is read from the code and not stored. Only the used
+// descriptor sets are stored.
+static void SnapshotModule(SpvReflectPrvSnapshot* p_snapshot, SpvReflectShaderModule* p_module) {
+  SnapshotString(p_snapshot, &p_module->entry_point_name);
+  SnapshotWord(p_snapshot, &p_module->entry_point_id);
+  SnapshotWord(p_snapshot, &p_module->entry_point_count);
+  SnapshotArray(p_snapshot, &p_module->entry_points, p_module->entry_point_count, SPV_REFLECT_PRV_REGION_ENTRY_POINTS);
+  SNAPSHOT_FIELD(p_snapshot, SpvSourceLanguage, p_module->source_language);
+  SnapshotWord(p_snapshot, &p_module->source_language_version);
+  SnapshotString(p_snapshot, &p_module->source_file);
+  SnapshotString(p_snapshot, &p_module->source_source);
+  SnapshotWord(p_snapshot, &p_module->capability_count);
+  SnapshotArray(p_snapshot, &p_module->capabilities, p_module->capability_count, SPV_REFLECT_PRV_REGION_CAPABILITIES);
+  SNAPSHOT_FIELD(p_snapshot, SpvExecutionModel, p_module->spirv_execution_model);
+  SNAPSHOT_FIELD(p_snapshot, SpvReflectShaderStageFlagBits, p_module->shader_stage);
+  SnapshotWord(p_snapshot, &p_module->descriptor_binding_count);
+  SnapshotArray(p_snapshot, &p_module->descriptor_bindings, p_module->descriptor_binding_count,
+                SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDINGS);
+  SnapshotWord(p_snapshot, &p_module->descriptor_set_count);
+  if (p_module->descriptor_set_count > SPV_REFLECT_MAX_DESCRIPTOR_SETS) {
+    SnapshotFail(p_snapshot, SPV_REFLECT_RESULT_ERROR_PARSE_FAILED);
+    return;
   }
+  for (uint32_t i = 0; i < SPV_REFLECT_MAX_DESCRIPTOR_SETS; ++i) {
+    SpvReflectDescriptorSet* p_set = &p_module->descriptor_sets[i];
+    if (i < p_module->descriptor_set_count) {
+      SnapshotDescriptorSet(p_snapshot, p_set);
+    } else if (p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) {
+      p_set->set = (uint32_t)INVALID_VALUE;
+      p_set->binding_count = 0;
+      p_set->bindings = NULL;
+    }
+  }
+  SnapshotWord(p_snapshot, &p_module->input_variable_count);
+  SnapshotArray(p_snapshot, &p_module->input_variables, p_module->input_variable_count,
+                SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS);
+  SnapshotWord(p_snapshot, &p_module->output_variable_count);
+  SnapshotArray(p_snapshot, &p_module->output_variables, p_module->output_variable_count,
+                SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS);
+  SnapshotWord(p_snapshot, &p_module->interface_variable_count);
+  SnapshotArray(p_snapshot, &p_module->interface_variables, p_module->interface_variable_count,
+                SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES);
+  SnapshotWord(p_snapshot, &p_module->push_constant_block_count);
+  SnapshotArray(p_snapshot, &p_module->push_constant_blocks, p_module->push_constant_block_count, SPV_REFLECT_PRV_REGION_BLOCKS);
+  SnapshotWord(p_snapshot, &p_module->spec_constant_count);
+  SnapshotArray(p_snapshot, &p_module->spec_constants, p_module->spec_constant_count, SPV_REFLECT_PRV_REGION_SPEC_CONSTANTS);
+  uint32_t type_count = (uint32_t)p_module->_internal->type_description_count;
+  SnapshotWord(p_snapshot, &type_count);
+  SnapshotArray(p_snapshot, &p_module->_internal->type_descriptions, type_count, SPV_REFLECT_PRV_REGION_TYPES);
+  if (p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) {
+    p_module->_internal->type_description_count = type_count;
+  }
+  SnapshotCheck(p_snapshot, IsValidSnapshotShaderStage(p_module->shader_stage));
+}
 
-  return SPV_REFLECT_RESULT_SUCCESS;
+// A string region is stored as its bytes, with its NUL, padded to words.
+static void SnapshotStringRegion(SpvReflectPrvSnapshot* p_snapshot, const SpvReflectPrvSnapshotRegion* p_region) {
+  for (uint32_t offset = 0; offset < p_region->size; offset += sizeof(uint32_t)) {
+    uint8_t bytes[sizeof(uint32_t)] = {0};
+    uint32_t size = Min(p_region->size - offset, (uint32_t)sizeof(bytes));
+    memcpy(bytes, p_region->p_data + offset, size);
+    uint32_t word = LoadLittleEndian(bytes);
+    SnapshotWord(p_snapshot, &word);
+    StoreLittleEndian(bytes, word);
+    if (p_snapshot->mode == SPV_REFLECT_PRV_SNAPSHOT_READ) {
+      memcpy(p_region->p_data + offset, bytes, size);
+    }
+  }
+  const uint8_t* p_end = (p_region->size > 0) ? (const uint8_t*)memchr(p_region->p_data, 0, p_region->size) : NULL;
+  SnapshotCheck(p_snapshot, IsNotNull(p_end) && (p_end == p_region->p_data + p_region->size - 1));
 }
 
-SpvReflectResult spvReflectEnumerateEntryPointInputVariables(const SpvReflectShaderModule* p_module, const char* entry_point,
-                                                             uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static void SnapshotRegion(SpvReflectPrvSnapshot* p_snapshot, uint32_t region_index) {
+  const SpvReflectPrvSnapshotRegion* p_region = &p_snapshot->regions[region_index];
+  if (p_region->kind == SPV_REFLECT_PRV_REGION_STRING) {
+    if (p_snapshot->mode != SPV_REFLECT_PRV_SNAPSHOT_FIND_CODE) {
+      SnapshotStringRegion(p_snapshot, p_region);
+    }
+    return;
   }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  size_t element_size = SnapshotElementSize(p_region->kind);
+  for (size_t offset = 0; (offset + element_size <= p_region->size) && (p_snapshot->result == SPV_REFLECT_RESULT_SUCCESS);
+       offset += element_size) {
+    uint8_t* p_element = p_region->p_data + offset;
+    switch (p_region->kind) {
+      default:
+        break;
+      case SPV_REFLECT_PRV_REGION_MODULE: {
+        SnapshotModule(p_snapshot, (SpvReflectShaderModule*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_WORDS: {
+        SnapshotWord(p_snapshot, (uint32_t*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_CAPABILITIES: {
+        SpvReflectCapability* p_capability = (SpvReflectCapability*)p_element;
+        SNAPSHOT_FIELD(p_snapshot, SpvCapability, p_capability->value);
+        SnapshotWordOffset(p_snapshot, &p_capability->word_offset, (uint32_t)p_capability->value);
+      } break;
+      case SPV_REFLECT_PRV_REGION_TYPES: {
+        SnapshotTypeDescription(p_snapshot, (SpvReflectTypeDescription*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_BLOCKS: {
+        SnapshotBlockVariable(p_snapshot, (SpvReflectBlockVariable*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES: {
+        SnapshotInterfaceVariable(p_snapshot, (SpvReflectInterfaceVariable*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLE_POINTERS: {
+        SnapshotElement(p_snapshot, p_element, SPV_REFLECT_PRV_REGION_INTERFACE_VARIABLES, true);
+      } break;
+      case SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDINGS: {
+        SnapshotDescriptorBinding(p_snapshot, (SpvReflectDescriptorBinding*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDING_POINTERS: {
+        SnapshotElement(p_snapshot, p_element, SPV_REFLECT_PRV_REGION_DESCRIPTOR_BINDINGS, true);
+      } break;
+      case SPV_REFLECT_PRV_REGION_DESCRIPTOR_SETS: {
+        SnapshotDescriptorSet(p_snapshot, (SpvReflectDescriptorSet*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_ENTRY_POINTS: {
+        SnapshotEntryPoint(p_snapshot, (SpvReflectEntryPoint*)p_element);
+      } break;
+      case SPV_REFLECT_PRV_REGION_SPEC_CONSTANTS: {
+        SpvReflectSpecializationConstant* p_spec_constant = (SpvReflectSpecializationConstant*)p_element;
+        SnapshotWord(p_snapshot, &p_spec_constant->spirv_id);
+        SnapshotWord(p_snapshot, &p_spec_constant->constant_id);
+        SnapshotString(p_snapshot, &p_spec_constant->name);
+        SnapshotElement(p_snapshot, &p_spec_constant->type_description, SPV_REFLECT_PRV_REGION_TYPES, false);
+        SnapshotDefaultValue(p_snapshot, p_spec_constant);
+      } break;
+      case SPV_REFLECT_PRV_REGION_RESOURCE_HEAP_ACCESSES: {
+        SpvReflectEntryPointResourceHeapAccess* p_access = (SpvReflectEntryPointResourceHeapAccess*)p_element;
+        SnapshotString(p_snapshot, &p_access->heap_name);
+        SnapshotWord(p_snapshot, &p_access->runtime_array_type_id);
+        SnapshotWord(p_snapshot, &p_access->stride);
+        SNAPSHOT_FIELD(p_snapshot, SpvReflectDescriptorType, p_access->descriptor_type);
+        SnapshotElement(p_snapshot, &p_access->type_description, SPV_REFLECT_PRV_REGION_TYPES, false);
+        // Left invalid when the heap element type is not a descriptor
+        SnapshotCheck(p_snapshot, (p_access->descriptor_type == (SpvReflectDescriptorType)INVALID_VALUE) ||
+                                      IsValidSnapshotDescriptorType(p_access->descriptor_type));
+      } break;
+      case SPV_REFLECT_PRV_REGION_SAMPLER_HEAP_ACCESSES: {
+        SpvReflectEntryPointSamplerHeapAccess* p_access = (SpvReflectEntryPointSamplerHeapAccess*)p_element;
+        SnapshotString(p_snapshot, &p_access->heap_name);
+        SnapshotWord(p_snapshot, &p_access->runtime_array_type_id);
+        SnapshotWord(p_snapshot, &p_access->stride);
+        SnapshotElement(p_snapshot, &p_access->type_description, SPV_REFLECT_PRV_REGION_TYPES, false);
+      } break;
+    }
   }
+}
 
-  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-  if (IsNull(p_entry)) {
-    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+// The digest covers the code, as hashed into p_code_digest by the caller,
+// the header words before the digest and the body.
+static void DigestSnapshot(const SpvReflectPrvSha256* p_code_digest, const uint8_t* p_snapshot, size_t body_size,
+                           uint8_t* p_digest) {
+  SpvReflectPrvSha256 sha = *p_code_digest;
+  size_t header_size = SPV_REFLECT_PRV_SNAPSHOT_HEADER_WORD_COUNT * sizeof(uint32_t);
+  Sha256Update(&sha, p_snapshot, header_size - SPV_REFLECT_PRV_SNAPSHOT_DIGEST_SIZE);
+  Sha256Update(&sha, p_snapshot + header_size, body_size);
+  Sha256Final(&sha, p_digest);
+}
+
+// Writes the snapshot of p_module to a new allocation. p_code_digest holds
+// the code it describes.
+static SpvReflectResult SerializeModule(const SpvReflectShaderModule* p_module, const SpvReflectPrvSha256* p_code_digest,
+                                        uint8_t** pp_data, size_t* p_size) {
+  SpvReflectPrvSnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.mode = SPV_REFLECT_PRV_SNAPSHOT_WRITE;
+  snapshot.p_code = (const uint8_t*)p_module->_internal->spirv_code;
+  snapshot.code_size = p_module->_internal->spirv_word_count * SPIRV_WORD_SIZE;
+  snapshot.result = SPV_REFLECT_RESULT_SUCCESS;
+  CollectModuleRegions(&snapshot, p_module);
+  SortSnapshotRegions(&snapshot);
+
+  uint32_t header[SPV_REFLECT_PRV_SNAPSHOT_HEADER_WORD_COUNT] = {
+      SPV_REFLECT_PRV_SNAPSHOT_MAGIC,
+      SPV_REFLECT_PRV_SNAPSHOT_VERSION,
+      p_module->_internal->spirv_word_count,
+  };
+  for (uint32_t i = 0; i < SPV_REFLECT_PRV_SNAPSHOT_HEADER_WORD_COUNT; ++i) {
+    SnapshotWord(&snapshot, &header[i]);
+  }
+  SnapshotWord(&snapshot, &snapshot.region_count);
+  for (uint32_t i = 0; i < snapshot.region_count; ++i) {
+    uint32_t count = snapshot.regions[i].size / (uint32_t)SnapshotElementSize(snapshot.regions[i].kind);
+    SnapshotWord(&snapshot, &snapshot.regions[i].kind);
+    SnapshotWord(&snapshot, &count);
+  }
+  for (uint32_t i = 0; i < snapshot.region_count; ++i) {
+    SnapshotRegion(&snapshot, i);
+  }
+
+  SpvReflectResult result = snapshot.result;
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    uint32_t body_word_count = snapshot.word_count - SPV_REFLECT_PRV_SNAPSHOT_HEADER_WORD_COUNT;
+    StoreLittleEndian(snapshot.p_out + 3 * sizeof(uint32_t), body_word_count);
+    DigestSnapshot(p_code_digest, snapshot.p_out, (size_t)body_word_count * sizeof(uint32_t),
+                   snapshot.p_out + 4 * sizeof(uint32_t));
+    *pp_data = snapshot.p_out;
+    *p_size = (size_t)snapshot.word_count * sizeof(uint32_t);
+  } else {
+    SafeFree(snapshot.p_out);
   }
+  SafeFree(snapshot.regions);
+  SafeFree(snapshot.sorted_regions);
+  return result;
+}
 
-  if (IsNotNull(pp_variables)) {
-    if (*p_count != p_entry->input_variable_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+// Replaces the reflection data of p_module, which only has its SPIR-V set,
+// with a snapshot written by SerializeModule, which may be followed by zero
+// words of padding. p_code_digest holds the code it must describe. On
+// failure p_module is left as it was.
+static SpvReflectResult LoadModule(SpvReflectShaderModule* p_module, const uint8_t* p_payload, size_t payload_size,
+                                   const SpvReflectPrvSha256* p_code_digest) {
+  size_t header_size = SPV_REFLECT_PRV_SNAPSHOT_HEADER_WORD_COUNT * sizeof(uint32_t);
+  if ((payload_size < header_size) || ((payload_size % sizeof(uint32_t)) != 0)) {
+    return SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+  }
+  uint32_t body_word_count = LoadLittleEndian(p_payload + 3 * sizeof(uint32_t));
+  if ((LoadLittleEndian(p_payload) != SPV_REFLECT_PRV_SNAPSHOT_MAGIC) ||
+      (LoadLittleEndian(p_payload + sizeof(uint32_t)) != SPV_REFLECT_PRV_SNAPSHOT_VERSION) ||
+      (LoadLittleEndian(p_payload + 2 * sizeof(uint32_t)) != p_module->_internal->spirv_word_count) ||
+      (body_word_count > (payload_size - header_size) / sizeof(uint32_t))) {
+    return SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+  }
+  uint8_t digest[SPV_REFLECT_PRV_SNAPSHOT_DIGEST_SIZE];
+  DigestSnapshot(p_code_digest, p_payload, (size_t)body_word_count * sizeof(uint32_t), digest);
+  if (memcmp(digest, p_payload + 4 * sizeof(uint32_t), sizeof(digest)) != 0) {
+    return SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+  }
+  for (size_t i = header_size + (size_t)body_word_count * sizeof(uint32_t); i < payload_size; ++i) {
+    if (p_payload[i] != 0) {
+      return SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+    }
+  }
+
+  SpvReflectPrvSnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.mode = SPV_REFLECT_PRV_SNAPSHOT_READ;
+  snapshot.p_code = (const uint8_t*)p_module->_internal->spirv_code;
+  snapshot.code_size = p_module->_internal->spirv_word_count * SPIRV_WORD_SIZE;
+  snapshot.result = SPV_REFLECT_RESULT_SUCCESS;
+  snapshot.p_in = p_payload + header_size;
+  snapshot.word_count = body_word_count;
+
+  // Every element takes at least a word, which bounds the allocations
+  uint32_t region_count = 0;
+  SnapshotWord(&snapshot, &region_count);
+  if ((region_count == 0) || (region_count > body_word_count / 2)) {
+    return SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+  }
+  snapshot.regions = (SpvReflectPrvSnapshotRegion*)calloc(region_count, sizeof(*snapshot.regions));
+  if (IsNull(snapshot.regions)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  uint64_t min_word_count = 1 + 2 * (uint64_t)region_count;
+  for (uint32_t i = 0; (snapshot.result == SPV_REFLECT_RESULT_SUCCESS) && (i < region_count); ++i) {
+    uint32_t kind = 0;
+    uint32_t count = 0;
+    SnapshotWord(&snapshot, &kind);
+    SnapshotWord(&snapshot, &count);
+    uint64_t size = (uint64_t)count * SnapshotElementSize(kind);
+    min_word_count += (kind == SPV_REFLECT_PRV_REGION_STRING) ? ((uint64_t)count + 3) / sizeof(uint32_t) : count;
+    SnapshotCheck(&snapshot, (kind < SPV_REFLECT_PRV_REGION_KIND_COUNT) && ((i == 0) == (kind == SPV_REFLECT_PRV_REGION_MODULE)) &&
+                                 ((i != 0) || (count == 1)) && (size <= UINT32_MAX) && (min_word_count <= body_word_count));
+    snapshot.regions[i].size = (uint32_t)size;
+    snapshot.regions[i].kind = kind;
+  }
+  snapshot.region_count = region_count;
+
+  // Everything but the generator and _internal comes from the snapshot
+  SpvReflectShaderModule original = *p_module;
+  for (uint32_t i = 0; (snapshot.result == SPV_REFLECT_RESULT_SUCCESS) && (i < region_count); ++i) {
+    if (i == 0) {
+      snapshot.regions[i].p_data = (uint8_t*)p_module;
+      continue;
     }
+    // Never zero sized, so every region has its own address
+    snapshot.regions[i].p_data = (uint8_t*)calloc(Max(snapshot.regions[i].size, 1), 1);
+    if (IsNull(snapshot.regions[i].p_data)) {
+      SnapshotFail(&snapshot, SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED);
+    }
+  }
+  for (uint32_t i = 0; (snapshot.result == SPV_REFLECT_RESULT_SUCCESS) && (i < region_count); ++i) {
+    SnapshotRegion(&snapshot, i);
+  }
+  SnapshotCheck(&snapshot, snapshot.word_cursor == body_word_count);
+  // Regions are found through the loaded pointers
+  if (snapshot.result == SPV_REFLECT_RESULT_SUCCESS) {
+    CollectModuleRegions(&snapshot, p_module);
+    SnapshotCheck(&snapshot, snapshot.region_cursor == region_count);
+  }
+  SpvReflectResult result = snapshot.result;
+  // Needed to destroy the module, unlike the lookup indices
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && (p_module->descriptor_binding_count > 0)) {
+    p_module->_internal->descriptor_binding_block_owners =
+        (uint32_t*)calloc(p_module->descriptor_binding_count, sizeof(*p_module->_internal->descriptor_binding_block_owners));
+    result = IsNull(p_module->_internal->descriptor_binding_block_owners)
+                 ? SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED
+                 : FindDescriptorBlockOwners(p_module, p_module->_internal->descriptor_binding_block_owners);
+  }
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectInterfaceVariable* p_var = p_entry->input_variables[index];
-      pp_variables[index] = p_var;
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    for (uint32_t i = 1; i < region_count; ++i) {
+      SafeFree(snapshot.regions[i].p_data);
     }
-  } else {
-    *p_count = p_entry->input_variable_count;
+    *p_module = original;
+    p_module->_internal->type_description_count = 0;
+    p_module->_internal->type_descriptions = NULL;
+    SafeFree(p_module->_internal->descriptor_binding_block_owners);
   }
+  SafeFree(snapshot.regions);
+  return result;
+}
 
-  return SPV_REFLECT_RESULT_SUCCESS;
+static bool StringOperandEquals(const uint32_t* p_words, uint32_t word_count, const char* str) {
+  size_t length = strlen(str);
+  return (length < word_count * SPIRV_WORD_SIZE) && (memcmp(p_words, str, length + 1) == 0);
 }
 
-SpvReflectResult spvReflectEnumerateOutputVariables(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                    SpvReflectInterfaceVariable** pp_variables) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+// Finds the payload of spvReflectEmbedReflection. Returns
+// SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND if there is none. On success
+// the caller frees p_embedded->chunk_offsets.
+static SpvReflectResult FindEmbeddedReflection(const uint32_t* p_code, uint32_t word_count,
+                                               SpvReflectPrvEmbeddedReflection* p_embedded) {
+  memset(p_embedded, 0, sizeof(*p_embedded));
+  uint32_t set_id = 0;
+  uint32_t word_index = SPIRV_STARTING_WORD_INDEX;
+  while (word_index < word_count) {
+    uint32_t instruction_word_count = p_code[word_index] >> 16;
+    if ((instruction_word_count == 0) || (instruction_word_count > word_count - word_index)) {
+      return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_INSTRUCTION;
+    }
+    SpvOp op = (SpvOp)(p_code[word_index] & 0xFFFF);
+    uint32_t section = ModuleSectionOfOp(op);
+    if ((p_embedded->import_offset == 0) && (section != SPV_REFLECT_PRV_SECTION_PREAMBLE)) {
+      // Most modules have no payload, so don't look further than the preamble
+      return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    if (section == SPV_REFLECT_PRV_SECTION_FUNCTIONS) {
+      break;
+    }
+    if ((op == SpvOpExtInstImport) && (p_embedded->import_offset == 0) && (instruction_word_count > 2) &&
+        StringOperandEquals(p_code + word_index + 2, instruction_word_count - 2, SPV_REFLECT_PRV_EMBEDDED_SET_NAME)) {
+      set_id = p_code[word_index + 1];
+      p_embedded->import_offset = word_index;
+    } else if ((op == SpvOpExtInst) && (p_embedded->import_offset != 0) && (instruction_word_count >= 5) &&
+               (p_code[word_index + 3] == set_id) && (p_code[word_index + 4] == SPV_REFLECT_PRV_EMBEDDED_INSTRUCTION)) {
+      p_embedded->instruction_offset = word_index;
+      p_embedded->chunk_count = instruction_word_count - 5;
+      break;
+    }
+    word_index += instruction_word_count;
   }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  if (p_embedded->instruction_offset == 0) {
+    p_embedded->import_offset = 0;
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+  if (p_embedded->chunk_count == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
   }
 
-  if (IsNotNull(pp_variables)) {
-    if (*p_count != p_module->output_variable_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
-
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectInterfaceVariable* p_var = p_module->output_variables[index];
-      pp_variables[index] = p_var;
+  p_embedded->chunk_offsets = (uint32_t*)calloc(p_embedded->chunk_count, sizeof(*p_embedded->chunk_offsets));
+  if (IsNull(p_embedded->chunk_offsets)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  // The OpStrings come before the OpExtInst, in operand order
+  const uint32_t* p_chunk_ids = p_code + p_embedded->instruction_offset + 5;
+  uint32_t chunk_index = 0;
+  for (word_index = SPIRV_STARTING_WORD_INDEX;
+       (word_index < p_embedded->instruction_offset) && (chunk_index < p_embedded->chunk_count);
+       word_index += p_code[word_index] >> 16) {
+    if (((SpvOp)(p_code[word_index] & 0xFFFF) == SpvOpString) && ((p_code[word_index] >> 16) > 2) &&
+        (p_code[word_index + 1] == p_chunk_ids[chunk_index])) {
+      p_embedded->chunk_offsets[chunk_index++] = word_index;
     }
-  } else {
-    *p_count = p_module->output_variable_count;
   }
-
+  if (chunk_index != p_embedded->chunk_count) {
+    SafeFree(p_embedded->chunk_offsets);
+    return SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+  }
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-SpvReflectResult spvReflectEnumerateEntryPointOutputVariables(const SpvReflectShaderModule* p_module, const char* entry_point,
-                                                              uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
+// Starts the snapshot digest with the SPIR-V without the OpStrings that hold
+// the payload, so that it is known before the payload is written.
+static void DigestEmbeddedCode(const uint32_t* p_code, uint32_t word_count, const SpvReflectPrvEmbeddedReflection* p_embedded,
+                               SpvReflectPrvSha256* p_sha) {
+  Sha256Init(p_sha);
+  uint32_t word_index = 0;
+  for (uint32_t i = 0; i < p_embedded->chunk_count; ++i) {
+    uint32_t chunk_offset = p_embedded->chunk_offsets[i];
+    Sha256Update(p_sha, p_code + word_index, (size_t)(chunk_offset - word_index) * SPIRV_WORD_SIZE);
+    word_index = chunk_offset + (p_code[chunk_offset] >> 16);
+  }
+  Sha256Update(p_sha, p_code + word_index, (size_t)(word_count - word_index) * SPIRV_WORD_SIZE);
+}
 
-  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-  if (IsNull(p_entry)) {
-    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-  }
+static const char* GetEmbeddedChunk(const uint32_t* p_code, uint32_t chunk_offset, size_t* p_length) {
+  const char* p_chunk = (const char*)(p_code + chunk_offset + 2);
+  const char* p_end = (const char*)memchr(p_chunk, 0, ((p_code[chunk_offset] >> 16) - 2) * SPIRV_WORD_SIZE);
+  *p_length = IsNotNull(p_end) ? (size_t)(p_end - p_chunk) : 0;
+  return IsNotNull(p_end) ? p_chunk : NULL;
+}
 
-  if (IsNotNull(pp_variables)) {
-    if (*p_count != p_entry->output_variable_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
+static const char base64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectInterfaceVariable* p_var = p_entry->output_variables[index];
-      pp_variables[index] = p_var;
+static size_t Base64Length(size_t size) { return (size + 2) / 3 * 4; }
+
+static void EncodeBase64(const uint8_t* p_data, size_t size, char* p_text) {
+  for (size_t i = 0; i < size; i += 3) {
+    uint32_t group = (uint32_t)p_data[i] << 16;
+    if (i + 1 < size) {
+      group |= (uint32_t)p_data[i + 1] << 8;
     }
-  } else {
-    *p_count = p_entry->output_variable_count;
+    if (i + 2 < size) {
+      group |= p_data[i + 2];
+    }
+    *p_text++ = base64_digits[(group >> 18) & 0x3F];
+    *p_text++ = base64_digits[(group >> 12) & 0x3F];
+    *p_text++ = (i + 1 < size) ? base64_digits[(group >> 6) & 0x3F] : '=';
+    *p_text++ = (i + 2 < size) ? base64_digits[group & 0x3F] : '=';
   }
-
-  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-SpvReflectResult spvReflectEnumeratePushConstantBlocks(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                       SpvReflectBlockVariable** pp_blocks) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+// Appends the bytes encoded by p_text to p_data. Padding may only end the text,
+// and the bits it drops must be zero, so that every text decodes differently.
+static bool DecodeBase64(const char* p_text, size_t length, uint8_t* p_data, size_t* p_size) {
+  if ((length % 4) != 0) {
+    return false;
   }
+  // 0xFF marks characters that are not digits
+  uint8_t values[256];
+  memset(values, 0xFF, sizeof(values));
+  for (uint32_t i = 0; i < 64; ++i) {
+    values[(uint8_t)base64_digits[i]] = (uint8_t)i;
+  }
+  uint32_t padding = 0;
+  if ((length > 0) && (p_text[length - 1] == '=')) {
+    padding = (p_text[length - 2] == '=') ? 2 : 1;
+  }
+
+  const uint8_t* p_in = (const uint8_t*)p_text;
+  uint8_t* p_out = p_data + *p_size;
+  uint32_t invalid = 0;
+  size_t full_length = (padding > 0) ? length - 4 : length;
+  for (size_t i = 0; i < full_length; i += 4) {
+    uint32_t group = ((uint32_t)values[p_in[i]] << 18) | ((uint32_t)values[p_in[i + 1]] << 12) |
+                     ((uint32_t)values[p_in[i + 2]] << 6) | (uint32_t)values[p_in[i + 3]];
+    invalid |= values[p_in[i]] | values[p_in[i + 1]] | values[p_in[i + 2]] | values[p_in[i + 3]];
+    p_out[0] = (uint8_t)(group >> 16);
+    p_out[1] = (uint8_t)(group >> 8);
+    p_out[2] = (uint8_t)group;
+    p_out += 3;
+  }
+  if (padding > 0) {
+    const uint8_t* p_last = p_in + full_length;
+    uint32_t third = (padding < 2) ? values[p_last[2]] : 0;
+    invalid |= values[p_last[0]] | values[p_last[1]] | third;
+    invalid |= (((padding < 2) ? third & 0x3 : values[p_last[1]] & 0xF) != 0) ? 0x80 : 0;
+    uint32_t group = ((uint32_t)values[p_last[0]] << 18) | ((uint32_t)values[p_last[1]] << 12) | (third << 6);
+    *p_out++ = (uint8_t)(group >> 16);
+    if (padding < 2) {
+      *p_out++ = (uint8_t)(group >> 8);
+    }
+  }
+  *p_size = (size_t)(p_out - p_data);
+  return (invalid & 0x80) == 0;
+}
 
-  if (pp_blocks != NULL) {
-    if (*p_count != p_module->push_constant_block_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-    }
+static SpvReflectResult LoadEmbeddedReflection(SpvReflectShaderModule* p_module) {
+  const uint32_t* p_code = p_module->_internal->spirv_code;
+  uint32_t word_count = p_module->_internal->spirv_word_count;
+  SpvReflectPrvEmbeddedReflection embedded;
+  SpvReflectResult result = FindEmbeddedReflection(p_code, word_count, &embedded);
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectBlockVariable* p_push_constant_blocks = (SpvReflectBlockVariable*)&p_module->push_constant_blocks[index];
-      pp_blocks[index] = p_push_constant_blocks;
+  size_t capacity = 0;
+  for (uint32_t i = 0; (result == SPV_REFLECT_RESULT_SUCCESS) && (i < embedded.chunk_count); ++i) {
+    size_t length = 0;
+    if (IsNull(GetEmbeddedChunk(p_code, embedded.chunk_offsets[i], &length))) {
+      result = SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+    }
+    capacity += length / 4 * 3;
+  }
+  uint8_t* p_data = NULL;
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && (capacity > 0)) {
+    p_data = (uint8_t*)malloc(capacity);
+    if (IsNull(p_data)) {
+      result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
-  } else {
-    *p_count = p_module->push_constant_block_count;
+  }
+  size_t size = 0;
+  for (uint32_t i = 0; (result == SPV_REFLECT_RESULT_SUCCESS) && (i < embedded.chunk_count); ++i) {
+    size_t length = 0;
+    const char* p_chunk = GetEmbeddedChunk(p_code, embedded.chunk_offsets[i], &length);
+    if (!DecodeBase64(p_chunk, length, p_data, &size)) {
+      result = SPV_REFLECT_RESULT_ERROR_PARSE_FAILED;
+    }
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    SpvReflectPrvSha256 code_digest;
+    DigestEmbeddedCode(p_code, word_count, &embedded, &code_digest);
+    result = LoadModule(p_module, p_data, size, &code_digest);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    p_module->_internal->embedded_reflection_loaded = 1;
   }
 
-  return SPV_REFLECT_RESULT_SUCCESS;
-}
-SpvReflectResult spvReflectEnumeratePushConstants(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                  SpvReflectBlockVariable** pp_blocks) {
-  return spvReflectEnumeratePushConstantBlocks(p_module, p_count, pp_blocks);
+  SafeFree(p_data);
+  SafeFree(embedded.chunk_offsets);
+  return result;
 }
 
-SpvReflectResult spvReflectEnumerateEntryPointPushConstantBlocks(const SpvReflectShaderModule* p_module, const char* entry_point,
-                                                                 uint32_t* p_count, SpvReflectBlockVariable** pp_blocks) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-  }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static uint32_t StringWordCount(size_t length) { return (uint32_t)(length / SPIRV_WORD_SIZE + 1); }
+
+static void WriteStringInstruction(uint32_t** pp_out, SpvOp op, uint32_t id, const char* str, size_t length) {
+  uint32_t* p_out = *pp_out;
+  uint32_t word_count = (id != 0 ? 2 : 1) + StringWordCount(length);
+  memset(p_out, 0, word_count * SPIRV_WORD_SIZE);
+  p_out[0] = (word_count << 16) | (uint32_t)op;
+  if (id != 0) {
+    p_out[1] = id;
   }
+  memcpy(p_out + word_count - StringWordCount(length), str, length);
+  *pp_out += word_count;
+}
 
-  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-  if (IsNull(p_entry)) {
-    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+// Copies p_code without any previous payload and with room for a new one
+// of payload_size bytes, whose OpStrings are filled with 'A's. The
+// extended instruction set is imported after the other ones, the OpStrings
+// start the debug section and the OpExtInst ends the types and globals.
+static SpvReflectResult BuildEmbeddedCode(const uint32_t* p_code, uint32_t word_count, size_t payload_size, uint32_t** pp_code,
+                                          uint32_t* p_word_count) {
+  SpvReflectPrvEmbeddedReflection previous;
+  SpvReflectResult result = FindEmbeddedReflection(p_code, word_count, &previous);
+  if (result == SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND) {
+    result = SPV_REFLECT_RESULT_SUCCESS;
+  }
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    return result;
   }
 
-  uint32_t count = 0;
-  for (uint32_t i = 0; i < p_module->push_constant_block_count; ++i) {
-    bool found = SearchSortedUint32(p_entry->used_push_constants, p_entry->used_push_constant_count,
-                                    p_module->push_constant_blocks[i].spirv_id);
-    if (found) {
-      if (IsNotNull(pp_blocks)) {
-        if (count >= *p_count) {
-          return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
-        }
-        pp_blocks[count++] = (SpvReflectBlockVariable*)&p_module->push_constant_blocks[i];
-      } else {
-        ++count;
-      }
+  // Sizes and ids
+  bool has_extension = false;
+  uint32_t void_id = 0;
+  uint32_t removed_word_count = 0;
+  for (uint32_t word_index = SPIRV_STARTING_WORD_INDEX; word_index < word_count;) {
+    uint32_t instruction_word_count = p_code[word_index] >> 16;
+    if ((instruction_word_count == 0) || (instruction_word_count > word_count - word_index)) {
+      SafeFree(previous.chunk_offsets);
+      return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_INSTRUCTION;
+    }
+    SpvOp op = (SpvOp)(p_code[word_index] & 0xFFFF);
+    if ((op == SpvOpExtension) && (instruction_word_count > 1) &&
+        StringOperandEquals(p_code + word_index + 1, instruction_word_count - 1, SPV_REFLECT_PRV_EMBEDDED_EXTENSION_NAME)) {
+      has_extension = true;
+    } else if ((op == SpvOpTypeVoid) && (instruction_word_count == 2)) {
+      void_id = p_code[word_index + 1];
     }
+    word_index += instruction_word_count;
   }
-  if (IsNotNull(pp_blocks)) {
-    if (count != *p_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+  if (previous.import_offset != 0) {
+    removed_word_count += (p_code[previous.import_offset] >> 16) + (p_code[previous.instruction_offset] >> 16);
+    for (uint32_t i = 0; i < previous.chunk_count; ++i) {
+      removed_word_count += p_code[previous.chunk_offsets[i]] >> 16;
     }
-  } else {
-    *p_count = count;
   }
-  return SPV_REFLECT_RESULT_SUCCESS;
-}
 
-SpvReflectResult spvReflectEnumerateSpecializationConstants(const SpvReflectShaderModule* p_module, uint32_t* p_count,
-                                                            SpvReflectSpecializationConstant** pp_constants) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  size_t text_length = Base64Length(payload_size);
+  uint32_t chunk_count = (uint32_t)((text_length + SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE - 1) / SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE);
+  if (chunk_count > UINT16_MAX - 5) {
+    SafeFree(previous.chunk_offsets);
+    return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
   }
-  if (IsNull(p_count)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  uint64_t added_word_count = 0;
+  if (!has_extension) {
+    added_word_count += 1 + StringWordCount(strlen(SPV_REFLECT_PRV_EMBEDDED_EXTENSION_NAME));
+  }
+  added_word_count += 2 + StringWordCount(strlen(SPV_REFLECT_PRV_EMBEDDED_SET_NAME));
+  for (uint32_t i = 0; i < chunk_count; ++i) {
+    size_t offset = (size_t)i * SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE;
+    size_t length = Min((uint32_t)(text_length - offset), SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE);
+    added_word_count += 2 + StringWordCount(length);
+  }
+  added_word_count += (void_id == 0 ? 2 : 0) + 5 + chunk_count;
+  uint64_t new_word_count = (uint64_t)word_count - removed_word_count + added_word_count;
+  uint64_t new_id_bound = (uint64_t)p_code[3] + (void_id == 0 ? 1 : 0) + 2 + chunk_count;
+  if ((new_word_count > UINT32_MAX / SPIRV_WORD_SIZE) || (new_id_bound > UINT32_MAX)) {
+    SafeFree(previous.chunk_offsets);
+    return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
   }
 
-  if (IsNotNull(pp_constants)) {
-    if (*p_count != p_module->spec_constant_count) {
-      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+  uint32_t* p_new_code = (uint32_t*)calloc((size_t)new_word_count, SPIRV_WORD_SIZE);
+  if (IsNull(p_new_code)) {
+    SafeFree(previous.chunk_offsets);
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  uint32_t next_id = p_code[3];
+  bool add_void = (void_id == 0);
+  if (add_void) {
+    void_id = next_id++;
+  }
+  uint32_t set_id = next_id++;
+  uint32_t result_id = next_id++;
+  uint32_t first_chunk_id = next_id;
+
+  uint32_t* p_out = p_new_code;
+  memcpy(p_out, p_code, SPIRV_STARTING_WORD_INDEX * SPIRV_WORD_SIZE);
+  p_out[3] = (uint32_t)new_id_bound;
+  p_out += SPIRV_STARTING_WORD_INDEX;
+  bool extension_written = has_extension;
+  bool import_written = false;
+  bool chunks_written = false;
+  bool instruction_written = false;
+  uint32_t section = SPV_REFLECT_PRV_SECTION_PREAMBLE;
+  uint32_t previous_chunk_index = 0;
+  for (uint32_t word_index = SPIRV_STARTING_WORD_INDEX; word_index <= word_count;) {
+    bool at_end = (word_index == word_count);
+    uint32_t instruction_word_count = at_end ? 0 : (p_code[word_index] >> 16);
+    SpvOp op = at_end ? SpvOpNop : (SpvOp)(p_code[word_index] & 0xFFFF);
+    if (!at_end) {
+      section = Max(section, ModuleSectionOfOp(op));
+    }
+    if (!extension_written && (at_end || (op != SpvOpCapability))) {
+      const char* name = SPV_REFLECT_PRV_EMBEDDED_EXTENSION_NAME;
+      WriteStringInstruction(&p_out, SpvOpExtension, 0, name, strlen(name));
+      extension_written = true;
+    }
+    if (!import_written && (at_end || ((op != SpvOpCapability) && (op != SpvOpExtension) && (op != SpvOpExtInstImport)))) {
+      const char* name = SPV_REFLECT_PRV_EMBEDDED_SET_NAME;
+      WriteStringInstruction(&p_out, SpvOpExtInstImport, set_id, name, strlen(name));
+      import_written = true;
+    }
+    if (!chunks_written && (at_end || (section > SPV_REFLECT_PRV_SECTION_ENTRY_POINTS))) {
+      for (uint32_t i = 0; i < chunk_count; ++i) {
+        size_t offset = (size_t)i * SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE;
+        size_t length = Min((uint32_t)(text_length - offset), SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE);
+        uint32_t chunk_word_count = 2 + StringWordCount(length);
+        memset(p_out, 0, chunk_word_count * SPIRV_WORD_SIZE);
+        p_out[0] = (chunk_word_count << 16) | (uint32_t)SpvOpString;
+        p_out[1] = first_chunk_id + i;
+        memset(p_out + 2, 'A', length);
+        p_out += chunk_word_count;
+      }
+      chunks_written = true;
+    }
+    if (!instruction_written && (at_end || (section > SPV_REFLECT_PRV_SECTION_GLOBALS))) {
+      if (add_void) {
+        *p_out++ = (2 << 16) | (uint32_t)SpvOpTypeVoid;
+        *p_out++ = void_id;
+      }
+      *p_out++ = ((5 + chunk_count) << 16) | (uint32_t)SpvOpExtInst;
+      *p_out++ = void_id;
+      *p_out++ = result_id;
+      *p_out++ = set_id;
+      *p_out++ = SPV_REFLECT_PRV_EMBEDDED_INSTRUCTION;
+      for (uint32_t i = 0; i < chunk_count; ++i) {
+        *p_out++ = first_chunk_id + i;
+      }
+      instruction_written = true;
+    }
+    if (at_end) {
+      break;
     }
 
-    for (uint32_t index = 0; index < *p_count; ++index) {
-      SpvReflectSpecializationConstant* p_constant = (SpvReflectSpecializationConstant*)&p_module->spec_constants[index];
-      pp_constants[index] = p_constant;
+    bool removed = (word_index == previous.import_offset) || (word_index == previous.instruction_offset);
+    if ((previous_chunk_index < previous.chunk_count) && (word_index == previous.chunk_offsets[previous_chunk_index])) {
+      removed = true;
+      ++previous_chunk_index;
     }
-  } else {
-    *p_count = p_module->spec_constant_count;
+    if (!removed) {
+      memcpy(p_out, p_code + word_index, instruction_word_count * SPIRV_WORD_SIZE);
+      p_out += instruction_word_count;
+    }
+    word_index += instruction_word_count;
   }
+  SafeFree(previous.chunk_offsets);
+  assert(p_out == p_new_code + new_word_count);
 
+  *pp_code = p_new_code;
+  *p_word_count = (uint32_t)new_word_count;
   return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const SpvReflectDescriptorBinding* spvReflectGetDescriptorBinding(const SpvReflectShaderModule* p_module, uint32_t binding_number,
-                                                                  uint32_t set_number, SpvReflectResult* p_result) {
-  const SpvReflectDescriptorBinding* p_descriptor = NULL;
-  if (IsNotNull(p_module)) {
-    for (uint32_t index = 0; index < p_module->descriptor_binding_count; ++index) {
-      const SpvReflectDescriptorBinding* p_potential = &p_module->descriptor_bindings[index];
-      if ((p_potential->binding == binding_number) && (p_potential->set == set_number)) {
-        p_descriptor = p_potential;
-        break;
-      }
-    }
+// Fills the OpStrings of BuildEmbeddedCode with the payload.
+static void WriteEmbeddedPayload(uint32_t* p_code, const SpvReflectPrvEmbeddedReflection* p_embedded, const uint8_t* p_data,
+                                 size_t size, char* p_text) {
+  EncodeBase64(p_data, size, p_text);
+  size_t text_length = Base64Length(size);
+  for (uint32_t i = 0; i < p_embedded->chunk_count; ++i) {
+    size_t offset = (size_t)i * SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE;
+    size_t length = Min((uint32_t)(text_length - offset), SPV_REFLECT_PRV_EMBEDDED_CHUNK_SIZE);
+    memcpy(p_code + p_embedded->chunk_offsets[i] + 2, p_text + offset, length);
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_descriptor)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+}
+
+//
+// Reflection cache
+//
+// spvReflectCreateShaderModuleCached keeps the snapshots of parsed modules in
+// files named after a 64-bit hash of the SPIR-V and of everything else the
+// snapshot depends on. The name only finds the file: the snapshot digest is
+// seeded with a SHA-256 of the same data, so LoadModule rejects a file that
+// was damaged, renamed or written for other code whose hash collides. Files
+// are written under a temporary name and renamed into place, so a reader sees
+// either no file or a whole one, and are never modified afterwards, so they
+// can be mapped instead of read.
+//
+// Must change whenever the reflection data created from the same SPIR-V does,
+// even if SPV_REFLECT_PRV_SNAPSHOT_VERSION does not.
+#define SPV_REFLECT_PRV_CACHE_VERSION      3
+#define SPV_REFLECT_PRV_CACHE_KEY_DIGITS   16
+// Attempts at a temporary name that no other writer is using
+#define SPV_REFLECT_PRV_CACHE_MAX_ATTEMPTS 16
+
+static void GetCacheKeyWords(const SpvReflectShaderModule* p_module, uint32_t key[3]) {
+  // Who owns the code does not change the snapshot, which is taken before
+  // the code is detached
+  key[0] = SPV_REFLECT_PRV_SNAPSHOT_VERSION;
+  key[1] = SPV_REFLECT_PRV_CACHE_VERSION;
+  key[2] = p_module->_internal->module_flags & ~(uint32_t)(SPV_REFLECT_MODULE_FLAG_NO_COPY | SPV_REFLECT_MODULE_FLAG_DETACH_CODE);
+}
+
+static uint64_t HashCacheKey(const SpvReflectShaderModule* p_module) {
+  uint32_t key[3];
+  GetCacheKeyWords(p_module, key);
+  return HashWordsUpdate(HashWords(key, 3), p_module->_internal->spirv_code, p_module->_internal->spirv_word_count);
+}
+
+static void DigestCacheKey(const SpvReflectShaderModule* p_module, SpvReflectPrvSha256* p_sha) {
+  uint32_t key[3];
+  GetCacheKeyWords(p_module, key);
+  uint8_t bytes[sizeof(key)];
+  for (uint32_t i = 0; i < 3; ++i) {
+    StoreLittleEndian(bytes + 4 * i, key[i]);
   }
-  return p_descriptor;
+  Sha256Init(p_sha);
+  Sha256Update(p_sha, bytes, sizeof(bytes));
+  Sha256Update(p_sha, p_module->_internal->spirv_code, (size_t)p_module->_internal->spirv_word_count * SPIRV_WORD_SIZE);
 }
 
-const SpvReflectDescriptorBinding* spvReflectGetEntryPointDescriptorBinding(const SpvReflectShaderModule* p_module,
-                                                                            const char* entry_point, uint32_t binding_number,
-                                                                            uint32_t set_number, SpvReflectResult* p_result) {
-  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-  if (IsNull(p_entry)) {
-    if (IsNotNull(p_result)) {
+static char* WriteHex(char* p_out, uint64_t value, uint32_t digit_count) {
+  for (uint32_t i = 0; i < digit_count; ++i) {
+    p_out[i] = "0123456789abcdef"[(value >> (4 * (digit_count - 1 - i))) & 0xF];
+  }
+  return p_out + digit_count;
+}
+
+// Returns "<cache_dir>/<key>" followed by a temporary suffix if attempt is
+// not 0, in a new allocation.
+static char* CachePath(const char* p_cache_dir, uint64_t key, uint32_t process_id, uint32_t attempt) {
+  size_t dir_length = strlen(p_cache_dir);
+  // '/', key, ".<process id>-<attempt>.tmp" and NUL
+  char* p_path = (char*)malloc(dir_length + 1 + SPV_REFLECT_PRV_CACHE_KEY_DIGITS + 1 + 8 + 1 + 8 + 4 + 1);
+  if (IsNull(p_path)) {
+    return NULL;
+  }
+  memcpy(p_path, p_cache_dir, dir_length);
+  char* p_out = p_path + dir_length;
+  *p_out++ = '/';
+  p_out = WriteHex(p_out, key, SPV_REFLECT_PRV_CACHE_KEY_DIGITS);
+  if (attempt != 0) {
+    *p_out++ = '.';
+    p_out = WriteHex(p_out, process_id, 8);
+    *p_out++ = '-';
+    p_out = WriteHex(p_out, attempt, 8);
+    memcpy(p_out, ".tmp", 4);
+    p_out += 4;
+  }
+  *p_out = 0;
+  return p_path;
+}
+
+// Loads the snapshot stored under key into p_module, which only has its
+// SPIR-V set. Returns SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND if there is
+// none.
+static SpvReflectResult LoadCachedReflection(const char* p_cache_dir, uint64_t key, SpvReflectShaderModule* p_module) {
+  char* p_path = CachePath(p_cache_dir, key, 0, 0);
+  if (IsNull(p_path)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  SpvReflectPrvSha256 key_digest;
+  DigestCacheKey(p_module, &key_digest);
+  SpvReflectResult result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+#if defined(_WIN32)
+  // Sharing delete access lets writers replace the file while it is mapped
+  HANDLE file = CreateFileA(p_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file != INVALID_HANDLE_VALUE) {
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && (size.QuadPart > 0) && ((uint64_t)size.QuadPart <= SIZE_MAX)) {
+      HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      if (IsNotNull(mapping)) {
+        const void* p_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (IsNotNull(p_data)) {
+          result = LoadModule(p_module, (const uint8_t*)p_data, (size_t)size.QuadPart, &key_digest);
+          UnmapViewOfFile(p_data);
+        }
+        CloseHandle(mapping);
+      }
+    }
+    CloseHandle(file);
+  }
+#else
+  int file = open(p_path, O_RDONLY);
+  if (file >= 0) {
+    struct stat info;
+    if ((fstat(file, &info) == 0) && (info.st_size > 0) && ((uint64_t)info.st_size <= SIZE_MAX)) {
+      void* p_data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+      if (p_data != MAP_FAILED) {
+        result = LoadModule(p_module, (const uint8_t*)p_data, (size_t)info.st_size, &key_digest);
+        munmap(p_data, (size_t)info.st_size);
+      }
+    }
+    close(file);
+  }
+#endif
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    p_module->_internal->cached_reflection_loaded = 1;
+  }
+  SafeFree(p_path);
+  return result;
+}
+
+// Writes p_data to a new temporary file and renames it to p_path, replacing
+// any file another process wrote there in the meantime.
+static SpvReflectResult WriteCacheFile(const char* p_cache_dir, uint64_t key, const char* p_path, const uint8_t* p_data,
+                                       size_t size) {
+  SpvReflectResult result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  char* p_temp_path = NULL;
+#if defined(_WIN32)
+  CreateDirectoryA(p_cache_dir, NULL);
+  HANDLE file = INVALID_HANDLE_VALUE;
+  for (uint32_t attempt = 1; (attempt <= SPV_REFLECT_PRV_CACHE_MAX_ATTEMPTS) && (file == INVALID_HANDLE_VALUE); ++attempt) {
+    SafeFree(p_temp_path);
+    p_temp_path = CachePath(p_cache_dir, key, (uint32_t)GetCurrentProcessId(), attempt);
+    if (IsNull(p_temp_path)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+    file = CreateFileA(p_temp_path, GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+    if ((file == INVALID_HANDLE_VALUE) && (GetLastError() != ERROR_FILE_EXISTS)) {
+      break;
+    }
+  }
+  if (file != INVALID_HANDLE_VALUE) {
+    size_t written = 0;
+    while (written < size) {
+      DWORD chunk_size = (size - written > (1u << 30)) ? (DWORD)(1u << 30) : (DWORD)(size - written);
+      DWORD chunk_written = 0;
+      if (!WriteFile(file, p_data + written, chunk_size, &chunk_written, NULL) || (chunk_written == 0)) {
+        break;
+      }
+      written += chunk_written;
+    }
+    CloseHandle(file);
+    if ((written == size) && MoveFileExA(p_temp_path, p_path, MOVEFILE_REPLACE_EXISTING)) {
+      result = SPV_REFLECT_RESULT_SUCCESS;
+    } else {
+      DeleteFileA(p_temp_path);
+    }
+  }
+#else
+  mkdir(p_cache_dir, 0777);
+  int file = -1;
+  for (uint32_t attempt = 1; (attempt <= SPV_REFLECT_PRV_CACHE_MAX_ATTEMPTS) && (file < 0); ++attempt) {
+    SafeFree(p_temp_path);
+    p_temp_path = CachePath(p_cache_dir, key, (uint32_t)getpid(), attempt);
+    if (IsNull(p_temp_path)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+    file = open(p_temp_path, O_WRONLY | O_CREAT | O_EXCL, 0666);
+    if ((file < 0) && (errno != EEXIST)) {
+      break;
+    }
+  }
+  if (file >= 0) {
+    size_t written = 0;
+    while (written < size) {
+      ssize_t chunk_written = write(file, p_data + written, size - written);
+      if ((chunk_written < 0) && (errno == EINTR)) {
+        continue;
+      }
+      if (chunk_written <= 0) {
+        break;
+      }
+      written += (size_t)chunk_written;
+    }
+    if ((close(file) == 0) && (written == size) && (rename(p_temp_path, p_path) == 0)) {
+      result = SPV_REFLECT_RESULT_SUCCESS;
+    } else {
+      unlink(p_temp_path);
+    }
+  }
+#endif
+  SafeFree(p_temp_path);
+  return result;
+}
+
+// Stores the snapshot of p_module, which was just parsed, under key.
+static SpvReflectResult StoreCachedReflection(const char* p_cache_dir, uint64_t key, const SpvReflectShaderModule* p_module) {
+  SpvReflectPrvSha256 key_digest;
+  DigestCacheKey(p_module, &key_digest);
+  uint8_t* p_data = NULL;
+  size_t data_size = 0;
+  SpvReflectResult result = SerializeModule(p_module, &key_digest, &p_data, &data_size);
+  char* p_path = NULL;
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    p_path = CachePath(p_cache_dir, key, 0, 0);
+    result = IsNotNull(p_path) ? WriteCacheFile(p_cache_dir, key, p_path, p_data, data_size)
+                               : SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  SafeFree(p_path);
+  SafeFree(p_data);
+  return result;
+}
+
+//
+// Detached modules
+//
+// SPV_REFLECT_MODULE_FLAG_DETACH_CODE walks the module as a snapshot does to
+// find the names and default values that point into the SPIR-V, and moves
+// them into one string pool. Equal strings are stored once, and
+// every entry keeps the word alignment it had in the code.
+//
+static SpvReflectResult DetachCode(SpvReflectShaderModule* p_module) {
+  SpvReflectPrvSnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.p_code = (const uint8_t*)p_module->_internal->spirv_code;
+  snapshot.code_size = p_module->_internal->spirv_word_count * SPIRV_WORD_SIZE;
+  snapshot.mode = SPV_REFLECT_PRV_SNAPSHOT_FIND_CODE;
+  snapshot.result = SPV_REFLECT_RESULT_SUCCESS;
+  CollectModuleRegions(&snapshot, p_module);
+  SortSnapshotRegions(&snapshot);
+  for (uint32_t i = 0; (snapshot.result == SPV_REFLECT_RESULT_SUCCESS) && (i < snapshot.region_count); ++i) {
+    SnapshotRegion(&snapshot, i);
+  }
+
+  // The table holds (reference index + 1) of the first reference with each
+  // content, whose pool offset the others share.
+  SpvReflectResult result = snapshot.result;
+  uint32_t reference_count = snapshot.code_reference_count;
+  uint32_t capacity = HashTableCapacity(reference_count);
+  uint32_t* p_pool_offsets = NULL;
+  uint32_t* p_table = NULL;
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && (capacity > 0)) {
+    p_pool_offsets = (uint32_t*)calloc(reference_count, sizeof(*p_pool_offsets));
+    p_table = (uint32_t*)calloc(capacity, sizeof(*p_table));
+    if (IsNull(p_pool_offsets) || IsNull(p_table)) {
+      result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+  }
+  size_t pool_size = 0;
+  for (uint32_t i = 0; (result == SPV_REFLECT_RESULT_SUCCESS) && (i < reference_count); ++i) {
+    const SpvReflectPrvSnapshotCodeReference* p_reference = &snapshot.code_references[i];
+    const uint8_t* p_target = snapshot.p_code + p_reference->offset;
+    uint32_t mask = capacity - 1;
+    uint32_t slot = HashStringLength((const char*)p_target, p_reference->size) & mask;
+    while (p_table[slot] != 0) {
+      const SpvReflectPrvSnapshotCodeReference* p_first = &snapshot.code_references[p_table[slot] - 1];
+      if ((p_first->size == p_reference->size) && (memcmp(snapshot.p_code + p_first->offset, p_target, p_reference->size) == 0)) {
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+    if (p_table[slot] != 0) {
+      p_pool_offsets[i] = p_pool_offsets[p_table[slot] - 1];
+    } else {
+      p_table[slot] = i + 1;
+      p_pool_offsets[i] = (uint32_t)pool_size;
+      pool_size += Max(RoundUp(p_reference->size, SPIRV_WORD_SIZE), SPIRV_WORD_SIZE);
+    }
+  }
+
+  char* p_pool = NULL;
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && (pool_size > 0)) {
+    p_pool = (char*)calloc(1, pool_size);
+    if (IsNull(p_pool)) {
+      result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+  }
+  for (uint32_t i = 0; (result == SPV_REFLECT_RESULT_SUCCESS) && (i < reference_count); ++i) {
+    const SpvReflectPrvSnapshotCodeReference* p_reference = &snapshot.code_references[i];
+    char* p_entry = p_pool + p_pool_offsets[i];
+    memcpy(p_entry, snapshot.p_code + p_reference->offset, p_reference->size);
+    memcpy(p_reference->p_field, &p_entry, sizeof(p_entry));
+  }
+
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    if ((p_module->_internal->module_flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) == 0) {
+      SafeFree(p_module->_internal->spirv_code);
+    }
+    p_module->_internal->spirv_code = NULL;
+    p_module->_internal->spirv_size = 0;
+    p_module->_internal->spirv_word_count = 0;
+    p_module->_internal->string_pool = p_pool;
+    p_module->_internal->string_pool_size = pool_size;
+  } else {
+    SafeFree(p_pool);
+  }
+  SafeFree(p_table);
+  SafeFree(p_pool_offsets);
+  SafeFree(snapshot.regions);
+  SafeFree(snapshot.sorted_regions);
+  SafeFree(snapshot.code_references);
+  return result;
+}
+
+static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const void* p_code,
+                                           const SpvReflectTaskScheduler* p_scheduler, const char* p_cache_dir,
+                                           SpvReflectShaderModule* p_previous, SpvReflectShaderModule* p_module) {
+  // Initialize all module fields to zero
+  memset(p_module, 0, sizeof(*p_module));
+
+  // Allocate module internals
+#ifdef __cplusplus
+  p_module->_internal = (SpvReflectShaderModule::Internal*)calloc(1, sizeof(*(p_module->_internal)));
+#else
+  p_module->_internal = calloc(1, sizeof(*(p_module->_internal)));
+#endif
+  if (IsNull(p_module->_internal)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  // Copy flags
+  p_module->_internal->module_flags = flags;
+  // Figure out if we need to copy the SPIR-V code or not
+  if (flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) {
+    // Set internal size and pointer to args passed in
+    p_module->_internal->spirv_size = size;
+#if defined(__cplusplus)
+    p_module->_internal->spirv_code = const_cast<uint32_t*>(static_cast<const uint32_t*>(p_code));  // cast that const away
+#else
+    p_module->_internal->spirv_code = (void*)p_code;  // cast that const away
+#endif
+    p_module->_internal->spirv_word_count = (uint32_t)(size / SPIRV_WORD_SIZE);
+  } else {
+    // Allocate SPIR-V code storage
+    p_module->_internal->spirv_size = size;
+    p_module->_internal->spirv_code = (uint32_t*)calloc(1, p_module->_internal->spirv_size);
+    p_module->_internal->spirv_word_count = (uint32_t)(size / SPIRV_WORD_SIZE);
+    if (IsNull(p_module->_internal->spirv_code)) {
+      SafeFree(p_module->_internal);
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+    // Copy SPIR-V to code storage
+    memcpy(p_module->_internal->spirv_code, p_code, size);
+  }
+
+  // Initialize everything to zero
+  SpvReflectPrvParser parser;
+  memset(&parser, 0, sizeof(SpvReflectPrvParser));
+
+  // Create parser
+  SpvReflectResult result = CreateParser(p_module->_internal->spirv_size, p_module->_internal->spirv_code, &parser);
+
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    // A module that cannot be split fails to parse below.
+    HashModuleSections(p_module);
+    if (IsNotNull(p_previous) && CanAdoptPreviousModule(p_previous, p_module)) {
+      parser.p_previous_module = p_previous;
+      InitPreviousRebase(p_previous, p_module, &parser.previous_rebase);
+    }
+  }
+
+  // Generator
+  {
+    const uint32_t* p_ptr = (const uint32_t*)p_module->_internal->spirv_code;
+    p_module->generator = (SpvReflectGenerator)((*(p_ptr + 2) & 0xFFFF0000) >> 16);
+  }
+
+  // Reflection data embedded by spvReflectEmbedReflection or kept in the
+  // cache replaces parsing if it describes exactly this code. Only the
+  // lookup indices are rebuilt.
+  bool loaded = false;
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && ((flags & SPV_REFLECT_MODULE_FLAG_IGNORE_EMBEDDED_REFLECTION) == 0)) {
+    loaded = (LoadEmbeddedReflection(p_module) == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  uint64_t cache_key = 0;
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && !loaded && IsNotNull(p_cache_dir)) {
+    cache_key = HashCacheKey(p_module);
+    loaded = (LoadCachedReflection(p_cache_dir, cache_key, p_module) == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (loaded) {
+    result = ParseDescriptorBindingIndex(p_module);
+    if (result == SPV_REFLECT_RESULT_SUCCESS) {
+      result = ParseEntryPointResources(p_module);
+    }
+    if (result == SPV_REFLECT_RESULT_SUCCESS) {
+      result = ParseEntryPointVariableIndex(p_module);
+    }
+    if (result == SPV_REFLECT_RESULT_SUCCESS) {
+      result = ParseEntryPointIndex(p_module);
+    }
+    if ((result == SPV_REFLECT_RESULT_SUCCESS) && (flags & SPV_REFLECT_MODULE_FLAG_DETACH_CODE)) {
+      result = DetachCode(p_module);
+    }
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      spvReflectDestroyShaderModule(p_module);
+    }
+    DestroyParser(&parser);
+    return result;
+  }
+
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseNodes(&parser);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+    p_module->_internal->hashed_id_map = IsNotNull(parser.node_table) ? 1 : 0;
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseStrings(&parser);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseSource(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseFunctions(&parser);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseMemberCounts(&parser);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseNames(&parser);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseDecorations(&parser);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+
+  // Start of reflection data parsing
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    p_module->source_language = parser.source_language;
+    p_module->source_language_version = parser.source_language_version;
+
+    // Zero out descriptor set data
+    p_module->descriptor_set_count = 0;
+    memset(p_module->descriptor_sets, 0, SPV_REFLECT_MAX_DESCRIPTOR_SETS * sizeof(*p_module->descriptor_sets));
+    // Initialize descriptor set numbers
+    for (uint32_t set_number = 0; set_number < SPV_REFLECT_MAX_DESCRIPTOR_SETS; ++set_number) {
+      p_module->descriptor_sets[set_number].set = (uint32_t)INVALID_VALUE;
+    }
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = IsNotNull(parser.p_previous_module) ? AdoptPreviousTypes(&parser, p_module) : ParseTypes(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseDescriptorBindings(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseDescriptorBindingIndex(p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseDescriptorType(p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseUAVCounterBindings(p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseDescriptorBlocks(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParsePushConstantBlocks(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseSpecConstants(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseEntryPoints(&parser, p_module, p_scheduler);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseEntryPointIndex(p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseEntryPointHeapAccesses(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseCapabilities(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS && p_module->entry_point_count > 0) {
+    SpvReflectEntryPoint* p_entry = &(p_module->entry_points[0]);
+    p_module->entry_point_name = p_entry->name;
+    p_module->entry_point_id = p_entry->id;
+    p_module->spirv_execution_model = p_entry->spirv_execution_model;
+    p_module->shader_stage = p_entry->shader_stage;
+    p_module->input_variable_count = p_entry->input_variable_count;
+    p_module->input_variables = p_entry->input_variables;
+    p_module->output_variable_count = p_entry->output_variable_count;
+    p_module->output_variables = p_entry->output_variables;
+    p_module->interface_variable_count = p_entry->interface_variable_count;
+    p_module->interface_variables = p_entry->interface_variables;
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = DisambiguateStorageBufferSrvUav(p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = SynchronizeDescriptorSets(p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = ParseExecutionModes(&parser, p_module);
+    SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+  }
+
+  // Replaces an entry that did not load. A cache that cannot be written only
+  // costs the next lookup.
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && IsNotNull(p_cache_dir)) {
+    StoreCachedReflection(p_cache_dir, cache_key, p_module);
+  }
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && (flags & SPV_REFLECT_MODULE_FLAG_DETACH_CODE)) {
+    result = DetachCode(p_module);
+  }
+
+  // Destroy module if parse was not successful
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    spvReflectDestroyShaderModule(p_module);
+  }
+
+  DestroyParser(&parser);
+
+  return result;
+}
+
+SpvReflectResult spvReflectCreateShaderModule(size_t size, const void* p_code, SpvReflectShaderModule* p_module) {
+  return CreateShaderModule(0, size, p_code, NULL, NULL, NULL, p_module);
+}
+
+SpvReflectResult spvReflectCreateShaderModule2(uint32_t flags, size_t size, const void* p_code, SpvReflectShaderModule* p_module) {
+  return CreateShaderModule(flags, size, p_code, NULL, NULL, NULL, p_module);
+}
+
+SpvReflectResult spvReflectCreateShaderModule3(uint32_t flags, size_t size, const void* p_code,
+                                               const SpvReflectTaskScheduler* p_scheduler, SpvReflectShaderModule* p_module) {
+  return CreateShaderModule(flags, size, p_code, p_scheduler, NULL, NULL, p_module);
+}
+
+SpvReflectResult spvReflectCreateShaderModuleCached(uint32_t flags, size_t size, const void* p_code, const char* p_cache_dir,
+                                                    SpvReflectShaderModule* p_module) {
+  return CreateShaderModule(flags, size, p_code, NULL, p_cache_dir, NULL, p_module);
+}
+
+SpvReflectResult spvReflectUpdateShaderModule(SpvReflectShaderModule* p_module, size_t size, const void* p_code) {
+  if (IsNull(p_module) || IsNull(p_module->_internal) || IsNull(p_code)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  SpvReflectShaderModule module;
+  SpvReflectResult result = CreateShaderModule(p_module->_internal->module_flags, size, p_code, NULL, NULL, p_module, &module);
+  // Whatever was taken over now belongs to the new module.
+  spvReflectDestroyShaderModule(p_module);
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    *p_module = module;
+  }
+  return result;
+}
+
+SpvReflectResult spvReflectEmbedReflection(size_t size, const void* p_code, size_t* p_embedded_size, void* p_embedded_code) {
+  if (IsNull(p_code) || IsNull(p_embedded_size)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if ((size < SPIRV_MINIMUM_FILE_SIZE) || ((size % SPIRV_WORD_SIZE) != 0) || (size / SPIRV_WORD_SIZE > UINT32_MAX)) {
+    return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_CODE_SIZE;
+  }
+
+  // The payload describes the code it is embedded in, whose word offsets
+  // depend on the payload size. The size of a snapshot does not depend on
+  // word offsets, and a payload may be padded, so this settles after a few
+  // passes of growing the payload.
+  uint32_t* p_code_words = NULL;
+  uint32_t word_count = 0;
+  uint8_t* p_data = NULL;
+  size_t payload_size = 0;
+  bool done = false;
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  for (uint32_t pass = 0; (pass < 8) && !done && (result == SPV_REFLECT_RESULT_SUCCESS); ++pass) {
+    SafeFree(p_code_words);
+    SafeFree(p_data);
+    result = BuildEmbeddedCode((const uint32_t*)p_code, (uint32_t)(size / SPIRV_WORD_SIZE), payload_size, &p_code_words,
+                               &word_count);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      break;
+    }
+    SpvReflectShaderModule module;
+    result = CreateShaderModule(SPV_REFLECT_MODULE_FLAG_NO_COPY | SPV_REFLECT_MODULE_FLAG_IGNORE_EMBEDDED_REFLECTION,
+                                word_count * SPIRV_WORD_SIZE, p_code_words, NULL, NULL, NULL, &module);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      break;
+    }
+    SpvReflectPrvEmbeddedReflection embedded;
+    result = FindEmbeddedReflection(p_code_words, word_count, &embedded);
+    size_t data_size = 0;
+    if (result == SPV_REFLECT_RESULT_SUCCESS) {
+      SpvReflectPrvSha256 code_digest;
+      DigestEmbeddedCode(p_code_words, word_count, &embedded, &code_digest);
+      result = SerializeModule(&module, &code_digest, &p_data, &data_size);
+    }
+    if ((result == SPV_REFLECT_RESULT_SUCCESS) && (data_size <= payload_size)) {
+      // Loading requires the padding to be zero
+      uint8_t* p_padded = (uint8_t*)calloc(1, payload_size);
+      char* p_text = (char*)malloc(Base64Length(payload_size));
+      if (IsNull(p_padded) || IsNull(p_text)) {
+        result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+      } else {
+        memcpy(p_padded, p_data, data_size);
+        WriteEmbeddedPayload(p_code_words, &embedded, p_padded, payload_size, p_text);
+        done = true;
+      }
+      SafeFree(p_padded);
+      SafeFree(p_text);
+    }
+    payload_size = (data_size > payload_size) ? data_size : payload_size;
+    SafeFree(embedded.chunk_offsets);
+    spvReflectDestroyShaderModule(&module);
+  }
+  if ((result == SPV_REFLECT_RESULT_SUCCESS) && !done) {
+    result = SPV_REFLECT_RESULT_ERROR_INTERNAL_ERROR;
+  }
+
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    size_t embedded_size = (size_t)word_count * SPIRV_WORD_SIZE;
+    if (IsNull(p_embedded_code)) {
+      *p_embedded_size = embedded_size;
+    } else if (*p_embedded_size != embedded_size) {
+      result = SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    } else {
+      memcpy(p_embedded_code, p_code_words, embedded_size);
+    }
+  }
+  SafeFree(p_code_words);
+  SafeFree(p_data);
+  return result;
+}
+
+SpvReflectResult spvReflectGetShaderModule(size_t size, const void* p_code, SpvReflectShaderModule* p_module) {
+  return spvReflectCreateShaderModule(size, p_code, p_module);
+}
+
+static void SafeFreeTypes(SpvReflectTypeDescription* p_type) {
+  if (IsNull(p_type) || p_type->copied || SharesStructMembers(p_type)) {
+    return;
+  }
+
+  if (IsNotNull(p_type->members)) {
+    for (size_t i = 0; i < p_type->member_count; ++i) {
+      SpvReflectTypeDescription* p_member = &p_type->members[i];
+      SafeFreeTypes(p_member);
+    }
+
+    SafeFree(p_type->members);
+    p_type->members = NULL;
+  }
+}
+
+static void SafeFreeInterfaceVariable(SpvReflectInterfaceVariable* p_interface) {
+  if (IsNull(p_interface)) {
+    return;
+  }
+
+  if (IsNotNull(p_interface->members)) {
+    for (size_t i = 0; i < p_interface->member_count; ++i) {
+      SpvReflectInterfaceVariable* p_member = &p_interface->members[i];
+      SafeFreeInterfaceVariable(p_member);
+    }
+
+    SafeFree(p_interface->members);
+    p_interface->members = NULL;
+  }
+}
+
+void spvReflectDestroyShaderModule(SpvReflectShaderModule* p_module) {
+  if (IsNull(p_module->_internal)) {
+    return;
+  }
+
+  SafeFree(p_module->source_source);
+
+  // Descriptor set bindings
+  for (size_t i = 0; i < p_module->descriptor_set_count; ++i) {
+    SpvReflectDescriptorSet* p_set = &p_module->descriptor_sets[i];
+    free(p_set->bindings);
+  }
+
+  // Descriptor binding blocks
+  for (size_t i = 0; i < p_module->descriptor_binding_count; ++i) {
+    SpvReflectDescriptorBinding* p_descriptor = &p_module->descriptor_bindings[i];
+    if (IsNotNull(p_descriptor->byte_address_buffer_offsets)) {
+      SafeFree(p_descriptor->byte_address_buffer_offsets);
+    }
+    if (OwnsBlockMembers(p_module, (uint32_t)i)) {
+      SafeFreeBlockVariables(&p_descriptor->block);
+    }
+  }
+  SafeFree(p_module->descriptor_bindings);
+
+  // Entry points
+  for (size_t i = 0; i < p_module->entry_point_count; ++i) {
+    SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
+    for (size_t j = 0; j < p_entry->interface_variable_count; j++) {
+      SafeFreeInterfaceVariable(&p_entry->interface_variables[j]);
+    }
+    for (uint32_t j = 0; j < p_entry->descriptor_set_count; ++j) {
+      SafeFree(p_entry->descriptor_sets[j].bindings);
+    }
+    SafeFree(p_entry->descriptor_sets);
+    SafeFree(p_entry->input_variables);
+    SafeFree(p_entry->output_variables);
+    SafeFree(p_entry->interface_variables);
+    SafeFree(p_entry->used_uniforms);
+    SafeFree(p_entry->used_push_constants);
+    SafeFree(p_entry->execution_modes);
+    SafeFree(p_entry->resource_heap_accesses);
+    SafeFree(p_entry->sampler_heap_accesses);
+  }
+  SafeFree(p_module->capabilities);
+  SafeFree(p_module->entry_points);
+  SafeFree(p_module->spec_constants);
+
+  // Push constants
+  for (size_t i = 0; i < p_module->push_constant_block_count; ++i) {
+    SafeFreeBlockVariables(&p_module->push_constant_blocks[i]);
+  }
+  SafeFree(p_module->push_constant_blocks);
+
+  // Type infos, last first so that struct types outlive the types sharing
+  // their members
+  for (size_t i = p_module->_internal->type_description_count; i > 0; --i) {
+    SpvReflectTypeDescription* p_type = &p_module->_internal->type_descriptions[i - 1];
+    if (SharesStructMembers(p_type)) {
+      continue;
+    }
+    if (IsNotNull(p_type->members)) {
+      SafeFreeTypes(p_type);
+    }
+    SafeFree(p_type->members);
+  }
+  SafeFree(p_module->_internal->type_descriptions);
+
+  // Lookup indices
+  SafeFree(p_module->_internal->descriptor_binding_index_by_number);
+  SafeFree(p_module->_internal->descriptor_binding_index_by_id);
+  SafeFree(p_module->_internal->descriptor_binding_index_by_name);
+  SafeFree(p_module->_internal->descriptor_binding_block_owners);
+  SafeFree(p_module->_internal->entry_point_index_by_name);
+  SafeFree(p_module->_internal->entry_point_descriptor_binding_offsets);
+  SafeFree(p_module->_internal->entry_point_descriptor_bindings);
+  SafeFree(p_module->_internal->entry_point_push_constant_block_offsets);
+  SafeFree(p_module->_internal->entry_point_push_constant_blocks);
+  SafeFree(p_module->_internal->entry_point_variable_index_offsets);
+  SafeFree(p_module->_internal->entry_point_variable_index);
+  SafeFree(p_module->_internal->entry_point_location_table_offsets);
+  SafeFree(p_module->_internal->entry_point_location_table);
+
+  // Free SPIR-V code if there was a copy
+  if ((p_module->_internal->module_flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) == 0) {
+    SafeFree(p_module->_internal->spirv_code);
+  }
+  SafeFree(p_module->_internal->string_pool);
+  // Free internal
+  SafeFree(p_module->_internal);
+}
+
+uint32_t spvReflectGetCodeSize(const SpvReflectShaderModule* p_module) {
+  if (IsNull(p_module)) {
+    return 0;
+  }
+
+  return (uint32_t)(p_module->_internal->spirv_size);
+}
+
+const uint32_t* spvReflectGetCode(const SpvReflectShaderModule* p_module) {
+  if (IsNull(p_module)) {
+    return NULL;
+  }
+
+  return p_module->_internal->spirv_code;
+}
+
+static uint32_t FindEntryPointIndex(const SpvReflectShaderModule* p_module, const char* entry_point) {
+  uint32_t capacity = p_module->_internal->entry_point_index_capacity;
+  if (capacity == 0) {
+    return UINT32_MAX;
+  }
+  const uint32_t* table = p_module->_internal->entry_point_index_by_name;
+  uint32_t mask = capacity - 1;
+  for (uint32_t slot = HashString(entry_point) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+    uint32_t index = table[slot] - 1;
+    if (strcmp(p_module->entry_points[index].name, entry_point) == 0) {
+      return index;
+    }
+  }
+  return UINT32_MAX;
+}
+
+static const SpvReflectEntryPoint* GetEntryPointByIndex(const SpvReflectShaderModule* p_module, uint32_t entry_point_index) {
+  if (IsNull(p_module) || (entry_point_index >= p_module->entry_point_count)) {
+    return NULL;
+  }
+  return &p_module->entry_points[entry_point_index];
+}
+
+const SpvReflectEntryPoint* spvReflectGetEntryPoint(const SpvReflectShaderModule* p_module, const char* entry_point) {
+  if (IsNull(p_module) || IsNull(entry_point)) {
+    return NULL;
+  }
+  return GetEntryPointByIndex(p_module, FindEntryPointIndex(p_module, entry_point));
+}
+
+uint32_t spvReflectGetEntryPointIndex(const SpvReflectShaderModule* p_module, const char* entry_point, SpvReflectResult* p_result) {
+  if (IsNull(p_module) || IsNull(entry_point)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return UINT32_MAX;
+  }
+  uint32_t index = FindEntryPointIndex(p_module, entry_point);
+  if (IsNotNull(p_result)) {
+    *p_result = (index != UINT32_MAX) ? SPV_REFLECT_RESULT_SUCCESS : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+  return index;
+}
+
+SpvReflectResult spvReflectEnumerateDescriptorBindings(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                       SpvReflectDescriptorBinding** pp_bindings) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  if (IsNotNull(pp_bindings)) {
+    if (*p_count != p_module->descriptor_binding_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectDescriptorBinding* p_bindings = (SpvReflectDescriptorBinding*)&p_module->descriptor_bindings[index];
+      pp_bindings[index] = p_bindings;
+    }
+  } else {
+    *p_count = p_module->descriptor_binding_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult EnumerateEntryPointDescriptorBindings(const SpvReflectShaderModule* p_module,
+                                                              const SpvReflectEntryPoint* p_entry, uint32_t* p_count,
+                                                              SpvReflectDescriptorBinding** pp_bindings) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+
+  uint32_t entry_point_index = (uint32_t)(p_entry - p_module->entry_points);
+  uint32_t first = p_module->_internal->entry_point_descriptor_binding_offsets[entry_point_index];
+  uint32_t count = p_module->_internal->entry_point_descriptor_binding_offsets[entry_point_index + 1] - first;
+  if (IsNotNull(pp_bindings)) {
+    if (count != *p_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+    if (count > 0) {
+      memcpy(pp_bindings, p_module->_internal->entry_point_descriptor_bindings + first, count * sizeof(*pp_bindings));
+    }
+  } else {
+    *p_count = count;
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointDescriptorBindings(const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                                 uint32_t* p_count, SpvReflectDescriptorBinding** pp_bindings) {
+  return EnumerateEntryPointDescriptorBindings(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, pp_bindings);
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointDescriptorBindingsByIndex(const SpvReflectShaderModule* p_module,
+                                                                        uint32_t entry_point_index, uint32_t* p_count,
+                                                                        SpvReflectDescriptorBinding** pp_bindings) {
+  return EnumerateEntryPointDescriptorBindings(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, pp_bindings);
+}
+
+SpvReflectResult spvReflectEnumerateDescriptorSets(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                   SpvReflectDescriptorSet** pp_sets) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  if (IsNotNull(pp_sets)) {
+    if (*p_count != p_module->descriptor_set_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectDescriptorSet* p_set = (SpvReflectDescriptorSet*)&p_module->descriptor_sets[index];
+      pp_sets[index] = p_set;
+    }
+  } else {
+    *p_count = p_module->descriptor_set_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult EnumerateEntryPointDescriptorSets(const SpvReflectShaderModule* p_module,
+                                                          const SpvReflectEntryPoint* p_entry, uint32_t* p_count,
+                                                          SpvReflectDescriptorSet** pp_sets) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+
+  if (IsNotNull(pp_sets)) {
+    if (*p_count != p_entry->descriptor_set_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectDescriptorSet* p_set = (SpvReflectDescriptorSet*)&p_entry->descriptor_sets[index];
+      pp_sets[index] = p_set;
+    }
+  } else {
+    *p_count = p_entry->descriptor_set_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointDescriptorSets(const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                             uint32_t* p_count, SpvReflectDescriptorSet** pp_sets) {
+  return EnumerateEntryPointDescriptorSets(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, pp_sets);
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointDescriptorSetsByIndex(const SpvReflectShaderModule* p_module,
+                                                                    uint32_t entry_point_index, uint32_t* p_count,
+                                                                    SpvReflectDescriptorSet** pp_sets) {
+  return EnumerateEntryPointDescriptorSets(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, pp_sets);
+}
+
+SpvReflectResult spvReflectEnumerateInterfaceVariables(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                       SpvReflectInterfaceVariable** pp_variables) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  if (IsNotNull(pp_variables)) {
+    if (*p_count != p_module->interface_variable_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectInterfaceVariable* p_var = &p_module->interface_variables[index];
+      pp_variables[index] = p_var;
+    }
+  } else {
+    *p_count = p_module->interface_variable_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult EnumerateEntryPointInterfaceVariables(const SpvReflectShaderModule* p_module,
+                                                              const SpvReflectEntryPoint* p_entry, uint32_t* p_count,
+                                                              SpvReflectInterfaceVariable** pp_variables) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+
+  if (IsNotNull(pp_variables)) {
+    if (*p_count != p_entry->interface_variable_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectInterfaceVariable* p_var = &p_entry->interface_variables[index];
+      pp_variables[index] = p_var;
+    }
+  } else {
+    *p_count = p_entry->interface_variable_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointInterfaceVariables(const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                                 uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) {
+  return EnumerateEntryPointInterfaceVariables(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, pp_variables);
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointInterfaceVariablesByIndex(const SpvReflectShaderModule* p_module,
+                                                                        uint32_t entry_point_index, uint32_t* p_count,
+                                                                        SpvReflectInterfaceVariable** pp_variables) {
+  return EnumerateEntryPointInterfaceVariables(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, pp_variables);
+}
+
+SpvReflectResult spvReflectEnumerateInputVariables(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                   SpvReflectInterfaceVariable** pp_variables) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  if (IsNotNull(pp_variables)) {
+    if (*p_count != p_module->input_variable_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectInterfaceVariable* p_var = p_module->input_variables[index];
+      pp_variables[index] = p_var;
+    }
+  } else {
+    *p_count = p_module->input_variable_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult EnumerateEntryPointInputVariables(const SpvReflectShaderModule* p_module,
+                                                          const SpvReflectEntryPoint* p_entry, uint32_t* p_count,
+                                                          SpvReflectInterfaceVariable** pp_variables) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+
+  if (IsNotNull(pp_variables)) {
+    if (*p_count != p_entry->input_variable_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectInterfaceVariable* p_var = p_entry->input_variables[index];
+      pp_variables[index] = p_var;
+    }
+  } else {
+    *p_count = p_entry->input_variable_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointInputVariables(const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                             uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) {
+  return EnumerateEntryPointInputVariables(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, pp_variables);
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointInputVariablesByIndex(const SpvReflectShaderModule* p_module,
+                                                                    uint32_t entry_point_index, uint32_t* p_count,
+                                                                    SpvReflectInterfaceVariable** pp_variables) {
+  return EnumerateEntryPointInputVariables(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, pp_variables);
+}
+
+SpvReflectResult spvReflectEnumerateOutputVariables(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                    SpvReflectInterfaceVariable** pp_variables) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  if (IsNotNull(pp_variables)) {
+    if (*p_count != p_module->output_variable_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectInterfaceVariable* p_var = p_module->output_variables[index];
+      pp_variables[index] = p_var;
+    }
+  } else {
+    *p_count = p_module->output_variable_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult EnumerateEntryPointOutputVariables(const SpvReflectShaderModule* p_module,
+                                                           const SpvReflectEntryPoint* p_entry, uint32_t* p_count,
+                                                           SpvReflectInterfaceVariable** pp_variables) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+
+  if (IsNotNull(pp_variables)) {
+    if (*p_count != p_entry->output_variable_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectInterfaceVariable* p_var = p_entry->output_variables[index];
+      pp_variables[index] = p_var;
+    }
+  } else {
+    *p_count = p_entry->output_variable_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointOutputVariables(const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                              uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) {
+  return EnumerateEntryPointOutputVariables(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, pp_variables);
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointOutputVariablesByIndex(const SpvReflectShaderModule* p_module,
+                                                                     uint32_t entry_point_index, uint32_t* p_count,
+                                                                     SpvReflectInterfaceVariable** pp_variables) {
+  return EnumerateEntryPointOutputVariables(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, pp_variables);
+}
+
+SpvReflectResult spvReflectEnumeratePushConstantBlocks(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                       SpvReflectBlockVariable** pp_blocks) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  if (pp_blocks != NULL) {
+    if (*p_count != p_module->push_constant_block_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectBlockVariable* p_push_constant_blocks = (SpvReflectBlockVariable*)&p_module->push_constant_blocks[index];
+      pp_blocks[index] = p_push_constant_blocks;
+    }
+  } else {
+    *p_count = p_module->push_constant_block_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+SpvReflectResult spvReflectEnumeratePushConstants(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                  SpvReflectBlockVariable** pp_blocks) {
+  return spvReflectEnumeratePushConstantBlocks(p_module, p_count, pp_blocks);
+}
+
+static SpvReflectResult EnumerateEntryPointPushConstantBlocks(const SpvReflectShaderModule* p_module,
+                                                              const SpvReflectEntryPoint* p_entry, uint32_t* p_count,
+                                                              SpvReflectBlockVariable** pp_blocks) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+
+  uint32_t entry_point_index = (uint32_t)(p_entry - p_module->entry_points);
+  uint32_t first = p_module->_internal->entry_point_push_constant_block_offsets[entry_point_index];
+  uint32_t count = p_module->_internal->entry_point_push_constant_block_offsets[entry_point_index + 1] - first;
+  if (IsNotNull(pp_blocks)) {
+    if (count != *p_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+    if (count > 0) {
+      memcpy(pp_blocks, p_module->_internal->entry_point_push_constant_blocks + first, count * sizeof(*pp_blocks));
+    }
+  } else {
+    *p_count = count;
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointPushConstantBlocks(const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                                 uint32_t* p_count, SpvReflectBlockVariable** pp_blocks) {
+  return EnumerateEntryPointPushConstantBlocks(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, pp_blocks);
+}
+
+SpvReflectResult spvReflectEnumerateEntryPointPushConstantBlocksByIndex(const SpvReflectShaderModule* p_module,
+                                                                        uint32_t entry_point_index, uint32_t* p_count,
+                                                                        SpvReflectBlockVariable** pp_blocks) {
+  return EnumerateEntryPointPushConstantBlocks(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, pp_blocks);
+}
+
+SpvReflectResult spvReflectEnumerateSpecializationConstants(const SpvReflectShaderModule* p_module, uint32_t* p_count,
+                                                            SpvReflectSpecializationConstant** pp_constants) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+
+  if (IsNotNull(pp_constants)) {
+    if (*p_count != p_module->spec_constant_count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+
+    for (uint32_t index = 0; index < *p_count; ++index) {
+      SpvReflectSpecializationConstant* p_constant = (SpvReflectSpecializationConstant*)&p_module->spec_constants[index];
+      pp_constants[index] = p_constant;
+    }
+  } else {
+    *p_count = p_module->spec_constant_count;
+  }
+
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+const SpvReflectDescriptorBinding* spvReflectGetDescriptorBinding(const SpvReflectShaderModule* p_module, uint32_t binding_number,
+                                                                  uint32_t set_number, SpvReflectResult* p_result) {
+  const SpvReflectDescriptorBinding* p_descriptor = NULL;
+  if (IsNotNull(p_module)) {
+    p_descriptor = FindDescriptorBindingByNumber(p_module, binding_number, set_number, NULL);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_descriptor)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_descriptor;
+}
+
+static const SpvReflectDescriptorBinding* const* GetEntryPointDescriptorBindingArray(const SpvReflectShaderModule* p_module,
+                                                                                  const SpvReflectEntryPoint* p_entry,
+                                                                                  uint32_t* p_count, SpvReflectResult* p_result) {
+  if (IsNull(p_module) || IsNull(p_count)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+  if (IsNull(p_entry)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  uint32_t entry_point_index = (uint32_t)(p_entry - p_module->entry_points);
+  uint32_t first = p_module->_internal->entry_point_descriptor_binding_offsets[entry_point_index];
+  *p_count = p_module->_internal->entry_point_descriptor_binding_offsets[entry_point_index + 1] - first;
+  if (IsNotNull(p_result)) {
+    *p_result = SPV_REFLECT_RESULT_SUCCESS;
+  }
+  return (*p_count > 0) ? (const SpvReflectDescriptorBinding* const*)(p_module->_internal->entry_point_descriptor_bindings + first)
+                        : NULL;
+}
+
+const SpvReflectDescriptorBinding* const* spvReflectGetEntryPointDescriptorBindingArray(const SpvReflectShaderModule* p_module,
+                                                                                        const char* entry_point, uint32_t* p_count,
+                                                                                        SpvReflectResult* p_result) {
+  return GetEntryPointDescriptorBindingArray(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, p_result);
+}
+
+const SpvReflectDescriptorBinding* const* spvReflectGetEntryPointDescriptorBindingArrayByIndex(
+    const SpvReflectShaderModule* p_module, uint32_t entry_point_index, uint32_t* p_count, SpvReflectResult* p_result) {
+  return GetEntryPointDescriptorBindingArray(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, p_result);
+}
+
+static const SpvReflectDescriptorBinding* GetEntryPointDescriptorBinding(const SpvReflectShaderModule* p_module,
+                                                                         const SpvReflectEntryPoint* p_entry,
+                                                                         uint32_t binding_number, uint32_t set_number,
+                                                                         SpvReflectResult* p_result) {
+  if (IsNull(p_entry)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  const SpvReflectDescriptorBinding* p_descriptor = NULL;
+  if (IsNotNull(p_module)) {
+    p_descriptor = FindDescriptorBindingByNumber(p_module, binding_number, set_number, p_entry);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_descriptor)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_descriptor;
+}
+
+const SpvReflectDescriptorBinding* spvReflectGetEntryPointDescriptorBinding(const SpvReflectShaderModule* p_module,
+                                                                            const char* entry_point, uint32_t binding_number,
+                                                                            uint32_t set_number, SpvReflectResult* p_result) {
+  return GetEntryPointDescriptorBinding(p_module, spvReflectGetEntryPoint(p_module, entry_point), binding_number, set_number,
+                                        p_result);
+}
+
+const SpvReflectDescriptorBinding* spvReflectGetEntryPointDescriptorBindingByIndex(const SpvReflectShaderModule* p_module,
+                                                                                   uint32_t entry_point_index,
+                                                                                   uint32_t binding_number, uint32_t set_number,
+                                                                                   SpvReflectResult* p_result) {
+  return GetEntryPointDescriptorBinding(p_module, GetEntryPointByIndex(p_module, entry_point_index), binding_number, set_number,
+                                        p_result);
+}
+
+const SpvReflectDescriptorBinding* spvReflectGetDescriptorBindingByName(const SpvReflectShaderModule* p_module, const char* name,
+                                                                        SpvReflectResult* p_result) {
+  const SpvReflectDescriptorBinding* p_descriptor = NULL;
+  if (IsNotNull(p_module) && IsNotNull(name)) {
+    p_descriptor = FindDescriptorBindingByName(p_module, name, (SpvReflectDescriptorType)INVALID_VALUE);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_descriptor) ? SPV_REFLECT_RESULT_SUCCESS
+                                        : ((IsNull(p_module) || IsNull(name)) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER
+                                                                              : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_descriptor;
+}
+
+const SpvReflectDescriptorBinding* spvReflectGetDescriptorBindingById(const SpvReflectShaderModule* p_module, uint32_t spirv_id,
+                                                                      SpvReflectResult* p_result) {
+  const SpvReflectDescriptorBinding* p_descriptor = NULL;
+  if (IsNotNull(p_module)) {
+    p_descriptor = FindDescriptorBindingById(p_module, spirv_id);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_descriptor)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_descriptor;
+}
+
+const SpvReflectDescriptorSet* spvReflectGetDescriptorSet(const SpvReflectShaderModule* p_module, uint32_t set_number,
+                                                          SpvReflectResult* p_result) {
+  const SpvReflectDescriptorSet* p_set = NULL;
+  if (IsNotNull(p_module)) {
+    for (uint32_t index = 0; index < p_module->descriptor_set_count; ++index) {
+      const SpvReflectDescriptorSet* p_potential = &p_module->descriptor_sets[index];
+      if (p_potential->set == set_number) {
+        p_set = p_potential;
+      }
+    }
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_set)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_set;
+}
+
+static const SpvReflectDescriptorSet* GetEntryPointDescriptorSet(const SpvReflectShaderModule* p_module,
+                                                                 const SpvReflectEntryPoint* p_entry, uint32_t set_number,
+                                                                 SpvReflectResult* p_result) {
+  const SpvReflectDescriptorSet* p_set = NULL;
+  if (IsNotNull(p_module)) {
+    if (IsNull(p_entry)) {
+      if (IsNotNull(p_result)) {
+        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+      }
+      return NULL;
+    }
+    for (uint32_t index = 0; index < p_entry->descriptor_set_count; ++index) {
+      const SpvReflectDescriptorSet* p_potential = &p_entry->descriptor_sets[index];
+      if (p_potential->set == set_number) {
+        p_set = p_potential;
+      }
+    }
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_set)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_set;
+}
+
+const SpvReflectDescriptorSet* spvReflectGetEntryPointDescriptorSet(const SpvReflectShaderModule* p_module,
+                                                                    const char* entry_point, uint32_t set_number,
+                                                                    SpvReflectResult* p_result) {
+  return GetEntryPointDescriptorSet(p_module, spvReflectGetEntryPoint(p_module, entry_point), set_number, p_result);
+}
+
+const SpvReflectDescriptorSet* spvReflectGetEntryPointDescriptorSetByIndex(const SpvReflectShaderModule* p_module,
+                                                                           uint32_t entry_point_index, uint32_t set_number,
+                                                                           SpvReflectResult* p_result) {
+  return GetEntryPointDescriptorSet(p_module, GetEntryPointByIndex(p_module, entry_point_index), set_number, p_result);
+}
+
+static const SpvReflectInterfaceVariable* FindEntryPointVariableByLocation(const SpvReflectShaderModule* p_module,
+                                                                           const SpvReflectEntryPoint* p_entry, bool output,
+                                                                           uint32_t location) {
+  if (IsNull(p_entry)) {
+    return NULL;
+  }
+  uint32_t capacity = 0;
+  const uint32_t* table = GetEntryPointVariableIndex(p_module, p_entry, output, false, &capacity);
+  if (capacity == 0) {
+    return NULL;
+  }
+  SpvReflectInterfaceVariable** pp_variables = output ? p_entry->output_variables : p_entry->input_variables;
+  uint32_t mask = capacity - 1;
+  for (uint32_t slot = HashUint32(location) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+    const SpvReflectInterfaceVariable* p_var = pp_variables[table[slot] - 1];
+    if (p_var->location == location) {
+      return p_var;
+    }
+  }
+  return NULL;
+}
+
+static const SpvReflectInterfaceVariable* FindEntryPointVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                           const SpvReflectEntryPoint* p_entry, bool output,
+                                                                           const char* semantic) {
+  if (IsNull(p_entry)) {
+    return NULL;
+  }
+  uint32_t capacity = 0;
+  const uint32_t* table = GetEntryPointVariableIndex(p_module, p_entry, output, true, &capacity);
+  if (capacity == 0) {
+    return NULL;
+  }
+  SpvReflectInterfaceVariable** pp_variables = output ? p_entry->output_variables : p_entry->input_variables;
+  uint32_t mask = capacity - 1;
+  for (uint32_t slot = HashString(semantic) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+    const SpvReflectInterfaceVariable* p_var = pp_variables[table[slot] - 1];
+    if (strcmp(p_var->semantic, semantic) == 0) {
+      return p_var;
+    }
+  }
+  return NULL;
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetInputVariableByLocation(const SpvReflectShaderModule* p_module, uint32_t location,
+                                                                        SpvReflectResult* p_result) {
+  if (location == (uint32_t)INVALID_VALUE) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    p_var = FindEntryPointVariableByLocation(p_module, GetEntryPointByIndex(p_module, 0), false, location);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+const SpvReflectInterfaceVariable* spvReflectGetInputVariable(const SpvReflectShaderModule* p_module, uint32_t location,
+                                                              SpvReflectResult* p_result) {
+  return spvReflectGetInputVariableByLocation(p_module, location, p_result);
+}
+
+static const SpvReflectInterfaceVariable* GetEntryPointInputVariableByLocation(const SpvReflectShaderModule* p_module,
+                                                                               const SpvReflectEntryPoint* p_entry,
+                                                                               uint32_t location, SpvReflectResult* p_result) {
+  if (location == (uint32_t)INVALID_VALUE) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    if (IsNull(p_entry)) {
+      if (IsNotNull(p_result)) {
+        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+      }
+      return NULL;
+    }
+    p_var = FindEntryPointVariableByLocation(p_module, p_entry, false, location);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetEntryPointInputVariableByLocation(const SpvReflectShaderModule* p_module,
+                                                                                  const char* entry_point, uint32_t location,
+                                                                                  SpvReflectResult* p_result) {
+  return GetEntryPointInputVariableByLocation(p_module, spvReflectGetEntryPoint(p_module, entry_point), location, p_result);
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointInputVariableByLocation(const SpvReflectShaderModule* p_module,
+                                                                                         uint32_t entry_point_index,
+                                                                                         uint32_t location,
+                                                                                         SpvReflectResult* p_result) {
+  return GetEntryPointInputVariableByLocation(p_module, GetEntryPointByIndex(p_module, entry_point_index), location, p_result);
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetInputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                        const char* semantic, SpvReflectResult* p_result) {
+  if (IsNull(semantic)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+  if (semantic[0] == '\0') {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    p_var = FindEntryPointVariableBySemantic(p_module, GetEntryPointByIndex(p_module, 0), false, semantic);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+
+static const SpvReflectInterfaceVariable* GetEntryPointInputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                               const SpvReflectEntryPoint* p_entry,
+                                                                               const char* semantic, SpvReflectResult* p_result) {
+  if (IsNull(semantic)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+  if (semantic[0] == '\0') {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    if (IsNull(p_entry)) {
+      if (IsNotNull(p_result)) {
+        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+      }
+      return NULL;
+    }
+    p_var = FindEntryPointVariableBySemantic(p_module, p_entry, false, semantic);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetEntryPointInputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                                  const char* entry_point, const char* semantic,
+                                                                                  SpvReflectResult* p_result) {
+  return GetEntryPointInputVariableBySemantic(p_module, spvReflectGetEntryPoint(p_module, entry_point), semantic, p_result);
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointInputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                                         uint32_t entry_point_index,
+                                                                                         const char* semantic,
+                                                                                         SpvReflectResult* p_result) {
+  return GetEntryPointInputVariableBySemantic(p_module, GetEntryPointByIndex(p_module, entry_point_index), semantic, p_result);
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetOutputVariableByLocation(const SpvReflectShaderModule* p_module, uint32_t location,
+                                                                         SpvReflectResult* p_result) {
+  if (location == (uint32_t)INVALID_VALUE) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    p_var = FindEntryPointVariableByLocation(p_module, GetEntryPointByIndex(p_module, 0), true, location);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+const SpvReflectInterfaceVariable* spvReflectGetOutputVariable(const SpvReflectShaderModule* p_module, uint32_t location,
+                                                               SpvReflectResult* p_result) {
+  return spvReflectGetOutputVariableByLocation(p_module, location, p_result);
+}
+
+static const SpvReflectInterfaceVariable* GetEntryPointOutputVariableByLocation(const SpvReflectShaderModule* p_module,
+                                                                                const SpvReflectEntryPoint* p_entry,
+                                                                                uint32_t location, SpvReflectResult* p_result) {
+  if (location == (uint32_t)INVALID_VALUE) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    if (IsNull(p_entry)) {
+      if (IsNotNull(p_result)) {
+        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+      }
+      return NULL;
+    }
+    p_var = FindEntryPointVariableByLocation(p_module, p_entry, true, location);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetEntryPointOutputVariableByLocation(const SpvReflectShaderModule* p_module,
+                                                                                   const char* entry_point, uint32_t location,
+                                                                                   SpvReflectResult* p_result) {
+  return GetEntryPointOutputVariableByLocation(p_module, spvReflectGetEntryPoint(p_module, entry_point), location, p_result);
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointOutputVariableByLocation(const SpvReflectShaderModule* p_module,
+                                                                                          uint32_t entry_point_index,
+                                                                                          uint32_t location,
+                                                                                          SpvReflectResult* p_result) {
+  return GetEntryPointOutputVariableByLocation(p_module, GetEntryPointByIndex(p_module, entry_point_index), location, p_result);
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetOutputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                         const char* semantic, SpvReflectResult* p_result) {
+  if (IsNull(semantic)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+  if (semantic[0] == '\0') {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    p_var = FindEntryPointVariableBySemantic(p_module, GetEntryPointByIndex(p_module, 0), true, semantic);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+
+static const SpvReflectInterfaceVariable* GetEntryPointOutputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                                const SpvReflectEntryPoint* p_entry,
+                                                                                const char* semantic, SpvReflectResult* p_result) {
+  if (IsNull(semantic)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+  if (semantic[0] == '\0') {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    }
+    return NULL;
+  }
+  const SpvReflectInterfaceVariable* p_var = NULL;
+  if (IsNotNull(p_module)) {
+    if (IsNull(p_entry)) {
+      if (IsNotNull(p_result)) {
+        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+      }
+      return NULL;
+    }
+    p_var = FindEntryPointVariableBySemantic(p_module, p_entry, true, semantic);
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_var)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_var;
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetEntryPointOutputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                                   const char* entry_point, const char* semantic,
+                                                                                   SpvReflectResult* p_result) {
+  return GetEntryPointOutputVariableBySemantic(p_module, spvReflectGetEntryPoint(p_module, entry_point), semantic, p_result);
+}
+
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointOutputVariableBySemantic(const SpvReflectShaderModule* p_module,
+                                                                                          uint32_t entry_point_index,
+                                                                                          const char* semantic,
+                                                                                          SpvReflectResult* p_result) {
+  return GetEntryPointOutputVariableBySemantic(p_module, GetEntryPointByIndex(p_module, entry_point_index), semantic, p_result);
+}
+
+const SpvReflectBlockVariable* spvReflectGetPushConstantBlock(const SpvReflectShaderModule* p_module, uint32_t index,
+                                                              SpvReflectResult* p_result) {
+  const SpvReflectBlockVariable* p_push_constant = NULL;
+  if (IsNotNull(p_module)) {
+    if (index < p_module->push_constant_block_count) {
+      p_push_constant = &p_module->push_constant_blocks[index];
+    }
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_push_constant)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_push_constant;
+}
+const SpvReflectBlockVariable* spvReflectGetPushConstant(const SpvReflectShaderModule* p_module, uint32_t index,
+                                                         SpvReflectResult* p_result) {
+  return spvReflectGetPushConstantBlock(p_module, index, p_result);
+}
+
+static const SpvReflectBlockVariable* const* GetEntryPointPushConstantBlockArray(const SpvReflectShaderModule* p_module,
+                                                                              const SpvReflectEntryPoint* p_entry,
+                                                                              uint32_t* p_count, SpvReflectResult* p_result) {
+  if (IsNull(p_module) || IsNull(p_count)) {
+    if (IsNotNull(p_result)) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+  if (IsNull(p_entry)) {
+    if (IsNotNull(p_result)) {
       *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
     }
-    return NULL;
+    return NULL;
+  }
+  uint32_t entry_point_index = (uint32_t)(p_entry - p_module->entry_points);
+  uint32_t first = p_module->_internal->entry_point_push_constant_block_offsets[entry_point_index];
+  *p_count = p_module->_internal->entry_point_push_constant_block_offsets[entry_point_index + 1] - first;
+  if (IsNotNull(p_result)) {
+    *p_result = SPV_REFLECT_RESULT_SUCCESS;
+  }
+  return (*p_count > 0) ? (const SpvReflectBlockVariable* const*)(p_module->_internal->entry_point_push_constant_blocks + first)
+                        : NULL;
+}
+
+const SpvReflectBlockVariable* const* spvReflectGetEntryPointPushConstantBlockArray(const SpvReflectShaderModule* p_module,
+                                                                                    const char* entry_point, uint32_t* p_count,
+                                                                                    SpvReflectResult* p_result) {
+  return GetEntryPointPushConstantBlockArray(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_count, p_result);
+}
+
+const SpvReflectBlockVariable* const* spvReflectGetEntryPointPushConstantBlockArrayByIndex(const SpvReflectShaderModule* p_module,
+                                                                                           uint32_t entry_point_index,
+                                                                                           uint32_t* p_count,
+                                                                                           SpvReflectResult* p_result) {
+  return GetEntryPointPushConstantBlockArray(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_count, p_result);
+}
+
+static const SpvReflectBlockVariable* GetEntryPointPushConstantBlock(const SpvReflectShaderModule* p_module,
+                                                                     const SpvReflectEntryPoint* p_entry,
+                                                                     SpvReflectResult* p_result) {
+  const SpvReflectBlockVariable* p_push_constant = NULL;
+  if (IsNotNull(p_module)) {
+    if (IsNull(p_entry)) {
+      if (IsNotNull(p_result)) {
+        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+      }
+      return NULL;
+    }
+    for (uint32_t i = 0; i < p_module->push_constant_block_count; ++i) {
+      bool found = SearchSortedUint32(p_entry->used_push_constants, p_entry->used_push_constant_count,
+                                      p_module->push_constant_blocks[i].spirv_id);
+      if (found) {
+        p_push_constant = &p_module->push_constant_blocks[i];
+        break;
+      }
+    }
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_push_constant)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_push_constant;
+}
+
+const SpvReflectBlockVariable* spvReflectGetEntryPointPushConstantBlock(const SpvReflectShaderModule* p_module,
+                                                                        const char* entry_point, SpvReflectResult* p_result) {
+  return GetEntryPointPushConstantBlock(p_module, spvReflectGetEntryPoint(p_module, entry_point), p_result);
+}
+
+const SpvReflectBlockVariable* spvReflectGetEntryPointPushConstantBlockByIndex(const SpvReflectShaderModule* p_module,
+                                                                               uint32_t entry_point_index,
+                                                                               SpvReflectResult* p_result) {
+  return GetEntryPointPushConstantBlock(p_module, GetEntryPointByIndex(p_module, entry_point_index), p_result);
+}
+
+SpvReflectResult spvReflectChangeDescriptorBindingNumbers(SpvReflectShaderModule* p_module,
+                                                          const SpvReflectDescriptorBinding* p_binding, uint32_t new_binding_number,
+                                                          uint32_t new_set_binding) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_binding)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_module->_internal->spirv_code)) {
+    return SPV_REFLECT_RESULT_ERROR_CODE_UNAVAILABLE;
+  }
+
+  SpvReflectDescriptorBinding* p_target_descriptor = FindDescriptorBindingById(p_module, p_binding->spirv_id);
+  if (p_target_descriptor != p_binding) {
+    p_target_descriptor = NULL;
+  }
+
+  if (IsNotNull(p_target_descriptor)) {
+    if (p_target_descriptor->word_offset.binding > (p_module->_internal->spirv_word_count - 1)) {
+      return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+    }
+    // Binding number
+    if (new_binding_number != (uint32_t)SPV_REFLECT_BINDING_NUMBER_DONT_CHANGE) {
+      uint32_t* p_code = p_module->_internal->spirv_code + p_target_descriptor->word_offset.binding;
+      *p_code = new_binding_number;
+      p_target_descriptor->binding = new_binding_number;
+    }
+    // Set number
+    if (new_set_binding != (uint32_t)SPV_REFLECT_SET_NUMBER_DONT_CHANGE) {
+      uint32_t* p_code = p_module->_internal->spirv_code + p_target_descriptor->word_offset.set;
+      *p_code = new_set_binding;
+      p_target_descriptor->set = new_set_binding;
+    }
+    RehashModuleAnnotations(p_module);
+    IndexDescriptorBindingNumbers(p_module);
+  }
+
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  if (new_set_binding != (uint32_t)SPV_REFLECT_SET_NUMBER_DONT_CHANGE) {
+    result = SynchronizeDescriptorSets(p_module);
+  }
+  return result;
+}
+SpvReflectResult spvReflectChangeDescriptorBindingNumber(SpvReflectShaderModule* p_module,
+                                                         const SpvReflectDescriptorBinding* p_descriptor_binding,
+                                                         uint32_t new_binding_number, uint32_t optional_new_set_number) {
+  return spvReflectChangeDescriptorBindingNumbers(p_module, p_descriptor_binding, new_binding_number, optional_new_set_number);
+}
+
+SpvReflectResult spvReflectChangeDescriptorSetNumber(SpvReflectShaderModule* p_module, const SpvReflectDescriptorSet* p_set,
+                                                     uint32_t new_set_number) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_set)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_module->_internal->spirv_code)) {
+    return SPV_REFLECT_RESULT_ERROR_CODE_UNAVAILABLE;
+  }
+  SpvReflectDescriptorSet* p_target_set = NULL;
+  for (uint32_t index = 0; index < SPV_REFLECT_MAX_DESCRIPTOR_SETS; ++index) {
+    // The descriptor sets for specific entry points might not be in this set,
+    // so just match on set index.
+    if (p_module->descriptor_sets[index].set == p_set->set) {
+      p_target_set = (SpvReflectDescriptorSet*)p_set;
+      break;
+    }
+  }
+
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  if (IsNotNull(p_target_set) && new_set_number != (uint32_t)SPV_REFLECT_SET_NUMBER_DONT_CHANGE) {
+    for (uint32_t index = 0; index < p_target_set->binding_count; ++index) {
+      SpvReflectDescriptorBinding* p_descriptor = p_target_set->bindings[index];
+      if (p_descriptor->word_offset.set > (p_module->_internal->spirv_word_count - 1)) {
+        return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+      }
+
+      uint32_t* p_code = p_module->_internal->spirv_code + p_descriptor->word_offset.set;
+      *p_code = new_set_number;
+      p_descriptor->set = new_set_number;
+    }
+    RehashModuleAnnotations(p_module);
+    IndexDescriptorBindingNumbers(p_module);
+
+    result = SynchronizeDescriptorSets(p_module);
+  }
+
+  return result;
+}
+
+static SpvReflectResult ChangeVariableLocation(SpvReflectShaderModule* p_module, SpvReflectInterfaceVariable* p_variable,
+                                               uint32_t new_location) {
+  if (IsNull(p_module->_internal->spirv_code)) {
+    return SPV_REFLECT_RESULT_ERROR_CODE_UNAVAILABLE;
+  }
+  if (p_variable->word_offset.location > (p_module->_internal->spirv_word_count - 1)) {
+    return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+  }
+  uint32_t* p_code = p_module->_internal->spirv_code + p_variable->word_offset.location;
+  *p_code = new_location;
+  p_variable->location = new_location;
+  RehashModuleAnnotations(p_module);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectChangeInputVariableLocation(SpvReflectShaderModule* p_module,
+                                                       const SpvReflectInterfaceVariable* p_input_variable, uint32_t new_location) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_input_variable)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  for (uint32_t index = 0; index < p_module->input_variable_count; ++index) {
+    if (p_module->input_variables[index] == p_input_variable) {
+      SpvReflectResult result = ChangeVariableLocation(p_module, p_module->input_variables[index], new_location);
+      IndexEntryPointVariableLocations(p_module);
+      return result;
+    }
+  }
+  return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+}
+
+SpvReflectResult spvReflectChangeOutputVariableLocation(SpvReflectShaderModule* p_module,
+                                                        const SpvReflectInterfaceVariable* p_output_variable,
+                                                        uint32_t new_location) {
+  if (IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  if (IsNull(p_output_variable)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  for (uint32_t index = 0; index < p_module->output_variable_count; ++index) {
+    if (p_module->output_variables[index] == p_output_variable) {
+      SpvReflectResult result = ChangeVariableLocation(p_module, p_module->output_variables[index], new_location);
+      IndexEntryPointVariableLocations(p_module);
+      return result;
+    }
+  }
+  return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+}
+
+const char* spvReflectSourceLanguage(SpvSourceLanguage source_lang) {
+  switch (source_lang) {
+    case SpvSourceLanguageESSL:
+      return "ESSL";
+    case SpvSourceLanguageGLSL:
+      return "GLSL";
+    case SpvSourceLanguageOpenCL_C:
+      return "OpenCL_C";
+    case SpvSourceLanguageOpenCL_CPP:
+      return "OpenCL_CPP";
+    case SpvSourceLanguageHLSL:
+      return "HLSL";
+    case SpvSourceLanguageCPP_for_OpenCL:
+      return "CPP_for_OpenCL";
+    case SpvSourceLanguageSYCL:
+      return "SYCL";
+    case SpvSourceLanguageHERO_C:
+      return "Hero C";
+    case SpvSourceLanguageNZSL:
+      return "NZSL";
+    case SpvSourceLanguageWGSL:
+      return "WGSL";
+    case SpvSourceLanguageSlang:
+      return "Slang";
+    case SpvSourceLanguageZig:
+      return "Zig";
+    case SpvSourceLanguageRust:
+      return "Rust";
+    default:
+      break;
+  }
+  // The source language is SpvSourceLanguageUnknown, SpvSourceLanguageMax, or
+  // some other value that does not correspond to a knonwn language.
+  return "Unknown";
+}
+
+const char* spvReflectBlockVariableTypeName(const SpvReflectBlockVariable* p_var) {
+  if (p_var == NULL) {
+    return NULL;
+  }
+  return p_var->type_description->type_name;
+}
+
+static uint32_t LowerBoundProgramDescriptorSet(const SpvReflectProgram* p_program, uint32_t set_number) {
+  uint32_t lo = 0;
+  uint32_t hi = p_program->descriptor_set_count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (p_program->descriptor_sets[mid].set < set_number) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static uint32_t LowerBoundProgramBinding(const SpvReflectProgramDescriptorSet* p_set, uint32_t binding_number) {
+  uint32_t lo = 0;
+  uint32_t hi = p_set->binding_count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (p_set->bindings[mid].binding < binding_number) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static SpvReflectResult MergeProgramBinding(SpvReflectProgram* p_program, const SpvReflectDescriptorBinding* p_binding,
+                                            SpvReflectShaderStageFlagBits stage) {
+  uint32_t set_index = LowerBoundProgramDescriptorSet(p_program, p_binding->set);
+  if ((set_index == p_program->descriptor_set_count) || (p_program->descriptor_sets[set_index].set != p_binding->set)) {
+    uint32_t set_capacity = p_program->_internal->descriptor_set_capacity;
+    void* p_sets = GrowArray(p_program->descriptor_sets, &set_capacity, p_program->descriptor_set_count,
+                             sizeof(*(p_program->descriptor_sets)));
+    if (IsNull(p_sets)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+    p_program->descriptor_sets = (SpvReflectProgramDescriptorSet*)p_sets;
+    // binding_capacities is parallel to descriptor_sets and shares its capacity
+    void* p_capacities = GrowArray(p_program->_internal->binding_capacities, &p_program->_internal->descriptor_set_capacity,
+                                   p_program->descriptor_set_count, sizeof(*(p_program->_internal->binding_capacities)));
+    if (IsNull(p_capacities)) {
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+    p_program->_internal->binding_capacities = (uint32_t*)p_capacities;
+
+    uint32_t move_count = p_program->descriptor_set_count - set_index;
+    memmove(&p_program->descriptor_sets[set_index + 1], &p_program->descriptor_sets[set_index],
+            move_count * sizeof(*(p_program->descriptor_sets)));
+    memmove(&p_program->_internal->binding_capacities[set_index + 1], &p_program->_internal->binding_capacities[set_index],
+            move_count * sizeof(*(p_program->_internal->binding_capacities)));
+    memset(&p_program->descriptor_sets[set_index], 0, sizeof(*(p_program->descriptor_sets)));
+    p_program->descriptor_sets[set_index].set = p_binding->set;
+    p_program->_internal->binding_capacities[set_index] = 0;
+    ++p_program->descriptor_set_count;
+  }
+
+  SpvReflectProgramDescriptorSet* p_set = &p_program->descriptor_sets[set_index];
+  uint32_t binding_index = LowerBoundProgramBinding(p_set, p_binding->binding);
+  if ((binding_index < p_set->binding_count) && (p_set->bindings[binding_index].binding == p_binding->binding)) {
+    SpvReflectProgramBinding* p_merged = &p_set->bindings[binding_index];
+    if (p_merged->descriptor_type != p_binding->descriptor_type) {
+      void* p_conflicts = GrowArray(p_program->conflicts, &p_program->_internal->conflict_capacity, p_program->conflict_count,
+                                    sizeof(*(p_program->conflicts)));
+      if (IsNull(p_conflicts)) {
+        return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+      }
+      p_program->conflicts = (SpvReflectProgramConflict*)p_conflicts;
+      SpvReflectProgramConflict* p_conflict = &p_program->conflicts[p_program->conflict_count++];
+      p_conflict->set = p_binding->set;
+      p_conflict->binding = p_binding->binding;
+      p_conflict->descriptor_type = p_merged->descriptor_type;
+      p_conflict->conflicting_descriptor_type = p_binding->descriptor_type;
+      p_conflict->conflicting_stage = stage;
+    }
+    // A runtime array (count 0) stays unbounded no matter what other stages declare
+    if ((p_merged->count != 0) && ((p_binding->count == 0) || (p_binding->count > p_merged->count))) {
+      p_merged->count = p_binding->count;
+    }
+    p_merged->stage_flags |= (uint32_t)stage;
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+
+  void* p_bindings = GrowArray(p_set->bindings, &p_program->_internal->binding_capacities[set_index], p_set->binding_count,
+                               sizeof(*(p_set->bindings)));
+  if (IsNull(p_bindings)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_set->bindings = (SpvReflectProgramBinding*)p_bindings;
+  memmove(&p_set->bindings[binding_index + 1], &p_set->bindings[binding_index],
+          (p_set->binding_count - binding_index) * sizeof(*(p_set->bindings)));
+  SpvReflectProgramBinding* p_merged = &p_set->bindings[binding_index];
+  p_merged->binding = p_binding->binding;
+  p_merged->descriptor_type = p_binding->descriptor_type;
+  p_merged->count = p_binding->count;
+  p_merged->stage_flags = (uint32_t)stage;
+  ++p_set->binding_count;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+// Regroups the per-stage push constant ranges so stages with identical ranges
+// share one entry, in stage bit order.
+static void UpdateProgramPushConstantRanges(SpvReflectProgram* p_program) {
+  p_program->push_constant_range_count = 0;
+  for (uint32_t bit = 0; bit < 32; ++bit) {
+    if (p_program->_internal->push_constant_end[bit] == 0) {
+      continue;
+    }
+    uint32_t offset = p_program->_internal->push_constant_begin[bit];
+    uint32_t size = p_program->_internal->push_constant_end[bit] - offset;
+    uint32_t range_index = 0;
+    while ((range_index < p_program->push_constant_range_count) &&
+           ((p_program->_internal->push_constant_ranges[range_index].offset != offset) ||
+            (p_program->_internal->push_constant_ranges[range_index].size != size))) {
+      ++range_index;
+    }
+    SpvReflectProgramPushConstantRange* p_range = &p_program->_internal->push_constant_ranges[range_index];
+    if (range_index == p_program->push_constant_range_count) {
+      p_range->stage_flags = 0;
+      p_range->offset = offset;
+      p_range->size = size;
+      ++p_program->push_constant_range_count;
+    }
+    p_range->stage_flags |= (1u << bit);
+  }
+  p_program->push_constant_ranges = (p_program->push_constant_range_count > 0) ? p_program->_internal->push_constant_ranges : NULL;
+}
+
+static SpvReflectResult ProgramAddEntryPoint(SpvReflectProgram* p_program, const SpvReflectShaderModule* p_module,
+                                             const SpvReflectEntryPoint* p_entry) {
+  uint32_t count = 0;
+  const SpvReflectDescriptorBinding* const* pp_bindings = GetEntryPointDescriptorBindingArray(p_module, p_entry, &count, NULL);
+  for (uint32_t i = 0; i < count; ++i) {
+    SpvReflectResult result = MergeProgramBinding(p_program, pp_bindings[i], p_entry->shader_stage);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      return result;
+    }
+  }
+
+  const SpvReflectBlockVariable* const* pp_blocks = GetEntryPointPushConstantBlockArray(p_module, p_entry, &count, NULL);
+  if (count > 0) {
+    // Push constant blocks report their lowest member offset and their size
+    // measured from offset 0.
+    uint32_t begin = UINT32_MAX;
+    uint32_t end = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+      begin = Min(begin, pp_blocks[i]->offset);
+      end = Max(end, pp_blocks[i]->size);
+    }
+    if (end > begin) {
+      for (uint32_t bit = 0; bit < 32; ++bit) {
+        if (((uint32_t)p_entry->shader_stage & (1u << bit)) == 0) {
+          continue;
+        }
+        if (p_program->_internal->push_constant_end[bit] == 0) {
+          p_program->_internal->push_constant_begin[bit] = begin;
+          p_program->_internal->push_constant_end[bit] = end;
+        } else {
+          p_program->_internal->push_constant_begin[bit] = Min(p_program->_internal->push_constant_begin[bit], begin);
+          p_program->_internal->push_constant_end[bit] = Max(p_program->_internal->push_constant_end[bit], end);
+        }
+      }
+      UpdateProgramPushConstantRanges(p_program);
+    }
+  }
+
+  p_program->stage_flags |= (uint32_t)p_entry->shader_stage;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectCreateProgram(SpvReflectProgram* p_program) {
+  if (IsNull(p_program)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  memset(p_program, 0, sizeof(*p_program));
+#ifdef __cplusplus
+  p_program->_internal = (SpvReflectProgram::ProgramInternal*)calloc(1, sizeof(*(p_program->_internal)));
+#else
+  p_program->_internal = calloc(1, sizeof(*(p_program->_internal)));
+#endif
+  if (IsNull(p_program->_internal)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+void spvReflectDestroyProgram(SpvReflectProgram* p_program) {
+  if (IsNull(p_program) || IsNull(p_program->_internal)) {
+    return;
+  }
+  for (uint32_t i = 0; i < p_program->descriptor_set_count; ++i) {
+    SafeFree(p_program->descriptor_sets[i].bindings);
+  }
+  SafeFree(p_program->descriptor_sets);
+  SafeFree(p_program->conflicts);
+  SafeFree(p_program->_internal->binding_capacities);
+  SafeFree(p_program->_internal);
+  memset(p_program, 0, sizeof(*p_program));
+}
+
+SpvReflectResult spvReflectProgramAddModule(SpvReflectProgram* p_program, const SpvReflectShaderModule* p_module) {
+  if (IsNull(p_program) || IsNull(p_program->_internal) || IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
+    SpvReflectResult result = ProgramAddEntryPoint(p_program, p_module, &p_module->entry_points[i]);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      return result;
+    }
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectProgramAddEntryPoint(SpvReflectProgram* p_program, const SpvReflectShaderModule* p_module,
+                                                const char* entry_point) {
+  if (IsNull(p_program) || IsNull(p_program->_internal) || IsNull(p_module) || IsNull(entry_point)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+  return ProgramAddEntryPoint(p_program, p_module, p_entry);
+}
+
+const SpvReflectProgramDescriptorSet* spvReflectProgramGetDescriptorSet(const SpvReflectProgram* p_program, uint32_t set_number,
+                                                                        SpvReflectResult* p_result) {
+  const SpvReflectProgramDescriptorSet* p_set = NULL;
+  if (IsNotNull(p_program)) {
+    uint32_t set_index = LowerBoundProgramDescriptorSet(p_program, set_number);
+    if ((set_index < p_program->descriptor_set_count) && (p_program->descriptor_sets[set_index].set == set_number)) {
+      p_set = &p_program->descriptor_sets[set_index];
+    }
+  }
+  if (IsNotNull(p_result)) {
+    *p_result = IsNotNull(p_set)
+                    ? SPV_REFLECT_RESULT_SUCCESS
+                    : (IsNull(p_program) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  }
+  return p_set;
+}
+
+static int SortCompareProgramBindings(const void* a, const void* b) {
+  const SpvReflectProgramBinding* p_elem_a = (const SpvReflectProgramBinding*)a;
+  const SpvReflectProgramBinding* p_elem_b = (const SpvReflectProgramBinding*)b;
+  if (p_elem_a->binding != p_elem_b->binding) {
+    return (p_elem_a->binding < p_elem_b->binding) ? -1 : 1;
+  }
+  if (p_elem_a->descriptor_type != p_elem_b->descriptor_type) {
+    return ((uint32_t)p_elem_a->descriptor_type < (uint32_t)p_elem_b->descriptor_type) ? -1 : 1;
+  }
+  return 0;
+}
+
+static uint32_t HashProgramBindings(const SpvReflectProgramBinding* p_bindings, uint32_t binding_count) {
+  uint32_t hash = HashUint32(binding_count);
+  for (uint32_t i = 0; i < binding_count; ++i) {
+    hash = HashUint32(hash ^ p_bindings[i].binding);
+    hash = HashUint32(hash ^ (uint32_t)p_bindings[i].descriptor_type);
+    hash = HashUint32(hash ^ p_bindings[i].count);
+  }
+  return hash;
+}
+
+// Stage flags are left out of the signature and the comparison, so sets that
+// only differ in the stages using them share a layout.
+static bool ProgramBindingsEqual(const SpvReflectProgramBinding* p_a, const SpvReflectProgramBinding* p_b, uint32_t binding_count) {
+  for (uint32_t i = 0; i < binding_count; ++i) {
+    if ((p_a[i].binding != p_b[i].binding) || (p_a[i].descriptor_type != p_b[i].descriptor_type) ||
+        (p_a[i].count != p_b[i].count)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the canonical bindings of p_set into p_bindings and their number into
+// p_binding_count. Aliased bindings that share a binding number collapse into
+// one if their descriptor types are equal. Otherwise each descriptor type
+// keeps its own binding, and every type after the lowest one is appended to
+// p_layouts->conflicts.
+static SpvReflectResult CanonicalizeDescriptorSet(SpvReflectDescriptorSetLayouts* p_layouts, const SpvReflectDescriptorSet* p_set,
+                                                  SpvReflectShaderStageFlagBits stage, SpvReflectProgramBinding* p_bindings,
+                                                  uint32_t* p_binding_count) {
+  for (uint32_t i = 0; i < p_set->binding_count; ++i) {
+    p_bindings[i].binding = p_set->bindings[i]->binding;
+    p_bindings[i].descriptor_type = p_set->bindings[i]->descriptor_type;
+    p_bindings[i].count = p_set->bindings[i]->count;
+    p_bindings[i].stage_flags = (uint32_t)stage;
+  }
+  qsort(p_bindings, p_set->binding_count, sizeof(*p_bindings), SortCompareProgramBindings);
+
+  uint32_t binding_count = 0;
+  uint32_t first_alias = 0;
+  for (uint32_t i = 0; i < p_set->binding_count; ++i) {
+    if ((binding_count > 0) && (p_bindings[binding_count - 1].binding == p_bindings[i].binding)) {
+      SpvReflectProgramBinding* p_kept = &p_bindings[binding_count - 1];
+      if (p_kept->descriptor_type == p_bindings[i].descriptor_type) {
+        if ((p_kept->count != 0) && ((p_bindings[i].count == 0) || (p_bindings[i].count > p_kept->count))) {
+          p_kept->count = p_bindings[i].count;
+        }
+        continue;
+      }
+
+      void* p_conflicts = GrowArray(p_layouts->conflicts, &p_layouts->_internal->conflict_capacity, p_layouts->conflict_count,
+                                    sizeof(*(p_layouts->conflicts)));
+      if (IsNull(p_conflicts)) {
+        return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+      }
+      p_layouts->conflicts = (SpvReflectProgramConflict*)p_conflicts;
+      SpvReflectProgramConflict* p_conflict = &p_layouts->conflicts[p_layouts->conflict_count++];
+      p_conflict->set = p_set->set;
+      p_conflict->binding = p_bindings[i].binding;
+      p_conflict->descriptor_type = p_bindings[first_alias].descriptor_type;
+      p_conflict->conflicting_descriptor_type = p_bindings[i].descriptor_type;
+      p_conflict->conflicting_stage = stage;
+    } else {
+      first_alias = binding_count;
+    }
+    p_bindings[binding_count++] = p_bindings[i];
+  }
+  *p_binding_count = binding_count;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectCreateDescriptorSetLayouts(uint32_t module_count, const SpvReflectShaderModule* const* pp_modules,
+                                                      SpvReflectDescriptorSetLayouts* p_layouts) {
+  if (IsNull(p_layouts) || ((module_count > 0) && IsNull(pp_modules))) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  memset(p_layouts, 0, sizeof(*p_layouts));
+
+  uint32_t use_count = 0;
+  uint32_t binding_count = 0;
+  for (uint32_t i = 0; i < module_count; ++i) {
+    if (IsNull(pp_modules[i])) {
+      return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    for (uint32_t j = 0; j < pp_modules[i]->entry_point_count; ++j) {
+      const SpvReflectEntryPoint* p_entry = &pp_modules[i]->entry_points[j];
+      use_count += p_entry->descriptor_set_count;
+      for (uint32_t k = 0; k < p_entry->descriptor_set_count; ++k) {
+        binding_count += p_entry->descriptor_sets[k].binding_count;
+      }
+    }
+  }
+
+#ifdef __cplusplus
+  p_layouts->_internal = (SpvReflectDescriptorSetLayouts::DescriptorSetLayoutsInternal*)calloc(1, sizeof(*(p_layouts->_internal)));
+#else
+  p_layouts->_internal = calloc(1, sizeof(*(p_layouts->_internal)));
+#endif
+  if (IsNull(p_layouts->_internal)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  if (use_count == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+
+  uint32_t capacity = HashTableCapacity(use_count);
+  uint32_t* table = (uint32_t*)calloc(capacity, sizeof(*table));
+  p_layouts->uses = (SpvReflectDescriptorSetLayoutUse*)calloc(use_count, sizeof(*(p_layouts->uses)));
+  p_layouts->layouts = (SpvReflectDescriptorSetLayout*)calloc(use_count, sizeof(*(p_layouts->layouts)));
+  p_layouts->_internal->bindings = (SpvReflectProgramBinding*)calloc(Max(binding_count, 1), sizeof(SpvReflectProgramBinding));
+  if (IsNull(table) || IsNull(p_layouts->uses) || IsNull(p_layouts->layouts) || IsNull(p_layouts->_internal->bindings)) {
+    SafeFree(table);
+    spvReflectDestroyDescriptorSetLayouts(p_layouts);
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+
+  // Each set is canonicalized at the end of the binding storage and only kept
+  // there if no equal layout exists yet.
+  uint32_t mask = capacity - 1;
+  SpvReflectProgramBinding* p_next_bindings = p_layouts->_internal->bindings;
+  for (uint32_t i = 0; i < module_count; ++i) {
+    for (uint32_t j = 0; j < pp_modules[i]->entry_point_count; ++j) {
+      const SpvReflectEntryPoint* p_entry = &pp_modules[i]->entry_points[j];
+      for (uint32_t k = 0; k < p_entry->descriptor_set_count; ++k) {
+        const SpvReflectDescriptorSet* p_set = &p_entry->descriptor_sets[k];
+        uint32_t set_binding_count = 0;
+        SpvReflectResult result =
+            CanonicalizeDescriptorSet(p_layouts, p_set, p_entry->shader_stage, p_next_bindings, &set_binding_count);
+        if (result != SPV_REFLECT_RESULT_SUCCESS) {
+          SafeFree(table);
+          spvReflectDestroyDescriptorSetLayouts(p_layouts);
+          return result;
+        }
+        uint32_t signature = HashProgramBindings(p_next_bindings, set_binding_count);
+
+        uint32_t layout_index = UINT32_MAX;
+        for (uint32_t slot = signature & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+          const SpvReflectDescriptorSetLayout* p_layout = &p_layouts->layouts[table[slot] - 1];
+          if ((p_layout->signature == signature) && (p_layout->binding_count == set_binding_count) &&
+              ProgramBindingsEqual(p_layout->bindings, p_next_bindings, set_binding_count)) {
+            layout_index = table[slot] - 1;
+            break;
+          }
+        }
+        if (layout_index != UINT32_MAX) {
+          SpvReflectProgramBinding* p_bindings = p_layouts->layouts[layout_index].bindings;
+          for (uint32_t binding_index = 0; binding_index < set_binding_count; ++binding_index) {
+            p_bindings[binding_index].stage_flags |= (uint32_t)p_entry->shader_stage;
+          }
+        } else {
+          layout_index = p_layouts->layout_count++;
+          SpvReflectDescriptorSetLayout* p_layout = &p_layouts->layouts[layout_index];
+          p_layout->signature = signature;
+          p_layout->binding_count = set_binding_count;
+          p_layout->bindings = p_next_bindings;
+          p_next_bindings += set_binding_count;
+          HashTableInsert(table, capacity, signature, layout_index);
+        }
+
+        SpvReflectDescriptorSetLayoutUse* p_use = &p_layouts->uses[p_layouts->use_count++];
+        p_use->module_index = i;
+        p_use->entry_point_index = j;
+        p_use->set = p_set->set;
+        p_use->layout_index = layout_index;
+      }
+    }
+  }
+
+  SafeFree(table);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+void spvReflectDestroyDescriptorSetLayouts(SpvReflectDescriptorSetLayouts* p_layouts) {
+  if (IsNull(p_layouts)) {
+    return;
+  }
+  if (IsNotNull(p_layouts->_internal)) {
+    SafeFree(p_layouts->_internal->bindings);
+  }
+  SafeFree(p_layouts->_internal);
+  SafeFree(p_layouts->layouts);
+  SafeFree(p_layouts->uses);
+  SafeFree(p_layouts->conflicts);
+  memset(p_layouts, 0, sizeof(*p_layouts));
+}
+
+static SpvReflectResult AddDescriptorSetsToPoolSizes(SpvReflectDescriptorPoolSizes* p_pool_sizes, uint32_t set_count,
+                                                     const SpvReflectDescriptorSet* p_sets, uint32_t runtime_array_size) {
+  for (uint32_t i = 0; i < set_count; ++i) {
+    const SpvReflectDescriptorSet* p_set = &p_sets[i];
+    for (uint32_t j = 0; j < p_set->binding_count; ++j) {
+      const SpvReflectDescriptorBinding* p_binding = p_set->bindings[j];
+      bool aliased = false;
+      for (uint32_t k = 0; k < j; ++k) {
+        aliased |= (p_set->bindings[k]->binding == p_binding->binding);
+      }
+      if (aliased) {
+        continue;
+      }
+
+      uint32_t index = 0;
+      while ((index < p_pool_sizes->pool_size_count) && (p_pool_sizes->pool_sizes[index].type != p_binding->descriptor_type)) {
+        ++index;
+      }
+      if (index == p_pool_sizes->pool_size_count) {
+        if (index == SPV_REFLECT_MAX_DESCRIPTOR_TYPES) {
+          return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+        }
+        p_pool_sizes->pool_sizes[index].type = p_binding->descriptor_type;
+        p_pool_sizes->pool_sizes[index].descriptor_count = 0;
+        ++p_pool_sizes->pool_size_count;
+      }
+      p_pool_sizes->pool_sizes[index].descriptor_count +=
+          (p_binding->count == SPV_REFLECT_ARRAY_DIM_RUNTIME) ? runtime_array_size : p_binding->count;
+    }
   }
-  const SpvReflectDescriptorBinding* p_descriptor = NULL;
-  if (IsNotNull(p_module)) {
-    for (uint32_t index = 0; index < p_module->descriptor_binding_count; ++index) {
-      const SpvReflectDescriptorBinding* p_potential = &p_module->descriptor_bindings[index];
-      bool found = SearchSortedUint32(p_entry->used_uniforms, p_entry->used_uniform_count, p_potential->spirv_id);
-      if ((p_potential->binding == binding_number) && (p_potential->set == set_number) && found) {
-        p_descriptor = p_potential;
-        break;
+  p_pool_sizes->max_sets += set_count;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectDescriptorPoolSizesAddModule(SpvReflectDescriptorPoolSizes* p_pool_sizes,
+                                                        const SpvReflectShaderModule* p_module, uint32_t runtime_array_size) {
+  if (IsNull(p_pool_sizes) || IsNull(p_module)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  return AddDescriptorSetsToPoolSizes(p_pool_sizes, p_module->descriptor_set_count, p_module->descriptor_sets, runtime_array_size);
+}
+
+SpvReflectResult spvReflectDescriptorPoolSizesAddEntryPoint(SpvReflectDescriptorPoolSizes* p_pool_sizes,
+                                                            const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                            uint32_t runtime_array_size) {
+  if (IsNull(p_pool_sizes) || IsNull(p_module) || IsNull(entry_point)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+  return AddDescriptorSetsToPoolSizes(p_pool_sizes, p_entry->descriptor_set_count, p_entry->descriptor_sets, runtime_array_size);
+}
+
+static uint32_t DescriptorInfoSize(const SpvReflectDescriptorInfoSizes* p_info_sizes, SpvReflectDescriptorType descriptor_type) {
+  switch (descriptor_type) {
+    case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLER:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+      return p_info_sizes->image_info;
+    case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+      return p_info_sizes->texel_buffer_view;
+    case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+    case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+      return p_info_sizes->buffer_info;
+    case SPV_REFLECT_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+      return p_info_sizes->acceleration_structure;
+  }
+  return 0;
+}
+
+SpvReflectResult spvReflectEnumerateDescriptorUpdateTemplateEntries(const SpvReflectDescriptorSet* p_set,
+                                                                    const SpvReflectDescriptorInfoSizes* p_info_sizes,
+                                                                    uint32_t runtime_array_size, uint32_t* p_count,
+                                                                    SpvReflectDescriptorUpdateTemplateEntry* p_entries,
+                                                                    uint32_t* p_data_size) {
+  if (IsNull(p_set) || IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  const SpvReflectDescriptorInfoSizes k_default_info_sizes = {24, 24, 8, 8};
+  if (IsNull(p_info_sizes)) {
+    p_info_sizes = &k_default_info_sizes;
+  }
+
+  // Visit bindings in ascending binding number, skipping aliases.
+  uint32_t count = 0;
+  uint32_t offset = 0;
+  uint32_t previous_binding = 0;
+  for (uint32_t visited = 0; visited < p_set->binding_count; ++visited) {
+    const SpvReflectDescriptorBinding* p_binding = NULL;
+    for (uint32_t i = 0; i < p_set->binding_count; ++i) {
+      const SpvReflectDescriptorBinding* p_candidate = p_set->bindings[i];
+      if ((visited > 0) && (p_candidate->binding <= previous_binding)) {
+        continue;
+      }
+      if (IsNull(p_binding) || (p_candidate->binding < p_binding->binding)) {
+        p_binding = p_candidate;
+      }
+    }
+    if (IsNull(p_binding)) {
+      break;
+    }
+    previous_binding = p_binding->binding;
+
+    uint32_t descriptor_count = (p_binding->count == SPV_REFLECT_ARRAY_DIM_RUNTIME) ? runtime_array_size : p_binding->count;
+    uint32_t stride = DescriptorInfoSize(p_info_sizes, p_binding->descriptor_type);
+    if ((descriptor_count == 0) || (stride == 0)) {
+      continue;
+    }
+    // Align to the largest power of two dividing the stride, at most 8.
+    uint32_t alignment = Min(stride & (~stride + 1), 8);
+    offset = RoundUp(offset, alignment);
+
+    if (IsNotNull(p_entries)) {
+      if (count >= *p_count) {
+        return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
       }
+      SpvReflectDescriptorUpdateTemplateEntry* p_entry = &p_entries[count];
+      p_entry->binding = p_binding->binding;
+      p_entry->array_element = 0;
+      p_entry->descriptor_count = descriptor_count;
+      p_entry->descriptor_type = p_binding->descriptor_type;
+      p_entry->offset = offset;
+      p_entry->stride = stride;
     }
+    offset += descriptor_count * stride;
+    ++count;
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_descriptor)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+
+  if (IsNotNull(p_entries)) {
+    if (*p_count != count) {
+      return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
+    }
+  } else {
+    *p_count = count;
   }
-  return p_descriptor;
+  if (IsNotNull(p_data_size)) {
+    *p_data_size = RoundUp(offset, 8);
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const SpvReflectDescriptorSet* spvReflectGetDescriptorSet(const SpvReflectShaderModule* p_module, uint32_t set_number,
-                                                          SpvReflectResult* p_result) {
-  const SpvReflectDescriptorSet* p_set = NULL;
-  if (IsNotNull(p_module)) {
-    for (uint32_t index = 0; index < p_module->descriptor_set_count; ++index) {
-      const SpvReflectDescriptorSet* p_potential = &p_module->descriptor_sets[index];
-      if (p_potential->set == set_number) {
-        p_set = p_potential;
+uint32_t spvReflectFormatSize(SpvReflectFormat format) {
+  switch (format) {
+    case SPV_REFLECT_FORMAT_UNDEFINED:
+      return 0;
+    case SPV_REFLECT_FORMAT_R16_UINT:
+    case SPV_REFLECT_FORMAT_R16_SINT:
+    case SPV_REFLECT_FORMAT_R16_SFLOAT:
+      return 2;
+    case SPV_REFLECT_FORMAT_R16G16_UINT:
+    case SPV_REFLECT_FORMAT_R16G16_SINT:
+    case SPV_REFLECT_FORMAT_R16G16_SFLOAT:
+    case SPV_REFLECT_FORMAT_R32_UINT:
+    case SPV_REFLECT_FORMAT_R32_SINT:
+    case SPV_REFLECT_FORMAT_R32_SFLOAT:
+      return 4;
+    case SPV_REFLECT_FORMAT_R16G16B16_UINT:
+    case SPV_REFLECT_FORMAT_R16G16B16_SINT:
+    case SPV_REFLECT_FORMAT_R16G16B16_SFLOAT:
+      return 6;
+    case SPV_REFLECT_FORMAT_R16G16B16A16_UINT:
+    case SPV_REFLECT_FORMAT_R16G16B16A16_SINT:
+    case SPV_REFLECT_FORMAT_R16G16B16A16_SFLOAT:
+    case SPV_REFLECT_FORMAT_R32G32_UINT:
+    case SPV_REFLECT_FORMAT_R32G32_SINT:
+    case SPV_REFLECT_FORMAT_R32G32_SFLOAT:
+    case SPV_REFLECT_FORMAT_R64_UINT:
+    case SPV_REFLECT_FORMAT_R64_SINT:
+    case SPV_REFLECT_FORMAT_R64_SFLOAT:
+      return 8;
+    case SPV_REFLECT_FORMAT_R32G32B32_UINT:
+    case SPV_REFLECT_FORMAT_R32G32B32_SINT:
+    case SPV_REFLECT_FORMAT_R32G32B32_SFLOAT:
+      return 12;
+    case SPV_REFLECT_FORMAT_R32G32B32A32_UINT:
+    case SPV_REFLECT_FORMAT_R32G32B32A32_SINT:
+    case SPV_REFLECT_FORMAT_R32G32B32A32_SFLOAT:
+    case SPV_REFLECT_FORMAT_R64G64_UINT:
+    case SPV_REFLECT_FORMAT_R64G64_SINT:
+    case SPV_REFLECT_FORMAT_R64G64_SFLOAT:
+      return 16;
+    case SPV_REFLECT_FORMAT_R64G64B64_UINT:
+    case SPV_REFLECT_FORMAT_R64G64B64_SINT:
+    case SPV_REFLECT_FORMAT_R64G64B64_SFLOAT:
+      return 24;
+    case SPV_REFLECT_FORMAT_R64G64B64A64_UINT:
+    case SPV_REFLECT_FORMAT_R64G64B64A64_SINT:
+    case SPV_REFLECT_FORMAT_R64G64B64A64_SFLOAT:
+      return 32;
+  }
+  return 0;
+}
+
+// Formats are ordered by component width: 16-bit, then 32-bit, then 64-bit.
+static uint32_t FormatComponentSize(SpvReflectFormat format) {
+  if (format >= SPV_REFLECT_FORMAT_R64_UINT) {
+    return 8;
+  }
+  return (format >= SPV_REFLECT_FORMAT_R32_UINT) ? 4 : 2;
+}
+
+// Within each component width, formats come in rows of UINT, SINT and SFLOAT
+// for one to four components.
+static uint32_t FormatRowStride(uint32_t component_size) {
+  return (component_size == 2) ? (uint32_t)(SPV_REFLECT_FORMAT_R16G16_UINT - SPV_REFLECT_FORMAT_R16_UINT) : 3;
+}
+
+static uint32_t FormatRowStart(uint32_t component_size) {
+  if (component_size == 8) {
+    return (uint32_t)SPV_REFLECT_FORMAT_R64_UINT;
+  }
+  return (component_size == 4) ? (uint32_t)SPV_REFLECT_FORMAT_R32_UINT : (uint32_t)SPV_REFLECT_FORMAT_R16_UINT;
+}
+
+// 0 for UINT, 1 for SINT and 2 for SFLOAT.
+static uint32_t FormatNumericType(SpvReflectFormat format) {
+  uint32_t component_size = FormatComponentSize(format);
+  return ((uint32_t)format - FormatRowStart(component_size)) % FormatRowStride(component_size);
+}
+
+static SpvReflectFormat FormatWithComponentCount(SpvReflectFormat format, uint32_t component_count) {
+  uint32_t component_size = FormatComponentSize(format);
+  return (SpvReflectFormat)(FormatRowStart(component_size) + (component_count - 1) * FormatRowStride(component_size) +
+                            FormatNumericType(format));
+}
+
+SpvReflectResult spvReflectComputeVertexInputLayout(const SpvReflectShaderModule* p_module, const char* entry_point,
+                                                    SpvReflectVertexInputLayoutMode mode, uint32_t location_binding_count,
+                                                    const uint32_t* p_location_bindings, SpvReflectVertexInputLayout* p_layout) {
+  if (IsNull(p_module) || IsNull(entry_point) || IsNull(p_layout)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
+  if (IsNull(p_entry)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+  memset(p_layout, 0, sizeof(*p_layout));
+
+  // One attribute per location: arrays and matrix columns each take a
+  // location, and 64-bit vectors of more than two components take two.
+  // Inputs packed into one location with Component decorations share its
+  // attribute, widened to cover the components of all of them.
+  for (uint32_t i = 0; i < p_entry->input_variable_count; ++i) {
+    const SpvReflectInterfaceVariable* p_var = p_entry->input_variables[i];
+    if ((p_var->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) || (p_var->format == SPV_REFLECT_FORMAT_UNDEFINED)) {
+      continue;
+    }
+    uint32_t element_count = 1;
+    for (uint32_t j = 0; j < p_var->array.dims_count; ++j) {
+      element_count *= p_var->array.dims[j];
+    }
+    if (IsNotNull(p_var->type_description) && (p_var->type_description->type_flags & SPV_REFLECT_TYPE_FLAG_MATRIX)) {
+      element_count *= p_var->numeric.matrix.column_count;
+    }
+    uint32_t location_stride = (spvReflectFormatSize(p_var->format) > 16) ? 2 : 1;
+    SpvReflectFormat format = p_var->format;
+    if ((location_stride == 1) && (p_var->component != (uint32_t)INVALID_VALUE)) {
+      // Component decorations count 32-bit components, and a 64-bit
+      // component takes two of them.
+      uint32_t component_size = FormatComponentSize(format);
+      uint32_t component_count = spvReflectFormatSize(format) / component_size;
+      uint32_t end = (component_size == 8) ? (p_var->component / 2 + component_count) : (p_var->component + component_count);
+      if (end > 4) {
+        return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+      }
+      format = FormatWithComponentCount(format, end);
+    }
+    for (uint32_t j = 0; j < element_count; ++j) {
+      uint32_t location = p_var->location + j * location_stride;
+      uint32_t index = 0;
+      while ((index < p_layout->attribute_count) && (p_layout->attributes[index].location < location)) {
+        ++index;
+      }
+      if ((index < p_layout->attribute_count) && (p_layout->attributes[index].location == location)) {
+        // One attribute has one format, so inputs sharing a location must
+        // agree on the component type.
+        SpvReflectVertexInputAttribute* p_attribute = &p_layout->attributes[index];
+        if ((FormatComponentSize(p_attribute->format) != FormatComponentSize(format)) ||
+            (FormatNumericType(p_attribute->format) != FormatNumericType(format))) {
+          return SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_INSTRUCTION;
+        }
+        if (spvReflectFormatSize(format) > spvReflectFormatSize(p_attribute->format)) {
+          p_attribute->format = format;
+        }
+        continue;
+      }
+      if (p_layout->attribute_count == SPV_REFLECT_MAX_VERTEX_INPUT_ATTRIBUTES) {
+        return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
       }
+      // Insertion keeps the attributes sorted by location.
+      for (uint32_t k = p_layout->attribute_count; k > index; --k) {
+        p_layout->attributes[k] = p_layout->attributes[k - 1];
+      }
+      ++p_layout->attribute_count;
+      p_layout->attributes[index].location = location;
+      p_layout->attributes[index].format = format;
     }
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_set)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+
+  // Offsets are aligned to the component size: 2, 4 or 8 bytes.
+  uint32_t alignments[SPV_REFLECT_MAX_VERTEX_INPUT_ATTRIBUTES] = {0};
+  for (uint32_t i = 0; i < p_layout->attribute_count; ++i) {
+    SpvReflectVertexInputAttribute* p_attribute = &p_layout->attributes[i];
+    if (mode == SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_DEINTERLEAVED) {
+      p_attribute->binding = i;
+    } else if (IsNotNull(p_location_bindings) && (p_attribute->location < location_binding_count)) {
+      p_attribute->binding = p_location_bindings[p_attribute->location];
+    }
+
+    uint32_t index = 0;
+    while ((index < p_layout->binding_count) && (p_layout->bindings[index].binding < p_attribute->binding)) {
+      ++index;
+    }
+    if ((index == p_layout->binding_count) || (p_layout->bindings[index].binding != p_attribute->binding)) {
+      for (uint32_t j = p_layout->binding_count; j > index; --j) {
+        p_layout->bindings[j] = p_layout->bindings[j - 1];
+        alignments[j] = alignments[j - 1];
+      }
+      ++p_layout->binding_count;
+      p_layout->bindings[index].binding = p_attribute->binding;
+      p_layout->bindings[index].stride = 0;
+      p_layout->bindings[index].input_rate = 0;
+      alignments[index] = 1;
+    }
+
+    uint32_t size = spvReflectFormatSize(p_attribute->format);
+    uint32_t alignment = FormatComponentSize(p_attribute->format);
+    SpvReflectVertexInputBinding* p_binding = &p_layout->bindings[index];
+    p_attribute->offset = RoundUp(p_binding->stride, alignment);
+    p_binding->stride = p_attribute->offset + size;
+    alignments[index] = Max(alignments[index], alignment);
   }
-  return p_set;
+  for (uint32_t i = 0; i < p_layout->binding_count; ++i) {
+    p_layout->bindings[i].stride = RoundUp(p_layout->bindings[i].stride, alignments[i]);
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const SpvReflectDescriptorSet* spvReflectGetEntryPointDescriptorSet(const SpvReflectShaderModule* p_module, const char* entry_point,
-                                                                    uint32_t set_number, SpvReflectResult* p_result) {
-  const SpvReflectDescriptorSet* p_set = NULL;
-  if (IsNotNull(p_module)) {
-    const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-    if (IsNull(p_entry)) {
-      if (IsNotNull(p_result)) {
-        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+// Tessellation and geometry inputs, and tessellation control and mesh
+// outputs, have an outer array with one element per vertex.
+static uint32_t PerVertexArrayDims(const SpvReflectInterfaceVariable* p_var, SpvReflectShaderStageFlagBits stage, bool output) {
+  bool arrayed = (stage == SPV_REFLECT_SHADER_STAGE_TESSELLATION_CONTROL_BIT);
+  if (output) {
+    arrayed |= (stage == SPV_REFLECT_SHADER_STAGE_MESH_BIT_EXT);
+  } else {
+    arrayed |= (stage == SPV_REFLECT_SHADER_STAGE_TESSELLATION_EVALUATION_BIT) || (stage == SPV_REFLECT_SHADER_STAGE_GEOMETRY_BIT);
+  }
+  if (!arrayed || (p_var->decoration_flags & SPV_REFLECT_DECORATION_PATCH) || (p_var->array.dims_count == 0)) {
+    return 0;
+  }
+  return 1;
+}
+
+static bool InterfaceArraysMatch(const SpvReflectArrayTraits* p_a, uint32_t a_skip, const SpvReflectArrayTraits* p_b,
+                                 uint32_t b_skip) {
+  if ((p_a->dims_count - a_skip) != (p_b->dims_count - b_skip)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < p_a->dims_count - a_skip; ++i) {
+    if (p_a->dims[a_skip + i] != p_b->dims[b_skip + i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool InterfaceTypesMatch(const SpvReflectInterfaceVariable* p_a, const SpvReflectInterfaceVariable* p_b) {
+  const SpvReflectTypeFlags type_mask = SPV_REFLECT_TYPE_FLAG_BOOL | SPV_REFLECT_TYPE_FLAG_INT | SPV_REFLECT_TYPE_FLAG_FLOAT |
+                                        SPV_REFLECT_TYPE_FLAG_VECTOR | SPV_REFLECT_TYPE_FLAG_MATRIX | SPV_REFLECT_TYPE_FLAG_STRUCT;
+  SpvReflectTypeFlags a_flags = IsNotNull(p_a->type_description) ? (p_a->type_description->type_flags & type_mask) : 0;
+  SpvReflectTypeFlags b_flags = IsNotNull(p_b->type_description) ? (p_b->type_description->type_flags & type_mask) : 0;
+  if ((a_flags != b_flags) || (p_a->numeric.scalar.width != p_b->numeric.scalar.width) ||
+      (p_a->numeric.scalar.signedness != p_b->numeric.scalar.signedness) ||
+      (p_a->numeric.vector.component_count != p_b->numeric.vector.component_count) ||
+      (p_a->numeric.matrix.column_count != p_b->numeric.matrix.column_count) ||
+      (p_a->numeric.matrix.row_count != p_b->numeric.matrix.row_count) || (p_a->member_count != p_b->member_count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < p_a->member_count; ++i) {
+    if (!InterfaceTypesMatch(&p_a->members[i], &p_b->members[i]) ||
+        !InterfaceArraysMatch(&p_a->members[i].array, 0, &p_b->members[i].array, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Built-ins the consumer reads from the previous stage's outputs, as a mask
+// of SpvBuiltIn bits.
+static uint32_t RequiredBuiltInMask(SpvReflectShaderStageFlagBits stage) {
+  uint32_t mask = (1u << SpvBuiltInClipDistance) | (1u << SpvBuiltInCullDistance);
+  if ((stage == SPV_REFLECT_SHADER_STAGE_TESSELLATION_CONTROL_BIT) ||
+      (stage == SPV_REFLECT_SHADER_STAGE_TESSELLATION_EVALUATION_BIT) || (stage == SPV_REFLECT_SHADER_STAGE_GEOMETRY_BIT)) {
+    mask |= (1u << SpvBuiltInPosition) | (1u << SpvBuiltInPointSize);
+  }
+  return mask;
+}
+
+static bool IsBuiltInInMask(int built_in, uint32_t mask) {
+  return (built_in >= 0) && (built_in < 32) && ((mask & (1u << built_in)) != 0);
+}
+
+static uint32_t OutputBuiltInMask(const SpvReflectEntryPoint* p_entry) {
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < p_entry->output_variable_count; ++i) {
+    const SpvReflectInterfaceVariable* p_var = p_entry->output_variables[i];
+    if ((p_var->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) == 0) {
+      continue;
+    }
+    if ((p_var->built_in >= 0) && (p_var->built_in < 32)) {
+      mask |= 1u << p_var->built_in;
+    }
+    for (uint32_t j = 0; j < p_var->member_count; ++j) {
+      if ((p_var->members[j].built_in >= 0) && (p_var->members[j].built_in < 32)) {
+        mask |= 1u << p_var->members[j].built_in;
       }
-      return NULL;
     }
-    for (uint32_t index = 0; index < p_entry->descriptor_set_count; ++index) {
-      const SpvReflectDescriptorSet* p_potential = &p_entry->descriptor_sets[index];
-      if (p_potential->set == set_number) {
-        p_set = p_potential;
+  }
+  return mask;
+}
+
+static void AppendInterfaceMismatch(SpvReflectInterfaceMismatch* p_mismatches, uint32_t capacity, uint32_t* p_count,
+                                    SpvReflectInterfaceMismatchType type, uint32_t key, const SpvReflectInterfaceVariable* p_output,
+                                    const SpvReflectInterfaceVariable* p_input) {
+  if (IsNotNull(p_mismatches) && (*p_count < capacity)) {
+    SpvReflectInterfaceMismatch* p_mismatch = &p_mismatches[*p_count];
+    const SpvReflectInterfaceVariable* p_var = IsNotNull(p_input) ? p_input : p_output;
+    p_mismatch->type = type;
+    p_mismatch->location = (type == SPV_REFLECT_INTERFACE_MISMATCH_MISSING_BUILT_IN) ? UINT32_MAX : (key >> 2);
+    p_mismatch->component = (type == SPV_REFLECT_INTERFACE_MISMATCH_MISSING_BUILT_IN) ? 0 : (key & 3);
+    p_mismatch->built_in = (type == SPV_REFLECT_INTERFACE_MISMATCH_MISSING_BUILT_IN) ? p_var->built_in : -1;
+    p_mismatch->output_variable = p_output;
+    p_mismatch->input_variable = p_input;
+  }
+  ++(*p_count);
+}
+
+// A variable, or a member of a block without a Location, matched against the
+// other stage as a whole.
+typedef struct SpvReflectPrvInterfaceUnit {
+  const SpvReflectInterfaceVariable* p_var;
+  uint32_t                           key;              // First location and component
+  uint32_t                           array_skip;       // Per-vertex array dimensions
+  uint32_t                           first_component;
+  uint32_t                           component_count;
+  uint32_t                           order;
+  bool                               used;
+} SpvReflectPrvInterfaceUnit;
+
+// One 32-bit component of a location covered by a unit.
+typedef struct SpvReflectPrvInterfaceComponent {
+  uint32_t                           key;              // location << 2 | component
+  uint32_t                           kind;             // Component type, signedness and width
+  uint32_t                           unit;
+} SpvReflectPrvInterfaceComponent;
+
+typedef struct SpvReflectPrvInterfaceComponents {
+  SpvReflectPrvInterfaceUnit*        units;
+  uint32_t                           unit_count;
+  uint32_t                           unit_capacity;
+  SpvReflectPrvInterfaceComponent*   components;
+  uint32_t                           component_count;
+  uint32_t                           component_capacity;
+} SpvReflectPrvInterfaceComponents;
+
+static int SortCompareInterfaceUnits(const void* a, const void* b) {
+  const SpvReflectPrvInterfaceUnit* p_elem_a = (const SpvReflectPrvInterfaceUnit*)a;
+  const SpvReflectPrvInterfaceUnit* p_elem_b = (const SpvReflectPrvInterfaceUnit*)b;
+  if (p_elem_a->key != p_elem_b->key) {
+    return (p_elem_a->key < p_elem_b->key) ? -1 : 1;
+  }
+  return (p_elem_a->order < p_elem_b->order) ? -1 : ((p_elem_a->order > p_elem_b->order) ? 1 : 0);
+}
+
+static int SortCompareInterfaceComponents(const void* a, const void* b) {
+  const SpvReflectPrvInterfaceComponent* p_elem_a = (const SpvReflectPrvInterfaceComponent*)a;
+  const SpvReflectPrvInterfaceComponent* p_elem_b = (const SpvReflectPrvInterfaceComponent*)b;
+  if (p_elem_a->key != p_elem_b->key) {
+    return (p_elem_a->key < p_elem_b->key) ? -1 : 1;
+  }
+  return (p_elem_a->unit < p_elem_b->unit) ? -1 : ((p_elem_a->unit > p_elem_b->unit) ? 1 : 0);
+}
+
+// Member decorations start out zeroed, so a member only has a Location if the
+// decoration was found in the code.
+static bool HasMemberLocation(const SpvReflectInterfaceVariable* p_member) {
+  return p_member->word_offset.location != 0;
+}
+
+static uint32_t InterfaceComponentKind(const SpvReflectInterfaceVariable* p_var) {
+  const SpvReflectTypeFlags type_mask = SPV_REFLECT_TYPE_FLAG_BOOL | SPV_REFLECT_TYPE_FLAG_INT | SPV_REFLECT_TYPE_FLAG_FLOAT;
+  uint32_t flags = IsNotNull(p_var->type_description) ? (p_var->type_description->type_flags & type_mask) : 0;
+  return flags | (p_var->numeric.scalar.width << 8) | (p_var->numeric.scalar.signedness ? 0x80000000 : 0);
+}
+
+// Appends the components p_var covers starting at *p_location, one location
+// per array element and matrix column, and advances *p_location past them.
+// 64-bit components take two 32-bit components each.
+static SpvReflectResult AddInterfaceComponents(SpvReflectPrvInterfaceComponents* p_list, const SpvReflectInterfaceVariable* p_var,
+                                               uint32_t array_skip, uint32_t first_component, uint32_t* p_location) {
+  uint32_t element_count = 1;
+  for (uint32_t i = array_skip; i < p_var->array.dims_count; ++i) {
+    element_count *= p_var->array.dims[i];
+    if (element_count > MAX_INTERFACE_LOCATION) {
+      return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+    }
+  }
+  SpvReflectTypeFlags type_flags = IsNotNull(p_var->type_description) ? p_var->type_description->type_flags : 0;
+
+  for (uint32_t element = 0; element < element_count; ++element) {
+    if (p_var->member_count > 0) {
+      for (uint32_t i = 0; i < p_var->member_count; ++i) {
+        // Block members may have their own Location.
+        if ((element == 0) && HasMemberLocation(&p_var->members[i])) {
+          *p_location = p_var->members[i].location;
+        }
+        SpvReflectResult result = AddInterfaceComponents(p_list, &p_var->members[i], 0, 0, p_location);
+        if (result != SPV_REFLECT_RESULT_SUCCESS) {
+          return result;
+        }
+      }
+      continue;
+    }
+
+    uint32_t column_count = 1;
+    uint32_t row_count = 1;
+    if (type_flags & SPV_REFLECT_TYPE_FLAG_MATRIX) {
+      column_count = p_var->numeric.matrix.column_count;
+      row_count = p_var->numeric.matrix.row_count;
+    } else if (type_flags & SPV_REFLECT_TYPE_FLAG_VECTOR) {
+      row_count = p_var->numeric.vector.component_count;
+    }
+    uint32_t column_size = row_count * ((p_var->numeric.scalar.width == 64) ? 2 : 1);
+    uint32_t kind = InterfaceComponentKind(p_var);
+    for (uint32_t column = 0; column < column_count; ++column) {
+      if (*p_location >= MAX_INTERFACE_LOCATION) {
+        return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
       }
+      for (uint32_t i = 0; i < column_size; ++i) {
+        void* p_components = GrowArray(p_list->components, &p_list->component_capacity, p_list->component_count,
+                                       sizeof(*p_list->components));
+        if (IsNull(p_components)) {
+          return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+        }
+        p_list->components = (SpvReflectPrvInterfaceComponent*)p_components;
+        SpvReflectPrvInterfaceComponent* p_component = &p_list->components[p_list->component_count++];
+        uint32_t component = first_component + i;
+        p_component->key = ((*p_location + component / 4) << 2) | (component & 3);
+        p_component->kind = kind;
+        p_component->unit = p_list->unit_count - 1;
+      }
+      *p_location += Max((first_component + column_size + 3) / 4, 1);
     }
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_set)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static SpvReflectResult AddInterfaceUnit(SpvReflectPrvInterfaceComponents* p_list, const SpvReflectInterfaceVariable* p_var,
+                                         uint32_t array_skip, uint32_t* p_location) {
+  void* p_units = GrowArray(p_list->units, &p_list->unit_capacity, p_list->unit_count, sizeof(*p_list->units));
+  if (IsNull(p_units)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
-  return p_set;
+  p_list->units = (SpvReflectPrvInterfaceUnit*)p_units;
+  uint32_t first_component = (p_var->component == (uint32_t)INVALID_VALUE) ? 0 : (p_var->component & 3);
+  SpvReflectPrvInterfaceUnit* p_unit = &p_list->units[p_list->unit_count];
+  p_unit->p_var = p_var;
+  p_unit->key = (*p_location << 2) | first_component;
+  p_unit->array_skip = array_skip;
+  p_unit->first_component = p_list->component_count;
+  p_unit->order = p_list->unit_count++;
+  p_unit->used = false;
+  SpvReflectResult result = AddInterfaceComponents(p_list, p_var, array_skip, first_component, p_location);
+  p_unit->component_count = p_list->component_count - p_unit->first_component;
+  return result;
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetInputVariableByLocation(const SpvReflectShaderModule* p_module, uint32_t location,
-                                                                        SpvReflectResult* p_result) {
-  if (location == (uint32_t)INVALID_VALUE) {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+// Expands the non-built-in inputs or outputs of p_entry to the components they
+// cover. Blocks without a Location take their locations from their members,
+// each member following the previous one unless it has its own Location.
+static SpvReflectResult CollectInterfaceComponents(const SpvReflectEntryPoint* p_entry, bool output,
+                                                   SpvReflectPrvInterfaceComponents* p_list) {
+  uint32_t count = output ? p_entry->output_variable_count : p_entry->input_variable_count;
+  SpvReflectInterfaceVariable* const* pp_variables = output ? p_entry->output_variables : p_entry->input_variables;
+  for (uint32_t i = 0; i < count; ++i) {
+    const SpvReflectInterfaceVariable* p_var = pp_variables[i];
+    if (p_var->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) {
+      continue;
+    }
+    SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+    if (p_var->location != (uint32_t)INVALID_VALUE) {
+      uint32_t location = p_var->location;
+      result = AddInterfaceUnit(p_list, p_var, PerVertexArrayDims(p_var, p_entry->shader_stage, output), &location);
+    } else {
+      uint32_t location = (uint32_t)INVALID_VALUE;
+      for (uint32_t j = 0; (j < p_var->member_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++j) {
+        const SpvReflectInterfaceVariable* p_member = &p_var->members[j];
+        if (p_member->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) {
+          continue;
+        }
+        if (HasMemberLocation(p_member)) {
+          location = p_member->location;
+        }
+        if (location != (uint32_t)INVALID_VALUE) {
+          result = AddInterfaceUnit(p_list, p_member, 0, &location);
+        }
+      }
+    }
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      return result;
     }
-    return NULL;
   }
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    for (uint32_t index = 0; index < p_module->input_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_module->input_variables[index];
-      if (p_potential->location == location) {
-        p_var = p_potential;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+static void DestroyInterfaceComponents(SpvReflectPrvInterfaceComponents* p_list) {
+  SafeFree(p_list->units);
+  SafeFree(p_list->components);
+}
+
+// Returns the first of the sorted components at key, or NULL.
+static const SpvReflectPrvInterfaceComponent* FindInterfaceComponent(const SpvReflectPrvInterfaceComponents* p_list, uint32_t key) {
+  uint32_t lo = 0;
+  uint32_t hi = p_list->component_count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (p_list->components[mid].key < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return ((lo < p_list->component_count) && (p_list->components[lo].key == key)) ? &p_list->components[lo] : NULL;
+}
+
+SpvReflectResult spvReflectCheckStageInterface(const SpvReflectShaderModule* p_producer_module, const char* producer_entry_point,
+                                               const SpvReflectShaderModule* p_consumer_module, const char* consumer_entry_point,
+                                               uint32_t* p_count, SpvReflectInterfaceMismatch* p_mismatches) {
+  if (IsNull(p_producer_module) || IsNull(producer_entry_point) || IsNull(p_consumer_module) || IsNull(consumer_entry_point) ||
+      IsNull(p_count)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  const SpvReflectEntryPoint* p_producer = spvReflectGetEntryPoint(p_producer_module, producer_entry_point);
+  const SpvReflectEntryPoint* p_consumer = spvReflectGetEntryPoint(p_consumer_module, consumer_entry_point);
+  if (IsNull(p_producer) || IsNull(p_consumer)) {
+    return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  }
+
+  SpvReflectPrvInterfaceComponents outputs;
+  SpvReflectPrvInterfaceComponents inputs;
+  memset(&outputs, 0, sizeof(outputs));
+  memset(&inputs, 0, sizeof(inputs));
+  SpvReflectResult result = CollectInterfaceComponents(p_producer, true, &outputs);
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = CollectInterfaceComponents(p_consumer, false, &inputs);
+  }
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    DestroyInterfaceComponents(&outputs);
+    DestroyInterfaceComponents(&inputs);
+    return result;
+  }
+  if (outputs.component_count > 0) {
+    qsort(outputs.components, outputs.component_count, sizeof(*outputs.components), SortCompareInterfaceComponents);
+  }
+  if (inputs.unit_count > 0) {
+    qsort(inputs.units, inputs.unit_count, sizeof(*inputs.units), SortCompareInterfaceUnits);
+  }
+
+  uint32_t capacity = IsNotNull(p_mismatches) ? *p_count : 0;
+  uint32_t count = 0;
+
+  // Every component of an input must be written by an output with the same
+  // component type. An output may cover more than one input and more
+  // components than are read.
+  for (uint32_t i = 0; i < inputs.unit_count; ++i) {
+    const SpvReflectPrvInterfaceUnit* p_input = &inputs.units[i];
+    const SpvReflectPrvInterfaceUnit* p_output = NULL;
+    bool covered = true;
+    bool kinds_match = true;
+    for (uint32_t j = 0; j < p_input->component_count; ++j) {
+      const SpvReflectPrvInterfaceComponent* p_component = &inputs.components[p_input->first_component + j];
+      const SpvReflectPrvInterfaceComponent* p_written = FindInterfaceComponent(&outputs, p_component->key);
+      if (IsNull(p_written)) {
+        covered = false;
+        continue;
+      }
+      outputs.units[p_written->unit].used = true;
+      if (IsNull(p_output)) {
+        p_output = &outputs.units[p_written->unit];
+      }
+      kinds_match &= (p_written->kind == p_component->kind);
+    }
+    if (IsNull(p_output)) {
+      AppendInterfaceMismatch(p_mismatches, capacity, &count, SPV_REFLECT_INTERFACE_MISMATCH_MISSING_OUTPUT, p_input->key, NULL,
+                              p_input->p_var);
+    } else if (!kinds_match ||
+               (!covered && InterfaceArraysMatch(&p_output->p_var->array, p_output->array_skip, &p_input->p_var->array,
+                                                 p_input->array_skip))) {
+      AppendInterfaceMismatch(p_mismatches, capacity, &count, SPV_REFLECT_INTERFACE_MISMATCH_TYPE, p_input->key, p_output->p_var,
+                              p_input->p_var);
+    } else if (!covered) {
+      AppendInterfaceMismatch(p_mismatches, capacity, &count, SPV_REFLECT_INTERFACE_MISMATCH_ARRAY, p_input->key, p_output->p_var,
+                              p_input->p_var);
+    }
+  }
+
+  uint32_t required_built_ins = RequiredBuiltInMask(p_consumer->shader_stage);
+  uint32_t written_built_ins = OutputBuiltInMask(p_producer);
+  for (uint32_t i = 0; i < p_consumer->input_variable_count; ++i) {
+    const SpvReflectInterfaceVariable* p_input = p_consumer->input_variables[i];
+    if ((p_input->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) == 0) {
+      continue;
+    }
+    if (IsBuiltInInMask(p_input->built_in, required_built_ins) && !IsBuiltInInMask(p_input->built_in, written_built_ins)) {
+      AppendInterfaceMismatch(p_mismatches, capacity, &count, SPV_REFLECT_INTERFACE_MISMATCH_MISSING_BUILT_IN, 0, NULL, p_input);
+    }
+    for (uint32_t k = 0; k < p_input->member_count; ++k) {
+      const SpvReflectInterfaceVariable* p_member = &p_input->members[k];
+      if (IsBuiltInInMask(p_member->built_in, required_built_ins) && !IsBuiltInInMask(p_member->built_in, written_built_ins)) {
+        AppendInterfaceMismatch(p_mismatches, capacity, &count, SPV_REFLECT_INTERFACE_MISMATCH_MISSING_BUILT_IN, 0, NULL,
+                                p_member);
       }
     }
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+
+  if (outputs.unit_count > 0) {
+    qsort(outputs.units, outputs.unit_count, sizeof(*outputs.units), SortCompareInterfaceUnits);
+  }
+  for (uint32_t i = 0; i < outputs.unit_count; ++i) {
+    if (!outputs.units[i].used) {
+      AppendInterfaceMismatch(p_mismatches, capacity, &count, SPV_REFLECT_INTERFACE_MISMATCH_UNUSED_OUTPUT, outputs.units[i].key,
+                              outputs.units[i].p_var, NULL);
+    }
+  }
+  DestroyInterfaceComponents(&outputs);
+  DestroyInterfaceComponents(&inputs);
+
+  if (IsNotNull(p_mismatches) && (count != capacity)) {
+    return SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH;
   }
-  return p_var;
-}
-const SpvReflectInterfaceVariable* spvReflectGetInputVariable(const SpvReflectShaderModule* p_module, uint32_t location,
-                                                              SpvReflectResult* p_result) {
-  return spvReflectGetInputVariableByLocation(p_module, location, p_result);
+  *p_count = count;
+  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetEntryPointInputVariableByLocation(const SpvReflectShaderModule* p_module,
-                                                                                  const char* entry_point, uint32_t location,
-                                                                                  SpvReflectResult* p_result) {
-  if (location == (uint32_t)INVALID_VALUE) {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-    }
-    return NULL;
+// Flattening runs twice: once to size the member and path storage, then
+// again with p_members set to fill it. The path of the member being visited
+// is built up in p_scratch.
+typedef struct SpvReflectPrvFlatBlockBuilder {
+  SpvReflectFlatBlockMember*      p_members;
+  char*                           p_paths;
+  char*                           p_scratch;
+  uint32_t                        member_count;
+  uint32_t                        path_size;
+  uint32_t                        max_path_length;
+} SpvReflectPrvFlatBlockBuilder;
+
+static void AppendFlatBlockPath(SpvReflectPrvFlatBlockBuilder* p_builder, uint32_t* p_path_length, const char* text) {
+  uint32_t length = (uint32_t)strlen(text);
+  if (IsNotNull(p_builder->p_members)) {
+    memcpy(p_builder->p_scratch + *p_path_length, text, length);
   }
+  *p_path_length += length;
+  p_builder->max_path_length = Max(p_builder->max_path_length, *p_path_length);
+}
 
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-    if (IsNull(p_entry)) {
-      if (IsNotNull(p_result)) {
-        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-      }
-      return NULL;
-    }
-    for (uint32_t index = 0; index < p_entry->input_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_entry->input_variables[index];
-      if (p_potential->location == location) {
-        p_var = p_potential;
+static void AppendFlatBlockIndex(SpvReflectPrvFlatBlockBuilder* p_builder, uint32_t* p_path_length, uint32_t index) {
+  char digits[10];
+  uint32_t digit_count = 0;
+  do {
+    digits[digit_count++] = (char)('0' + (index % 10));
+    index /= 10;
+  } while (index > 0);
+
+  char text[13];
+  uint32_t length = 0;
+  text[length++] = '[';
+  while (digit_count > 0) {
+    text[length++] = digits[--digit_count];
+  }
+  text[length++] = ']';
+  text[length] = '\0';
+  AppendFlatBlockPath(p_builder, p_path_length, text);
+}
+
+static void FlattenBlockVariable(SpvReflectPrvFlatBlockBuilder* p_builder, const SpvReflectBlockVariable* p_block,
+                                 uint32_t base_offset, uint32_t path_length) {
+  for (uint32_t i = 0; i < p_block->member_count; ++i) {
+    const SpvReflectBlockVariable* p_member = &p_block->members[i];
+    uint32_t member_path_length = path_length;
+    if (path_length > 0) {
+      AppendFlatBlockPath(p_builder, &member_path_length, ".");
+    }
+    AppendFlatBlockPath(p_builder, &member_path_length, IsNotNull(p_member->name) ? p_member->name : "");
+    uint32_t offset = base_offset + p_member->offset;
+
+    uint32_t element_count = 1;
+    for (uint32_t j = 0; j < p_member->array.dims_count; ++j) {
+      element_count *= p_member->array.dims[j];
+    }
+
+    // Physical pointers are leaves; their members describe the pointee.
+    bool is_reference =
+        IsNotNull(p_member->type_description) && (p_member->type_description->type_flags & SPV_REFLECT_TYPE_FLAG_REF);
+    if ((p_member->member_count > 0) && !is_reference) {
+      // Expand arrays of structs element by element, last index fastest.
+      uint32_t expanded_count = (element_count == 0) ? 1 : element_count;
+      for (uint32_t element = 0; element < expanded_count; ++element) {
+        uint32_t element_path_length = member_path_length;
+        uint32_t remainder = element;
+        uint32_t divisor = expanded_count;
+        for (uint32_t j = 0; j < p_member->array.dims_count; ++j) {
+          uint32_t dim = Max(p_member->array.dims[j], 1);
+          divisor /= dim;
+          AppendFlatBlockIndex(p_builder, &element_path_length, (divisor > 0) ? (remainder / divisor) : 0);
+          remainder = (divisor > 0) ? (remainder % divisor) : 0;
+        }
+        FlattenBlockVariable(p_builder, p_member, offset + element * p_member->array.stride, element_path_length);
       }
+      continue;
     }
+
+    if (IsNotNull(p_builder->p_members)) {
+      SpvReflectFlatBlockMember* p_flat = &p_builder->p_members[p_builder->member_count];
+      char* p_path = p_builder->p_paths + p_builder->path_size;
+      memcpy(p_path, p_builder->p_scratch, member_path_length);
+      p_path[member_path_length] = '\0';
+      p_flat->path = p_path;
+      p_flat->path_hash = HashString(p_path);
+      p_flat->absolute_offset = offset;
+      p_flat->size = p_member->size;
+      p_flat->type_flags =
+          IsNotNull(p_member->type_description)
+              ? (p_member->type_description->type_flags & (SPV_REFLECT_TYPE_FLAG_BOOL | SPV_REFLECT_TYPE_FLAG_INT |
+                                                           SPV_REFLECT_TYPE_FLAG_FLOAT | SPV_REFLECT_TYPE_FLAG_VECTOR |
+                                                           SPV_REFLECT_TYPE_FLAG_MATRIX | SPV_REFLECT_TYPE_FLAG_REF))
+              : 0;
+      p_flat->numeric = p_member->numeric;
+      p_flat->array_count = element_count;
+      p_flat->array_stride = (p_member->array.dims_count > 0) ? p_member->array.stride : 0;
+      p_flat->decoration_flags = p_member->decoration_flags;
+      p_flat->member = p_member;
+    }
+    p_builder->member_count += 1;
+    p_builder->path_size += member_path_length + 1;
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+}
+
+SpvReflectResult spvReflectCreateFlatBlock(const SpvReflectBlockVariable* p_block, SpvReflectFlatBlock* p_flat_block) {
+  if (IsNull(p_block) || IsNull(p_flat_block)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
   }
-  return p_var;
+  memset(p_flat_block, 0, sizeof(*p_flat_block));
+
+  SpvReflectPrvFlatBlockBuilder builder;
+  memset(&builder, 0, sizeof(builder));
+  FlattenBlockVariable(&builder, p_block, 0, 0);
+
+#ifdef __cplusplus
+  p_flat_block->_internal = (SpvReflectFlatBlock::FlatBlockInternal*)calloc(1, sizeof(*(p_flat_block->_internal)));
+#else
+  p_flat_block->_internal = calloc(1, sizeof(*(p_flat_block->_internal)));
+#endif
+  if (IsNull(p_flat_block->_internal)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  if (builder.member_count == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+
+  p_flat_block->members = (SpvReflectFlatBlockMember*)calloc(builder.member_count, sizeof(*(p_flat_block->members)));
+  p_flat_block->_internal->paths = (char*)calloc(builder.path_size, sizeof(char));
+  builder.p_scratch = (char*)calloc(builder.max_path_length + 1, sizeof(char));
+  if (IsNull(p_flat_block->members) || IsNull(p_flat_block->_internal->paths) || IsNull(builder.p_scratch)) {
+    SafeFree(builder.p_scratch);
+    spvReflectDestroyFlatBlock(p_flat_block);
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+
+  builder.p_members = p_flat_block->members;
+  builder.p_paths = p_flat_block->_internal->paths;
+  builder.member_count = 0;
+  builder.path_size = 0;
+  FlattenBlockVariable(&builder, p_block, 0, 0);
+  p_flat_block->member_count = builder.member_count;
+
+  SafeFree(builder.p_scratch);
+  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetInputVariableBySemantic(const SpvReflectShaderModule* p_module,
-                                                                        const char* semantic, SpvReflectResult* p_result) {
-  if (IsNull(semantic)) {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-    }
+static const SpvReflectFlatBlockMember* FindFlatBlockMember(const SpvReflectFlatBlock* p_flat_block, const char* path,
+                                                            size_t length) {
+  uint32_t capacity = p_flat_block->_internal->member_index_capacity;
+  if (capacity == 0) {
     return NULL;
   }
-  if (semantic[0] == '\0') {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  const uint32_t* table = p_flat_block->_internal->member_index_by_path;
+  uint32_t mask = capacity - 1;
+  uint32_t hash = HashStringLength(path, length);
+  for (uint32_t slot = hash & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+    const SpvReflectFlatBlockMember* p_member = &p_flat_block->members[table[slot] - 1];
+    if ((p_member->path_hash == hash) && (strncmp(p_member->path, path, length) == 0) && (p_member->path[length] == '\0')) {
+      return p_member;
     }
-    return NULL;
   }
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    for (uint32_t index = 0; index < p_module->input_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_module->input_variables[index];
-      if (p_potential->semantic != NULL && strcmp(p_potential->semantic, semantic) == 0) {
-        p_var = p_potential;
-      }
+  return NULL;
+}
+
+// Parses one "[n]" subscript at *p_str; returns false if there is none.
+static bool ParseFlatBlockSubscript(const char** p_str, uint32_t* p_index) {
+  const char* str = *p_str;
+  if (*str != '[') {
+    return false;
+  }
+  ++str;
+  uint64_t index = 0;
+  const char* digits = str;
+  while ((*str >= '0') && (*str <= '9')) {
+    index = index * 10 + (uint64_t)(*str - '0');
+    if (index > UINT32_MAX) {
+      return false;
     }
+    ++str;
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  if ((str == digits) || (*str != ']')) {
+    return false;
   }
-  return p_var;
+  *p_index = (uint32_t)index;
+  *p_str = str + 1;
+  return true;
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetEntryPointInputVariableBySemantic(const SpvReflectShaderModule* p_module,
-                                                                                  const char* entry_point, const char* semantic,
-                                                                                  SpvReflectResult* p_result) {
-  if (IsNull(semantic)) {
+const SpvReflectFlatBlockMember* spvReflectGetFlatBlockMemberByPath(SpvReflectFlatBlock* p_flat_block, const char* path,
+                                                                    uint32_t* p_offset, SpvReflectResult* p_result) {
+  if (IsNull(p_flat_block) || IsNull(p_flat_block->_internal) || IsNull(path)) {
     if (IsNotNull(p_result)) {
       *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
     }
     return NULL;
   }
-  if (semantic[0] == '\0') {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-    }
-    return NULL;
-  }
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-    if (IsNull(p_entry)) {
+
+  // Build the index on first use.
+  if ((p_flat_block->member_count > 0) && IsNull(p_flat_block->_internal->member_index_by_path)) {
+    uint32_t capacity = HashTableCapacity(p_flat_block->member_count);
+    uint32_t* table = (uint32_t*)calloc(capacity, sizeof(*table));
+    if (IsNull(table)) {
       if (IsNotNull(p_result)) {
-        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+        *p_result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
       }
       return NULL;
     }
-    for (uint32_t index = 0; index < p_entry->input_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_entry->input_variables[index];
-      if (p_potential->semantic != NULL && strcmp(p_potential->semantic, semantic) == 0) {
-        p_var = p_potential;
+    for (uint32_t i = 0; i < p_flat_block->member_count; ++i) {
+      HashTableInsert(table, capacity, p_flat_block->members[i].path_hash, i);
+    }
+    p_flat_block->_internal->member_index_by_path = table;
+    p_flat_block->_internal->member_index_capacity = capacity;
+  }
+
+  size_t length = strlen(path);
+  const SpvReflectFlatBlockMember* p_member = FindFlatBlockMember(p_flat_block, path, length);
+  uint32_t offset = IsNotNull(p_member) ? p_member->absolute_offset : 0;
+
+  // Subscripts into an array leaf, e.g. "weights[2]", are not stored in the
+  // table; strip them and index into the leaf's array.
+  if (IsNull(p_member)) {
+    size_t prefix_length = length;
+    while ((prefix_length > 0) && (path[prefix_length - 1] == ']')) {
+      size_t open = prefix_length - 1;
+      while ((open > 0) && (path[open - 1] >= '0') && (path[open - 1] <= '9')) {
+        --open;
+      }
+      if ((open == 0) || (open == prefix_length - 1) || (path[open - 1] != '[')) {
+        break;
+      }
+      prefix_length = open - 1;
+    }
+    if (prefix_length < length) {
+      p_member = FindFlatBlockMember(p_flat_block, path, prefix_length);
+    }
+    if (IsNotNull(p_member)) {
+      const SpvReflectArrayTraits* p_array = &p_member->member->array;
+      const char* subscripts = path + prefix_length;
+      uint32_t flat_index = 0;
+      uint32_t dim_index = 0;
+      uint32_t index = 0;
+      while (ParseFlatBlockSubscript(&subscripts, &index)) {
+        uint32_t dim = (dim_index < p_array->dims_count) ? p_array->dims[dim_index] : 0;
+        bool in_bounds = (dim_index < p_array->dims_count) && ((dim == SPV_REFLECT_ARRAY_DIM_RUNTIME) || (index < dim));
+        if (!in_bounds) {
+          p_member = NULL;
+          break;
+        }
+        flat_index = flat_index * dim + index;
+        ++dim_index;
+      }
+      // Only fully subscripted elements have a single offset.
+      if (IsNotNull(p_member) && (dim_index != p_array->dims_count)) {
+        p_member = NULL;
+      }
+      if (IsNotNull(p_member)) {
+        offset = p_member->absolute_offset + flat_index * p_member->array_stride;
       }
     }
   }
+
+  if (IsNotNull(p_offset) && IsNotNull(p_member)) {
+    *p_offset = offset;
+  }
   if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+    *p_result = IsNotNull(p_member) ? SPV_REFLECT_RESULT_SUCCESS : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
   }
-  return p_var;
+  return p_member;
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetOutputVariableByLocation(const SpvReflectShaderModule* p_module, uint32_t location,
-                                                                         SpvReflectResult* p_result) {
-  if (location == (uint32_t)INVALID_VALUE) {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-    }
-    return NULL;
+void spvReflectDestroyFlatBlock(SpvReflectFlatBlock* p_flat_block) {
+  if (IsNull(p_flat_block)) {
+    return;
   }
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    for (uint32_t index = 0; index < p_module->output_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_module->output_variables[index];
-      if (p_potential->location == location) {
-        p_var = p_potential;
-      }
+  if (IsNotNull(p_flat_block->_internal)) {
+    SafeFree(p_flat_block->_internal->paths);
+    SafeFree(p_flat_block->_internal->member_index_by_path);
+  }
+  SafeFree(p_flat_block->_internal);
+  SafeFree(p_flat_block->members);
+  memset(p_flat_block, 0, sizeof(*p_flat_block));
+}
+
+typedef struct SpvReflectPrvPackPlanBuilder {
+  SpvReflectPackOp*               p_ops;
+  uint32_t                        op_count;
+  uint32_t                        op_capacity;
+  uint32_t                        host_size;
+} SpvReflectPrvPackPlanBuilder;
+
+static SpvReflectResult AppendPackOp(SpvReflectPrvPackPlanBuilder* p_builder, uint32_t dst_offset, uint32_t size, uint32_t count,
+                                     uint32_t src_stride, uint32_t dst_stride) {
+  if ((size == 0) || (count == 0)) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+  // A run of back to back copies is one contiguous copy.
+  if ((count > 1) && (src_stride == size) && (dst_stride == size)) {
+    size *= count;
+    count = 1;
+  }
+  uint32_t src_offset = p_builder->host_size;
+  if ((count == 1) && (p_builder->op_count > 0)) {
+    SpvReflectPackOp* p_last = &p_builder->p_ops[p_builder->op_count - 1];
+    if ((p_last->count == 1) && (p_last->src_offset + p_last->size == src_offset) &&
+        (p_last->dst_offset + p_last->size == dst_offset)) {
+      p_last->size += size;
+      p_builder->host_size += size;
+      return SPV_REFLECT_RESULT_SUCCESS;
     }
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  void* p_ops = GrowArray(p_builder->p_ops, &p_builder->op_capacity, p_builder->op_count, sizeof(*(p_builder->p_ops)));
+  if (IsNull(p_ops)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
-  return p_var;
-}
-const SpvReflectInterfaceVariable* spvReflectGetOutputVariable(const SpvReflectShaderModule* p_module, uint32_t location,
-                                                               SpvReflectResult* p_result) {
-  return spvReflectGetOutputVariableByLocation(p_module, location, p_result);
+  p_builder->p_ops = (SpvReflectPackOp*)p_ops;
+  SpvReflectPackOp* p_op = &p_builder->p_ops[p_builder->op_count++];
+  p_op->src_offset = src_offset;
+  p_op->dst_offset = dst_offset;
+  p_op->size = size;
+  p_op->count = count;
+  p_op->src_stride = (count > 1) ? src_stride : 0;
+  p_op->dst_stride = (count > 1) ? dst_stride : 0;
+  p_builder->host_size += (count - 1) * src_stride + size;
+  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetEntryPointOutputVariableByLocation(const SpvReflectShaderModule* p_module,
-                                                                                   const char* entry_point, uint32_t location,
-                                                                                   SpvReflectResult* p_result) {
-  if (location == (uint32_t)INVALID_VALUE) {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-    }
-    return NULL;
+static SpvReflectResult AppendPackOpsForLeaf(SpvReflectPrvPackPlanBuilder* p_builder, const SpvReflectBlockVariable* p_member,
+                                             uint32_t dst_offset, uint32_t element_count) {
+  SpvReflectTypeFlags type_flags = IsNotNull(p_member->type_description) ? p_member->type_description->type_flags : 0;
+  uint32_t component_size = p_member->numeric.scalar.width / SPIRV_BYTE_WIDTH;
+  if (type_flags & SPV_REFLECT_TYPE_FLAG_REF) {
+    component_size = sizeof(uint64_t);
+  } else if ((type_flags & SPV_REFLECT_TYPE_FLAG_BOOL) || (component_size == 0)) {
+    component_size = SPIRV_WORD_SIZE;
   }
+  uint32_t array_stride = (p_member->array.dims_count > 0) ? p_member->array.stride : 0;
 
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-    if (IsNull(p_entry)) {
-      if (IsNotNull(p_result)) {
-        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  if ((type_flags & SPV_REFLECT_TYPE_FLAG_MATRIX) && !(type_flags & SPV_REFLECT_TYPE_FLAG_REF)) {
+    uint32_t column_count = p_member->numeric.matrix.column_count;
+    uint32_t row_count = p_member->numeric.matrix.row_count;
+    uint32_t matrix_stride = p_member->numeric.matrix.stride;
+    uint32_t column_size = row_count * component_size;
+    bool row_major = (p_member->decoration_flags & SPV_REFLECT_DECORATION_ROW_MAJOR) != 0;
+    for (uint32_t element = 0; (element < element_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++element) {
+      uint32_t element_offset = dst_offset + element * array_stride;
+      if (!row_major) {
+        result = AppendPackOp(p_builder, element_offset, column_size, column_count, column_size, matrix_stride);
+        continue;
       }
-      return NULL;
-    }
-    for (uint32_t index = 0; index < p_entry->output_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_entry->output_variables[index];
-      if (p_potential->location == location) {
-        p_var = p_potential;
+      // Host columns become strided writes across the rows.
+      for (uint32_t column = 0; (column < column_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++column) {
+        result = AppendPackOp(p_builder, element_offset + column * component_size, component_size, row_count, component_size,
+                              matrix_stride);
       }
     }
+    return result;
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
-  }
-  return p_var;
+
+  uint32_t component_count = Max(p_member->numeric.vector.component_count, 1);
+  uint32_t element_size = component_count * component_size;
+  return AppendPackOp(p_builder, dst_offset, element_size, element_count, element_size, array_stride);
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetOutputVariableBySemantic(const SpvReflectShaderModule* p_module,
-                                                                         const char* semantic, SpvReflectResult* p_result) {
-  if (IsNull(semantic)) {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static SpvReflectResult AppendPackOpsForBlock(SpvReflectPrvPackPlanBuilder* p_builder, const SpvReflectBlockVariable* p_block,
+                                              uint32_t base_offset) {
+  for (uint32_t i = 0; i < p_block->member_count; ++i) {
+    const SpvReflectBlockVariable* p_member = &p_block->members[i];
+    uint32_t element_count = 1;
+    for (uint32_t j = 0; j < p_member->array.dims_count; ++j) {
+      element_count *= p_member->array.dims[j];
     }
-    return NULL;
-  }
-  if (semantic[0] == '\0') {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+    // Runtime-sized arrays have no fixed host layout.
+    if (element_count == 0) {
+      continue;
     }
-    return NULL;
-  }
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    for (uint32_t index = 0; index < p_module->output_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_module->output_variables[index];
-      if (p_potential->semantic != NULL && strcmp(p_potential->semantic, semantic) == 0) {
-        p_var = p_potential;
+    uint32_t offset = base_offset + p_member->offset;
+    bool is_reference =
+        IsNotNull(p_member->type_description) && (p_member->type_description->type_flags & SPV_REFLECT_TYPE_FLAG_REF);
+    SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+    if ((p_member->member_count > 0) && !is_reference) {
+      for (uint32_t element = 0; (element < element_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++element) {
+        result = AppendPackOpsForBlock(p_builder, p_member, offset + element * p_member->array.stride);
       }
+    } else {
+      result = AppendPackOpsForLeaf(p_builder, p_member, offset, element_count);
+    }
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      return result;
     }
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+SpvReflectResult spvReflectCreatePackPlan(const SpvReflectBlockVariable* p_block, SpvReflectPackPlan* p_plan) {
+  if (IsNull(p_block) || IsNull(p_plan)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
   }
-  return p_var;
+  memset(p_plan, 0, sizeof(*p_plan));
+
+  SpvReflectPrvPackPlanBuilder builder;
+  memset(&builder, 0, sizeof(builder));
+  SpvReflectResult result = AppendPackOpsForBlock(&builder, p_block, 0);
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    SafeFree(builder.p_ops);
+    return result;
+  }
+
+  // Some storage blocks report no size, so also cover the furthest write.
+  uint32_t device_size = Max(p_block->padded_size, p_block->size);
+  for (uint32_t i = 0; i < builder.op_count; ++i) {
+    const SpvReflectPackOp* p_op = &builder.p_ops[i];
+    device_size = Max(device_size, p_op->dst_offset + (p_op->count - 1) * p_op->dst_stride + p_op->size);
+  }
+  p_plan->host_size = builder.host_size;
+  p_plan->device_size = device_size;
+  p_plan->op_count = builder.op_count;
+  p_plan->ops = builder.p_ops;
+  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const SpvReflectInterfaceVariable* spvReflectGetEntryPointOutputVariableBySemantic(const SpvReflectShaderModule* p_module,
-                                                                                   const char* entry_point, const char* semantic,
-                                                                                   SpvReflectResult* p_result) {
-  if (IsNull(semantic)) {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
-    }
-    return NULL;
+// Copies with a size known at compile time let the compiler use vector loads
+// and stores instead of a call to memcpy.
+static void CopyPackRun(uint8_t* p_dst, const uint8_t* p_src, size_t size) {
+  switch (size) {
+    case 4:
+      memcpy(p_dst, p_src, 4);
+      break;
+    case 8:
+      memcpy(p_dst, p_src, 8);
+      break;
+    case 12:
+      memcpy(p_dst, p_src, 12);
+      break;
+    case 16:
+      memcpy(p_dst, p_src, 16);
+      break;
+    default:
+      memcpy(p_dst, p_src, size);
+      break;
   }
-  if (semantic[0] == '\0') {
-    if (IsNotNull(p_result)) {
-      *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-    }
-    return NULL;
+}
+
+SpvReflectResult spvReflectExecutePackPlan(const SpvReflectPackPlan* p_plan, uint32_t instance_count, const void* p_src,
+                                           uint32_t src_instance_stride, void* p_dst, uint32_t dst_instance_stride) {
+  if (IsNull(p_plan)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
   }
-  const SpvReflectInterfaceVariable* p_var = NULL;
-  if (IsNotNull(p_module)) {
-    const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-    if (IsNull(p_entry)) {
-      if (IsNotNull(p_result)) {
-        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  if (instance_count == 0) {
+    return SPV_REFLECT_RESULT_SUCCESS;
+  }
+  if (IsNull(p_src) || IsNull(p_dst)) {
+    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  }
+  size_t src_stride = (src_instance_stride != 0) ? src_instance_stride : p_plan->host_size;
+  size_t dst_stride = (dst_instance_stride != 0) ? dst_instance_stride : p_plan->device_size;
+  const uint8_t* p_src_bytes = (const uint8_t*)p_src;
+  uint8_t* p_dst_bytes = (uint8_t*)p_dst;
+
+  // Each op is applied to every instance before moving on, so its offsets,
+  // strides and size stay in registers across the inner loop.
+  for (uint32_t op_index = 0; op_index < p_plan->op_count; ++op_index) {
+    const SpvReflectPackOp* p_op = &p_plan->ops[op_index];
+    const uint8_t* p_op_src = p_src_bytes + p_op->src_offset;
+    uint8_t* p_op_dst = p_dst_bytes + p_op->dst_offset;
+    size_t size = p_op->size;
+    if (p_op->count == 1) {
+      for (uint32_t instance = 0; instance < instance_count; ++instance) {
+        CopyPackRun(p_op_dst + instance * dst_stride, p_op_src + instance * src_stride, size);
       }
-      return NULL;
+      continue;
     }
-    for (uint32_t index = 0; index < p_entry->output_variable_count; ++index) {
-      const SpvReflectInterfaceVariable* p_potential = p_entry->output_variables[index];
-      if (p_potential->semantic != NULL && strcmp(p_potential->semantic, semantic) == 0) {
-        p_var = p_potential;
+    for (uint32_t instance = 0; instance < instance_count; ++instance) {
+      const uint8_t* p_run_src = p_op_src + instance * src_stride;
+      uint8_t* p_run_dst = p_op_dst + instance * dst_stride;
+      for (uint32_t run = 0; run < p_op->count; ++run) {
+        CopyPackRun(p_run_dst, p_run_src, size);
+        p_run_src += p_op->src_stride;
+        p_run_dst += p_op->dst_stride;
       }
     }
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_var)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+void spvReflectDestroyPackPlan(SpvReflectPackPlan* p_plan) {
+  if (IsNull(p_plan)) {
+    return;
+  }
+  SafeFree(p_plan->ops);
+  memset(p_plan, 0, sizeof(*p_plan));
+}
+
+typedef struct SpvReflectPrvModuleDiffBuilder {
+  SpvReflectModuleChange*         p_changes;
+  uint32_t                        change_count;
+  uint32_t                        change_capacity;
+  SpvReflectFlatBlock*            p_flat_blocks;
+  uint32_t                        flat_block_count;
+  uint32_t                        flat_block_capacity;
+} SpvReflectPrvModuleDiffBuilder;
+
+static bool StringsEqual(const char* a, const char* b) {
+  if (IsNull(a) || IsNull(b)) {
+    return a == b;
+  }
+  return strcmp(a, b) == 0;
+}
+
+static SpvReflectResult AppendModuleChange(SpvReflectPrvModuleDiffBuilder* p_builder, const SpvReflectModuleChange* p_change) {
+  SpvReflectModuleChange* p_changes = (SpvReflectModuleChange*)GrowArray(p_builder->p_changes, &p_builder->change_capacity,
+                                                                         p_builder->change_count, sizeof(*p_changes));
+  if (IsNull(p_changes)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  p_builder->p_changes = p_changes;
+  p_builder->p_changes[p_builder->change_count] = *p_change;
+  p_builder->change_count += 1;
+  return SPV_REFLECT_RESULT_SUCCESS;
+}
+
+// Appends an ADDED or REMOVED change if p_old or p_new is NULL, or a MODIFIED
+// one if changed; p_template supplies the object and its key.
+static SpvReflectResult AppendModuleChangeIf(SpvReflectPrvModuleDiffBuilder* p_builder, const SpvReflectModuleChange* p_template,
+                                             const void* p_old, const void* p_new, bool changed,
+                                             SpvReflectModuleRebuildFlags rebuild_flags) {
+  if (IsNotNull(p_old) && IsNotNull(p_new) && !changed) {
+    return SPV_REFLECT_RESULT_SUCCESS;
   }
-  return p_var;
+  SpvReflectModuleChange change = *p_template;
+  change.type = IsNull(p_old)   ? SPV_REFLECT_MODULE_CHANGE_TYPE_ADDED
+                : IsNull(p_new) ? SPV_REFLECT_MODULE_CHANGE_TYPE_REMOVED
+                                : SPV_REFLECT_MODULE_CHANGE_TYPE_MODIFIED;
+  change.rebuild_flags = rebuild_flags;
+  change.p_old = p_old;
+  change.p_new = p_new;
+  return AppendModuleChange(p_builder, &change);
 }
 
-const SpvReflectBlockVariable* spvReflectGetPushConstantBlock(const SpvReflectShaderModule* p_module, uint32_t index,
-                                                              SpvReflectResult* p_result) {
-  const SpvReflectBlockVariable* p_push_constant = NULL;
-  if (IsNotNull(p_module)) {
-    if (index < p_module->push_constant_block_count) {
-      p_push_constant = &p_module->push_constant_blocks[index];
-    }
+// Flattens p_block into storage owned by the diff. Returns NULL if that
+// fails.
+static SpvReflectFlatBlock* AppendDiffFlatBlock(SpvReflectPrvModuleDiffBuilder* p_builder, const SpvReflectBlockVariable* p_block) {
+  SpvReflectFlatBlock* p_flat_blocks = (SpvReflectFlatBlock*)GrowArray(
+      p_builder->p_flat_blocks, &p_builder->flat_block_capacity, p_builder->flat_block_count, sizeof(*p_flat_blocks));
+  if (IsNull(p_flat_blocks)) {
+    return NULL;
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_push_constant)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  p_builder->p_flat_blocks = p_flat_blocks;
+  SpvReflectFlatBlock* p_flat_block = &p_builder->p_flat_blocks[p_builder->flat_block_count];
+  if (spvReflectCreateFlatBlock(p_block, p_flat_block) != SPV_REFLECT_RESULT_SUCCESS) {
+    return NULL;
   }
-  return p_push_constant;
+  p_builder->flat_block_count += 1;
+  return p_flat_block;
 }
-const SpvReflectBlockVariable* spvReflectGetPushConstant(const SpvReflectShaderModule* p_module, uint32_t index,
-                                                         SpvReflectResult* p_result) {
-  return spvReflectGetPushConstantBlock(p_module, index, p_result);
+
+// Returns the first member with exactly the given path; subscripted lookups
+// that resolve into array leaves do not count.
+static const SpvReflectFlatBlockMember* FindDiffFlatBlockMember(SpvReflectFlatBlock* p_flat_block, const char* path) {
+  const SpvReflectFlatBlockMember* p_member = spvReflectGetFlatBlockMemberByPath(p_flat_block, path, NULL, NULL);
+  return (IsNotNull(p_member) && (strcmp(p_member->path, path) == 0)) ? p_member : NULL;
 }
 
-const SpvReflectBlockVariable* spvReflectGetEntryPointPushConstantBlock(const SpvReflectShaderModule* p_module,
-                                                                        const char* entry_point, SpvReflectResult* p_result) {
-  const SpvReflectBlockVariable* p_push_constant = NULL;
-  if (IsNotNull(p_module)) {
-    const SpvReflectEntryPoint* p_entry = spvReflectGetEntryPoint(p_module, entry_point);
-    if (IsNull(p_entry)) {
-      if (IsNotNull(p_result)) {
-        *p_result = SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-      }
-      return NULL;
-    }
-    for (uint32_t i = 0; i < p_module->push_constant_block_count; ++i) {
-      bool found = SearchSortedUint32(p_entry->used_push_constants, p_entry->used_push_constant_count,
-                                      p_module->push_constant_blocks[i].spirv_id);
-      if (found) {
-        p_push_constant = &p_module->push_constant_blocks[i];
-        break;
-      }
-    }
+// Paths through unnamed members are not unique, so members are matched by
+// path and by which occurrence of that path they are. Only duplicates scan.
+static uint32_t DiffFlatBlockMemberOrdinal(SpvReflectFlatBlock* p_flat_block, uint32_t index) {
+  const SpvReflectFlatBlockMember* p_member = &p_flat_block->members[index];
+  const SpvReflectFlatBlockMember* p_first = FindDiffFlatBlockMember(p_flat_block, p_member->path);
+  uint32_t ordinal = 0;
+  for (uint32_t i = IsNotNull(p_first) ? (uint32_t)(p_first - p_flat_block->members) : index; i < index; ++i) {
+    ordinal += StringsEqual(p_flat_block->members[i].path, p_member->path) ? 1 : 0;
   }
-  if (IsNotNull(p_result)) {
-    *p_result = IsNotNull(p_push_constant)
-                    ? SPV_REFLECT_RESULT_SUCCESS
-                    : (IsNull(p_module) ? SPV_REFLECT_RESULT_ERROR_NULL_POINTER : SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
-  }
-  return p_push_constant;
+  return ordinal;
 }
 
-SpvReflectResult spvReflectChangeDescriptorBindingNumbers(SpvReflectShaderModule* p_module,
-                                                          const SpvReflectDescriptorBinding* p_binding, uint32_t new_binding_number,
-                                                          uint32_t new_set_binding) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static const SpvReflectFlatBlockMember* FindDiffFlatBlockMemberOccurrence(SpvReflectFlatBlock* p_flat_block, const char* path,
+                                                                          uint32_t ordinal) {
+  const SpvReflectFlatBlockMember* p_first = FindDiffFlatBlockMember(p_flat_block, path);
+  if (IsNull(p_first) || (ordinal == 0)) {
+    return p_first;
   }
-  if (IsNull(p_binding)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  for (uint32_t i = (uint32_t)(p_first - p_flat_block->members) + 1; i < p_flat_block->member_count; ++i) {
+    if (StringsEqual(p_flat_block->members[i].path, path) && (--ordinal == 0)) {
+      return &p_flat_block->members[i];
+    }
+  }
+  return NULL;
+}
+
+static bool FlatBlockMembersEqual(const SpvReflectFlatBlockMember* p_a, const SpvReflectFlatBlockMember* p_b) {
+  const SpvReflectDecorationFlags layout_mask = SPV_REFLECT_DECORATION_ROW_MAJOR | SPV_REFLECT_DECORATION_COLUMN_MAJOR;
+  return (p_a->absolute_offset == p_b->absolute_offset) && (p_a->size == p_b->size) && (p_a->type_flags == p_b->type_flags) &&
+         (memcmp(&p_a->numeric, &p_b->numeric, sizeof(p_a->numeric)) == 0) && (p_a->array_count == p_b->array_count) &&
+         (p_a->array_stride == p_b->array_stride) &&
+         ((p_a->decoration_flags & layout_mask) == (p_b->decoration_flags & layout_mask));
+}
+
+// Lists members of p_old_block that were removed or changed, then members
+// only in p_new_block.
+static SpvReflectResult DiffBlockMembers(SpvReflectPrvModuleDiffBuilder* p_builder, const SpvReflectModuleChange* p_template,
+                                         const SpvReflectBlockVariable* p_old_block, const SpvReflectBlockVariable* p_new_block) {
+  // Look both blocks up by index, since the array may move as it grows.
+  uint32_t old_index = p_builder->flat_block_count;
+  uint32_t new_index = old_index + 1;
+  if (IsNull(AppendDiffFlatBlock(p_builder, p_old_block)) || IsNull(AppendDiffFlatBlock(p_builder, p_new_block))) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
 
-  SpvReflectDescriptorBinding* p_target_descriptor = NULL;
-  for (uint32_t index = 0; index < p_module->descriptor_binding_count; ++index) {
-    if (&p_module->descriptor_bindings[index] == p_binding) {
-      p_target_descriptor = &p_module->descriptor_bindings[index];
-      break;
+  SpvReflectModuleChange change = *p_template;
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  for (uint32_t i = 0; (i < p_builder->p_flat_blocks[old_index].member_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    SpvReflectFlatBlock* p_old_flat_block = &p_builder->p_flat_blocks[old_index];
+    const SpvReflectFlatBlockMember* p_old = &p_old_flat_block->members[i];
+    uint32_t ordinal = DiffFlatBlockMemberOrdinal(p_old_flat_block, i);
+    const SpvReflectFlatBlockMember* p_new =
+        FindDiffFlatBlockMemberOccurrence(&p_builder->p_flat_blocks[new_index], p_old->path, ordinal);
+    change.path = p_old->path;
+    bool changed = IsNotNull(p_new) && !FlatBlockMembersEqual(p_old, p_new);
+    result = AppendModuleChangeIf(p_builder, &change, p_old, p_new, changed, SPV_REFLECT_MODULE_REBUILD_MATERIAL);
+  }
+  for (uint32_t i = 0; (i < p_builder->p_flat_blocks[new_index].member_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    SpvReflectFlatBlock* p_new_flat_block = &p_builder->p_flat_blocks[new_index];
+    const SpvReflectFlatBlockMember* p_new = &p_new_flat_block->members[i];
+    uint32_t ordinal = DiffFlatBlockMemberOrdinal(p_new_flat_block, i);
+    if (IsNull(FindDiffFlatBlockMemberOccurrence(&p_builder->p_flat_blocks[old_index], p_new->path, ordinal))) {
+      change.path = p_new->path;
+      result = AppendModuleChangeIf(p_builder, &change, NULL, p_new, true, SPV_REFLECT_MODULE_REBUILD_MATERIAL);
     }
   }
+  return result;
+}
 
-  if (IsNotNull(p_target_descriptor)) {
-    if (p_target_descriptor->word_offset.binding > (p_module->_internal->spirv_word_count - 1)) {
-      return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+static bool ExecutionModesEqual(const SpvReflectEntryPoint* p_a, const SpvReflectEntryPoint* p_b) {
+  if ((p_a->execution_mode_count != p_b->execution_mode_count) || (p_a->local_size.x != p_b->local_size.x) ||
+      (p_a->local_size.y != p_b->local_size.y) || (p_a->local_size.z != p_b->local_size.z) ||
+      (p_a->invocations != p_b->invocations) || (p_a->output_vertices != p_b->output_vertices)) {
+    return false;
+  }
+  // The modes are few and may be declared in any order.
+  for (uint32_t i = 0; i < p_a->execution_mode_count; ++i) {
+    uint32_t a_count = 0;
+    uint32_t b_count = 0;
+    for (uint32_t j = 0; j < p_a->execution_mode_count; ++j) {
+      a_count += (p_a->execution_modes[j] == p_a->execution_modes[i]) ? 1 : 0;
+      b_count += (p_b->execution_modes[j] == p_a->execution_modes[i]) ? 1 : 0;
     }
-    // Binding number
-    if (new_binding_number != (uint32_t)SPV_REFLECT_BINDING_NUMBER_DONT_CHANGE) {
-      uint32_t* p_code = p_module->_internal->spirv_code + p_target_descriptor->word_offset.binding;
-      *p_code = new_binding_number;
-      p_target_descriptor->binding = new_binding_number;
+    if (a_count != b_count) {
+      return false;
     }
-    // Set number
-    if (new_set_binding != (uint32_t)SPV_REFLECT_SET_NUMBER_DONT_CHANGE) {
-      uint32_t* p_code = p_module->_internal->spirv_code + p_target_descriptor->word_offset.set;
-      *p_code = new_set_binding;
-      p_target_descriptor->set = new_set_binding;
+  }
+  return true;
+}
+
+static const SpvReflectEntryPoint* FindEntryPointByName(const SpvReflectShaderModule* p_module, const char* name) {
+  for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
+    if (StringsEqual(p_module->entry_points[i].name, name)) {
+      return &p_module->entry_points[i];
     }
   }
+  return NULL;
+}
 
+static SpvReflectResult DiffEntryPoints(SpvReflectPrvModuleDiffBuilder* p_builder, const SpvReflectShaderModule* p_old_module,
+                                        const SpvReflectShaderModule* p_new_module) {
+  SpvReflectModuleChange change;
+  memset(&change, 0, sizeof(change));
   SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
-  if (new_set_binding != (uint32_t)SPV_REFLECT_SET_NUMBER_DONT_CHANGE) {
-    result = SynchronizeDescriptorSets(p_module);
+  for (uint32_t i = 0; (i < p_old_module->entry_point_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectEntryPoint* p_old = &p_old_module->entry_points[i];
+    const SpvReflectEntryPoint* p_new = FindEntryPointByName(p_new_module, p_old->name);
+    change.entry_point = p_old->name;
+    change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_ENTRY_POINT;
+    bool changed = IsNotNull(p_new) && (p_old->shader_stage != p_new->shader_stage);
+    result = AppendModuleChangeIf(p_builder, &change, p_old, p_new, changed, SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE);
+    if (IsNotNull(p_new) && (result == SPV_REFLECT_RESULT_SUCCESS)) {
+      change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_EXECUTION_MODES;
+      result = AppendModuleChangeIf(p_builder, &change, p_old, p_new, !ExecutionModesEqual(p_old, p_new),
+                                    SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE);
+    }
+  }
+  change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_ENTRY_POINT;
+  for (uint32_t i = 0; (i < p_new_module->entry_point_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectEntryPoint* p_new = &p_new_module->entry_points[i];
+    if (IsNull(FindEntryPointByName(p_old_module, p_new->name))) {
+      change.entry_point = p_new->name;
+      result = AppendModuleChangeIf(p_builder, &change, NULL, p_new, true, SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE);
+    }
   }
   return result;
 }
-SpvReflectResult spvReflectChangeDescriptorBindingNumber(SpvReflectShaderModule* p_module,
-                                                         const SpvReflectDescriptorBinding* p_descriptor_binding,
-                                                         uint32_t new_binding_number, uint32_t optional_new_set_number) {
-  return spvReflectChangeDescriptorBindingNumbers(p_module, p_descriptor_binding, new_binding_number, optional_new_set_number);
+
+// Stages of the entry points that statically use the binding.
+static uint32_t DescriptorBindingStages(const SpvReflectShaderModule* p_module, const SpvReflectDescriptorBinding* p_binding) {
+  uint32_t stages = 0;
+  for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
+    const SpvReflectEntryPoint* p_entry_point = &p_module->entry_points[i];
+    for (uint32_t j = 0; j < p_entry_point->descriptor_set_count; ++j) {
+      const SpvReflectDescriptorSet* p_set = &p_entry_point->descriptor_sets[j];
+      for (uint32_t k = 0; k < p_set->binding_count; ++k) {
+        if (p_set->bindings[k] == p_binding) {
+          stages |= p_entry_point->shader_stage;
+        }
+      }
+    }
+  }
+  return stages;
 }
 
-SpvReflectResult spvReflectChangeDescriptorSetNumber(SpvReflectShaderModule* p_module, const SpvReflectDescriptorSet* p_set,
-                                                     uint32_t new_set_number) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static int SortCompareDiffDescriptorBindings(const void* a, const void* b) {
+  const SpvReflectDescriptorBinding* p_a = *(const SpvReflectDescriptorBinding* const*)a;
+  const SpvReflectDescriptorBinding* p_b = *(const SpvReflectDescriptorBinding* const*)b;
+  if (p_a->set != p_b->set) {
+    return (p_a->set < p_b->set) ? -1 : 1;
   }
-  if (IsNull(p_set)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  if (p_a->binding != p_b->binding) {
+    return (p_a->binding < p_b->binding) ? -1 : 1;
   }
-  SpvReflectDescriptorSet* p_target_set = NULL;
-  for (uint32_t index = 0; index < SPV_REFLECT_MAX_DESCRIPTOR_SETS; ++index) {
-    // The descriptor sets for specific entry points might not be in this set,
-    // so just match on set index.
-    if (p_module->descriptor_sets[index].set == p_set->set) {
-      p_target_set = (SpvReflectDescriptorSet*)p_set;
-      break;
-    }
+  // Aliases of one binding pair up in declaration order.
+  return (p_a < p_b) ? -1 : (p_a > p_b) ? 1 : 0;
+}
+
+static SpvReflectModuleRebuildFlags DescriptorBindingChanges(const SpvReflectShaderModule* p_old_module,
+                                                             const SpvReflectDescriptorBinding* p_old,
+                                                             const SpvReflectShaderModule* p_new_module,
+                                                             const SpvReflectDescriptorBinding* p_new) {
+  SpvReflectModuleRebuildFlags flags = SPV_REFLECT_MODULE_REBUILD_NONE;
+  if ((p_old->descriptor_type != p_new->descriptor_type) || (p_old->count != p_new->count) ||
+      (DescriptorBindingStages(p_old_module, p_old) != DescriptorBindingStages(p_new_module, p_new))) {
+    flags |= SPV_REFLECT_MODULE_REBUILD_PIPELINE_LAYOUT | SPV_REFLECT_MODULE_REBUILD_MATERIAL;
+  }
+  if (!StringsEqual(p_old->name, p_new->name) || (p_old->resource_type != p_new->resource_type) ||
+      (memcmp(&p_old->image, &p_new->image, sizeof(p_old->image)) != 0) || (p_old->user_type != p_new->user_type) ||
+      (p_old->block.size != p_new->block.size) || (p_old->block.padded_size != p_new->block.padded_size)) {
+    flags |= SPV_REFLECT_MODULE_REBUILD_MATERIAL;
+  }
+  return flags;
+}
+
+static SpvReflectResult DiffDescriptorBindings(SpvReflectPrvModuleDiffBuilder* p_builder,
+                                               const SpvReflectShaderModule* p_old_module,
+                                               const SpvReflectShaderModule* p_new_module) {
+  uint32_t old_count = p_old_module->descriptor_binding_count;
+  uint32_t new_count = p_new_module->descriptor_binding_count;
+  if ((old_count == 0) && (new_count == 0)) {
+    return SPV_REFLECT_RESULT_SUCCESS;
   }
+  const SpvReflectDescriptorBinding** pp_bindings =
+      (const SpvReflectDescriptorBinding**)calloc(old_count + new_count, sizeof(*pp_bindings));
+  if (IsNull(pp_bindings)) {
+    return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  const SpvReflectDescriptorBinding** pp_old = pp_bindings;
+  const SpvReflectDescriptorBinding** pp_new = pp_bindings + old_count;
+  for (uint32_t i = 0; i < old_count; ++i) {
+    pp_old[i] = &p_old_module->descriptor_bindings[i];
+  }
+  for (uint32_t i = 0; i < new_count; ++i) {
+    pp_new[i] = &p_new_module->descriptor_bindings[i];
+  }
+  qsort(pp_old, old_count, sizeof(*pp_old), SortCompareDiffDescriptorBindings);
+  qsort(pp_new, new_count, sizeof(*pp_new), SortCompareDiffDescriptorBindings);
 
   SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
-  if (IsNotNull(p_target_set) && new_set_number != (uint32_t)SPV_REFLECT_SET_NUMBER_DONT_CHANGE) {
-    for (uint32_t index = 0; index < p_target_set->binding_count; ++index) {
-      SpvReflectDescriptorBinding* p_descriptor = p_target_set->bindings[index];
-      if (p_descriptor->word_offset.set > (p_module->_internal->spirv_word_count - 1)) {
-        return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
-      }
+  uint32_t old_index = 0;
+  uint32_t new_index = 0;
+  while (((old_index < old_count) || (new_index < new_count)) && (result == SPV_REFLECT_RESULT_SUCCESS)) {
+    const SpvReflectDescriptorBinding* p_old = (old_index < old_count) ? pp_old[old_index] : NULL;
+    const SpvReflectDescriptorBinding* p_new = (new_index < new_count) ? pp_new[new_index] : NULL;
+    if (IsNotNull(p_old) && IsNotNull(p_new)) {
+      int order = (p_old->set != p_new->set)             ? ((p_old->set < p_new->set) ? -1 : 1)
+                  : (p_old->binding != p_new->binding) ? ((p_old->binding < p_new->binding) ? -1 : 1)
+                                                       : 0;
+      if (order < 0) {
+        p_new = NULL;
+      } else if (order > 0) {
+        p_old = NULL;
+      }
+    }
+    old_index += IsNotNull(p_old) ? 1 : 0;
+    new_index += IsNotNull(p_new) ? 1 : 0;
+
+    const SpvReflectDescriptorBinding* p_key = IsNotNull(p_old) ? p_old : p_new;
+    SpvReflectModuleChange change;
+    memset(&change, 0, sizeof(change));
+    change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_DESCRIPTOR_BINDING;
+    change.set = p_key->set;
+    change.binding = p_key->binding;
+    SpvReflectModuleRebuildFlags flags =
+        (IsNotNull(p_old) && IsNotNull(p_new))
+            ? DescriptorBindingChanges(p_old_module, p_old, p_new_module, p_new)
+            : (SPV_REFLECT_MODULE_REBUILD_PIPELINE_LAYOUT | SPV_REFLECT_MODULE_REBUILD_MATERIAL);
+    result = AppendModuleChangeIf(p_builder, &change, p_old, p_new, flags != SPV_REFLECT_MODULE_REBUILD_NONE, flags);
+    if (IsNotNull(p_old) && IsNotNull(p_new) && (p_old->block.member_count > 0) && (p_new->block.member_count > 0) &&
+        (result == SPV_REFLECT_RESULT_SUCCESS)) {
+      change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_BLOCK_MEMBER;
+      result = DiffBlockMembers(p_builder, &change, &p_old->block, &p_new->block);
+    }
+  }
+  SafeFree(pp_bindings);
+  return result;
+}
 
-      uint32_t* p_code = p_module->_internal->spirv_code + p_descriptor->word_offset.set;
-      *p_code = new_set_number;
-      p_descriptor->set = new_set_number;
+static SpvReflectResult DiffPushConstantBlocks(SpvReflectPrvModuleDiffBuilder* p_builder,
+                                               const SpvReflectShaderModule* p_old_module,
+                                               const SpvReflectShaderModule* p_new_module) {
+  uint32_t count = Max(p_old_module->push_constant_block_count, p_new_module->push_constant_block_count);
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  for (uint32_t i = 0; (i < count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectBlockVariable* p_old =
+        (i < p_old_module->push_constant_block_count) ? &p_old_module->push_constant_blocks[i] : NULL;
+    const SpvReflectBlockVariable* p_new =
+        (i < p_new_module->push_constant_block_count) ? &p_new_module->push_constant_blocks[i] : NULL;
+    SpvReflectModuleChange change;
+    memset(&change, 0, sizeof(change));
+    change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_PUSH_CONSTANT_BLOCK;
+    change.index = i;
+    // Only the range is part of the pipeline layout; members are listed separately.
+    bool changed = IsNotNull(p_old) && IsNotNull(p_new) && ((p_old->offset != p_new->offset) || (p_old->size != p_new->size));
+    result = AppendModuleChangeIf(p_builder, &change, p_old, p_new, changed, SPV_REFLECT_MODULE_REBUILD_PIPELINE_LAYOUT);
+    if (IsNotNull(p_old) && IsNotNull(p_new) && (result == SPV_REFLECT_RESULT_SUCCESS)) {
+      change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_PUSH_CONSTANT_MEMBER;
+      result = DiffBlockMembers(p_builder, &change, p_old, p_new);
     }
+  }
+  return result;
+}
 
-    result = SynchronizeDescriptorSets(p_module);
+static bool InterfaceVariablesEqual(const SpvReflectInterfaceVariable* p_a, const SpvReflectInterfaceVariable* p_b) {
+  return InterfaceTypesMatch(p_a, p_b) && InterfaceArraysMatch(&p_a->array, 0, &p_b->array, 0) && (p_a->format == p_b->format) &&
+         (p_a->decoration_flags == p_b->decoration_flags) && StringsEqual(p_a->semantic, p_b->semantic);
+}
+
+static const SpvReflectInterfaceVariable* FindInterfaceVariableByKey(SpvReflectInterfaceVariable* const* pp_variables,
+                                                                     uint32_t count, uint32_t key) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if (HasInterfaceLocation(pp_variables[i]) && (InterfaceLocationKey(pp_variables[i]) == key)) {
+      return pp_variables[i];
+    }
   }
+  return NULL;
+}
 
+// Lists located variables of p_old_variables that were removed or changed,
+// then those only in p_new_variables.
+static SpvReflectResult DiffInterfaceVariables(SpvReflectPrvModuleDiffBuilder* p_builder, const SpvReflectModuleChange* p_template,
+                                               SpvReflectModuleRebuildFlags rebuild_flags,
+                                               SpvReflectInterfaceVariable* const* pp_old_variables, uint32_t old_count,
+                                               SpvReflectInterfaceVariable* const* pp_new_variables, uint32_t new_count) {
+  SpvReflectModuleChange change = *p_template;
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  for (uint32_t i = 0; (i < old_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectInterfaceVariable* p_old = pp_old_variables[i];
+    if (!HasInterfaceLocation(p_old)) {
+      continue;
+    }
+    const SpvReflectInterfaceVariable* p_new =
+        FindInterfaceVariableByKey(pp_new_variables, new_count, InterfaceLocationKey(p_old));
+    change.index = p_old->location;
+    bool changed = IsNotNull(p_new) && !InterfaceVariablesEqual(p_old, p_new);
+    result = AppendModuleChangeIf(p_builder, &change, p_old, p_new, changed, rebuild_flags);
+  }
+  for (uint32_t i = 0; (i < new_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectInterfaceVariable* p_new = pp_new_variables[i];
+    if (HasInterfaceLocation(p_new) &&
+        IsNull(FindInterfaceVariableByKey(pp_old_variables, old_count, InterfaceLocationKey(p_new)))) {
+      change.index = p_new->location;
+      result = AppendModuleChangeIf(p_builder, &change, NULL, p_new, true, rebuild_flags);
+    }
+  }
   return result;
 }
 
-static SpvReflectResult ChangeVariableLocation(SpvReflectShaderModule* p_module, SpvReflectInterfaceVariable* p_variable,
-                                               uint32_t new_location) {
-  if (p_variable->word_offset.location > (p_module->_internal->spirv_word_count - 1)) {
-    return SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED;
+static SpvReflectResult DiffEntryPointInterfaces(SpvReflectPrvModuleDiffBuilder* p_builder,
+                                                 const SpvReflectShaderModule* p_old_module,
+                                                 const SpvReflectShaderModule* p_new_module) {
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  for (uint32_t i = 0; (i < p_old_module->entry_point_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectEntryPoint* p_old = &p_old_module->entry_points[i];
+    const SpvReflectEntryPoint* p_new = FindEntryPointByName(p_new_module, p_old->name);
+    if (IsNull(p_new)) {
+      continue;
+    }
+    SpvReflectModuleChange change;
+    memset(&change, 0, sizeof(change));
+    change.entry_point = p_old->name;
+    // Vertex inputs feed the vertex input state and fragment outputs the
+    // color attachments; other stages' interfaces live in the SPIR-V only.
+    change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_INPUT_VARIABLE;
+    SpvReflectModuleRebuildFlags flags = (p_new->shader_stage == SPV_REFLECT_SHADER_STAGE_VERTEX_BIT)
+                                             ? SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE
+                                             : SPV_REFLECT_MODULE_REBUILD_NONE;
+    result = DiffInterfaceVariables(p_builder, &change, flags, p_old->input_variables, p_old->input_variable_count,
+                                    p_new->input_variables, p_new->input_variable_count);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      break;
+    }
+    change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_OUTPUT_VARIABLE;
+    flags = (p_new->shader_stage == SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT) ? SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE
+                                                                           : SPV_REFLECT_MODULE_REBUILD_NONE;
+    result = DiffInterfaceVariables(p_builder, &change, flags, p_old->output_variables, p_old->output_variable_count,
+                                    p_new->output_variables, p_new->output_variable_count);
   }
-  uint32_t* p_code = p_module->_internal->spirv_code + p_variable->word_offset.location;
-  *p_code = new_location;
-  p_variable->location = new_location;
-  return SPV_REFLECT_RESULT_SUCCESS;
+  return result;
 }
 
-SpvReflectResult spvReflectChangeInputVariableLocation(SpvReflectShaderModule* p_module,
-                                                       const SpvReflectInterfaceVariable* p_input_variable, uint32_t new_location) {
-  if (IsNull(p_module)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+static const SpvReflectSpecializationConstant* FindSpecializationConstant(const SpvReflectShaderModule* p_module,
+                                                                          uint32_t constant_id) {
+  for (uint32_t i = 0; i < p_module->spec_constant_count; ++i) {
+    if (p_module->spec_constants[i].constant_id == constant_id) {
+      return &p_module->spec_constants[i];
+    }
   }
-  if (IsNull(p_input_variable)) {
-    return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+  return NULL;
+}
+
+static bool SpecializationConstantsEqual(const SpvReflectSpecializationConstant* p_a, const SpvReflectSpecializationConstant* p_b) {
+  SpvOp a_op = IsNotNull(p_a->type_description) ? p_a->type_description->op : SpvOpNop;
+  SpvOp b_op = IsNotNull(p_b->type_description) ? p_b->type_description->op : SpvOpNop;
+  if ((a_op != b_op) || (p_a->default_value_size != p_b->default_value_size)) {
+    return false;
   }
-  for (uint32_t index = 0; index < p_module->input_variable_count; ++index) {
-    if (p_module->input_variables[index] == p_input_variable) {
-      return ChangeVariableLocation(p_module, p_module->input_variables[index], new_location);
+  return (p_a->default_value_size == 0) || (memcmp(p_a->default_value, p_b->default_value, p_a->default_value_size) == 0);
+}
+
+static SpvReflectResult DiffSpecializationConstants(SpvReflectPrvModuleDiffBuilder* p_builder,
+                                                    const SpvReflectShaderModule* p_old_module,
+                                                    const SpvReflectShaderModule* p_new_module) {
+  SpvReflectModuleChange change;
+  memset(&change, 0, sizeof(change));
+  change.object = SPV_REFLECT_MODULE_CHANGE_OBJECT_SPECIALIZATION_CONSTANT;
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  for (uint32_t i = 0; (i < p_old_module->spec_constant_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectSpecializationConstant* p_old = &p_old_module->spec_constants[i];
+    const SpvReflectSpecializationConstant* p_new = FindSpecializationConstant(p_new_module, p_old->constant_id);
+    change.index = p_old->constant_id;
+    bool changed = IsNotNull(p_new) && !SpecializationConstantsEqual(p_old, p_new);
+    result = AppendModuleChangeIf(p_builder, &change, p_old, p_new, changed, SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE);
+  }
+  for (uint32_t i = 0; (i < p_new_module->spec_constant_count) && (result == SPV_REFLECT_RESULT_SUCCESS); ++i) {
+    const SpvReflectSpecializationConstant* p_new = &p_new_module->spec_constants[i];
+    if (IsNull(FindSpecializationConstant(p_old_module, p_new->constant_id))) {
+      change.index = p_new->constant_id;
+      result = AppendModuleChangeIf(p_builder, &change, NULL, p_new, true, SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE);
     }
   }
-  return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
+  return result;
 }
 
-SpvReflectResult spvReflectChangeOutputVariableLocation(SpvReflectShaderModule* p_module,
-                                                        const SpvReflectInterfaceVariable* p_output_variable,
-                                                        uint32_t new_location) {
-  if (IsNull(p_module)) {
+// Detached modules only keep the hashes of their code's sections.
+static bool ModuleCodeEqual(const SpvReflectShaderModule* p_a, const SpvReflectShaderModule* p_b) {
+  if (IsNull(p_a->_internal->spirv_code) || IsNull(p_b->_internal->spirv_code)) {
+    return ModuleSectionsEqual(p_a, p_b, SPV_REFLECT_PRV_SECTION_PREAMBLE, SPV_REFLECT_PRV_SECTION_FUNCTIONS);
+  }
+  return (p_a->_internal->spirv_size == p_b->_internal->spirv_size) &&
+         (memcmp(p_a->_internal->spirv_code, p_b->_internal->spirv_code, p_a->_internal->spirv_size) == 0);
+}
+
+SpvReflectResult spvReflectDiffShaderModules(const SpvReflectShaderModule* p_old_module,
+                                             const SpvReflectShaderModule* p_new_module, SpvReflectModuleDiff* p_diff) {
+  if (IsNull(p_old_module) || IsNull(p_new_module) || IsNull(p_diff)) {
     return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
   }
-  if (IsNull(p_output_variable)) {
+  memset(p_diff, 0, sizeof(*p_diff));
+  if (IsNull(p_old_module->_internal) || IsNull(p_new_module->_internal)) {
     return SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
   }
-  for (uint32_t index = 0; index < p_module->output_variable_count; ++index) {
-    if (p_module->output_variables[index] == p_output_variable) {
-      return ChangeVariableLocation(p_module, p_module->output_variables[index], new_location);
+
+  SpvReflectPrvModuleDiffBuilder builder;
+  memset(&builder, 0, sizeof(builder));
+  SpvReflectResult result = DiffEntryPoints(&builder, p_old_module, p_new_module);
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = DiffDescriptorBindings(&builder, p_old_module, p_new_module);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = DiffPushConstantBlocks(&builder, p_old_module, p_new_module);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = DiffEntryPointInterfaces(&builder, p_old_module, p_new_module);
+  }
+  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+    result = DiffSpecializationConstants(&builder, p_old_module, p_new_module);
+  }
+
+#ifdef __cplusplus
+  p_diff->_internal = (SpvReflectModuleDiff::ModuleDiffInternal*)calloc(1, sizeof(*(p_diff->_internal)));
+#else
+  p_diff->_internal = calloc(1, sizeof(*(p_diff->_internal)));
+#endif
+  if (IsNull(p_diff->_internal) && (result == SPV_REFLECT_RESULT_SUCCESS)) {
+    result = SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+  }
+  // Hand everything to p_diff, so destroying it also cleans up after a failure.
+  p_diff->change_count = builder.change_count;
+  p_diff->changes = builder.p_changes;
+  if (IsNotNull(p_diff->_internal)) {
+    p_diff->_internal->flat_block_count = builder.flat_block_count;
+    p_diff->_internal->flat_blocks = builder.p_flat_blocks;
+  } else {
+    for (uint32_t i = 0; i < builder.flat_block_count; ++i) {
+      spvReflectDestroyFlatBlock(&builder.p_flat_blocks[i]);
     }
+    SafeFree(builder.p_flat_blocks);
+  }
+  if (result != SPV_REFLECT_RESULT_SUCCESS) {
+    spvReflectDestroyModuleDiff(p_diff);
+    return result;
   }
-  return SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND;
-}
 
-const char* spvReflectSourceLanguage(SpvSourceLanguage source_lang) {
-  switch (source_lang) {
-    case SpvSourceLanguageESSL:
-      return "ESSL";
-    case SpvSourceLanguageGLSL:
-      return "GLSL";
-    case SpvSourceLanguageOpenCL_C:
-      return "OpenCL_C";
-    case SpvSourceLanguageOpenCL_CPP:
-      return "OpenCL_CPP";
-    case SpvSourceLanguageHLSL:
-      return "HLSL";
-    case SpvSourceLanguageCPP_for_OpenCL:
-      return "CPP_for_OpenCL";
-    case SpvSourceLanguageSYCL:
-      return "SYCL";
-    case SpvSourceLanguageHERO_C:
-      return "Hero C";
-    case SpvSourceLanguageNZSL:
-      return "NZSL";
-    case SpvSourceLanguageWGSL:
-      return "WGSL";
-    case SpvSourceLanguageSlang:
-      return "Slang";
-    case SpvSourceLanguageZig:
-      return "Zig";
-    case SpvSourceLanguageRust:
-      return "Rust";
-    default:
-      break;
+  for (uint32_t i = 0; i < p_diff->change_count; ++i) {
+    p_diff->rebuild_flags |= p_diff->changes[i].rebuild_flags;
   }
-  // The source language is SpvSourceLanguageUnknown, SpvSourceLanguageMax, or
-  // some other value that does not correspond to a knonwn language.
-  return "Unknown";
+  if (!ModuleCodeEqual(p_old_module, p_new_module)) {
+    p_diff->rebuild_flags |= SPV_REFLECT_MODULE_REBUILD_SHADER_MODULE;
+  }
+  return SPV_REFLECT_RESULT_SUCCESS;
 }
 
-const char* spvReflectBlockVariableTypeName(const SpvReflectBlockVariable* p_var) {
-  if (p_var == NULL) {
-    return NULL;
+void spvReflectDestroyModuleDiff(SpvReflectModuleDiff* p_diff) {
+  if (IsNull(p_diff)) {
+    return;
   }
-  return p_var->type_description->type_name;
+  if (IsNotNull(p_diff->_internal)) {
+    for (uint32_t i = 0; i < p_diff->_internal->flat_block_count; ++i) {
+      spvReflectDestroyFlatBlock(&p_diff->_internal->flat_blocks[i]);
+    }
+    SafeFree(p_diff->_internal->flat_blocks);
+  }
+  SafeFree(p_diff->_internal);
+  SafeFree(p_diff->changes);
+  memset(p_diff, 0, sizeof(*p_diff));
 }
@@ -81,6 +81,7 @@ typedef enum SpvReflectResult {
   SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_ENTRY_POINT,
   SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_EXECUTION_MODE,
   SPV_REFLECT_RESULT_ERROR_SPIRV_MAX_RECURSIVE_EXCEEDED,
+  SPV_REFLECT_RESULT_ERROR_CODE_UNAVAILABLE,
 } SpvReflectResult;
 
 /*! @enum SpvReflectModuleFlagBits
@@ -94,10 +95,25 @@ SPV_REFLECT_MODULE_FLAG_NO_COPY - Disables copying of SPIR-V code
   This is flag is intended for cases where the memory overhead of
   storing the copied SPIR-V is undesirable.
 
+SPV_REFLECT_MODULE_FLAG_IGNORE_EMBEDDED_REFLECTION - Parses the
+  SPIR-V even if it carries reflection data embedded by
+  spvReflectEmbedReflection.
+
+SPV_REFLECT_MODULE_FLAG_DETACH_CODE - Copies the names and default
+  values the module points at into a string pool, in which equal
+  strings are stored once, and releases the SPIR-V once the module is
+  created: a copy is freed, and with SPV_REFLECT_MODULE_FLAG_NO_COPY the
+  caller may free the code. This is intended for modules that are kept
+  long after their VkShaderModule is created. spvReflectGetCode then
+  returns NULL, and the spvReflectChange functions, which modify the
+  code, return SPV_REFLECT_RESULT_ERROR_CODE_UNAVAILABLE.
+
 */
 typedef enum SpvReflectModuleFlagBits {
-  SPV_REFLECT_MODULE_FLAG_NONE    = 0x00000000,
-  SPV_REFLECT_MODULE_FLAG_NO_COPY = 0x00000001,
+  SPV_REFLECT_MODULE_FLAG_NONE                       = 0x00000000,
+  SPV_REFLECT_MODULE_FLAG_NO_COPY                    = 0x00000001,
+  SPV_REFLECT_MODULE_FLAG_IGNORE_EMBEDDED_REFLECTION = 0x00000002,
+  SPV_REFLECT_MODULE_FLAG_DETACH_CODE                = 0x00000004,
 } SpvReflectModuleFlagBits;
 
 typedef uint32_t SpvReflectModuleFlags;
@@ -331,6 +347,8 @@ typedef enum SpvReflectGenerator {
 enum {
   SPV_REFLECT_MAX_ARRAY_DIMS                    = 32,
   SPV_REFLECT_MAX_DESCRIPTOR_SETS               = 64,
+  SPV_REFLECT_MAX_DESCRIPTOR_TYPES              = 12,
+  SPV_REFLECT_MAX_VERTEX_INPUT_ATTRIBUTES       = 32,
 };
 
 enum {
@@ -628,6 +646,23 @@ typedef struct SpvReflectSpecializationConstant {
   void* default_value;  
 } SpvReflectSpecializationConstant;
 
+/*! @struct SpvReflectTaskScheduler
+ @brief  Optional scheduler used by spvReflectCreateShaderModule3 to analyze
+         entry points concurrently (call graph traversal, statically used
+         resources and interface variables).
+
+         parallel_for must call p_task(p_task_data, i) exactly once for every
+         i in [0, task_count) and must not return before all of those calls
+         have completed. The calls may run in any order and on any thread;
+         they never write to state shared with one another.
+*/
+typedef void (*SpvReflectTaskFunction)(void* p_task_data, uint32_t task_index);
+
+typedef struct SpvReflectTaskScheduler {
+  void*                             p_user_data;
+  void                              (*parallel_for)(void* p_user_data, uint32_t task_count, SpvReflectTaskFunction p_task, void* p_task_data);
+} SpvReflectTaskScheduler;
+
 /*! @struct SpvReflectShaderModule
 
 */
@@ -666,12 +701,430 @@ typedef struct SpvReflectShaderModule {
     uint32_t*                       spirv_code;
     uint32_t                        spirv_word_count;
 
+    // Names and default values of a module created with
+    // SPV_REFLECT_MODULE_FLAG_DETACH_CODE, whose spirv_code is NULL.
+    char*                           string_pool;
+    size_t                          string_pool_size;
+
     size_t                          type_description_count;
     SpvReflectTypeDescription*      type_descriptions;
+
+    // Hash indices into descriptor_bindings keyed by (set, binding), SPIR-V
+    // result id and name. Each table has descriptor_binding_index_capacity
+    // slots holding (binding index + 1), with 0 marking an empty slot.
+    uint32_t                        descriptor_binding_index_capacity;
+    uint32_t*                       descriptor_binding_index_by_number;
+    uint32_t*                       descriptor_binding_index_by_id;
+    uint32_t*                       descriptor_binding_index_by_name;
+
+    // Index of the descriptor binding whose block owns the members of the
+    // block of each binding. Bindings whose blocks are the same share one
+    // members array, owned by the first of them.
+    uint32_t*                       descriptor_binding_block_owners;
+
+    // Hash index into entry_points keyed by name, laid out like the
+    // descriptor binding tables above.
+    uint32_t                        entry_point_index_capacity;
+    uint32_t*                       entry_point_index_by_name;
+
+    // Descriptor bindings and push constant blocks statically used by each
+    // entry point, in module order. The pointers for entry_points[i] are
+    // [offsets[i], offsets[i + 1]) of the matching array.
+    uint32_t*                       entry_point_descriptor_binding_offsets;
+    SpvReflectDescriptorBinding**   entry_point_descriptor_bindings;
+    uint32_t*                       entry_point_push_constant_block_offsets;
+    SpvReflectBlockVariable**       entry_point_push_constant_blocks;
+
+    // Hash indices into each entry point's input_variables and
+    // output_variables keyed by location and by semantic. The tables for
+    // entry_points[i] start at entry_point_variable_index_offsets[i].
+    uint32_t*                       entry_point_variable_index_offsets;
+    uint32_t*                       entry_point_variable_index;
+
+    // Indices into each entry point's input_variables and output_variables
+    // that have a location, sorted by location and component. The inputs of
+    // entry_points[i] are [offsets[2 * i], offsets[2 * i + 1]) and its
+    // outputs [offsets[2 * i + 1], offsets[2 * i + 2]).
+    uint32_t*                       entry_point_location_table_offsets;
+    uint32_t*                       entry_point_location_table;
+
+    // First word and hash of each logical section of the SPIR-V: header and
+    // preamble, entry points, debug, annotations, types and globals, and
+    // functions. section_offsets[6] is the word count. Compared by
+    // spvReflectUpdateShaderModule; section_hashes_valid is 0 if the
+    // instruction stream could not be split.
+    uint32_t                        section_offsets[7];
+    uint64_t                        section_hashes[6];
+    uint32_t                        section_hashes_valid;
+
+    // Non-zero if the reflection data was loaded from a payload written by
+    // spvReflectEmbedReflection instead of parsed from the SPIR-V.
+    uint32_t                        embedded_reflection_loaded;
+    // Non-zero if the reflection data was loaded from the cache directory
+    // of spvReflectCreateShaderModuleCached.
+    uint32_t                        cached_reflection_loaded;
+    // Non-zero if result ids were looked up in a hash table while parsing,
+    // because the id bound was far larger than the instruction count,
+    // instead of a table indexed by id.
+    uint32_t                        hashed_id_map;
   } * _internal;
 
 } SpvReflectShaderModule;
 
+/*! @struct SpvReflectProgramBinding
+ @brief  A descriptor binding merged across every entry point added to a
+         SpvReflectProgram.
+*/
+typedef struct SpvReflectProgramBinding {
+  uint32_t                          binding;
+  SpvReflectDescriptorType          descriptor_type;  // From the first entry point that uses the binding
+  uint32_t                          count;            // Largest count, or 0 if any entry point uses a runtime array
+  uint32_t                          stage_flags;      // Union of SpvReflectShaderStageFlagBits
+} SpvReflectProgramBinding;
+
+/*! @struct SpvReflectProgramDescriptorSet
+
+*/
+typedef struct SpvReflectProgramDescriptorSet {
+  uint32_t                          set;
+  uint32_t                          binding_count;
+  SpvReflectProgramBinding*         bindings;         // Sorted by binding number
+} SpvReflectProgramDescriptorSet;
+
+/*! @struct SpvReflectProgramPushConstantRange
+ @brief  Byte range of push constants used by the stages in stage_flags.
+         Ranges never share a stage, so they map directly onto
+         VkPushConstantRange.
+*/
+typedef struct SpvReflectProgramPushConstantRange {
+  uint32_t                          stage_flags;
+  uint32_t                          offset;           // Measured in bytes
+  uint32_t                          size;             // Measured in bytes
+} SpvReflectProgramPushConstantRange;
+
+/*! @struct SpvReflectProgramConflict
+ @brief  Records an entry point that uses a (set, binding) already present
+         in the program or the descriptor set layout with a different
+         descriptor type.
+*/
+typedef struct SpvReflectProgramConflict {
+  uint32_t                          set;
+  uint32_t                          binding;
+  SpvReflectDescriptorType          descriptor_type;              // Type already in the program
+  SpvReflectDescriptorType          conflicting_descriptor_type;  // Type used by the added entry point
+  SpvReflectShaderStageFlagBits     conflicting_stage;
+} SpvReflectProgramConflict;
+
+/*! @struct SpvReflectProgram
+ @brief  Descriptor set layouts and push constant ranges merged across
+         several shader modules or entry points, e.g. all stages of one
+         pipeline. Each entry point is merged into the existing result when it
+         is added; the arrays may move on every add.
+*/
+typedef struct SpvReflectProgram {
+  uint32_t                            stage_flags;
+  uint32_t                            descriptor_set_count;
+  SpvReflectProgramDescriptorSet*     descriptor_sets;   // Sorted by set number
+  uint32_t                            push_constant_range_count;
+  SpvReflectProgramPushConstantRange* push_constant_ranges;
+  uint32_t                            conflict_count;
+  SpvReflectProgramConflict*          conflicts;
+
+  struct ProgramInternal {
+    uint32_t                          descriptor_set_capacity;
+    uint32_t*                         binding_capacities;  // Parallel to descriptor_sets
+    uint32_t                          conflict_capacity;
+
+    // Push constant byte range [begin, end) used by each stage, indexed by
+    // stage bit. A stage without push constants has end == 0.
+    uint32_t                          push_constant_begin[32];
+    uint32_t                          push_constant_end[32];
+    SpvReflectProgramPushConstantRange push_constant_ranges[32];
+  } * _internal;
+} SpvReflectProgram;
+
+/*! @struct SpvReflectDescriptorSetLayout
+ @brief  Canonical form of a descriptor set: its bindings sorted by binding
+         number and descriptor type. Aliased bindings merge into one only if
+         their descriptor types are equal. Sets with equal binding numbers,
+         descriptor types and counts share a layout, and each binding's
+         stage_flags holds the stages of every entry point using it.
+*/
+typedef struct SpvReflectDescriptorSetLayout {
+  uint32_t                          signature;        // Hash of the bindings, without stage flags
+  uint32_t                          binding_count;
+  SpvReflectProgramBinding*         bindings;
+} SpvReflectDescriptorSetLayout;
+
+/*! @struct SpvReflectDescriptorSetLayoutUse
+
+*/
+typedef struct SpvReflectDescriptorSetLayoutUse {
+  uint32_t                          module_index;     // Index into the modules passed at creation
+  uint32_t                          entry_point_index;
+  uint32_t                          set;
+  uint32_t                          layout_index;     // Index into SpvReflectDescriptorSetLayouts::layouts
+} SpvReflectDescriptorSetLayoutUse;
+
+/*! @struct SpvReflectDescriptorSetLayouts
+ @brief  The distinct descriptor set layouts used across a collection of
+         shader modules, and which layout every (module, entry point, set)
+         uses.
+*/
+typedef struct SpvReflectDescriptorSetLayouts {
+  uint32_t                          layout_count;
+  SpvReflectDescriptorSetLayout*    layouts;
+  uint32_t                          use_count;
+  SpvReflectDescriptorSetLayoutUse* uses;             // Sorted by module, entry point and set
+  uint32_t                          conflict_count;
+  SpvReflectProgramConflict*        conflicts;        // Aliased bindings with different descriptor types
+
+  struct DescriptorSetLayoutsInternal {
+    SpvReflectProgramBinding*       bindings;         // Storage for every layout's bindings
+    uint32_t                        conflict_capacity;
+  } * _internal;
+} SpvReflectDescriptorSetLayouts;
+
+/*! @struct SpvReflectDescriptorPoolSize
+ @brief  Same layout as VkDescriptorPoolSize.
+*/
+typedef struct SpvReflectDescriptorPoolSize {
+  SpvReflectDescriptorType          type;
+  uint32_t                          descriptor_count;
+} SpvReflectDescriptorPoolSize;
+
+/*! @struct SpvReflectDescriptorPoolSizes
+ @brief  Accumulated descriptor counts per type and the number of descriptor
+         sets needed to allocate every set of the shaders added to it. Maps
+         directly onto VkDescriptorPoolCreateInfo::maxSets, poolSizeCount and
+         pPoolSizes. Zero-initialize before the first use.
+*/
+typedef struct SpvReflectDescriptorPoolSizes {
+  uint32_t                          max_sets;
+  uint32_t                          pool_size_count;
+  SpvReflectDescriptorPoolSize      pool_sizes[SPV_REFLECT_MAX_DESCRIPTOR_TYPES]; // In order of first use
+} SpvReflectDescriptorPoolSizes;
+
+/*! @struct SpvReflectDescriptorInfoSizes
+ @brief  Sizes, in bytes, of the structs a descriptor update template reads
+         for each kind of descriptor.
+*/
+typedef struct SpvReflectDescriptorInfoSizes {
+  uint32_t                          image_info;             // sizeof(VkDescriptorImageInfo)
+  uint32_t                          buffer_info;            // sizeof(VkDescriptorBufferInfo)
+  uint32_t                          texel_buffer_view;      // sizeof(VkBufferView)
+  uint32_t                          acceleration_structure; // sizeof(VkAccelerationStructureKHR)
+} SpvReflectDescriptorInfoSizes;
+
+/*! @struct SpvReflectDescriptorUpdateTemplateEntry
+ @brief  Same fields as VkDescriptorUpdateTemplateEntry. offset and stride
+         locate the binding's descriptor infos in the caller's struct.
+*/
+typedef struct SpvReflectDescriptorUpdateTemplateEntry {
+  uint32_t                          binding;
+  uint32_t                          array_element;
+  uint32_t                          descriptor_count;
+  SpvReflectDescriptorType          descriptor_type;
+  uint32_t                          offset;
+  uint32_t                          stride;
+} SpvReflectDescriptorUpdateTemplateEntry;
+
+/*! @enum SpvReflectVertexInputLayoutMode
+
+*/
+typedef enum SpvReflectVertexInputLayoutMode {
+  // Attributes share vertex buffer bindings, binding 0 unless assigned
+  // per location, and are interleaved within each binding.
+  SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED   = 0,
+  // Every attribute gets its own binding, numbered in location order.
+  SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_DEINTERLEAVED = 1,
+} SpvReflectVertexInputLayoutMode;
+
+/*! @struct SpvReflectVertexInputAttribute
+ @brief  Same layout as VkVertexInputAttributeDescription.
+*/
+typedef struct SpvReflectVertexInputAttribute {
+  uint32_t                          location;
+  uint32_t                          binding;
+  SpvReflectFormat                  format;
+  uint32_t                          offset;
+} SpvReflectVertexInputAttribute;
+
+/*! @struct SpvReflectVertexInputBinding
+ @brief  Same layout as VkVertexInputBindingDescription.
+*/
+typedef struct SpvReflectVertexInputBinding {
+  uint32_t                          binding;
+  uint32_t                          stride;
+  uint32_t                          input_rate;       // Always VK_VERTEX_INPUT_RATE_VERTEX (0)
+} SpvReflectVertexInputBinding;
+
+/*! @struct SpvReflectVertexInputLayout
+ @brief  Vertex buffer layout matching a vertex shader's inputs, ready to
+         fill VkPipelineVertexInputStateCreateInfo.
+*/
+typedef struct SpvReflectVertexInputLayout {
+  uint32_t                          binding_count;
+  SpvReflectVertexInputBinding      bindings[SPV_REFLECT_MAX_VERTEX_INPUT_ATTRIBUTES];     // Sorted by binding
+  uint32_t                          attribute_count;
+  SpvReflectVertexInputAttribute    attributes[SPV_REFLECT_MAX_VERTEX_INPUT_ATTRIBUTES];   // Sorted by location
+} SpvReflectVertexInputLayout;
+
+/*! @enum SpvReflectInterfaceMismatchType
+
+*/
+typedef enum SpvReflectInterfaceMismatchType {
+  SPV_REFLECT_INTERFACE_MISMATCH_MISSING_OUTPUT   = 0, // No output at the input's location and component
+  SPV_REFLECT_INTERFACE_MISMATCH_TYPE             = 1, // Numeric traits or struct members differ
+  SPV_REFLECT_INTERFACE_MISMATCH_ARRAY            = 2, // Array dimensions differ, ignoring per-vertex arrays
+  SPV_REFLECT_INTERFACE_MISMATCH_MISSING_BUILT_IN = 3, // Built-in input not written by the previous stage
+  SPV_REFLECT_INTERFACE_MISMATCH_UNUSED_OUTPUT    = 4, // Not an error: output not read by the next stage
+} SpvReflectInterfaceMismatchType;
+
+/*! @struct SpvReflectInterfaceMismatch
+
+*/
+typedef struct SpvReflectInterfaceMismatch {
+  SpvReflectInterfaceMismatchType    type;
+  uint32_t                           location;        // UINT32_MAX for built-ins
+  uint32_t                           component;
+  int                                built_in;        // SpvBuiltIn for MISSING_BUILT_IN, -1 otherwise
+  const SpvReflectInterfaceVariable* output_variable; // NULL for MISSING_OUTPUT and MISSING_BUILT_IN
+  const SpvReflectInterfaceVariable* input_variable;  // NULL for UNUSED_OUTPUT
+} SpvReflectInterfaceMismatch;
+
+/*! @struct SpvReflectFlatBlockMember
+ @brief  One leaf member of a block: a scalar, vector, matrix or physical
+         pointer, or an array of them. Arrays of structs are expanded into
+         one set of leaves per element; runtime-sized arrays of structs into
+         element 0 only.
+*/
+typedef struct SpvReflectFlatBlockMember {
+  const char*                       path;             // Full path, e.g. "lights[3].color"
+  uint32_t                          path_hash;
+  uint32_t                          absolute_offset;  // Measured in bytes from the start of the block
+  uint32_t                          size;             // Measured in bytes
+  SpvReflectTypeFlags               type_flags;       // Only the scalar, vector, matrix and reference flags
+  SpvReflectNumericTraits           numeric;          // Includes the matrix stride
+  uint32_t                          array_count;      // 1 if not an array, 0 if runtime-sized
+  uint32_t                          array_stride;     // Measured in bytes, 0 if not an array
+  SpvReflectDecorationFlags         decoration_flags; // Includes row and column major
+  const SpvReflectBlockVariable*    member;
+} SpvReflectFlatBlockMember;
+
+/*! @struct SpvReflectFlatBlock
+ @brief  The leaf members of a block variable in declaration order, so
+         writing a uniform or push constant block needs no tree walk.
+*/
+typedef struct SpvReflectFlatBlock {
+  uint32_t                          member_count;
+  SpvReflectFlatBlockMember*        members;
+
+  struct FlatBlockInternal {
+    char*                           paths;            // Storage for every member's path
+    uint32_t                        member_index_capacity;
+    uint32_t*                       member_index_by_path;  // Built on first lookup
+  } * _internal;
+} SpvReflectFlatBlock;
+
+/*! @struct SpvReflectPackOp
+ @brief  Copies count runs of size bytes; run i is read from
+         src_offset + i * src_stride and written to
+         dst_offset + i * dst_stride.
+*/
+typedef struct SpvReflectPackOp {
+  uint32_t                          src_offset;
+  uint32_t                          dst_offset;
+  uint32_t                          size;
+  uint32_t                          count;
+  uint32_t                          src_stride;
+  uint32_t                          dst_stride;
+} SpvReflectPackOp;
+
+/*! @struct SpvReflectPackPlan
+ @brief  Copies a tightly packed host struct into a block's std140 or std430
+         layout. The host struct holds every leaf member in declaration
+         order with no padding: vectors are tightly packed, matrices are
+         column-major, bools are 32-bit, and arrays of structs are expanded
+         element by element. Runtime-sized arrays are not included.
+*/
+typedef struct SpvReflectPackPlan {
+  uint32_t                          host_size;   // Size of the packed host struct, in bytes
+  uint32_t                          device_size; // Size of the block, in bytes
+  uint32_t                          op_count;
+  SpvReflectPackOp*                 ops;         // Sorted by src_offset
+} SpvReflectPackPlan;
+
+/*! @enum SpvReflectModuleChangeType
+
+*/
+typedef enum SpvReflectModuleChangeType {
+  SPV_REFLECT_MODULE_CHANGE_TYPE_ADDED    = 0, // Only in the new module
+  SPV_REFLECT_MODULE_CHANGE_TYPE_REMOVED  = 1, // Only in the old module
+  SPV_REFLECT_MODULE_CHANGE_TYPE_MODIFIED = 2, // In both modules, with different properties
+} SpvReflectModuleChangeType;
+
+/*! @enum SpvReflectModuleChangeObject
+ @brief  What a change refers to, how it is matched between the modules, and
+         what SpvReflectModuleChange::p_old and p_new point to.
+*/
+typedef enum SpvReflectModuleChangeObject {
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_ENTRY_POINT             = 0, // SpvReflectEntryPoint, by name
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_EXECUTION_MODES         = 1, // SpvReflectEntryPoint, by name
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_DESCRIPTOR_BINDING      = 2, // SpvReflectDescriptorBinding, by set and binding
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_BLOCK_MEMBER            = 3, // SpvReflectFlatBlockMember, by binding and path
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_PUSH_CONSTANT_BLOCK     = 4, // SpvReflectBlockVariable, by index
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_PUSH_CONSTANT_MEMBER    = 5, // SpvReflectFlatBlockMember, by block index and path
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_INPUT_VARIABLE          = 6, // SpvReflectInterfaceVariable, by location and component
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_OUTPUT_VARIABLE         = 7, // SpvReflectInterfaceVariable, by location and component
+  SPV_REFLECT_MODULE_CHANGE_OBJECT_SPECIALIZATION_CONSTANT = 8, // SpvReflectSpecializationConstant, by constant_id
+} SpvReflectModuleChangeObject;
+
+/*! @enum SpvReflectModuleRebuildFlagBits
+ @brief  What an application has to recreate after a shader changed. A new
+         VkShaderModule also means new pipelines; the other bits say what
+         else has to change with them.
+*/
+typedef enum SpvReflectModuleRebuildFlagBits {
+  SPV_REFLECT_MODULE_REBUILD_NONE            = 0x00000000,
+  SPV_REFLECT_MODULE_REBUILD_SHADER_MODULE   = 0x00000001, // The SPIR-V differs
+  SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE  = 0x00000002, // Shader stages, vertex input, color outputs or specialization
+  SPV_REFLECT_MODULE_REBUILD_PIPELINE_LAYOUT = 0x00000004, // Descriptor set layouts or push constant ranges
+  SPV_REFLECT_MODULE_REBUILD_MATERIAL        = 0x00000008, // Resources bound by name, or block layouts data is packed by
+} SpvReflectModuleRebuildFlagBits;
+
+typedef uint32_t SpvReflectModuleRebuildFlags;
+
+/*! @struct SpvReflectModuleChange
+
+*/
+typedef struct SpvReflectModuleChange {
+  SpvReflectModuleChangeObject      object;
+  SpvReflectModuleChangeType        type;
+  SpvReflectModuleRebuildFlags      rebuild_flags;
+  const char*                       entry_point;  // Entry points, execution modes and interface variables, else NULL
+  uint32_t                          set;          // Descriptor bindings and their block members
+  uint32_t                          binding;      // Descriptor bindings and their block members
+  uint32_t                          index;        // Push constant block index, location or constant_id
+  const char*                       path;         // Block and push constant members, else NULL
+  const void*                       p_old;        // Object in the old module, NULL if added
+  const void*                       p_new;        // Object in the new module, NULL if removed
+} SpvReflectModuleChange;
+
+/*! @struct SpvReflectModuleDiff
+ @brief  Changes between two versions of a shader module.
+*/
+typedef struct SpvReflectModuleDiff {
+  SpvReflectModuleRebuildFlags      rebuild_flags; // Union of all changes, plus SHADER_MODULE if the SPIR-V differs
+  uint32_t                          change_count;
+  SpvReflectModuleChange*           changes;
+
+  struct ModuleDiffInternal {
+    uint32_t                        flat_block_count;
+    SpvReflectFlatBlock*            flat_blocks;  // Storage for the members and paths of changed blocks
+  } * _internal;
+} SpvReflectModuleDiff;
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -706,6 +1159,126 @@ SpvReflectResult spvReflectCreateShaderModule2(
   SpvReflectShaderModule*  p_module
 );
 
+/*! @fn spvReflectCreateShaderModule3
+ @brief  Same as spvReflectCreateShaderModule2, but lets the caller provide a
+         scheduler so that per-entry-point analysis of modules with many
+         entry points (e.g. ray tracing libraries) runs in parallel. The
+         resulting module is identical to the one created without a
+         scheduler.
+ @param  flags        Flags for module creations.
+ @param  size         Size in bytes of SPIR-V code.
+ @param  p_code       Pointer to SPIR-V code.
+ @param  p_scheduler  Pointer to a task scheduler, or NULL to analyze the
+                      entry points serially.
+ @param  p_module     Pointer to an instance of SpvReflectShaderModule.
+ @return              SPV_REFLECT_RESULT_SUCCESS on success.
+
+*/
+SpvReflectResult spvReflectCreateShaderModule3(
+  SpvReflectModuleFlags          flags,
+  size_t                         size,
+  const void*                    p_code,
+  const SpvReflectTaskScheduler* p_scheduler,
+  SpvReflectShaderModule*        p_module
+);
+
+/*! @fn spvReflectCreateShaderModuleCached
+ @brief  Same as spvReflectCreateShaderModule2, but keeps the reflection
+         data of parsed modules in a cache directory, and loads it from
+         there instead of parsing when the same SPIR-V is reflected again
+         with the same flags, e.g. by a later build step. Entries are named
+         after a 64-bit hash of the SPIR-V, the library version and the
+         flags, and carry a SHA-256 digest of the same data and of the
+         entry itself, so an entry written for other SPIR-V whose hash
+         collides is not loaded.
+
+         Entries are written to a temporary file that is renamed into
+         place, so any number of processes may share the directory. An
+         entry that cannot be read or loaded, e.g. because it was damaged
+         or belongs to other SPIR-V, is a miss: the SPIR-V is parsed and
+         the entry written again. An entry that cannot be written is
+         ignored. Entries are stored and checked like
+         spvReflectEmbedReflection's data.
+ @param  flags        Flags for module creations.
+ @param  size         Size in bytes of SPIR-V code.
+ @param  p_code       Pointer to SPIR-V code.
+ @param  p_cache_dir  Path of the cache directory, which is created if its
+                      parent exists, or NULL to not use a cache.
+ @param  p_module     Pointer to an instance of SpvReflectShaderModule.
+ @return              SPV_REFLECT_RESULT_SUCCESS on success.
+
+*/
+SpvReflectResult spvReflectCreateShaderModuleCached(
+  SpvReflectModuleFlags          flags,
+  size_t                         size,
+  const void*                    p_code,
+  const char*                    p_cache_dir,
+  SpvReflectShaderModule*        p_module
+);
+
+/*! @fn spvReflectUpdateShaderModule
+ @brief  Replaces the reflection data in p_module with that of p_code, e.g.
+         after a shader is recompiled for hot reload. The result is the
+         same as destroying p_module and creating it again from p_code with
+         the same flags.
+
+         When the debug, annotation and type/global sections of p_code are
+         identical to those p_module was created from, its type
+         descriptions and descriptor and push constant block layouts are
+         taken over instead of parsed again, and only the function bodies
+         are analyzed for usage. Modules that use PhysicalStorageBuffer
+         pointers are always parsed in full.
+ @param  p_module  Pointer to a module created with one of the
+                   spvReflectCreateShaderModule functions. Pointers into it
+                   are invalidated, even when nothing is reused.
+ @param  size      Size in bytes of the new SPIR-V code.
+ @param  p_code    Pointer to the new SPIR-V code. If p_module was created
+                   with SPV_REFLECT_MODULE_FLAG_NO_COPY, it must outlive
+                   p_module.
+ @return           SPV_REFLECT_RESULT_SUCCESS on success. On failure
+                   p_module has been destroyed.
+
+*/
+SpvReflectResult spvReflectUpdateShaderModule(
+  SpvReflectShaderModule*  p_module,
+  size_t                   size,
+  const void*              p_code
+);
+
+/*! @fn spvReflectEmbedReflection
+ @brief  Writes a copy of p_code that carries its own reflection data, so
+         that creating a module from it loads the data instead of parsing
+         the SPIR-V. The data is stored, base64 encoded, in OpStrings used
+         by an OpExtInst of the "NonSemantic.SPIRV-Reflect" extended
+         instruction set, which drivers and tools ignore, together with a
+         SHA-256 digest of the data and the rest of the code. If either is
+         changed afterwards, e.g. by an optimizer or by the
+         spvReflectChange functions, the digest no longer matches and the
+         SPIR-V is parsed as usual. A payload embedded earlier is replaced.
+
+         The data is stored field by field in a format that does not
+         depend on the host, and every field is checked as it is loaded.
+         It is only loaded by versions of SPIRV-Reflect that write the same
+         format; otherwise it is ignored.
+ @param  size               Size in bytes of SPIR-V code.
+ @param  p_code             Pointer to SPIR-V code.
+ @param  p_embedded_size    If p_embedded_code is NULL, receives the size in
+                            bytes of the resulting code. Otherwise it must
+                            hold that size.
+ @param  p_embedded_code    Pointer to storage for the resulting code, or
+                            NULL.
+ @return                    If successful, returns
+                            SPV_REFLECT_RESULT_SUCCESS. Otherwise, the
+                            error code indicates the cause of the failure.
+
+*/
+SpvReflectResult spvReflectEmbedReflection(
+  size_t                   size,
+  const void*              p_code,
+  size_t*                  p_embedded_size,
+  void*                    p_embedded_code
+);
+
 SPV_REFLECT_DEPRECATED("renamed to spvReflectCreateShaderModule")
 SpvReflectResult spvReflectGetShaderModule(
   size_t                   size,
@@ -725,7 +1298,9 @@ void spvReflectDestroyShaderModule(SpvReflectShaderModule* p_module);
 /*! @fn spvReflectGetCodeSize
 
  @param  p_module  Pointer to an instance of SpvReflectShaderModule.
- @return           Returns the size of the SPIR-V in bytes
+ @return           Returns the size of the SPIR-V in bytes, or 0 if the
+                   module was created with
+                   SPV_REFLECT_MODULE_FLAG_DETACH_CODE.
 
 */
 uint32_t spvReflectGetCodeSize(const SpvReflectShaderModule* p_module);
@@ -734,7 +1309,9 @@ uint32_t spvReflectGetCodeSize(const SpvReflectShaderModule* p_module);
 /*! @fn spvReflectGetCode
 
  @param  p_module  Pointer to an instance of SpvReflectShaderModule.
- @return           Returns a const pointer to the compiled SPIR-V bytecode.
+ @return           Returns a const pointer to the compiled SPIR-V bytecode,
+                   or NULL if the module was created with
+                   SPV_REFLECT_MODULE_FLAG_DETACH_CODE.
 
 */
 const uint32_t* spvReflectGetCode(const SpvReflectShaderModule* p_module);
@@ -751,6 +1328,26 @@ const SpvReflectEntryPoint* spvReflectGetEntryPoint(
   const char*                   entry_point
 );
 
+/*! @fn spvReflectGetEntryPointIndex
+
+ @param  p_module     Pointer to an instance of SpvReflectShaderModule.
+ @param  entry_point  Name of the requested entry point.
+ @param  p_result     If successful, SPV_REFLECT_RESULT_SUCCESS will be
+                      written to *p_result. Otherwise, a error code
+                      indicating the cause of the failure will be stored
+                      here.
+ @return              Returns the index of the requested entry point in
+                      SpvReflectShaderModule::entry_points, or UINT32_MAX
+                      if it's not found. The index can be passed to the
+                      *ByIndex and GetIndexedEntryPoint* functions to
+                      skip the name lookup on repeated queries.
+*/
+uint32_t spvReflectGetEntryPointIndex(
+  const SpvReflectShaderModule* p_module,
+  const char*                   entry_point,
+  SpvReflectResult*             p_result
+);
+
 /*! @fn spvReflectEnumerateDescriptorBindings
 
  @param  p_module     Pointer to an instance of SpvReflectShaderModule.
@@ -802,6 +1399,20 @@ SpvReflectResult spvReflectEnumerateEntryPointDescriptorBindings(
   SpvReflectDescriptorBinding** pp_bindings
 );
 
+/*! @fn spvReflectEnumerateEntryPointDescriptorBindingsByIndex
+ @brief  Same as spvReflectEnumerateEntryPointDescriptorBindings, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+SpvReflectResult spvReflectEnumerateEntryPointDescriptorBindingsByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectDescriptorBinding** pp_bindings
+);
+
 /*! @fn spvReflectEnumerateDescriptorSets
 
  @param  p_module  Pointer to an instance of SpvReflectShaderModule.
@@ -853,6 +1464,20 @@ SpvReflectResult spvReflectEnumerateEntryPointDescriptorSets(
   SpvReflectDescriptorSet**     pp_sets
 );
 
+/*! @fn spvReflectEnumerateEntryPointDescriptorSetsByIndex
+ @brief  Same as spvReflectEnumerateEntryPointDescriptorSets, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+SpvReflectResult spvReflectEnumerateEntryPointDescriptorSetsByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectDescriptorSet**     pp_sets
+);
+
 
 /*! @fn spvReflectEnumerateInterfaceVariables
  @brief  If the module contains multiple entry points, this will only get
@@ -905,6 +1530,20 @@ SpvReflectResult spvReflectEnumerateEntryPointInterfaceVariables(
   SpvReflectInterfaceVariable** pp_variables
 );
 
+/*! @fn spvReflectEnumerateEntryPointInterfaceVariablesByIndex
+ @brief  Same as spvReflectEnumerateEntryPointInterfaceVariables, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+SpvReflectResult spvReflectEnumerateEntryPointInterfaceVariablesByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectInterfaceVariable** pp_variables
+);
+
 
 /*! @fn spvReflectEnumerateInputVariables
  @brief  If the module contains multiple entry points, this will only get
@@ -957,6 +1596,20 @@ SpvReflectResult spvReflectEnumerateEntryPointInputVariables(
   SpvReflectInterfaceVariable** pp_variables
 );
 
+/*! @fn spvReflectEnumerateEntryPointInputVariablesByIndex
+ @brief  Same as spvReflectEnumerateEntryPointInputVariables, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+SpvReflectResult spvReflectEnumerateEntryPointInputVariablesByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectInterfaceVariable** pp_variables
+);
+
 
 /*! @fn spvReflectEnumerateOutputVariables
  @brief  Note: If the module contains multiple entry points, this will only get
@@ -1009,6 +1662,20 @@ SpvReflectResult spvReflectEnumerateEntryPointOutputVariables(
   SpvReflectInterfaceVariable** pp_variables
 );
 
+/*! @fn spvReflectEnumerateEntryPointOutputVariablesByIndex
+ @brief  Same as spvReflectEnumerateEntryPointOutputVariables, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+SpvReflectResult spvReflectEnumerateEntryPointOutputVariablesByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectInterfaceVariable** pp_variables
+);
+
 
 /*! @fn spvReflectEnumeratePushConstantBlocks
  @brief  Note: If the module contains multiple entry points, this will only get
@@ -1069,6 +1736,20 @@ SpvReflectResult spvReflectEnumerateEntryPointPushConstantBlocks(
   SpvReflectBlockVariable**     pp_blocks
 );
 
+/*! @fn spvReflectEnumerateEntryPointPushConstantBlocksByIndex
+ @brief  Same as spvReflectEnumerateEntryPointPushConstantBlocks, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+SpvReflectResult spvReflectEnumerateEntryPointPushConstantBlocksByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectBlockVariable**     pp_blocks
+);
+
 
 /*! @fn spvReflectEnumerateSpecializationConstants
  @param  p_module      Pointer to an instance of SpvReflectShaderModule.
@@ -1151,6 +1832,111 @@ const SpvReflectDescriptorBinding* spvReflectGetEntryPointDescriptorBinding(
   SpvReflectResult*             p_result
 );
 
+/*! @fn spvReflectGetEntryPointDescriptorBindingByIndex
+ @brief  Same as spvReflectGetEntryPointDescriptorBinding, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectDescriptorBinding* spvReflectGetEntryPointDescriptorBindingByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t                      binding_number,
+  uint32_t                      set_number,
+  SpvReflectResult*             p_result
+);
+
+/*! @fn spvReflectGetEntryPointDescriptorBindingArray
+ @brief  Returns the descriptor bindings used in the static call tree of the
+         given entry point without copying them. The array holds the same
+         pointers, in the same order, as
+         spvReflectEnumerateEntryPointDescriptorBindings writes.
+ @param  p_module     Pointer to an instance of SpvReflectShaderModule.
+ @param  entry_point  The name of the entry point to get the descriptor
+                      bindings for.
+ @param  p_count      The entry point's descriptor binding count will be
+                      stored here.
+ @param  p_result     If successful, SPV_REFLECT_RESULT_SUCCESS will be
+                      written to *p_result. Otherwise, a error code
+                      indicating the cause of the failure will be stored
+                      here.
+ @return              Returns a pointer to *p_count binding pointers owned
+                      by the module, or NULL if the entry point uses no
+                      bindings or an error occurred. The array is valid
+                      until the module is destroyed.
+
+*/
+const SpvReflectDescriptorBinding* const* spvReflectGetEntryPointDescriptorBindingArray(
+  const SpvReflectShaderModule* p_module,
+  const char*                   entry_point,
+  uint32_t*                     p_count,
+  SpvReflectResult*             p_result
+);
+
+/*! @fn spvReflectGetEntryPointDescriptorBindingArrayByIndex
+ @brief  Same as spvReflectGetEntryPointDescriptorBindingArray, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectDescriptorBinding* const* spvReflectGetEntryPointDescriptorBindingArrayByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectResult*             p_result
+);
+
+/*! @fn spvReflectGetDescriptorBindingByName
+ @brief  Get the descriptor binding with the given name using the hash index
+         built at module creation.
+ @param  p_module  Pointer to an instance of SpvReflectShaderModule.
+ @param  name      The name of the requested descriptor binding.
+ @param  p_result  If successful, SPV_REFLECT_RESULT_SUCCESS will be
+                   written to *p_result. Otherwise, a error code
+                   indicating the cause of the failure will be stored
+                   here.
+ @return           If the module contains a descriptor binding with the
+                   given name, a pointer to that binding is returned. The
+                   caller must not free this pointer.
+                   If no match can be found, or if an unrelated error
+                   occurs, the return value will be NULL. Detailed
+                   error results are written to *pResult.
+@note              If the module contains multiple descriptor bindings
+                   with the same name, the first one in descriptor_bindings
+                   is returned.
+
+*/
+const SpvReflectDescriptorBinding* spvReflectGetDescriptorBindingByName(
+  const SpvReflectShaderModule* p_module,
+  const char*                   name,
+  SpvReflectResult*             p_result
+);
+
+/*! @fn spvReflectGetDescriptorBindingById
+ @brief  Get the descriptor binding whose variable has the given SPIR-V
+         result id using the hash index built at module creation.
+ @param  p_module  Pointer to an instance of SpvReflectShaderModule.
+ @param  spirv_id  The SPIR-V result id of the binding's variable.
+ @param  p_result  If successful, SPV_REFLECT_RESULT_SUCCESS will be
+                   written to *p_result. Otherwise, a error code
+                   indicating the cause of the failure will be stored
+                   here.
+ @return           If the module contains a matching descriptor binding,
+                   a pointer to that binding is returned. The caller must
+                   not free this pointer.
+                   If no match can be found, or if an unrelated error
+                   occurs, the return value will be NULL. Detailed
+                   error results are written to *pResult.
+
+*/
+const SpvReflectDescriptorBinding* spvReflectGetDescriptorBindingById(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      spirv_id,
+  SpvReflectResult*             p_result
+);
+
 
 /*! @fn spvReflectGetDescriptorSet
 
@@ -1198,6 +1984,20 @@ const SpvReflectDescriptorSet* spvReflectGetEntryPointDescriptorSet(
   SpvReflectResult*             p_result
 );
 
+/*! @fn spvReflectGetEntryPointDescriptorSetByIndex
+ @brief  Same as spvReflectGetEntryPointDescriptorSet, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectDescriptorSet* spvReflectGetEntryPointDescriptorSetByIndex(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t                      set_number,
+  SpvReflectResult*             p_result
+);
+
 
 /* @fn spvReflectGetInputVariableByLocation
 
@@ -1259,6 +2059,20 @@ const SpvReflectInterfaceVariable* spvReflectGetEntryPointInputVariableByLocatio
   SpvReflectResult*             p_result
 );
 
+/*! @fn spvReflectGetIndexedEntryPointInputVariableByLocation
+ @brief  Same as spvReflectGetEntryPointInputVariableByLocation, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointInputVariableByLocation(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  uint32_t                      location,
+  SpvReflectResult*             p_result
+);
+
 /* @fn spvReflectGetInputVariableBySemantic
 
  @param  p_module  Pointer to an instance of SpvReflectShaderModule.
@@ -1315,6 +2129,20 @@ const SpvReflectInterfaceVariable* spvReflectGetEntryPointInputVariableBySemanti
   SpvReflectResult*             p_result
 );
 
+/*! @fn spvReflectGetIndexedEntryPointInputVariableBySemantic
+ @brief  Same as spvReflectGetEntryPointInputVariableBySemantic, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointInputVariableBySemantic(
+  const SpvReflectShaderModule* p_module,
+  uint32_t                      entry_point_index,
+  const char*                   semantic,
+  SpvReflectResult*             p_result
+);
+
 /* @fn spvReflectGetOutputVariableByLocation
 
  @param  p_module  Pointer to an instance of SpvReflectShaderModule.
@@ -1375,6 +2203,20 @@ const SpvReflectInterfaceVariable* spvReflectGetEntryPointOutputVariableByLocati
   SpvReflectResult*              p_result
 );
 
+/*! @fn spvReflectGetIndexedEntryPointOutputVariableByLocation
+ @brief  Same as spvReflectGetEntryPointOutputVariableByLocation, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointOutputVariableByLocation(
+  const SpvReflectShaderModule*  p_module,
+  uint32_t                       entry_point_index,
+  uint32_t                       location,
+  SpvReflectResult*              p_result
+);
+
 /* @fn spvReflectGetOutputVariableBySemantic
 
  @param  p_module  Pointer to an instance of SpvReflectShaderModule.
@@ -1431,6 +2273,20 @@ const SpvReflectInterfaceVariable* spvReflectGetEntryPointOutputVariableBySemant
   SpvReflectResult*              p_result
 );
 
+/*! @fn spvReflectGetIndexedEntryPointOutputVariableBySemantic
+ @brief  Same as spvReflectGetEntryPointOutputVariableBySemantic, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectInterfaceVariable* spvReflectGetIndexedEntryPointOutputVariableBySemantic(
+  const SpvReflectShaderModule*  p_module,
+  uint32_t                       entry_point_index,
+  const char*                    semantic,
+  SpvReflectResult*              p_result
+);
+
 /*! @fn spvReflectGetPushConstantBlock
 
  @param  p_module  Pointer to an instance of SpvReflectShaderModule.
@@ -1485,24 +2341,78 @@ const SpvReflectBlockVariable* spvReflectGetEntryPointPushConstantBlock(
   SpvReflectResult*              p_result
 );
 
+/*! @fn spvReflectGetEntryPointPushConstantBlockByIndex
+ @brief  Same as spvReflectGetEntryPointPushConstantBlock, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
 
-/*! @fn spvReflectChangeDescriptorBindingNumbers
- @brief  Assign new set and/or binding numbers to a descriptor binding.
-         In addition to updating the reflection data, this function modifies
-         the underlying SPIR-V bytecode. The updated code can be retrieved
-         with spvReflectGetCode().  If the binding is used in multiple
-         entry points within the module, it will be changed in all of them.
- @param  p_module            Pointer to an instance of SpvReflectShaderModule.
- @param  p_binding           Pointer to the descriptor binding to modify.
- @param  new_binding_number  The new binding number to assign to the
-                             provided descriptor binding.
-                             To leave the binding number unchanged, pass
-                             SPV_REFLECT_BINDING_NUMBER_DONT_CHANGE.
- @param  new_set_number      The new set number to assign to the
-                             provided descriptor binding. Successfully changing
-                             a descriptor binding's set number invalidates all
-                             existing SpvReflectDescriptorBinding and
-                             SpvReflectDescriptorSet pointers from this module.
+*/
+const SpvReflectBlockVariable* spvReflectGetEntryPointPushConstantBlockByIndex(
+  const SpvReflectShaderModule*  p_module,
+  uint32_t                       entry_point_index,
+  SpvReflectResult*              p_result
+);
+
+/*! @fn spvReflectGetEntryPointPushConstantBlockArray
+ @brief  Returns the push constant blocks used in the static call tree of
+         the given entry point without copying them. The array holds the
+         same pointers, in the same order, as
+         spvReflectEnumerateEntryPointPushConstantBlocks writes.
+ @param  p_module     Pointer to an instance of SpvReflectShaderModule.
+ @param  entry_point  The name of the entry point to get the push constant
+                      blocks for.
+ @param  p_count      The entry point's push constant block count will be
+                      stored here.
+ @param  p_result     If successful, SPV_REFLECT_RESULT_SUCCESS will be
+                      written to *p_result. Otherwise, a error code
+                      indicating the cause of the failure will be stored
+                      here.
+ @return              Returns a pointer to *p_count block pointers owned
+                      by the module, or NULL if the entry point uses no
+                      push constants or an error occurred. The array is
+                      valid until the module is destroyed.
+
+*/
+const SpvReflectBlockVariable* const* spvReflectGetEntryPointPushConstantBlockArray(
+  const SpvReflectShaderModule*  p_module,
+  const char*                    entry_point,
+  uint32_t*                      p_count,
+  SpvReflectResult*              p_result
+);
+
+/*! @fn spvReflectGetEntryPointPushConstantBlockArrayByIndex
+ @brief  Same as spvReflectGetEntryPointPushConstantBlockArray, but
+         identifies the entry point by its index into
+         SpvReflectShaderModule::entry_points instead of its name. An
+         out-of-range index is reported as not found.
+
+*/
+const SpvReflectBlockVariable* const* spvReflectGetEntryPointPushConstantBlockArrayByIndex(
+  const SpvReflectShaderModule*  p_module,
+  uint32_t                       entry_point_index,
+  uint32_t*                      p_count,
+  SpvReflectResult*              p_result
+);
+
+
+/*! @fn spvReflectChangeDescriptorBindingNumbers
+ @brief  Assign new set and/or binding numbers to a descriptor binding.
+         In addition to updating the reflection data, this function modifies
+         the underlying SPIR-V bytecode. The updated code can be retrieved
+         with spvReflectGetCode().  If the binding is used in multiple
+         entry points within the module, it will be changed in all of them.
+ @param  p_module            Pointer to an instance of SpvReflectShaderModule.
+ @param  p_binding           Pointer to the descriptor binding to modify.
+ @param  new_binding_number  The new binding number to assign to the
+                             provided descriptor binding.
+                             To leave the binding number unchanged, pass
+                             SPV_REFLECT_BINDING_NUMBER_DONT_CHANGE.
+ @param  new_set_number      The new set number to assign to the
+                             provided descriptor binding. Successfully changing
+                             a descriptor binding's set number invalidates all
+                             existing SpvReflectDescriptorBinding and
+                             SpvReflectDescriptorSet pointers from this module.
                              To leave the set number unchanged, pass
                              SPV_REFLECT_SET_NUMBER_DONT_CHANGE.
  @return                     If successful, returns SPV_REFLECT_RESULT_SUCCESS.
@@ -1617,6 +2527,406 @@ const char* spvReflectBlockVariableTypeName(
   const SpvReflectBlockVariable* p_var
 );
 
+/*! @fn spvReflectCreateProgram
+
+ @param  p_program  Pointer to an instance of SpvReflectProgram.
+ @return            If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                    Otherwise, the error code indicates the cause of the
+                    failure.
+
+*/
+SpvReflectResult spvReflectCreateProgram(SpvReflectProgram* p_program);
+
+/*! @fn spvReflectDestroyProgram
+
+ @param  p_program  Pointer to an instance of SpvReflectProgram.
+
+*/
+void spvReflectDestroyProgram(SpvReflectProgram* p_program);
+
+/*! @fn spvReflectProgramAddModule
+ @brief  Merges every entry point of p_module into the program. Only the
+         descriptor bindings and push constant blocks an entry point
+         statically uses contribute to its stage.
+ @param  p_program  Pointer to an instance of SpvReflectProgram.
+ @param  p_module   Pointer to an instance of SpvReflectShaderModule. The
+                    program keeps no references to the module.
+ @return            If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                    Descriptor type mismatches are not errors; they are
+                    appended to p_program->conflicts.
+
+*/
+SpvReflectResult spvReflectProgramAddModule(
+  SpvReflectProgram*            p_program,
+  const SpvReflectShaderModule* p_module
+);
+
+/*! @fn spvReflectProgramAddEntryPoint
+ @brief  Same as spvReflectProgramAddModule, but merges a single entry
+         point.
+ @param  p_program    Pointer to an instance of SpvReflectProgram.
+ @param  p_module     Pointer to an instance of SpvReflectShaderModule.
+ @param  entry_point  The name of the entry point to merge.
+ @return              If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                      Otherwise, the error code indicates the cause of the
+                      failure.
+
+*/
+SpvReflectResult spvReflectProgramAddEntryPoint(
+  SpvReflectProgram*            p_program,
+  const SpvReflectShaderModule* p_module,
+  const char*                   entry_point
+);
+
+/*! @fn spvReflectProgramGetDescriptorSet
+
+ @param  p_program   Pointer to an instance of SpvReflectProgram.
+ @param  set_number  The "set" value of the requested descriptor set.
+ @param  p_result    If successful, SPV_REFLECT_RESULT_SUCCESS will be
+                     written to *p_result. Otherwise, a error code
+                     indicating the cause of the failure will be stored
+                     here.
+ @return             If the program contains a descriptor set with the
+                     provided set number, a pointer to that set is
+                     returned. Otherwise NULL is returned.
+
+*/
+const SpvReflectProgramDescriptorSet* spvReflectProgramGetDescriptorSet(
+  const SpvReflectProgram* p_program,
+  uint32_t                 set_number,
+  SpvReflectResult*        p_result
+);
+
+/*! @fn spvReflectCreateDescriptorSetLayouts
+ @brief  Computes the distinct descriptor set layouts statically used by
+         every entry point of the given modules. Create one
+         VkDescriptorSetLayout per element of p_layouts->layouts and look up
+         the one a pipeline needs through p_layouts->uses.
+ @param  module_count  Number of elements in pp_modules.
+ @param  pp_modules    Pointers to instances of SpvReflectShaderModule. The
+                       result keeps no references to the modules.
+ @param  p_layouts     Pointer to an instance of
+                       SpvReflectDescriptorSetLayouts.
+ @return               If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                       Aliased bindings with different descriptor types are
+                       not errors; they are appended to p_layouts->conflicts.
+                       Otherwise, the error code indicates the cause of the
+                       failure.
+
+*/
+SpvReflectResult spvReflectCreateDescriptorSetLayouts(
+  uint32_t                             module_count,
+  const SpvReflectShaderModule* const* pp_modules,
+  SpvReflectDescriptorSetLayouts*      p_layouts
+);
+
+/*! @fn spvReflectDestroyDescriptorSetLayouts
+
+ @param  p_layouts  Pointer to an instance of SpvReflectDescriptorSetLayouts.
+
+*/
+void spvReflectDestroyDescriptorSetLayouts(SpvReflectDescriptorSetLayouts* p_layouts);
+
+/*! @fn spvReflectDescriptorPoolSizesAddModule
+ @brief  Adds one allocation of every descriptor set of a module, as seen by
+         all of its entry points together, to p_pool_sizes. Bindings that
+         alias the same binding number in a set are counted once.
+ @param  p_pool_sizes        Pointer to an instance of
+                             SpvReflectDescriptorPoolSizes.
+ @param  p_module            Pointer to an instance of SpvReflectShaderModule.
+ @param  runtime_array_size  Number of descriptors to reserve for each
+                             runtime-sized binding array, whose reflected
+                             count is 0.
+ @return                     If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                             Otherwise, the error code indicates the cause of
+                             the failure.
+
+*/
+SpvReflectResult spvReflectDescriptorPoolSizesAddModule(
+  SpvReflectDescriptorPoolSizes* p_pool_sizes,
+  const SpvReflectShaderModule*  p_module,
+  uint32_t                       runtime_array_size
+);
+
+/*! @fn spvReflectDescriptorPoolSizesAddEntryPoint
+ @brief  Same as spvReflectDescriptorPoolSizesAddModule, but only adds the
+         descriptor sets statically used by the given entry point.
+ @param  p_pool_sizes        Pointer to an instance of
+                             SpvReflectDescriptorPoolSizes.
+ @param  p_module            Pointer to an instance of SpvReflectShaderModule.
+ @param  entry_point         The name of the entry point.
+ @param  runtime_array_size  Number of descriptors to reserve for each
+                             runtime-sized binding array.
+ @return                     If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                             Otherwise, the error code indicates the cause of
+                             the failure.
+
+*/
+SpvReflectResult spvReflectDescriptorPoolSizesAddEntryPoint(
+  SpvReflectDescriptorPoolSizes* p_pool_sizes,
+  const SpvReflectShaderModule*  p_module,
+  const char*                    entry_point,
+  uint32_t                       runtime_array_size
+);
+
+/*! @fn spvReflectEnumerateDescriptorUpdateTemplateEntries
+ @brief  Lays out a struct holding the descriptor infos of every binding of
+         a descriptor set, and returns one update template entry per
+         binding, in binding order. An arrayed binding is a single entry
+         whose infos are consecutive in the struct. Bindings that alias the
+         same binding number are listed once.
+ @param  p_set               Pointer to an instance of
+                             SpvReflectDescriptorSet.
+ @param  p_info_sizes        Sizes of the descriptor info structs, or NULL
+                             for the sizes Vulkan uses: 24 bytes for image
+                             and buffer infos, 8 bytes for handles.
+ @param  runtime_array_size  Number of descriptors to lay out for each
+                             runtime-sized binding array. Runtime-sized
+                             bindings are skipped if this is 0.
+ @param  p_count             If p_entries is NULL, the entry count.
+                             If p_entries is not NULL, must be the entry
+                             count.
+ @param  p_entries           If NULL, the entry count is written to
+                             p_count. Otherwise, receives the entries.
+ @param  p_data_size         If not NULL, receives the size of the struct,
+                             rounded up to a multiple of 8 bytes.
+ @return                     If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                             Otherwise, the error code indicates the cause of
+                             the failure.
+
+*/
+SpvReflectResult spvReflectEnumerateDescriptorUpdateTemplateEntries(
+  const SpvReflectDescriptorSet*           p_set,
+  const SpvReflectDescriptorInfoSizes*     p_info_sizes,
+  uint32_t                                 runtime_array_size,
+  uint32_t*                                p_count,
+  SpvReflectDescriptorUpdateTemplateEntry* p_entries,
+  uint32_t*                                p_data_size
+);
+
+/*! @fn spvReflectFormatSize
+
+ @param  format  A format reported for an interface variable.
+ @return         The size of one element of format in bytes, or 0 for
+                 SPV_REFLECT_FORMAT_UNDEFINED.
+
+*/
+uint32_t spvReflectFormatSize(SpvReflectFormat format);
+
+/*! @fn spvReflectComputeVertexInputLayout
+ @brief  Computes vertex attributes and bindings for the input variables of
+         a vertex entry point. Built-in inputs are skipped. Matrix and array
+         inputs get one attribute per location they occupy. Inputs packed
+         into one location with Component decorations share one attribute
+         whose format covers all of their components. Attributes are
+         placed in location order at offsets aligned to their component
+         size, and each binding's stride is rounded up to the largest such
+         alignment in it.
+ @param  p_module                Pointer to an instance of
+                                 SpvReflectShaderModule.
+ @param  entry_point             The name of the entry point.
+ @param  mode                    Whether attributes are interleaved or each
+                                 streamed from its own binding.
+ @param  location_binding_count  Number of elements in p_location_bindings.
+ @param  p_location_bindings     Optional. In interleaved mode, the binding of
+                                 the attribute at location i is
+                                 p_location_bindings[i]; locations past the
+                                 end use binding 0. Ignored in deinterleaved
+                                 mode.
+ @param  p_layout                Pointer to an instance of
+                                 SpvReflectVertexInputLayout.
+ @return                         If successful, returns
+                                 SPV_REFLECT_RESULT_SUCCESS. Returns
+                                 SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED if
+                                 the inputs need more than
+                                 SPV_REFLECT_MAX_VERTEX_INPUT_ATTRIBUTES
+                                 attributes, and
+                                 SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_INSTRUCTION
+                                 if inputs packed into one location have
+                                 different component types.
+
+*/
+SpvReflectResult spvReflectComputeVertexInputLayout(
+  const SpvReflectShaderModule*   p_module,
+  const char*                     entry_point,
+  SpvReflectVertexInputLayoutMode mode,
+  uint32_t                        location_binding_count,
+  const uint32_t*                 p_location_bindings,
+  SpvReflectVertexInputLayout*    p_layout
+);
+
+/*! @fn spvReflectCheckStageInterface
+ @brief  Matches the outputs of one entry point against the inputs of the
+         entry point that consumes them, component by component. Arrays,
+         matrices and blocks are expanded to every location and component
+         they cover, so an input may be written by several outputs and an
+         output read by several inputs. Blocks without a Location take
+         their locations from their members. The outer per-vertex array of
+         tessellation and geometry inputs and of tessellation control and
+         mesh outputs is ignored, except for patch variables. Clip and cull
+         distances, and for tessellation and geometry inputs also position
+         and point size, must be written by the producer; members of
+         arrayed blocks such as gl_in[] carry no built-in information and
+         are not checked. Runs in O(n log n) time in the number of
+         components.
+ @param  p_producer_module     Pointer to the module with the producing entry
+                               point.
+ @param  producer_entry_point  The name of the producing entry point.
+ @param  p_consumer_module     Pointer to the module with the consuming entry
+                               point. May equal p_producer_module.
+ @param  consumer_entry_point  The name of the consuming entry point.
+ @param  p_count               If p_mismatches is NULL, receives the number
+                               of mismatches, including unused outputs.
+                               Otherwise must equal that number.
+ @param  p_mismatches          Optional. Receives the mismatches: inputs in
+                               location order, then missing built-ins, then
+                               unused outputs in location order.
+ @return                       If successful, returns
+                               SPV_REFLECT_RESULT_SUCCESS. Otherwise, the
+                               error code indicates the cause of the failure.
+
+*/
+SpvReflectResult spvReflectCheckStageInterface(
+  const SpvReflectShaderModule* p_producer_module,
+  const char*                   producer_entry_point,
+  const SpvReflectShaderModule* p_consumer_module,
+  const char*                   consumer_entry_point,
+  uint32_t*                     p_count,
+  SpvReflectInterfaceMismatch*  p_mismatches
+);
+
+/*! @fn spvReflectCreateFlatBlock
+ @brief  Flattens a block variable, such as SpvReflectDescriptorBinding::block
+         or a push constant block, into its leaf members.
+ @param  p_block       Pointer to an instance of SpvReflectBlockVariable.
+                       The flat block points into it, so it must outlive
+                       p_flat_block.
+ @param  p_flat_block  Pointer to an instance of SpvReflectFlatBlock.
+ @return               If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                       Otherwise, the error code indicates the cause of the
+                       failure.
+
+*/
+SpvReflectResult spvReflectCreateFlatBlock(
+  const SpvReflectBlockVariable* p_block,
+  SpvReflectFlatBlock*           p_flat_block
+);
+
+/*! @fn spvReflectGetFlatBlockMemberByPath
+ @brief  Finds a leaf member by its full path, such as "lights[3].color".
+         Subscripts into an array leaf, such as "weights[2]", resolve to the
+         leaf with p_offset set to the element's offset. The path index is
+         built on the first call, so the first call must not race with
+         other calls on the same flat block.
+ @param  p_flat_block  Pointer to an instance of SpvReflectFlatBlock.
+ @param  path          The member path, without the block name.
+ @param  p_offset      If not NULL, receives the absolute offset of the
+                       named member or array element.
+ @param  p_result      If it is not NULL, the return value will be written
+                       to this location.
+ @return               If the member is found, a pointer to it is returned.
+                       Otherwise NULL is returned and p_result is set to
+                       SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND.
+
+*/
+const SpvReflectFlatBlockMember* spvReflectGetFlatBlockMemberByPath(
+  SpvReflectFlatBlock* p_flat_block,
+  const char*          path,
+  uint32_t*            p_offset,
+  SpvReflectResult*    p_result
+);
+
+/*! @fn spvReflectDestroyFlatBlock
+
+ @param  p_flat_block  Pointer to an instance of SpvReflectFlatBlock.
+
+*/
+void spvReflectDestroyFlatBlock(SpvReflectFlatBlock* p_flat_block);
+
+/*! @fn spvReflectCreatePackPlan
+ @brief  Compiles the layout of a block variable into a list of copy
+         operations, merging members that are contiguous on both sides.
+ @param  p_block  Pointer to an instance of SpvReflectBlockVariable.
+ @param  p_plan   Pointer to an instance of SpvReflectPackPlan.
+ @return          If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                  Otherwise, the error code indicates the cause of the
+                  failure.
+
+*/
+SpvReflectResult spvReflectCreatePackPlan(
+  const SpvReflectBlockVariable* p_block,
+  SpvReflectPackPlan*            p_plan
+);
+
+/*! @fn spvReflectExecutePackPlan
+ @brief  Packs instance_count host structs into block layout. Bytes of
+         p_dst that no member covers, such as padding, are not written.
+ @param  p_plan               Pointer to an instance of SpvReflectPackPlan.
+ @param  instance_count       Number of instances to pack.
+ @param  p_src                Host data, instance i starting at
+                              i * src_instance_stride bytes.
+ @param  src_instance_stride  Bytes between host instances; 0 means
+                              p_plan->host_size.
+ @param  p_dst                Block data, instance i starting at
+                              i * dst_instance_stride bytes.
+ @param  dst_instance_stride  Bytes between block instances; 0 means
+                              p_plan->device_size.
+ @return                      If successful, returns
+                              SPV_REFLECT_RESULT_SUCCESS. Otherwise, the
+                              error code indicates the cause of the
+                              failure.
+
+*/
+SpvReflectResult spvReflectExecutePackPlan(
+  const SpvReflectPackPlan* p_plan,
+  uint32_t                  instance_count,
+  const void*               p_src,
+  uint32_t                  src_instance_stride,
+  void*                     p_dst,
+  uint32_t                  dst_instance_stride
+);
+
+/*! @fn spvReflectDestroyPackPlan
+
+ @param  p_plan  Pointer to an instance of SpvReflectPackPlan.
+
+*/
+void spvReflectDestroyPackPlan(SpvReflectPackPlan* p_plan);
+
+/*! @fn spvReflectDiffShaderModules
+ @brief  Lists what changed between two versions of a shader module, so that
+         only the objects built from the affected parts need to be rebuilt.
+         Changes are listed in this order: entry points and their execution
+         modes; descriptor bindings, each followed by its block members;
+         push constant blocks, each followed by its members; input and
+         output variables of every entry point in both modules; and
+         specialization constants. Built-in interface variables are not
+         compared. Of the names, only descriptor binding names and
+         interface variable semantics are compared, since materials and
+         vertex formats bind by them.
+ @param  p_old_module  Pointer to an instance of SpvReflectShaderModule.
+ @param  p_new_module  Pointer to an instance of SpvReflectShaderModule.
+ @param  p_diff        Pointer to an instance of SpvReflectModuleDiff. The
+                       changes point into both modules, so they must outlive
+                       p_diff.
+ @return               If successful, returns SPV_REFLECT_RESULT_SUCCESS.
+                       Otherwise, the error code indicates the cause of the
+                       failure.
+
+*/
+SpvReflectResult spvReflectDiffShaderModules(
+  const SpvReflectShaderModule* p_old_module,
+  const SpvReflectShaderModule* p_new_module,
+  SpvReflectModuleDiff*         p_diff
+);
+
+/*! @fn spvReflectDestroyModuleDiff
+
+ @param  p_diff  Pointer to an instance of SpvReflectModuleDiff.
+
+*/
+void spvReflectDestroyModuleDiff(SpvReflectModuleDiff* p_diff);
+
 #if defined(__cplusplus)
 };
 #endif
@@ -1624,6 +2934,7 @@ const char* spvReflectBlockVariableTypeName(
 #if defined(__cplusplus) && !defined(SPIRV_REFLECT_DISABLE_CPP_BINDINGS)
 #include <cstdlib>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace spv_reflect {
@@ -1637,12 +2948,16 @@ public:
   ShaderModule(size_t size, const void* p_code, SpvReflectModuleFlags flags = SPV_REFLECT_MODULE_FLAG_NONE);
   ShaderModule(const std::vector<uint8_t>& code, SpvReflectModuleFlags flags = SPV_REFLECT_MODULE_FLAG_NONE);
   ShaderModule(const std::vector<uint32_t>& code, SpvReflectModuleFlags flags = SPV_REFLECT_MODULE_FLAG_NONE);
+  ShaderModule(size_t size, const void* p_code, SpvReflectModuleFlags flags, const SpvReflectTaskScheduler* p_scheduler);
+  ShaderModule(size_t size, const void* p_code, SpvReflectModuleFlags flags, const char* p_cache_dir);
   ~ShaderModule();
 
   ShaderModule(ShaderModule&& other);
   ShaderModule& operator=(ShaderModule&& other);
 
   SpvReflectResult GetResult() const;
+  // Re-reflects the module from recompiled SPIR-V; see spvReflectUpdateShaderModule.
+  SpvReflectResult Update(size_t size, const void* p_code);
 
   const SpvReflectShaderModule& GetShaderModule() const;
 
@@ -1656,6 +2971,7 @@ public:
   uint32_t                      GetEntryPointCount() const;
   const char*                   GetEntryPointName(uint32_t index) const;
   SpvReflectShaderStageFlagBits GetEntryPointShaderStage(uint32_t index) const;
+  uint32_t                      GetEntryPointIndex(const char* entry_point, SpvReflectResult* p_result = nullptr) const;
 
   SpvReflectShaderStageFlagBits GetShaderStage() const;
   SPV_REFLECT_DEPRECATED("Renamed to GetShaderStage")
@@ -1665,16 +2981,22 @@ public:
 
   SpvReflectResult  EnumerateDescriptorBindings(uint32_t* p_count, SpvReflectDescriptorBinding** pp_bindings) const;
   SpvReflectResult  EnumerateEntryPointDescriptorBindings(const char* entry_point, uint32_t* p_count, SpvReflectDescriptorBinding** pp_bindings) const;
+  SpvReflectResult  EnumerateEntryPointDescriptorBindingsByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectDescriptorBinding** pp_bindings) const;
   SpvReflectResult  EnumerateDescriptorSets( uint32_t* p_count, SpvReflectDescriptorSet** pp_sets) const ;
   SpvReflectResult  EnumerateEntryPointDescriptorSets(const char* entry_point, uint32_t* p_count, SpvReflectDescriptorSet** pp_sets) const ;
+  SpvReflectResult  EnumerateEntryPointDescriptorSetsByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectDescriptorSet** pp_sets) const ;
   SpvReflectResult  EnumerateInterfaceVariables(uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) const;
   SpvReflectResult  EnumerateEntryPointInterfaceVariables(const char* entry_point, uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) const;
+  SpvReflectResult  EnumerateEntryPointInterfaceVariablesByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) const;
   SpvReflectResult  EnumerateInputVariables(uint32_t* p_count,SpvReflectInterfaceVariable** pp_variables) const;
   SpvReflectResult  EnumerateEntryPointInputVariables(const char* entry_point, uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) const;
+  SpvReflectResult  EnumerateEntryPointInputVariablesByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) const;
   SpvReflectResult  EnumerateOutputVariables(uint32_t* p_count,SpvReflectInterfaceVariable** pp_variables) const;
   SpvReflectResult  EnumerateEntryPointOutputVariables(const char* entry_point, uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) const;
+  SpvReflectResult  EnumerateEntryPointOutputVariablesByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectInterfaceVariable** pp_variables) const;
   SpvReflectResult  EnumeratePushConstantBlocks(uint32_t* p_count, SpvReflectBlockVariable** pp_blocks) const;
   SpvReflectResult  EnumerateEntryPointPushConstantBlocks(const char* entry_point, uint32_t* p_count, SpvReflectBlockVariable** pp_blocks) const;
+  SpvReflectResult  EnumerateEntryPointPushConstantBlocksByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectBlockVariable** pp_blocks) const;
   SPV_REFLECT_DEPRECATED("Renamed to EnumeratePushConstantBlocks")
   SpvReflectResult  EnumeratePushConstants(uint32_t* p_count, SpvReflectBlockVariable** pp_blocks) const {
     return EnumeratePushConstantBlocks(p_count, pp_blocks);
@@ -1683,30 +3005,43 @@ public:
 
   const SpvReflectDescriptorBinding*  GetDescriptorBinding(uint32_t binding_number, uint32_t set_number, SpvReflectResult* p_result = nullptr) const;
   const SpvReflectDescriptorBinding*  GetEntryPointDescriptorBinding(const char* entry_point, uint32_t binding_number, uint32_t set_number, SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectDescriptorBinding*  GetEntryPointDescriptorBindingByIndex(uint32_t entry_point_index, uint32_t binding_number, uint32_t set_number, SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectDescriptorBinding* const* GetEntryPointDescriptorBindingArray(const char* entry_point, uint32_t* p_count, SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectDescriptorBinding* const* GetEntryPointDescriptorBindingArrayByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectDescriptorBinding*  GetDescriptorBindingByName(const char* name, SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectDescriptorBinding*  GetDescriptorBindingById(uint32_t spirv_id, SpvReflectResult* p_result = nullptr) const;
   const SpvReflectDescriptorSet*      GetDescriptorSet(uint32_t set_number, SpvReflectResult* p_result = nullptr) const;
   const SpvReflectDescriptorSet*      GetEntryPointDescriptorSet(const char* entry_point, uint32_t set_number, SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectDescriptorSet*      GetEntryPointDescriptorSetByIndex(uint32_t entry_point_index, uint32_t set_number, SpvReflectResult* p_result = nullptr) const;
   const SpvReflectInterfaceVariable*  GetInputVariableByLocation(uint32_t location,  SpvReflectResult* p_result = nullptr) const;
   SPV_REFLECT_DEPRECATED("Renamed to GetInputVariableByLocation")
   const SpvReflectInterfaceVariable*  GetInputVariable(uint32_t location,  SpvReflectResult* p_result = nullptr) const {
     return GetInputVariableByLocation(location, p_result);
   }
   const SpvReflectInterfaceVariable*  GetEntryPointInputVariableByLocation(const char* entry_point, uint32_t location,  SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectInterfaceVariable*  GetIndexedEntryPointInputVariableByLocation(uint32_t entry_point_index, uint32_t location,  SpvReflectResult* p_result = nullptr) const;
   const SpvReflectInterfaceVariable*  GetInputVariableBySemantic(const char* semantic,  SpvReflectResult* p_result = nullptr) const;
   const SpvReflectInterfaceVariable*  GetEntryPointInputVariableBySemantic(const char* entry_point, const char* semantic,  SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectInterfaceVariable*  GetIndexedEntryPointInputVariableBySemantic(uint32_t entry_point_index, const char* semantic,  SpvReflectResult* p_result = nullptr) const;
   const SpvReflectInterfaceVariable*  GetOutputVariableByLocation(uint32_t location, SpvReflectResult*  p_result = nullptr) const;
   SPV_REFLECT_DEPRECATED("Renamed to GetOutputVariableByLocation")
   const SpvReflectInterfaceVariable*  GetOutputVariable(uint32_t location, SpvReflectResult*  p_result = nullptr) const {
     return GetOutputVariableByLocation(location, p_result);
   }
   const SpvReflectInterfaceVariable*  GetEntryPointOutputVariableByLocation(const char* entry_point, uint32_t location, SpvReflectResult*  p_result = nullptr) const;
+  const SpvReflectInterfaceVariable*  GetIndexedEntryPointOutputVariableByLocation(uint32_t entry_point_index, uint32_t location, SpvReflectResult*  p_result = nullptr) const;
   const SpvReflectInterfaceVariable*  GetOutputVariableBySemantic(const char* semantic, SpvReflectResult*  p_result = nullptr) const;
   const SpvReflectInterfaceVariable*  GetEntryPointOutputVariableBySemantic(const char* entry_point, const char* semantic, SpvReflectResult*  p_result = nullptr) const;
+  const SpvReflectInterfaceVariable*  GetIndexedEntryPointOutputVariableBySemantic(uint32_t entry_point_index, const char* semantic, SpvReflectResult*  p_result = nullptr) const;
   const SpvReflectBlockVariable*      GetPushConstantBlock(uint32_t index, SpvReflectResult*  p_result = nullptr) const;
   SPV_REFLECT_DEPRECATED("Renamed to GetPushConstantBlock")
   const SpvReflectBlockVariable*      GetPushConstant(uint32_t index, SpvReflectResult*  p_result = nullptr) const {
     return GetPushConstantBlock(index, p_result);
   }
   const SpvReflectBlockVariable*      GetEntryPointPushConstantBlock(const char* entry_point, SpvReflectResult*  p_result = nullptr) const;
+  const SpvReflectBlockVariable*      GetEntryPointPushConstantBlockByIndex(uint32_t entry_point_index, SpvReflectResult*  p_result = nullptr) const;
+  const SpvReflectBlockVariable* const*     GetEntryPointPushConstantBlockArray(const char* entry_point, uint32_t* p_count, SpvReflectResult* p_result = nullptr) const;
+  const SpvReflectBlockVariable* const*     GetEntryPointPushConstantBlockArrayByIndex(uint32_t entry_point_index, uint32_t* p_count, SpvReflectResult* p_result = nullptr) const;
 
   SpvReflectResult ChangeDescriptorBindingNumbers(const SpvReflectDescriptorBinding* p_binding,
       uint32_t new_binding_number = SPV_REFLECT_BINDING_NUMBER_DONT_CHANGE,
@@ -1720,6 +3055,8 @@ public:
   SpvReflectResult ChangeInputVariableLocation(const SpvReflectInterfaceVariable* p_input_variable, uint32_t new_location);
   SpvReflectResult ChangeOutputVariableLocation(const SpvReflectInterfaceVariable* p_output_variable, uint32_t new_location);
 
+  const SpvReflectFlatBlockMember* GetBlockMemberByPath(const SpvReflectBlockVariable* p_block, const char* path, uint32_t* p_offset = nullptr, SpvReflectResult* p_result = nullptr) const;
+
 private:
   // Make noncopyable
   ShaderModule(const ShaderModule&);
@@ -1728,6 +3065,8 @@ private:
 private:
   mutable SpvReflectResult  m_result = SPV_REFLECT_RESULT_NOT_READY;
   SpvReflectShaderModule    m_module = {};
+  // Flattened on first lookup, keyed by the block they were created from
+  mutable std::vector<std::pair<const SpvReflectBlockVariable*, SpvReflectFlatBlock>> m_flat_blocks;
 };
 
 
@@ -1781,10 +3120,47 @@ inline ShaderModule::ShaderModule(const std::vector<uint32_t>& code, SpvReflectM
     &m_module);
 }
 
+/*! @fn ShaderModule
+
+  @param  size
+  @param  p_code
+  @param  flags
+  @param  p_scheduler
+
+*/
+inline ShaderModule::ShaderModule(size_t size, const void* p_code, SpvReflectModuleFlags flags, const SpvReflectTaskScheduler* p_scheduler) {
+  m_result = spvReflectCreateShaderModule3(
+    flags,
+    size,
+    p_code,
+    p_scheduler,
+    &m_module);
+}
+
+/*! @fn ShaderModule
+
+  @param  size
+  @param  p_code
+  @param  flags
+  @param  p_cache_dir
+
+*/
+inline ShaderModule::ShaderModule(size_t size, const void* p_code, SpvReflectModuleFlags flags, const char* p_cache_dir) {
+  m_result = spvReflectCreateShaderModuleCached(
+    flags,
+    size,
+    p_code,
+    p_cache_dir,
+    &m_module);
+}
+
 /*! @fn  ~ShaderModule
 
 */
 inline ShaderModule::~ShaderModule() {
+  for (auto& flat_block : m_flat_blocks) {
+    spvReflectDestroyFlatBlock(&flat_block.second);
+  }
   spvReflectDestroyShaderModule(&m_module);
 }
 
@@ -1796,10 +3172,15 @@ inline ShaderModule::ShaderModule(ShaderModule&& other)
 
 inline ShaderModule& ShaderModule::operator=(ShaderModule&& other)
 {
+    for (auto& flat_block : m_flat_blocks) {
+      spvReflectDestroyFlatBlock(&flat_block.second);
+    }
     m_result = std::move(other.m_result);
     m_module = std::move(other.m_module);
+    m_flat_blocks = std::move(other.m_flat_blocks);
 
     other.m_module = {};
+    other.m_flat_blocks.clear();
     return *this;
 }
 
@@ -1812,6 +3193,25 @@ inline SpvReflectResult ShaderModule::GetResult() const {
   return m_result;
 }
 
+/*! @fn Update
+
+  @param  size
+  @param  p_code
+  @return
+
+*/
+inline SpvReflectResult ShaderModule::Update(size_t size, const void* p_code) {
+  for (auto& flat_block : m_flat_blocks) {
+    spvReflectDestroyFlatBlock(&flat_block.second);
+  }
+  m_flat_blocks.clear();
+  m_result = spvReflectUpdateShaderModule(
+    &m_module,
+    size,
+    p_code);
+  return m_result;
+}
+
 
 /*! @fn GetShaderModule
 
@@ -1888,6 +3288,17 @@ inline SpvReflectShaderStageFlagBits ShaderModule::GetEntryPointShaderStage(uint
   return m_module.entry_points[index].shader_stage;
 }
 
+/*! @fn GetEntryPointIndex
+
+  @param  entry_point
+  @param  p_result
+  @return Returns the index of the named entry point, or UINT32_MAX
+
+*/
+inline uint32_t ShaderModule::GetEntryPointIndex(const char* entry_point, SpvReflectResult* p_result) const {
+  return spvReflectGetEntryPointIndex(&m_module, entry_point, p_result);
+}
+
 /*! @fn GetShaderStage
 
   @return Returns shader stage for the first entry point
@@ -1939,6 +3350,28 @@ inline SpvReflectResult ShaderModule::EnumerateEntryPointDescriptorBindings(
   return m_result;
 }
 
+/*! @fn EnumerateEntryPointDescriptorBindingsByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  pp_bindings
+  @return
+
+*/
+inline SpvReflectResult ShaderModule::EnumerateEntryPointDescriptorBindingsByIndex(
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectDescriptorBinding** pp_bindings
+) const
+{
+  m_result = spvReflectEnumerateEntryPointDescriptorBindingsByIndex(
+      &m_module,
+      entry_point_index,
+      p_count,
+      pp_bindings);
+  return m_result;
+}
+
 
 /*! @fn EnumerateDescriptorSets
 
@@ -1981,6 +3414,28 @@ inline SpvReflectResult ShaderModule::EnumerateEntryPointDescriptorSets(
   return m_result;
 }
 
+/*! @fn EnumerateEntryPointDescriptorSetsByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  pp_sets
+  @return
+
+*/
+inline SpvReflectResult ShaderModule::EnumerateEntryPointDescriptorSetsByIndex(
+  uint32_t                  entry_point_index,
+  uint32_t*                 p_count,
+  SpvReflectDescriptorSet** pp_sets
+) const
+{
+  m_result = spvReflectEnumerateEntryPointDescriptorSetsByIndex(
+      &m_module,
+      entry_point_index,
+      p_count,
+      pp_sets);
+  return m_result;
+}
+
 
 /*! @fn EnumerateInterfaceVariables
 
@@ -2023,6 +3478,28 @@ inline SpvReflectResult ShaderModule::EnumerateEntryPointInterfaceVariables(
   return m_result;
 }
 
+/*! @fn EnumerateEntryPointInterfaceVariablesByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  pp_variables
+  @return
+
+*/
+inline SpvReflectResult ShaderModule::EnumerateEntryPointInterfaceVariablesByIndex(
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectInterfaceVariable** pp_variables
+) const
+{
+  m_result = spvReflectEnumerateEntryPointInterfaceVariablesByIndex(
+      &m_module,
+      entry_point_index,
+      p_count,
+      pp_variables);
+  return m_result;
+}
+
 
 /*! @fn EnumerateInputVariables
 
@@ -2065,6 +3542,28 @@ inline SpvReflectResult ShaderModule::EnumerateEntryPointInputVariables(
   return m_result;
 }
 
+/*! @fn EnumerateEntryPointInputVariablesByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  pp_variables
+  @return
+
+*/
+inline SpvReflectResult ShaderModule::EnumerateEntryPointInputVariablesByIndex(
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectInterfaceVariable** pp_variables
+) const
+{
+  m_result = spvReflectEnumerateEntryPointInputVariablesByIndex(
+      &m_module,
+      entry_point_index,
+      p_count,
+      pp_variables);
+  return m_result;
+}
+
 
 /*! @fn EnumerateOutputVariables
 
@@ -2107,6 +3606,28 @@ inline SpvReflectResult ShaderModule::EnumerateEntryPointOutputVariables(
   return m_result;
 }
 
+/*! @fn EnumerateEntryPointOutputVariablesByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  pp_variables
+  @return
+
+*/
+inline SpvReflectResult ShaderModule::EnumerateEntryPointOutputVariablesByIndex(
+  uint32_t                      entry_point_index,
+  uint32_t*                     p_count,
+  SpvReflectInterfaceVariable** pp_variables
+) const
+{
+  m_result = spvReflectEnumerateEntryPointOutputVariablesByIndex(
+      &m_module,
+      entry_point_index,
+      p_count,
+      pp_variables);
+  return m_result;
+}
+
 
 /*! @fn EnumeratePushConstantBlocks
 
@@ -2167,6 +3688,28 @@ inline SpvReflectResult ShaderModule::EnumerateEntryPointPushConstantBlocks(
   return m_result;
 }
 
+/*! @fn EnumerateEntryPointPushConstantBlocksByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  pp_blocks
+  @return
+
+*/
+inline SpvReflectResult ShaderModule::EnumerateEntryPointPushConstantBlocksByIndex(
+  uint32_t                  entry_point_index,
+  uint32_t*                 p_count,
+  SpvReflectBlockVariable** pp_blocks
+) const
+{
+  m_result = spvReflectEnumerateEntryPointPushConstantBlocksByIndex(
+      &m_module,
+      entry_point_index,
+      p_count,
+      pp_blocks);
+  return m_result;
+}
+
 
 /*! @fn GetDescriptorBinding
 
@@ -2213,6 +3756,108 @@ inline const SpvReflectDescriptorBinding* ShaderModule::GetEntryPointDescriptorB
     p_result);
 }
 
+/*! @fn GetEntryPointDescriptorBindingByIndex
+
+  @param  entry_point_index
+  @param  binding_number
+  @param  set_number
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectDescriptorBinding* ShaderModule::GetEntryPointDescriptorBindingByIndex(
+  uint32_t          entry_point_index,
+  uint32_t          binding_number,
+  uint32_t          set_number,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetEntryPointDescriptorBindingByIndex(
+    &m_module,
+    entry_point_index,
+    binding_number,
+    set_number,
+    p_result);
+}
+
+/*! @fn GetEntryPointDescriptorBindingArray
+
+  @param  entry_point
+  @param  p_count
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectDescriptorBinding* const* ShaderModule::GetEntryPointDescriptorBindingArray(
+  const char*       entry_point,
+  uint32_t*         p_count,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetEntryPointDescriptorBindingArray(
+    &m_module,
+    entry_point,
+    p_count,
+    p_result);
+}
+
+/*! @fn GetEntryPointDescriptorBindingArrayByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectDescriptorBinding* const* ShaderModule::GetEntryPointDescriptorBindingArrayByIndex(
+  uint32_t          entry_point_index,
+  uint32_t*         p_count,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetEntryPointDescriptorBindingArrayByIndex(
+    &m_module,
+    entry_point_index,
+    p_count,
+    p_result);
+}
+
+/*! @fn GetDescriptorBindingByName
+
+  @param  name
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectDescriptorBinding* ShaderModule::GetDescriptorBindingByName(
+  const char*       name,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetDescriptorBindingByName(
+    &m_module,
+    name,
+    p_result);
+}
+
+/*! @fn GetDescriptorBindingById
+
+  @param  spirv_id
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectDescriptorBinding* ShaderModule::GetDescriptorBindingById(
+  uint32_t          spirv_id,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetDescriptorBindingById(
+    &m_module,
+    spirv_id,
+    p_result);
+}
+
 
 /*! @fn GetDescriptorSet
 
@@ -2253,6 +3898,27 @@ inline const SpvReflectDescriptorSet* ShaderModule::GetEntryPointDescriptorSet(
     p_result);
 }
 
+/*! @fn GetEntryPointDescriptorSetByIndex
+
+  @param  entry_point_index
+  @param  set_number
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectDescriptorSet* ShaderModule::GetEntryPointDescriptorSetByIndex(
+  uint32_t          entry_point_index,
+  uint32_t          set_number,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetEntryPointDescriptorSetByIndex(
+    &m_module,
+    entry_point_index,
+    set_number,
+    p_result);
+}
+
 
 /*! @fn GetInputVariable
 
@@ -2302,6 +3968,27 @@ inline const SpvReflectInterfaceVariable* ShaderModule::GetEntryPointInputVariab
     location,
     p_result);
 }
+
+/*! @fn GetIndexedEntryPointInputVariableByLocation
+
+  @param  entry_point_index
+  @param  location
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectInterfaceVariable* ShaderModule::GetIndexedEntryPointInputVariableByLocation(
+  uint32_t          entry_point_index,
+  uint32_t          location,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetIndexedEntryPointInputVariableByLocation(
+    &m_module,
+    entry_point_index,
+    location,
+    p_result);
+}
 inline const SpvReflectInterfaceVariable* ShaderModule::GetEntryPointInputVariableBySemantic(
   const char*       entry_point,
   const char*       semantic,
@@ -2315,6 +4002,27 @@ inline const SpvReflectInterfaceVariable* ShaderModule::GetEntryPointInputVariab
     p_result);
 }
 
+/*! @fn GetIndexedEntryPointInputVariableBySemantic
+
+  @param  entry_point_index
+  @param  semantic
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectInterfaceVariable* ShaderModule::GetIndexedEntryPointInputVariableBySemantic(
+  uint32_t          entry_point_index,
+  const char*       semantic,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetIndexedEntryPointInputVariableBySemantic(
+    &m_module,
+    entry_point_index,
+    semantic,
+    p_result);
+}
+
 
 /*! @fn GetOutputVariable
 
@@ -2363,6 +4071,27 @@ inline const SpvReflectInterfaceVariable* ShaderModule::GetEntryPointOutputVaria
     location,
     p_result);
 }
+
+/*! @fn GetIndexedEntryPointOutputVariableByLocation
+
+  @param  entry_point_index
+  @param  location
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectInterfaceVariable* ShaderModule::GetIndexedEntryPointOutputVariableByLocation(
+  uint32_t           entry_point_index,
+  uint32_t           location,
+  SpvReflectResult*  p_result
+) const
+{
+  return spvReflectGetIndexedEntryPointOutputVariableByLocation(
+    &m_module,
+    entry_point_index,
+    location,
+    p_result);
+}
 inline const SpvReflectInterfaceVariable* ShaderModule::GetEntryPointOutputVariableBySemantic(
   const char*       entry_point,
   const char*       semantic,
@@ -2376,6 +4105,27 @@ inline const SpvReflectInterfaceVariable* ShaderModule::GetEntryPointOutputVaria
     p_result);
 }
 
+/*! @fn GetIndexedEntryPointOutputVariableBySemantic
+
+  @param  entry_point_index
+  @param  semantic
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectInterfaceVariable* ShaderModule::GetIndexedEntryPointOutputVariableBySemantic(
+  uint32_t          entry_point_index,
+  const char*       semantic,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetIndexedEntryPointOutputVariableBySemantic(
+    &m_module,
+    entry_point_index,
+    semantic,
+    p_result);
+}
+
 
 /*! @fn GetPushConstant
 
@@ -2414,6 +4164,66 @@ inline const SpvReflectBlockVariable* ShaderModule::GetEntryPointPushConstantBlo
     p_result);
 }
 
+/*! @fn GetEntryPointPushConstantBlockByIndex
+
+  @param  entry_point_index
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectBlockVariable* ShaderModule::GetEntryPointPushConstantBlockByIndex(
+  uint32_t           entry_point_index,
+  SpvReflectResult*  p_result
+) const
+{
+  return spvReflectGetEntryPointPushConstantBlockByIndex(
+    &m_module,
+    entry_point_index,
+    p_result);
+}
+
+/*! @fn GetEntryPointPushConstantBlockArray
+
+  @param  entry_point
+  @param  p_count
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectBlockVariable* const* ShaderModule::GetEntryPointPushConstantBlockArray(
+  const char*       entry_point,
+  uint32_t*         p_count,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetEntryPointPushConstantBlockArray(
+    &m_module,
+    entry_point,
+    p_count,
+    p_result);
+}
+
+/*! @fn GetEntryPointPushConstantBlockArrayByIndex
+
+  @param  entry_point_index
+  @param  p_count
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectBlockVariable* const* ShaderModule::GetEntryPointPushConstantBlockArrayByIndex(
+  uint32_t          entry_point_index,
+  uint32_t*         p_count,
+  SpvReflectResult* p_result
+) const
+{
+  return spvReflectGetEntryPointPushConstantBlockArrayByIndex(
+    &m_module,
+    entry_point_index,
+    p_count,
+    p_result);
+}
+
 
 /*! @fn ChangeDescriptorBindingNumbers
 
@@ -2491,6 +4301,53 @@ inline SpvReflectResult ShaderModule::ChangeOutputVariableLocation(
     new_location);
 }
 
+/*! @fn GetBlockMemberByPath
+
+  @param  p_block   A binding's block or a push constant block of this module.
+  @param  path      The member path, e.g. "lights[3].color".
+  @param  p_offset  If not null, receives the member's absolute offset.
+  @param  p_result
+  @return
+
+*/
+inline const SpvReflectFlatBlockMember* ShaderModule::GetBlockMemberByPath(
+  const SpvReflectBlockVariable* p_block,
+  const char*                    path,
+  uint32_t*                      p_offset,
+  SpvReflectResult*              p_result) const
+{
+  if (p_block == nullptr) {
+    if (p_result != nullptr) {
+      *p_result = SPV_REFLECT_RESULT_ERROR_NULL_POINTER;
+    }
+    return nullptr;
+  }
+  SpvReflectFlatBlock* p_flat_block = nullptr;
+  for (auto& flat_block : m_flat_blocks) {
+    if (flat_block.first == p_block) {
+      p_flat_block = &flat_block.second;
+      break;
+    }
+  }
+  if (p_flat_block == nullptr) {
+    SpvReflectFlatBlock flat_block = {};
+    SpvReflectResult result = spvReflectCreateFlatBlock(p_block, &flat_block);
+    if (result != SPV_REFLECT_RESULT_SUCCESS) {
+      if (p_result != nullptr) {
+        *p_result = result;
+      }
+      return nullptr;
+    }
+    m_flat_blocks.emplace_back(p_block, flat_block);
+    p_flat_block = &m_flat_blocks.back().second;
+  }
+  return spvReflectGetFlatBlockMemberByPath(
+    p_flat_block,
+    path,
+    p_offset,
+    p_result);
+}
+
 } // namespace spv_reflect
 #endif // defined(__cplusplus) && !defined(SPIRV_REFLECT_DISABLE_CPP_WRAPPER)
 #endif // SPIRV_REFLECT_H
@@ -1,9 +1,14 @@
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <regex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include "../common/output_stream.h"
 #include "gtest/gtest.h"
@@ -11,8 +16,10 @@
 
 #if defined(_MSC_VER)
 #include <direct.h>
+#include <io.h>
 #define posix_chdir(d) _chdir(d)
 #else
+#include <dirent.h>
 #include <unistd.h>
 #define posix_chdir(d) chdir(d)
 #endif
@@ -169,6 +176,109 @@ TEST_P(SpirvReflectTest, GetDescriptorBinding) {
     EXPECT_EQ(db, also_db);
   }
 }
+TEST_P(SpirvReflectTest, GetDescriptorBindingByNameAndId) {
+  for (uint32_t i = 0; i < module_.descriptor_binding_count; ++i) {
+    const SpvReflectDescriptorBinding* db = &module_.descriptor_bindings[i];
+    SpvReflectResult result;
+    EXPECT_EQ(db, spvReflectGetDescriptorBindingById(&module_, db->spirv_id,
+                                                     &result));
+    EXPECT_EQ(result, SPV_REFLECT_RESULT_SUCCESS);
+
+    if (db->name == nullptr) {
+      continue;
+    }
+    // Names may be shared (or empty), the first binding with the name wins.
+    const SpvReflectDescriptorBinding* first = db;
+    for (uint32_t j = 0; j < i; ++j) {
+      const char* name = module_.descriptor_bindings[j].name;
+      if (name != nullptr && strcmp(name, db->name) == 0) {
+        first = &module_.descriptor_bindings[j];
+        break;
+      }
+    }
+    EXPECT_EQ(first,
+              spvReflectGetDescriptorBindingByName(&module_, db->name, &result));
+    EXPECT_EQ(result, SPV_REFLECT_RESULT_SUCCESS);
+  }
+}
+TEST_P(SpirvReflectTest, GetDescriptorBindingByNameAndId_Errors) {
+  SpvReflectResult result;
+  EXPECT_EQ(spvReflectGetDescriptorBindingByName(nullptr, "a", &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_NULL_POINTER);
+  EXPECT_EQ(spvReflectGetDescriptorBindingByName(&module_, nullptr, &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_NULL_POINTER);
+  EXPECT_EQ(spvReflectGetDescriptorBindingByName(
+                &module_, "not a binding name", &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  EXPECT_EQ(spvReflectGetDescriptorBindingById(nullptr, 1, &result), nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_NULL_POINTER);
+  EXPECT_EQ(spvReflectGetDescriptorBindingById(&module_, 0xdeadbeef, &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+}
+TEST_P(SpirvReflectTest, GetEntryPointResourceArrays) {
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    const char* entry_point = module_.entry_points[i].name;
+
+    uint32_t count = 0;
+    ASSERT_EQ(spvReflectEnumerateEntryPointDescriptorBindings(
+                  &module_, entry_point, &count, nullptr),
+              SPV_REFLECT_RESULT_SUCCESS);
+    std::vector<SpvReflectDescriptorBinding*> bindings(count);
+    ASSERT_EQ(spvReflectEnumerateEntryPointDescriptorBindings(
+                  &module_, entry_point, &count, bindings.data()),
+              SPV_REFLECT_RESULT_SUCCESS);
+    uint32_t array_count = 0;
+    SpvReflectResult result = SPV_REFLECT_RESULT_NOT_READY;
+    const SpvReflectDescriptorBinding* const* binding_array =
+        spvReflectGetEntryPointDescriptorBindingArrayByIndex(
+            &module_, i, &array_count, &result);
+    ASSERT_EQ(result, SPV_REFLECT_RESULT_SUCCESS);
+    ASSERT_EQ(array_count, count);
+    for (uint32_t j = 0; j < count; ++j) {
+      EXPECT_EQ(binding_array[j], bindings[j]);
+    }
+
+    ASSERT_EQ(spvReflectEnumerateEntryPointPushConstantBlocks(
+                  &module_, entry_point, &count, nullptr),
+              SPV_REFLECT_RESULT_SUCCESS);
+    std::vector<SpvReflectBlockVariable*> blocks(count);
+    ASSERT_EQ(spvReflectEnumerateEntryPointPushConstantBlocks(
+                  &module_, entry_point, &count, blocks.data()),
+              SPV_REFLECT_RESULT_SUCCESS);
+    const SpvReflectBlockVariable* const* block_array =
+        spvReflectGetEntryPointPushConstantBlockArray(&module_, entry_point,
+                                                      &array_count, &result);
+    ASSERT_EQ(result, SPV_REFLECT_RESULT_SUCCESS);
+    ASSERT_EQ(array_count, count);
+    for (uint32_t j = 0; j < count; ++j) {
+      EXPECT_EQ(block_array[j], blocks[j]);
+    }
+  }
+}
+TEST_P(SpirvReflectTest, GetEntryPointResourceArrays_Errors) {
+  uint32_t count = 0;
+  SpvReflectResult result;
+  EXPECT_EQ(spvReflectGetEntryPointDescriptorBindingArray(
+                nullptr, module_.entry_point_name, &count, &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_NULL_POINTER);
+  EXPECT_EQ(spvReflectGetEntryPointDescriptorBindingArray(
+                &module_, module_.entry_point_name, nullptr, &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_NULL_POINTER);
+  EXPECT_EQ(spvReflectGetEntryPointDescriptorBindingArray(
+                &module_, "not an entry point", &count, &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  EXPECT_EQ(spvReflectGetEntryPointPushConstantBlockArrayByIndex(
+                &module_, module_.entry_point_count, &count, &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+}
 TEST_P(SpirvReflectTest, EnumerateDescriptorBindings_Errors) {
   uint32_t binding_count = 0;
   // NULL module
@@ -670,6 +780,559 @@ TEST_P(SpirvReflectTest, ChangeDescriptorSetNumber_Errors) {
             SPV_REFLECT_RESULT_ERROR_NULL_POINTER);
 }
 
+TEST_P(SpirvReflectTest, ProgramAddModule) {
+  SpvReflectProgram program;
+  ASSERT_EQ(spvReflectCreateProgram(&program), SPV_REFLECT_RESULT_SUCCESS);
+  ASSERT_EQ(spvReflectProgramAddModule(&program, &module_),
+            SPV_REFLECT_RESULT_SUCCESS);
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    const SpvReflectEntryPoint& entry = module_.entry_points[i];
+    EXPECT_EQ(program.stage_flags & entry.shader_stage,
+              (uint32_t)entry.shader_stage);
+    uint32_t count = 0;
+    const SpvReflectDescriptorBinding* const* bindings =
+        spvReflectGetEntryPointDescriptorBindingArrayByIndex(&module_, i,
+                                                             &count, nullptr);
+    for (uint32_t j = 0; j < count; ++j) {
+      SpvReflectResult result;
+      const SpvReflectProgramDescriptorSet* set =
+          spvReflectProgramGetDescriptorSet(&program, bindings[j]->set,
+                                            &result);
+      ASSERT_EQ(result, SPV_REFLECT_RESULT_SUCCESS);
+      const SpvReflectProgramBinding* merged = nullptr;
+      for (uint32_t k = 0; k < set->binding_count; ++k) {
+        if (set->bindings[k].binding == bindings[j]->binding) {
+          merged = &set->bindings[k];
+        }
+      }
+      ASSERT_NE(merged, nullptr);
+      EXPECT_EQ(merged->stage_flags & entry.shader_stage,
+                (uint32_t)entry.shader_stage);
+      if (bindings[j]->count == 0) {
+        EXPECT_EQ(merged->count, 0u);
+      } else if (merged->count != 0) {
+        EXPECT_GE(merged->count, bindings[j]->count);
+      }
+    }
+  }
+  for (uint32_t i = 0; i < program.descriptor_set_count; ++i) {
+    if (i > 0) {
+      EXPECT_LT(program.descriptor_sets[i - 1].set,
+                program.descriptor_sets[i].set);
+    }
+    const SpvReflectProgramDescriptorSet& set = program.descriptor_sets[i];
+    for (uint32_t j = 1; j < set.binding_count; ++j) {
+      EXPECT_LT(set.bindings[j - 1].binding, set.bindings[j].binding);
+    }
+  }
+  uint32_t range_stages = 0;
+  for (uint32_t i = 0; i < program.push_constant_range_count; ++i) {
+    EXPECT_EQ(range_stages & program.push_constant_ranges[i].stage_flags, 0u);
+    range_stages |= program.push_constant_ranges[i].stage_flags;
+    EXPECT_GT(program.push_constant_ranges[i].size, 0u);
+  }
+  spvReflectDestroyProgram(&program);
+}
+
+TEST_P(SpirvReflectTest, DescriptorSetLayouts) {
+  const SpvReflectShaderModule* modules[] = {&module_};
+  SpvReflectDescriptorSetLayouts layouts;
+  ASSERT_EQ(spvReflectCreateDescriptorSetLayouts(1, modules, &layouts),
+            SPV_REFLECT_RESULT_SUCCESS);
+  uint32_t use_count = 0;
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    use_count += module_.entry_points[i].descriptor_set_count;
+  }
+  ASSERT_EQ(layouts.use_count, use_count);
+  EXPECT_LE(layouts.layout_count, layouts.use_count);
+  for (uint32_t i = 0; i < layouts.use_count; ++i) {
+    const SpvReflectDescriptorSetLayoutUse& use = layouts.uses[i];
+    ASSERT_EQ(use.module_index, 0u);
+    ASSERT_LT(use.entry_point_index, module_.entry_point_count);
+    ASSERT_LT(use.layout_index, layouts.layout_count);
+    const SpvReflectEntryPoint& entry =
+        module_.entry_points[use.entry_point_index];
+    const SpvReflectDescriptorSet* set = nullptr;
+    for (uint32_t j = 0; j < entry.descriptor_set_count; ++j) {
+      if (entry.descriptor_sets[j].set == use.set) {
+        set = &entry.descriptor_sets[j];
+      }
+    }
+    ASSERT_NE(set, nullptr);
+    const SpvReflectDescriptorSetLayout& layout =
+        layouts.layouts[use.layout_index];
+    for (uint32_t j = 0; j < set->binding_count; ++j) {
+      const SpvReflectProgramBinding* p_binding = nullptr;
+      for (uint32_t k = 0; k < layout.binding_count; ++k) {
+        if (layout.bindings[k].binding == set->bindings[j]->binding) {
+          p_binding = &layout.bindings[k];
+        }
+      }
+      ASSERT_NE(p_binding, nullptr);
+      EXPECT_NE(p_binding->stage_flags & (uint32_t)entry.shader_stage, 0u);
+    }
+  }
+  uint32_t aliased_count = 0;
+  for (uint32_t i = 0; i < layouts.layout_count; ++i) {
+    const SpvReflectDescriptorSetLayout& layout = layouts.layouts[i];
+    for (uint32_t j = 1; j < layout.binding_count; ++j) {
+      const SpvReflectProgramBinding& prev = layout.bindings[j - 1];
+      const SpvReflectProgramBinding& next = layout.bindings[j];
+      EXPECT_LE(prev.binding, next.binding);
+      if (prev.binding == next.binding) {
+        EXPECT_LT(prev.descriptor_type, next.descriptor_type);
+        aliased_count += 1;
+      }
+    }
+  }
+  // A layout shared by several sets reports its conflicts once per set
+  EXPECT_LE(aliased_count, layouts.conflict_count);
+  EXPECT_EQ(aliased_count == 0, layouts.conflict_count == 0);
+  spvReflectDestroyDescriptorSetLayouts(&layouts);
+}
+
+TEST_P(SpirvReflectTest, DescriptorPoolSizes) {
+  const uint32_t kRuntimeArraySize = 16;
+  SpvReflectDescriptorPoolSizes pool_sizes = {};
+  ASSERT_EQ(spvReflectDescriptorPoolSizesAddModule(&pool_sizes, &module_,
+                                                   kRuntimeArraySize),
+            SPV_REFLECT_RESULT_SUCCESS);
+  EXPECT_EQ(pool_sizes.max_sets, module_.descriptor_set_count);
+
+  std::map<SpvReflectDescriptorType, uint32_t> expected;
+  for (uint32_t i = 0; i < module_.descriptor_set_count; ++i) {
+    const SpvReflectDescriptorSet& set = module_.descriptor_sets[i];
+    std::set<uint32_t> binding_numbers;
+    for (uint32_t j = 0; j < set.binding_count; ++j) {
+      const SpvReflectDescriptorBinding* binding = set.bindings[j];
+      if (binding_numbers.insert(binding->binding).second) {
+        expected[binding->descriptor_type] +=
+            binding->count == 0 ? kRuntimeArraySize : binding->count;
+      }
+    }
+  }
+  ASSERT_EQ(pool_sizes.pool_size_count, expected.size());
+  for (uint32_t i = 0; i < pool_sizes.pool_size_count; ++i) {
+    EXPECT_EQ(pool_sizes.pool_sizes[i].descriptor_count,
+              expected[pool_sizes.pool_sizes[i].type]);
+  }
+
+  SpvReflectDescriptorPoolSizes entry_pool_sizes = {};
+  uint32_t set_count = 0;
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    ASSERT_EQ(spvReflectDescriptorPoolSizesAddEntryPoint(
+                  &entry_pool_sizes, &module_, module_.entry_points[i].name,
+                  kRuntimeArraySize),
+              SPV_REFLECT_RESULT_SUCCESS);
+    set_count += module_.entry_points[i].descriptor_set_count;
+  }
+  EXPECT_EQ(entry_pool_sizes.max_sets, set_count);
+}
+
+TEST_P(SpirvReflectTest, VertexInputLayout) {
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    const SpvReflectEntryPoint& entry = module_.entry_points[i];
+    if (entry.shader_stage != SPV_REFLECT_SHADER_STAGE_VERTEX_BIT) {
+      continue;
+    }
+    SpvReflectVertexInputLayout layout;
+    SpvReflectResult result = spvReflectComputeVertexInputLayout(
+        &module_, entry.name, SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED,
+        0, nullptr, &layout);
+    if (result == SPV_REFLECT_RESULT_ERROR_RANGE_EXCEEDED) {
+      continue;
+    }
+    ASSERT_EQ(result, SPV_REFLECT_RESULT_SUCCESS);
+    ASSERT_LE(layout.binding_count, 1u);
+    uint32_t end = 0;
+    for (uint32_t j = 0; j < layout.attribute_count; ++j) {
+      const SpvReflectVertexInputAttribute& attribute = layout.attributes[j];
+      if (j > 0) {
+        EXPECT_LT(layout.attributes[j - 1].location, attribute.location);
+      }
+      EXPECT_EQ(attribute.binding, 0u);
+      EXPECT_GE(attribute.offset, end);
+      end = attribute.offset + spvReflectFormatSize(attribute.format);
+    }
+    if (layout.attribute_count > 0) {
+      EXPECT_GE(layout.bindings[0].stride, end);
+    }
+
+    SpvReflectVertexInputLayout streams;
+    ASSERT_EQ(spvReflectComputeVertexInputLayout(
+                  &module_, entry.name,
+                  SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_DEINTERLEAVED, 0,
+                  nullptr, &streams),
+              SPV_REFLECT_RESULT_SUCCESS);
+    ASSERT_EQ(streams.attribute_count, layout.attribute_count);
+    ASSERT_EQ(streams.binding_count, streams.attribute_count);
+    for (uint32_t j = 0; j < streams.attribute_count; ++j) {
+      EXPECT_EQ(streams.attributes[j].binding, j);
+      EXPECT_EQ(streams.attributes[j].offset, 0u);
+      EXPECT_EQ(streams.bindings[j].stride,
+                spvReflectFormatSize(streams.attributes[j].format));
+    }
+  }
+}
+
+TEST_P(SpirvReflectTest, CheckStageInterface) {
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    const char* entry_point = module_.entry_points[i].name;
+    uint32_t count = 0;
+    ASSERT_EQ(spvReflectCheckStageInterface(&module_, entry_point, &module_,
+                                            entry_point, &count, nullptr),
+              SPV_REFLECT_RESULT_SUCCESS);
+    std::vector<SpvReflectInterfaceMismatch> mismatches(count);
+    ASSERT_EQ(spvReflectCheckStageInterface(&module_, entry_point, &module_,
+                                            entry_point, &count,
+                                            mismatches.data()),
+              SPV_REFLECT_RESULT_SUCCESS);
+    for (uint32_t j = 0; j < count; ++j) {
+      const SpvReflectInterfaceMismatch& mismatch = mismatches[j];
+      if (mismatch.type == SPV_REFLECT_INTERFACE_MISMATCH_UNUSED_OUTPUT) {
+        ASSERT_NE(mismatch.output_variable, nullptr);
+        EXPECT_EQ(mismatch.input_variable, nullptr);
+        EXPECT_EQ(mismatch.location, mismatch.output_variable->location);
+      } else {
+        ASSERT_NE(mismatch.input_variable, nullptr);
+      }
+      if (j > 0 && mismatch.type == mismatches[j - 1].type &&
+          mismatch.type != SPV_REFLECT_INTERFACE_MISMATCH_MISSING_BUILT_IN) {
+        EXPECT_LE(mismatches[j - 1].location, mismatch.location);
+      }
+    }
+    if (count > 0) {
+      uint32_t wrong_count = count - 1;
+      EXPECT_EQ(spvReflectCheckStageInterface(&module_, entry_point, &module_,
+                                              entry_point, &wrong_count,
+                                              mismatches.data()),
+                SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH);
+    }
+  }
+}
+
+static void CheckFlatBlock(const SpvReflectBlockVariable& block) {
+  SpvReflectFlatBlock flat_block;
+  ASSERT_EQ(spvReflectCreateFlatBlock(&block, &flat_block),
+            SPV_REFLECT_RESULT_SUCCESS);
+  for (uint32_t i = 0; i < flat_block.member_count; ++i) {
+    const SpvReflectFlatBlockMember& member = flat_block.members[i];
+    ASSERT_NE(member.path, nullptr);
+    ASSERT_NE(member.member, nullptr);
+    if ((member.type_flags & SPV_REFLECT_TYPE_FLAG_REF) == 0) {
+      EXPECT_EQ(member.member->member_count, 0u);
+    }
+    EXPECT_EQ(member.size, member.member->size);
+    EXPECT_EQ(member.array_count == 1, member.array_stride == 0);
+    if (block.padded_size > 0 && member.array_count > 0) {
+      EXPECT_LE(member.absolute_offset + member.size, block.padded_size)
+          << member.path;
+    }
+    if (i > 0 && member.path[0] != '\0') {
+      EXPECT_STRNE(member.path, flat_block.members[i - 1].path);
+    }
+    uint32_t offset = 0;
+    const SpvReflectFlatBlockMember* p_found =
+        spvReflectGetFlatBlockMemberByPath(&flat_block, member.path, &offset,
+                                           nullptr);
+    ASSERT_NE(p_found, nullptr);
+    EXPECT_STREQ(p_found->path, member.path);
+    EXPECT_EQ(offset, p_found->absolute_offset);
+  }
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  EXPECT_EQ(spvReflectGetFlatBlockMemberByPath(&flat_block, "\x01missing",
+                                               nullptr, &result),
+            nullptr);
+  EXPECT_EQ(result, SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND);
+  spvReflectDestroyFlatBlock(&flat_block);
+}
+
+TEST_P(SpirvReflectTest, FlatBlock) {
+  for (uint32_t i = 0; i < module_.descriptor_binding_count; ++i) {
+    const SpvReflectDescriptorBinding& binding =
+        module_.descriptor_bindings[i];
+    if (binding.descriptor_type ==
+        SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+      CheckFlatBlock(binding.block);
+    }
+  }
+  for (uint32_t i = 0; i < module_.push_constant_block_count; ++i) {
+    CheckFlatBlock(module_.push_constant_blocks[i]);
+  }
+  EXPECT_EQ(spvReflectCreateFlatBlock(nullptr, nullptr),
+            SPV_REFLECT_RESULT_ERROR_NULL_POINTER);
+}
+
+// Runtime-sized arrays have no fixed layout, and arrays sized by
+// OpSpecConstantOp report a length that disagrees with their size.
+static bool HasUnsizedArray(const SpvReflectBlockVariable& block) {
+  for (uint32_t i = 0; i < block.member_count; ++i) {
+    const SpvReflectBlockVariable& member = block.members[i];
+    uint32_t element_count = 1;
+    for (uint32_t j = 0; j < member.array.dims_count; ++j) {
+      element_count *= member.array.dims[j];
+    }
+    if (member.array.dims_count > 0 &&
+        (element_count == 0 ||
+         element_count * member.array.stride != member.size)) {
+      return true;
+    }
+    bool is_reference =
+        member.type_description != nullptr &&
+        (member.type_description->type_flags & SPV_REFLECT_TYPE_FLAG_REF);
+    if (member.member_count > 0 && !is_reference && HasUnsizedArray(member)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Packs two instances with the plan and checks every host component landed
+// where the flat block says it belongs.
+static void CheckPackPlan(const SpvReflectBlockVariable& block) {
+  SpvReflectPackPlan plan;
+  ASSERT_EQ(spvReflectCreatePackPlan(&block, &plan),
+            SPV_REFLECT_RESULT_SUCCESS);
+  uint32_t copied_size = 0;
+  for (uint32_t i = 0; i < plan.op_count; ++i) {
+    const SpvReflectPackOp& op = plan.ops[i];
+    uint32_t last_run = op.count - 1;
+    EXPECT_LE(op.src_offset + last_run * op.src_stride + op.size,
+              plan.host_size);
+    EXPECT_LE(op.dst_offset + last_run * op.dst_stride + op.size,
+              plan.device_size);
+    if (i > 0) {
+      EXPECT_LT(plan.ops[i - 1].src_offset, op.src_offset);
+    }
+    copied_size += op.count * op.size;
+  }
+  EXPECT_EQ(copied_size, plan.host_size);
+
+  if (HasUnsizedArray(block) || plan.host_size == 0) {
+    spvReflectDestroyPackPlan(&plan);
+    return;
+  }
+  const uint32_t instance_count = 2;
+  std::vector<uint8_t> host(plan.host_size * instance_count);
+  for (size_t i = 0; i < host.size(); ++i) {
+    host[i] = static_cast<uint8_t>(i * 7 + 1);
+  }
+  std::vector<uint8_t> device(plan.device_size * instance_count, 0);
+  ASSERT_EQ(spvReflectExecutePackPlan(&plan, instance_count, host.data(), 0,
+                                      device.data(), 0),
+            SPV_REFLECT_RESULT_SUCCESS);
+
+  SpvReflectFlatBlock flat_block;
+  ASSERT_EQ(spvReflectCreateFlatBlock(&block, &flat_block),
+            SPV_REFLECT_RESULT_SUCCESS);
+  uint32_t host_offset = 0;
+  for (uint32_t i = 0; i < flat_block.member_count; ++i) {
+    const SpvReflectFlatBlockMember& member = flat_block.members[i];
+    uint32_t component_size = member.numeric.scalar.width / 8;
+    if (member.type_flags & SPV_REFLECT_TYPE_FLAG_REF) {
+      component_size = 8;
+    } else if (component_size == 0) {
+      component_size = 4;
+    }
+    bool is_matrix = (member.type_flags & SPV_REFLECT_TYPE_FLAG_MATRIX) &&
+                     !(member.type_flags & SPV_REFLECT_TYPE_FLAG_REF);
+    uint32_t column_count =
+        is_matrix ? member.numeric.matrix.column_count : 1;
+    uint32_t row_count = is_matrix
+                             ? member.numeric.matrix.row_count
+                             : std::max(member.numeric.vector.component_count,
+                                        1u);
+    bool row_major =
+        (member.decoration_flags & SPV_REFLECT_DECORATION_ROW_MAJOR) != 0;
+    for (uint32_t element = 0; element < member.array_count; ++element) {
+      for (uint32_t column = 0; column < column_count; ++column) {
+        for (uint32_t row = 0; row < row_count; ++row) {
+          uint32_t device_offset =
+              member.absolute_offset + element * member.array_stride;
+          if (!is_matrix) {
+            device_offset += row * component_size;
+          } else if (row_major) {
+            device_offset += row * member.numeric.matrix.stride +
+                             column * component_size;
+          } else {
+            device_offset += column * member.numeric.matrix.stride +
+                             row * component_size;
+          }
+          for (uint32_t instance = 0; instance < instance_count; ++instance) {
+            ASSERT_EQ(0, memcmp(&device[instance * plan.device_size +
+                                        device_offset],
+                                &host[instance * plan.host_size + host_offset],
+                                component_size))
+                << member.path;
+          }
+          host_offset += component_size;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(host_offset, plan.host_size);
+  spvReflectDestroyFlatBlock(&flat_block);
+  spvReflectDestroyPackPlan(&plan);
+}
+
+TEST_P(SpirvReflectTest, PackPlan) {
+  for (uint32_t i = 0; i < module_.descriptor_binding_count; ++i) {
+    const SpvReflectDescriptorBinding& binding =
+        module_.descriptor_bindings[i];
+    if (binding.descriptor_type ==
+            SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+        binding.descriptor_type ==
+            SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+      CheckPackPlan(binding.block);
+    }
+  }
+  for (uint32_t i = 0; i < module_.push_constant_block_count; ++i) {
+    CheckPackPlan(module_.push_constant_blocks[i]);
+  }
+}
+
+TEST_P(SpirvReflectTest, DescriptorUpdateTemplate) {
+  const uint32_t runtime_array_size = 3;
+  for (uint32_t i = 0; i < module_.descriptor_set_count; ++i) {
+    const SpvReflectDescriptorSet& set = module_.descriptor_sets[i];
+    uint32_t count = 0;
+    ASSERT_EQ(spvReflectEnumerateDescriptorUpdateTemplateEntries(
+                  &set, nullptr, runtime_array_size, &count, nullptr,
+                  nullptr),
+              SPV_REFLECT_RESULT_SUCCESS);
+    std::vector<SpvReflectDescriptorUpdateTemplateEntry> entries(count);
+    uint32_t data_size = 0;
+    ASSERT_EQ(spvReflectEnumerateDescriptorUpdateTemplateEntries(
+                  &set, nullptr, runtime_array_size, &count, entries.data(),
+                  &data_size),
+              SPV_REFLECT_RESULT_SUCCESS);
+
+    std::set<uint32_t> binding_numbers;
+    for (uint32_t j = 0; j < set.binding_count; ++j) {
+      binding_numbers.insert(set.bindings[j]->binding);
+    }
+    EXPECT_EQ(count, binding_numbers.size());
+    uint32_t end = 0;
+    for (const SpvReflectDescriptorUpdateTemplateEntry& entry : entries) {
+      EXPECT_EQ(binding_numbers.count(entry.binding), 1u);
+      EXPECT_GT(entry.descriptor_count, 0u);
+      EXPECT_GE(entry.offset, end);
+      EXPECT_EQ(entry.offset % 8, 0u);
+      end = entry.offset + entry.descriptor_count * entry.stride;
+      if (&entry != &entries[0]) {
+        EXPECT_LT((&entry - 1)->binding, entry.binding);
+      }
+    }
+    EXPECT_LE(end, data_size);
+
+    if (count > 0) {
+      uint32_t wrong_count = count + 1;
+      EXPECT_EQ(spvReflectEnumerateDescriptorUpdateTemplateEntries(
+                    &set, nullptr, runtime_array_size, &wrong_count,
+                    entries.data(), nullptr),
+                SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH);
+    }
+  }
+}
+
+TEST_P(SpirvReflectTest, WriteCppHeader) {
+  std::stringstream header;
+  WriteCppHeader(module_, "shader", "", header);
+  const std::string text = header.str();
+  // The first line must be a comment or the header does not compile.
+  EXPECT_EQ(text.rfind("// Generated by spirv-reflect --emit-cpp. Do not edit.\n"
+                       "#pragma once\n",
+                       0),
+            0u);
+  EXPECT_NE(text.find("namespace shader {"), std::string::npos);
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    const char* entry_point = module_.entry_points[i].name;
+    EXPECT_NE(text.find(std::string("constexpr const char* kName = \"") +
+                        entry_point + "\";"),
+              std::string::npos);
+    uint32_t binding_count = 0;
+    ASSERT_EQ(spvReflectEnumerateEntryPointDescriptorBindings(
+                  &module_, entry_point, &binding_count, nullptr),
+              SPV_REFLECT_RESULT_SUCCESS);
+    EXPECT_NE(text.find("constexpr uint32_t kDescriptorBindingCount = " +
+                        std::to_string(binding_count) + ";"),
+              std::string::npos);
+  }
+}
+
+static const SpvReflectInterfaceVariable* FindLastVariable(
+    SpvReflectInterfaceVariable* const* variables, uint32_t count,
+    uint32_t location, const char* semantic) {
+  const SpvReflectInterfaceVariable* p_var = nullptr;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (semantic == nullptr ? variables[i]->location == location
+                            : (variables[i]->semantic != nullptr &&
+                               strcmp(variables[i]->semantic, semantic) == 0)) {
+      p_var = variables[i];
+    }
+  }
+  return p_var;
+}
+TEST_P(SpirvReflectTest, GetVariableByLocationAndSemantic) {
+  SpvReflectResult result;
+  for (uint32_t i = 0; i < module_.entry_point_count; ++i) {
+    const SpvReflectEntryPoint& entry = module_.entry_points[i];
+    for (uint32_t j = 0; j < entry.input_variable_count; ++j) {
+      const SpvReflectInterfaceVariable* p_var = entry.input_variables[j];
+      if (p_var->location != UINT32_MAX) {
+        EXPECT_EQ(spvReflectGetEntryPointInputVariableByLocation(
+                      &module_, entry.name, p_var->location, &result),
+                  FindLastVariable(entry.input_variables,
+                                   entry.input_variable_count,
+                                   p_var->location, nullptr));
+      }
+      if (p_var->semantic != nullptr && p_var->semantic[0] != '\0') {
+        EXPECT_EQ(spvReflectGetIndexedEntryPointInputVariableBySemantic(
+                      &module_, i, p_var->semantic, &result),
+                  FindLastVariable(entry.input_variables,
+                                   entry.input_variable_count, 0,
+                                   p_var->semantic));
+      }
+    }
+    for (uint32_t j = 0; j < entry.output_variable_count; ++j) {
+      const SpvReflectInterfaceVariable* p_var = entry.output_variables[j];
+      if (p_var->location != UINT32_MAX) {
+        EXPECT_EQ(spvReflectGetIndexedEntryPointOutputVariableByLocation(
+                      &module_, i, p_var->location, &result),
+                  FindLastVariable(entry.output_variables,
+                                   entry.output_variable_count,
+                                   p_var->location, nullptr));
+      }
+      if (p_var->semantic != nullptr && p_var->semantic[0] != '\0') {
+        EXPECT_EQ(spvReflectGetEntryPointOutputVariableBySemantic(
+                      &module_, entry.name, p_var->semantic, &result),
+                  FindLastVariable(entry.output_variables,
+                                   entry.output_variable_count, 0,
+                                   p_var->semantic));
+      }
+    }
+  }
+  for (uint32_t j = 0; j < module_.input_variable_count; ++j) {
+    const SpvReflectInterfaceVariable* p_var = module_.input_variables[j];
+    if (p_var->location != UINT32_MAX) {
+      EXPECT_EQ(spvReflectGetInputVariableByLocation(&module_, p_var->location,
+                                                     &result),
+                FindLastVariable(module_.input_variables,
+                                 module_.input_variable_count,
+                                 p_var->location, nullptr));
+    }
+  }
+  for (uint32_t j = 0; j < module_.output_variable_count; ++j) {
+    const SpvReflectInterfaceVariable* p_var = module_.output_variables[j];
+    if (p_var->semantic != nullptr && p_var->semantic[0] != '\0') {
+      EXPECT_EQ(spvReflectGetOutputVariableBySemantic(
+                    &module_, p_var->semantic, &result),
+                FindLastVariable(module_.output_variables,
+                                 module_.output_variable_count, 0,
+                                 p_var->semantic));
+    }
+  }
+}
 TEST_P(SpirvReflectTest, ChangeInputVariableLocation) {
   uint32_t iv_count = 0;
   SpvReflectResult result;
@@ -791,6 +1454,307 @@ TEST_P(SpirvReflectTest, CheckYamlOutput) {
          "\"tests/build_golden_yaml.py\" and see what changed.";
 }
 
+TEST_P(SpirvReflectTest, DiffShaderModulesIdentical) {
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv_.size(), spirv_.data(),
+                                         &module));
+  SpvReflectModuleDiff diff;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectDiffShaderModules(&module_, &module, &diff));
+  EXPECT_EQ(diff.change_count, 0u);
+  EXPECT_EQ(diff.rebuild_flags,
+            static_cast<uint32_t>(SPV_REFLECT_MODULE_REBUILD_NONE));
+  spvReflectDestroyModuleDiff(&diff);
+  spvReflectDestroyShaderModule(&module);
+}
+
+// Minimal JSON grammar check; advances p past one value.
+static bool SkipJsonValue(const char*& p) {
+  if (*p == '{' || *p == '[') {
+    const char close = (*p == '{') ? '}' : ']';
+    const bool is_object = (*p == '{');
+    ++p;
+    if (*p == close) {
+      ++p;
+      return true;
+    }
+    for (;;) {
+      if (is_object) {
+        if (*p != '"' || !SkipJsonValue(p) || *p++ != ':') {
+          return false;
+        }
+      }
+      if (!SkipJsonValue(p)) {
+        return false;
+      }
+      if (*p == close) {
+        ++p;
+        return true;
+      }
+      if (*p++ != ',') {
+        return false;
+      }
+    }
+  }
+  if (*p == '"') {
+    for (++p; *p != '"'; ++p) {
+      if (*p == '\0' || static_cast<unsigned char>(*p) < 0x20) {
+        return false;
+      }
+      if (*p == '\\' && *++p == '\0') {
+        return false;
+      }
+    }
+    ++p;
+    return true;
+  }
+  if (strncmp(p, "null", 4) == 0) {
+    p += 4;
+    return true;
+  }
+  const char* start = p;
+  if (*p == '-') {
+    ++p;
+  }
+  while (*p >= '0' && *p <= '9') {
+    ++p;
+  }
+  return p > start && p[-1] != '-';
+}
+
+TEST_P(SpirvReflectTest, CheckJsonOutput) {
+  for (uint32_t verbosity = 0; verbosity <= 2; ++verbosity) {
+    SpvReflectToJson jsonizer(module_, verbosity);
+    std::stringstream json;
+    json << jsonizer;
+    const std::string json_str = json.str();
+    const char* p = json_str.c_str();
+    EXPECT_TRUE(SkipJsonValue(p)) << "verbosity " << verbosity << " at offset "
+                                  << (p - json_str.c_str());
+    EXPECT_STREQ(p, "\n");
+    EXPECT_EQ(json_str.find("{\"schema_version\":1,"), 0u);
+    EXPECT_EQ(json_str.find("\"type_descriptions\":") != std::string::npos,
+              verbosity >= 1);
+  }
+}
+
+// Runs every task on its own thread.
+static void ThreadParallelFor(void* /*p_user_data*/, uint32_t task_count,
+                              SpvReflectTaskFunction p_task,
+                              void* p_task_data) {
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < task_count; ++i) {
+    threads.emplace_back(p_task, p_task_data, i);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST_P(SpirvReflectTest, CreateShaderModuleWithScheduler) {
+  SpvReflectTaskScheduler scheduler = {nullptr, ThreadParallelFor};
+  SpvReflectShaderModule scheduled_module;
+  SpvReflectResult result = spvReflectCreateShaderModule3(
+      SPV_REFLECT_MODULE_FLAG_NONE, spirv_.size(), spirv_.data(), &scheduler,
+      &scheduled_module);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, result);
+
+  const uint32_t yaml_verbosity = 2;
+  SpvReflectToYaml serial_yamlizer(module_, yaml_verbosity);
+  std::stringstream serial_yaml;
+  serial_yaml << serial_yamlizer;
+  SpvReflectToYaml scheduled_yamlizer(scheduled_module, yaml_verbosity);
+  std::stringstream scheduled_yaml;
+  scheduled_yaml << scheduled_yamlizer;
+  EXPECT_EQ(serial_yaml.str(), scheduled_yaml.str());
+
+  spvReflectDestroyShaderModule(&scheduled_module);
+}
+
+// Repeats the first OpCapability and adds an OpNop after the first OpLabel:
+// every later section moves, but only the function bodies change.
+static std::vector<uint32_t> ShiftAndEditFunctions(
+    const std::vector<uint8_t>& spirv) {
+  std::vector<uint32_t> words(spirv.size() / 4);
+  memcpy(words.data(), spirv.data(), words.size() * 4);
+  std::vector<uint32_t> edited(words.begin(), words.begin() + 5);
+  bool repeated_capability = false;
+  bool added_nop = false;
+  for (size_t i = 5; i < words.size(); i += words[i] >> 16) {
+    edited.insert(edited.end(), words.begin() + i,
+                  words.begin() + i + (words[i] >> 16));
+    SpvOp op = static_cast<SpvOp>(words[i] & 0xFFFF);
+    if (op == SpvOpCapability && !repeated_capability) {
+      edited.insert(edited.end(), words.begin() + i, words.begin() + i + 2);
+      repeated_capability = true;
+    } else if (op == SpvOpLabel && !added_nop) {
+      edited.push_back((1u << 16) | SpvOpNop);
+      added_nop = true;
+    }
+  }
+  return edited;
+}
+
+TEST_P(SpirvReflectTest, UpdateShaderModule) {
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv_.size(), spirv_.data(),
+                                         &module));
+  const std::vector<uint32_t> edited = ShiftAndEditFunctions(spirv_);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectUpdateShaderModule(&module, edited.size() * 4,
+                                         edited.data()));
+  SpvReflectShaderModule expected;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(edited.size() * 4, edited.data(),
+                                         &expected));
+
+  const uint32_t yaml_verbosity = 2;
+  SpvReflectToYaml expected_yamlizer(expected, yaml_verbosity);
+  std::stringstream expected_yaml;
+  expected_yaml << expected_yamlizer;
+  SpvReflectToYaml updated_yamlizer(module, yaml_verbosity);
+  std::stringstream updated_yaml;
+  updated_yaml << updated_yamlizer;
+  EXPECT_EQ(expected_yaml.str(), updated_yaml.str());
+
+  spvReflectDestroyShaderModule(&expected);
+  spvReflectDestroyShaderModule(&module);
+}
+
+TEST_P(SpirvReflectTest, EmbedReflection) {
+  size_t embedded_size = 0;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv_.size(), spirv_.data(),
+                                      &embedded_size, nullptr));
+  std::vector<uint8_t> embedded(embedded_size);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv_.size(), spirv_.data(),
+                                      &embedded_size, embedded.data()));
+
+  SpvReflectShaderModule loaded;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(embedded.size(), embedded.data(),
+                                         &loaded));
+  EXPECT_TRUE(loaded._internal->embedded_reflection_loaded);
+  SpvReflectShaderModule parsed;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule2(
+                SPV_REFLECT_MODULE_FLAG_IGNORE_EMBEDDED_REFLECTION,
+                embedded.size(), embedded.data(), &parsed));
+  EXPECT_FALSE(parsed._internal->embedded_reflection_loaded);
+
+  const uint32_t yaml_verbosity = 2;
+  SpvReflectToYaml parsed_yamlizer(parsed, yaml_verbosity);
+  std::stringstream parsed_yaml;
+  parsed_yaml << parsed_yamlizer;
+  SpvReflectToYaml loaded_yamlizer(loaded, yaml_verbosity);
+  std::stringstream loaded_yaml;
+  loaded_yaml << loaded_yamlizer;
+  EXPECT_EQ(parsed_yaml.str(), loaded_yaml.str());
+
+  spvReflectDestroyShaderModule(&parsed);
+  spvReflectDestroyShaderModule(&loaded);
+}
+
+TEST_P(SpirvReflectTest, CreateShaderModuleCached) {
+  // Whether the first module is parsed or comes from an earlier run, the
+  // second one is loaded from the cache.
+  const char* cache_dir = "spirv_reflect_test_cache";
+  SpvReflectShaderModule first;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModuleCached(SPV_REFLECT_MODULE_FLAG_NONE,
+                                               spirv_.size(), spirv_.data(),
+                                               cache_dir, &first));
+  spvReflectDestroyShaderModule(&first);
+  SpvReflectShaderModule cached;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModuleCached(SPV_REFLECT_MODULE_FLAG_NONE,
+                                               spirv_.size(), spirv_.data(),
+                                               cache_dir, &cached));
+  EXPECT_TRUE(cached._internal->cached_reflection_loaded);
+
+  const uint32_t yaml_verbosity = 2;
+  SpvReflectToYaml parsed_yamlizer(module_, yaml_verbosity);
+  std::stringstream parsed_yaml;
+  parsed_yaml << parsed_yamlizer;
+  SpvReflectToYaml cached_yamlizer(cached, yaml_verbosity);
+  std::stringstream cached_yaml;
+  cached_yaml << cached_yamlizer;
+  EXPECT_EQ(parsed_yaml.str(), cached_yaml.str());
+
+  spvReflectDestroyShaderModule(&cached);
+}
+
+TEST_P(SpirvReflectTest, DetachCode) {
+  std::vector<uint8_t> code = spirv_;
+  SpvReflectShaderModule detached;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule2(
+                SPV_REFLECT_MODULE_FLAG_NO_COPY |
+                    SPV_REFLECT_MODULE_FLAG_DETACH_CODE,
+                code.size(), code.data(), &detached));
+  // Nothing may point into the caller's code anymore.
+  std::fill(code.begin(), code.end(), 0xFF);
+  EXPECT_EQ(spvReflectGetCode(&detached), nullptr);
+  EXPECT_EQ(spvReflectGetCodeSize(&detached), 0u);
+  EXPECT_LE(detached._internal->string_pool_size, spirv_.size());
+
+  const uint32_t yaml_verbosity = 1;
+  SpvReflectToYaml parsed_yamlizer(module_, yaml_verbosity);
+  std::stringstream parsed_yaml;
+  parsed_yaml << parsed_yamlizer;
+  SpvReflectToYaml detached_yamlizer(detached, yaml_verbosity);
+  std::stringstream detached_yaml;
+  detached_yaml << detached_yamlizer;
+  EXPECT_EQ(parsed_yaml.str(), detached_yaml.str());
+
+  spvReflectDestroyShaderModule(&detached);
+}
+
+TEST_P(SpirvReflectTest, SparseIdBound) {
+  EXPECT_EQ(module_._internal->hashed_id_map, 0u);
+  // Same ids, but an id bound that would need a 1 GB table indexed by id
+  std::vector<uint8_t> code = spirv_;
+  const uint32_t id_bound = 0x10000000;
+  memcpy(code.data() + 3 * sizeof(uint32_t), &id_bound, sizeof(id_bound));
+  SpvReflectShaderModule sparse;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(code.size(), code.data(), &sparse));
+  EXPECT_EQ(sparse._internal->hashed_id_map, 1u);
+
+  const uint32_t yaml_verbosity = 1;
+  SpvReflectToYaml parsed_yamlizer(module_, yaml_verbosity);
+  std::stringstream parsed_yaml;
+  parsed_yaml << parsed_yamlizer;
+  SpvReflectToYaml sparse_yamlizer(sparse, yaml_verbosity);
+  std::stringstream sparse_yaml;
+  sparse_yaml << sparse_yamlizer;
+  EXPECT_EQ(parsed_yaml.str(), sparse_yaml.str());
+
+  spvReflectDestroyShaderModule(&sparse);
+}
+
+TEST_P(SpirvReflectTest, SharedStructMembers) {
+  const SpvReflectTypeDescription* p_types =
+      module_._internal->type_descriptions;
+  size_t type_count = module_._internal->type_description_count;
+  for (size_t i = 0; i < type_count; ++i) {
+    const SpvReflectTypeDescription& type = p_types[i];
+    const SpvReflectTypeDescription* p_struct = type.struct_type_description;
+    if ((p_struct == nullptr) || (p_struct == &type) ||
+        (type.members != p_struct->members)) {
+      continue;
+    }
+    // Members are shared with a struct type parsed earlier.
+    ASSERT_GE(p_struct, p_types);
+    EXPECT_LT(p_struct, &type);
+    EXPECT_EQ(p_struct->op, SpvOpTypeStruct);
+    EXPECT_EQ(type.member_count, p_struct->member_count);
+  }
+}
+
 namespace {
 // TODO - have this glob search all .spv files
 const std::vector<const char*> all_spirv_paths = {
@@ -1056,6 +2020,73 @@ TEST_F(SpirvReflectMultiEntryPointTest, GetEntryPoint) {
   ASSERT_EQ(NULL, spvReflectGetEntryPoint(&module_, "entry_tess"));
 }
 
+TEST_F(SpirvReflectMultiEntryPointTest, GetEntryPointIndex) {
+  for (uint32_t i = 0; i < 2; ++i) {
+    SpvReflectResult result = SPV_REFLECT_RESULT_NOT_READY;
+    EXPECT_EQ(i, spvReflectGetEntryPointIndex(&module_, eps_[i], &result));
+    EXPECT_EQ(SPV_REFLECT_RESULT_SUCCESS, result);
+  }
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  EXPECT_EQ(UINT32_MAX,
+            spvReflectGetEntryPointIndex(&module_, "entry_tess", &result));
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND, result);
+  EXPECT_EQ(UINT32_MAX, spvReflectGetEntryPointIndex(&module_, NULL, &result));
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_NULL_POINTER, result);
+}
+
+TEST_F(SpirvReflectMultiEntryPointTest, QueriesByIndex) {
+  for (uint32_t i = 0; i < 2; ++i) {
+    uint32_t count = 0;
+    uint32_t index_count = 0;
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEnumerateEntryPointDescriptorBindings(&module_, eps_[i],
+                                                              &count, NULL));
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEnumerateEntryPointDescriptorBindingsByIndex(
+                  &module_, i, &index_count, NULL));
+    ASSERT_EQ(count, index_count);
+    std::vector<SpvReflectDescriptorBinding*> bindings(count);
+    std::vector<SpvReflectDescriptorBinding*> index_bindings(count);
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEnumerateEntryPointDescriptorBindings(
+                  &module_, eps_[i], &count, bindings.data()));
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEnumerateEntryPointDescriptorBindingsByIndex(
+                  &module_, i, &count, index_bindings.data()));
+    EXPECT_EQ(bindings, index_bindings);
+
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEnumerateEntryPointInputVariables(&module_, eps_[i],
+                                                          &count, NULL));
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEnumerateEntryPointInputVariablesByIndex(
+                  &module_, i, &index_count, NULL));
+    EXPECT_EQ(count, index_count);
+
+    SpvReflectResult result = SPV_REFLECT_RESULT_NOT_READY;
+    SpvReflectResult index_result = SPV_REFLECT_RESULT_NOT_READY;
+    EXPECT_EQ(spvReflectGetEntryPointPushConstantBlock(&module_, eps_[i],
+                                                       &result),
+              spvReflectGetEntryPointPushConstantBlockByIndex(&module_, i,
+                                                              &index_result));
+    EXPECT_EQ(result, index_result);
+    EXPECT_EQ(
+        spvReflectGetEntryPointDescriptorSet(&module_, eps_[i], 0, &result),
+        spvReflectGetEntryPointDescriptorSetByIndex(&module_, i, 0,
+                                                    &index_result));
+    EXPECT_EQ(result, index_result);
+  }
+
+  uint32_t count = 0;
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND,
+            spvReflectEnumerateEntryPointDescriptorBindingsByIndex(
+                &module_, module_.entry_point_count, &count, NULL));
+  SpvReflectResult result = SPV_REFLECT_RESULT_SUCCESS;
+  EXPECT_EQ(NULL, spvReflectGetEntryPointDescriptorBindingByIndex(
+                      &module_, module_.entry_point_count, 0, 0, &result));
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND, result);
+}
+
 TEST_F(SpirvReflectMultiEntryPointTest, GetDescriptorBindings0) {
   uint32_t binding_count = 0;
   ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
@@ -1295,3 +2326,1565 @@ TEST_F(SpirvReflectMultiEntryPointTest, ChangeDescriptorSetNumber) {
   ASSERT_EQ(set0->bindings[0], set1->bindings[1]);
   ASSERT_EQ(set0->bindings[0]->set, 1);
 }
+
+TEST_F(SpirvReflectMultiEntryPointTest, ProgramAddEntryPoint) {
+  SpvReflectProgram incremental;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, spvReflectCreateProgram(&incremental));
+  SpvReflectProgram whole;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, spvReflectCreateProgram(&whole));
+
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectProgramAddEntryPoint(&incremental, &module_, eps_[0]));
+  EXPECT_EQ(SPV_REFLECT_SHADER_STAGE_VERTEX_BIT, incremental.stage_flags);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectProgramAddEntryPoint(&incremental, &module_, eps_[1]));
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND,
+            spvReflectProgramAddEntryPoint(&incremental, &module_, "main"));
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectProgramAddModule(&whole, &module_));
+
+  EXPECT_EQ(SPV_REFLECT_SHADER_STAGE_VERTEX_BIT |
+                SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT,
+            incremental.stage_flags);
+  EXPECT_EQ(0u, incremental.conflict_count);
+  ASSERT_EQ(whole.descriptor_set_count, incremental.descriptor_set_count);
+  for (uint32_t i = 0; i < whole.descriptor_set_count; ++i) {
+    ASSERT_EQ(whole.descriptor_sets[i].set, incremental.descriptor_sets[i].set);
+    ASSERT_EQ(whole.descriptor_sets[i].binding_count,
+              incremental.descriptor_sets[i].binding_count);
+    for (uint32_t j = 0; j < whole.descriptor_sets[i].binding_count; ++j) {
+      const SpvReflectProgramBinding& a = whole.descriptor_sets[i].bindings[j];
+      const SpvReflectProgramBinding& b =
+          incremental.descriptor_sets[i].bindings[j];
+      EXPECT_EQ(a.binding, b.binding);
+      EXPECT_EQ(a.descriptor_type, b.descriptor_type);
+      EXPECT_EQ(a.count, b.count);
+      EXPECT_EQ(a.stage_flags, b.stage_flags);
+    }
+  }
+
+  // The binding shared by both entry points is visible to both stages.
+  SpvReflectResult result;
+  const SpvReflectProgramDescriptorSet* set =
+      spvReflectProgramGetDescriptorSet(&incremental, 0, &result);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, result);
+  bool found_shared = false;
+  for (uint32_t i = 0; i < set->binding_count; ++i) {
+    found_shared |= set->bindings[i].stage_flags ==
+                    (SPV_REFLECT_SHADER_STAGE_VERTEX_BIT |
+                     SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT);
+  }
+  EXPECT_TRUE(found_shared);
+  EXPECT_EQ(NULL, spvReflectProgramGetDescriptorSet(&incremental, 7, &result));
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND, result);
+
+  spvReflectDestroyProgram(&whole);
+  spvReflectDestroyProgram(&incremental);
+}
+
+TEST_F(SpirvReflectMultiEntryPointTest, DescriptorSetLayoutsShared) {
+  const SpvReflectShaderModule* once[] = {&module_};
+  const SpvReflectShaderModule* twice[] = {&module_, &module_};
+  SpvReflectDescriptorSetLayouts single;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateDescriptorSetLayouts(1, once, &single));
+  SpvReflectDescriptorSetLayouts doubled;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateDescriptorSetLayouts(2, twice, &doubled));
+
+  // The second copy of the module reuses every layout of the first.
+  EXPECT_EQ(single.layout_count, doubled.layout_count);
+  ASSERT_EQ(2 * single.use_count, doubled.use_count);
+  for (uint32_t i = 0; i < single.use_count; ++i) {
+    const SpvReflectDescriptorSetLayoutUse& a = doubled.uses[i];
+    const SpvReflectDescriptorSetLayoutUse& b =
+        doubled.uses[single.use_count + i];
+    EXPECT_EQ(0u, a.module_index);
+    EXPECT_EQ(1u, b.module_index);
+    EXPECT_EQ(a.entry_point_index, b.entry_point_index);
+    EXPECT_EQ(a.set, b.set);
+    EXPECT_EQ(a.layout_index, b.layout_index);
+    EXPECT_EQ(single.uses[i].layout_index, a.layout_index);
+  }
+  // The vertex and fragment sets have different bindings, so they stay
+  // distinct and each keeps its own stage.
+  EXPECT_EQ(2u, single.layout_count);
+  for (uint32_t i = 0; i < single.use_count; ++i) {
+    const SpvReflectDescriptorSetLayoutUse& use = single.uses[i];
+    const SpvReflectDescriptorSetLayout& layout =
+        single.layouts[use.layout_index];
+    ASSERT_GT(layout.binding_count, 0u);
+    EXPECT_EQ((uint32_t)module_.entry_points[use.entry_point_index].shader_stage,
+              layout.bindings[0].stage_flags);
+  }
+
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_NULL_POINTER,
+            spvReflectCreateDescriptorSetLayouts(1, nullptr, &single));
+  spvReflectDestroyDescriptorSetLayouts(&doubled);
+  spvReflectDestroyDescriptorSetLayouts(&single);
+}
+
+TEST_F(SpirvReflectMultiEntryPointTest, DescriptorPoolSizes) {
+  SpvReflectDescriptorPoolSizes pool_sizes = {};
+  for (const char* ep : eps_) {
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectDescriptorPoolSizesAddEntryPoint(&pool_sizes, &module_,
+                                                         ep, 0));
+  }
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND,
+            spvReflectDescriptorPoolSizesAddEntryPoint(&pool_sizes, &module_,
+                                                       "main", 0));
+  // Each entry point allocates its own set 0; only the fragment shader
+  // samples the texture.
+  EXPECT_EQ(2u, pool_sizes.max_sets);
+  ASSERT_EQ(2u, pool_sizes.pool_size_count);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            pool_sizes.pool_sizes[0].type);
+  EXPECT_EQ(2u, pool_sizes.pool_sizes[0].descriptor_count);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            pool_sizes.pool_sizes[1].type);
+  EXPECT_EQ(1u, pool_sizes.pool_sizes[1].descriptor_count);
+
+  SpvReflectDescriptorPoolSizes module_pool_sizes = {};
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectDescriptorPoolSizesAddModule(&module_pool_sizes,
+                                                   &module_, 0));
+  EXPECT_EQ(1u, module_pool_sizes.max_sets);
+  EXPECT_EQ(2u, module_pool_sizes.pool_size_count);
+}
+
+TEST_F(SpirvReflectMultiEntryPointTest, VertexInputLayout) {
+  // entry_vert reads a vec2 at location 0 and a vec3 at location 1.
+  SpvReflectVertexInputLayout layout;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectComputeVertexInputLayout(
+                &module_, eps_[0],
+                SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED, 0, nullptr,
+                &layout));
+  ASSERT_EQ(1u, layout.binding_count);
+  EXPECT_EQ(20u, layout.bindings[0].stride);
+  ASSERT_EQ(2u, layout.attribute_count);
+  EXPECT_EQ(SPV_REFLECT_FORMAT_R32G32_SFLOAT, layout.attributes[0].format);
+  EXPECT_EQ(0u, layout.attributes[0].offset);
+  EXPECT_EQ(SPV_REFLECT_FORMAT_R32G32B32_SFLOAT, layout.attributes[1].format);
+  EXPECT_EQ(8u, layout.attributes[1].offset);
+
+  const uint32_t location_bindings[] = {1, 0};
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectComputeVertexInputLayout(
+                &module_, eps_[0],
+                SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED, 2,
+                location_bindings, &layout));
+  ASSERT_EQ(2u, layout.binding_count);
+  EXPECT_EQ(0u, layout.bindings[0].binding);
+  EXPECT_EQ(12u, layout.bindings[0].stride);
+  EXPECT_EQ(1u, layout.bindings[1].binding);
+  EXPECT_EQ(8u, layout.bindings[1].stride);
+  EXPECT_EQ(1u, layout.attributes[0].binding);
+  EXPECT_EQ(0u, layout.attributes[1].binding);
+  EXPECT_EQ(0u, layout.attributes[1].offset);
+
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND,
+            spvReflectComputeVertexInputLayout(
+                &module_, "main",
+                SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED, 0, nullptr,
+                &layout));
+}
+
+static std::vector<uint8_t> ReadSpirvFile(const char* path) {
+  std::ifstream spirv_file(path, std::ios::binary | std::ios::ate);
+  std::vector<uint8_t> spirv(static_cast<size_t>(spirv_file.tellg()));
+  spirv_file.seekg(0);
+  spirv_file.read(reinterpret_cast<char*>(spirv.data()), spirv.size());
+  return spirv;
+}
+
+TEST(SpirvReflectTestCase, ProgramDescriptorTypeConflict) {
+  std::vector<uint8_t> attachment_spirv =
+      ReadSpirvFile("../tests/glsl/input_attachment.spv");
+  std::vector<uint8_t> buffer_spirv =
+      ReadSpirvFile("../tests/glsl/storage_buffer.spv");
+  SpvReflectShaderModule attachment_module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(attachment_spirv.size(),
+                                         attachment_spirv.data(),
+                                         &attachment_module));
+  SpvReflectShaderModule buffer_module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(buffer_spirv.size(),
+                                         buffer_spirv.data(), &buffer_module));
+
+  SpvReflectProgram program;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, spvReflectCreateProgram(&program));
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectProgramAddModule(&program, &attachment_module));
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectProgramAddModule(&program, &buffer_module));
+
+  ASSERT_GE(program.conflict_count, 1u);
+  EXPECT_EQ(0u, program.conflicts[0].set);
+  EXPECT_EQ(0u, program.conflicts[0].binding);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+            program.conflicts[0].descriptor_type);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            program.conflicts[0].conflicting_descriptor_type);
+  EXPECT_EQ(SPV_REFLECT_SHADER_STAGE_COMPUTE_BIT,
+            program.conflicts[0].conflicting_stage);
+
+  spvReflectDestroyProgram(&program);
+  spvReflectDestroyShaderModule(&buffer_module);
+  spvReflectDestroyShaderModule(&attachment_module);
+}
+
+TEST(SpirvReflectTestCase, DescriptorSetLayoutsTypeConflict) {
+  // A sampler and a sampled image aliasing set 0, binding 0.
+  const uint32_t kVoid = 1, kFunctionType = 2, kMain = 3, kLabel = 4;
+  const uint32_t kFloat = 5, kSampler = 6, kImage = 7, kSamplerPointer = 8;
+  const uint32_t kImagePointer = 9, kSamplerVariable = 10;
+  const uint32_t kImageVariable = 11, kLoadedSampler = 12, kLoadedImage = 13;
+  std::vector<uint32_t> words = {SpvMagicNumber, 0x00010000, 0, 14, 0};
+  auto add = [&words](SpvOp op, std::vector<uint32_t> operands) {
+    words.push_back(static_cast<uint32_t>((operands.size() + 1) << 16) | op);
+    words.insert(words.end(), operands.begin(), operands.end());
+  };
+  add(SpvOpCapability, {SpvCapabilityShader});
+  add(SpvOpMemoryModel, {SpvAddressingModelLogical, SpvMemoryModelGLSL450});
+  add(SpvOpEntryPoint, {SpvExecutionModelGLCompute, kMain, 0x6E69616D, 0});
+  add(SpvOpExecutionMode, {kMain, SpvExecutionModeLocalSize, 1, 1, 1});
+  for (uint32_t variable : {kSamplerVariable, kImageVariable}) {
+    add(SpvOpDecorate, {variable, SpvDecorationDescriptorSet, 0});
+    add(SpvOpDecorate, {variable, SpvDecorationBinding, 0});
+  }
+  add(SpvOpTypeVoid, {kVoid});
+  add(SpvOpTypeFunction, {kFunctionType, kVoid});
+  add(SpvOpTypeFloat, {kFloat, 32});
+  add(SpvOpTypeSampler, {kSampler});
+  add(SpvOpTypeImage,
+      {kImage, kFloat, SpvDim2D, 0, 0, 0, 1, SpvImageFormatUnknown});
+  add(SpvOpTypePointer, {kSamplerPointer, SpvStorageClassUniformConstant,
+                         kSampler});
+  add(SpvOpTypePointer, {kImagePointer, SpvStorageClassUniformConstant,
+                         kImage});
+  add(SpvOpVariable, {kSamplerPointer, kSamplerVariable,
+                      SpvStorageClassUniformConstant});
+  add(SpvOpVariable, {kImagePointer, kImageVariable,
+                      SpvStorageClassUniformConstant});
+  add(SpvOpFunction, {kVoid, kMain, SpvFunctionControlMaskNone, kFunctionType});
+  add(SpvOpLabel, {kLabel});
+  add(SpvOpLoad, {kSampler, kLoadedSampler, kSamplerVariable});
+  add(SpvOpLoad, {kImage, kLoadedImage, kImageVariable});
+  add(SpvOpReturn, {});
+  add(SpvOpFunctionEnd, {});
+
+  spv_reflect::ShaderModule module(words);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, module.GetResult());
+  const SpvReflectShaderModule* modules[] = {&module.GetShaderModule()};
+  SpvReflectDescriptorSetLayouts layouts;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateDescriptorSetLayouts(1, modules, &layouts));
+
+  // Both aliases keep their own binding
+  ASSERT_EQ(1u, layouts.layout_count);
+  ASSERT_EQ(2u, layouts.layouts[0].binding_count);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLER,
+            layouts.layouts[0].bindings[0].descriptor_type);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            layouts.layouts[0].bindings[1].descriptor_type);
+
+  ASSERT_EQ(1u, layouts.conflict_count);
+  EXPECT_EQ(0u, layouts.conflicts[0].set);
+  EXPECT_EQ(0u, layouts.conflicts[0].binding);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLER,
+            layouts.conflicts[0].descriptor_type);
+  EXPECT_EQ(SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            layouts.conflicts[0].conflicting_descriptor_type);
+  EXPECT_EQ(SPV_REFLECT_SHADER_STAGE_COMPUTE_BIT,
+            layouts.conflicts[0].conflicting_stage);
+  spvReflectDestroyDescriptorSetLayouts(&layouts);
+}
+
+TEST_F(SpirvReflectMultiEntryPointTest, CheckStageInterface) {
+  // entry_vert writes oUV at location 0, which entry_frag reads as iUV.
+  uint32_t count = 1;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCheckStageInterface(&module_, eps_[0], &module_, eps_[1],
+                                          &count, nullptr));
+  EXPECT_EQ(0u, count);
+
+  // entry_frag writes a vec4 to location 0 and reads a vec2 from it, which
+  // only leaves components unread.
+  SpvReflectInterfaceMismatch mismatches[2];
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCheckStageInterface(&module_, eps_[1], &module_, eps_[1],
+                                          &count, nullptr));
+  EXPECT_EQ(0u, count);
+
+  // Moved to location 1, the vec2 output no longer matches the vec3 input.
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectChangeOutputVariableLocation(
+                &module_,
+                spvReflectGetOutputVariableByLocation(&module_, 0, nullptr),
+                1));
+  count = 0;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCheckStageInterface(&module_, eps_[0], &module_, eps_[0],
+                                          &count, nullptr));
+  ASSERT_EQ(2u, count);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCheckStageInterface(&module_, eps_[0], &module_, eps_[0],
+                                          &count, mismatches));
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_MISSING_OUTPUT, mismatches[0].type);
+  EXPECT_EQ(0u, mismatches[0].location);
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_TYPE, mismatches[1].type);
+  EXPECT_EQ(1u, mismatches[1].location);
+
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND,
+            spvReflectCheckStageInterface(&module_, eps_[0], &module_, "main",
+                                          &count, nullptr));
+}
+
+TEST(SpirvReflectTestCase, DescriptorSetLayoutsSharedAcrossStages) {
+  std::vector<uint8_t> vertex = ReadSpirvFile("../tests/hlsl/cbuffer.spv");
+  ASSERT_FALSE(vertex.empty());
+  // The same shader compiled for the fragment stage has identical bindings.
+  std::vector<uint8_t> fragment = vertex;
+  uint32_t* p_words = reinterpret_cast<uint32_t*>(fragment.data());
+  const size_t word_count = fragment.size() / 4;
+  for (size_t i = 5; i < word_count; i += p_words[i] >> 16) {
+    if ((p_words[i] & 0xFFFF) == SpvOpEntryPoint) {
+      ASSERT_EQ(SpvExecutionModelVertex, p_words[i + 1]);
+      p_words[i + 1] = SpvExecutionModelFragment;
+      break;
+    }
+  }
+  spv_reflect::ShaderModule vs(vertex);
+  spv_reflect::ShaderModule fs(fragment);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, vs.GetResult());
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, fs.GetResult());
+  ASSERT_EQ(SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT, fs.GetShaderStage());
+
+  const SpvReflectShaderModule* modules[] = {&vs.GetShaderModule(),
+                                             &fs.GetShaderModule()};
+  SpvReflectDescriptorSetLayouts layouts;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateDescriptorSetLayouts(2, modules, &layouts));
+  ASSERT_EQ(2u, layouts.use_count);
+  ASSERT_EQ(1u, layouts.layout_count);
+  EXPECT_EQ(0u, layouts.uses[0].layout_index);
+  EXPECT_EQ(0u, layouts.uses[1].layout_index);
+  const SpvReflectDescriptorSetLayout& layout = layouts.layouts[0];
+  ASSERT_EQ(1u, layout.binding_count);
+  EXPECT_EQ((uint32_t)(SPV_REFLECT_SHADER_STAGE_VERTEX_BIT |
+                       SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT),
+            layout.bindings[0].stage_flags);
+  spvReflectDestroyDescriptorSetLayouts(&layouts);
+}
+
+TEST(SpirvReflectTestCase, VertexInputLayoutAlignment) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/16bit/vert_in_out_16.spv");
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv.size(), spirv.data(), &module));
+  SpvReflectVertexInputLayout layout;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectComputeVertexInputLayout(
+                &module, module.entry_point_name,
+                SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED, 0, nullptr,
+                &layout));
+  // Alternating 16-bit scalars and 3-component vectors pack with 2-byte
+  // alignment: 2 + 6 bytes per pair.
+  ASSERT_EQ(6u, layout.attribute_count);
+  for (uint32_t i = 0; i < layout.attribute_count; ++i) {
+    EXPECT_EQ(i, layout.attributes[i].location);
+    EXPECT_EQ((i / 2) * 8 + (i % 2) * 2, layout.attributes[i].offset);
+  }
+  EXPECT_EQ(24u, layout.bindings[0].stride);
+  spvReflectDestroyShaderModule(&module);
+}
+
+// An Input or Output variable of a generated shader, with a Component
+// decoration unless component is UINT32_MAX.
+struct GeneratedInterfaceVariable {
+  uint32_t location;  // UINT32_MAX for none, only valid for block members
+  uint32_t component;
+  uint32_t component_count;
+  bool is_int;
+  uint32_t column_count;  // 0 unless a matrix
+  uint32_t array_size;    // 0 unless an array
+};
+
+// With as_block, the variables become the members of one Block variable
+// without a Location.
+static std::vector<uint32_t> BuildInterfaceShader(
+    SpvExecutionModel model, SpvStorageClass storage_class,
+    const std::vector<GeneratedInterfaceVariable>& variables,
+    bool as_block = false) {
+  const uint32_t kVoid = 1, kFunctionType = 2, kMain = 3, kLabel = 4;
+  const uint32_t kFloat = 5, kInt = 6, kBlock = 7, kBlockVariable = 8;
+  uint32_t next_id = 9;
+  std::vector<uint32_t> variable_ids;
+  if (as_block) {
+    variable_ids.push_back(kBlockVariable);
+  } else {
+    for (size_t i = 0; i < variables.size(); ++i) {
+      variable_ids.push_back(next_id++);
+    }
+  }
+  std::vector<uint32_t> words = {SpvMagicNumber, 0x00010000, 0, 0, 0};
+  auto add = [&words](SpvOp op, std::vector<uint32_t> operands) {
+    words.push_back(static_cast<uint32_t>((operands.size() + 1) << 16) | op);
+    words.insert(words.end(), operands.begin(), operands.end());
+  };
+  add(SpvOpCapability, {SpvCapabilityShader});
+  add(SpvOpMemoryModel, {SpvAddressingModelLogical, SpvMemoryModelGLSL450});
+  std::vector<uint32_t> entry_point = {static_cast<uint32_t>(model), kMain,
+                                       0x6E69616D, 0};
+  entry_point.insert(entry_point.end(), variable_ids.begin(),
+                     variable_ids.end());
+  add(SpvOpEntryPoint, entry_point);
+  if (as_block) {
+    add(SpvOpDecorate, {kBlock, SpvDecorationBlock});
+  }
+  for (uint32_t i = 0; i < variables.size(); ++i) {
+    const GeneratedInterfaceVariable& variable = variables[i];
+    if (as_block) {
+      if (variable.location != UINT32_MAX) {
+        add(SpvOpMemberDecorate,
+            {kBlock, i, SpvDecorationLocation, variable.location});
+      }
+      if (variable.component != UINT32_MAX) {
+        add(SpvOpMemberDecorate,
+            {kBlock, i, SpvDecorationComponent, variable.component});
+      }
+      continue;
+    }
+    add(SpvOpDecorate,
+        {variable_ids[i], SpvDecorationLocation, variable.location});
+    if (variable.component != UINT32_MAX) {
+      add(SpvOpDecorate,
+          {variable_ids[i], SpvDecorationComponent, variable.component});
+    }
+  }
+  add(SpvOpTypeVoid, {kVoid});
+  add(SpvOpTypeFunction, {kFunctionType, kVoid});
+  add(SpvOpTypeFloat, {kFloat, 32});
+  add(SpvOpTypeInt, {kInt, 32, 1});
+  std::vector<uint32_t> member_types = {kBlock};
+  for (size_t i = 0; i < variables.size(); ++i) {
+    const GeneratedInterfaceVariable& variable = variables[i];
+    uint32_t type = variable.is_int ? kInt : kFloat;
+    if (variable.component_count > 1) {
+      uint32_t vector_type = next_id++;
+      add(SpvOpTypeVector, {vector_type, type, variable.component_count});
+      type = vector_type;
+    }
+    if (variable.column_count > 0) {
+      uint32_t matrix_type = next_id++;
+      add(SpvOpTypeMatrix, {matrix_type, type, variable.column_count});
+      type = matrix_type;
+    }
+    if (variable.array_size > 0) {
+      uint32_t length = next_id++;
+      uint32_t array_type = next_id++;
+      add(SpvOpConstant, {kInt, length, variable.array_size});
+      add(SpvOpTypeArray, {array_type, type, length});
+      type = array_type;
+    }
+    if (as_block) {
+      member_types.push_back(type);
+      continue;
+    }
+    uint32_t pointer_type = next_id++;
+    add(SpvOpTypePointer, {pointer_type, storage_class, type});
+    add(SpvOpVariable, {pointer_type, variable_ids[i], storage_class});
+  }
+  if (as_block) {
+    uint32_t pointer_type = next_id++;
+    add(SpvOpTypeStruct, member_types);
+    add(SpvOpTypePointer, {pointer_type, storage_class, kBlock});
+    add(SpvOpVariable, {pointer_type, kBlockVariable, storage_class});
+  }
+  add(SpvOpFunction, {kVoid, kMain, SpvFunctionControlMaskNone, kFunctionType});
+  add(SpvOpLabel, {kLabel});
+  add(SpvOpReturn, {});
+  add(SpvOpFunctionEnd, {});
+  words[3] = next_id;
+  return words;
+}
+
+TEST(SpirvReflectTestCase, VertexInputLayoutPackedComponents) {
+  // A vec2 and a float packed into location 0, and a float in the second
+  // component of location 1.
+  std::vector<uint32_t> words = BuildInterfaceShader(
+      SpvExecutionModelVertex, SpvStorageClassInput,
+      {{0, 0, 2, false, 0, 0},
+       {0, 2, 1, false, 0, 0},
+       {1, 1, 1, false, 0, 0}});
+  spv_reflect::ShaderModule module(words);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, module.GetResult());
+  ASSERT_EQ(3u, module.GetShaderModule().input_variable_count);
+  SpvReflectVertexInputLayout layout;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectComputeVertexInputLayout(
+                &module.GetShaderModule(), "main",
+                SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED, 0, nullptr,
+                &layout));
+  ASSERT_EQ(2u, layout.attribute_count);
+  EXPECT_EQ(0u, layout.attributes[0].location);
+  EXPECT_EQ(SPV_REFLECT_FORMAT_R32G32B32_SFLOAT, layout.attributes[0].format);
+  EXPECT_EQ(0u, layout.attributes[0].offset);
+  EXPECT_EQ(1u, layout.attributes[1].location);
+  EXPECT_EQ(SPV_REFLECT_FORMAT_R32G32_SFLOAT, layout.attributes[1].format);
+  EXPECT_EQ(12u, layout.attributes[1].offset);
+  ASSERT_EQ(1u, layout.binding_count);
+  EXPECT_EQ(20u, layout.bindings[0].stride);
+
+  // One attribute cannot hold both float and int components.
+  words = BuildInterfaceShader(SpvExecutionModelVertex, SpvStorageClassInput,
+                               {{0, 0, 2, false, 0, 0}, {0, 2, 2, true, 0, 0}});
+  spv_reflect::ShaderModule mixed(words);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, mixed.GetResult());
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_SPIRV_INVALID_INSTRUCTION,
+            spvReflectComputeVertexInputLayout(
+                &mixed.GetShaderModule(), "main",
+                SPV_REFLECT_VERTEX_INPUT_LAYOUT_MODE_INTERLEAVED, 0, nullptr,
+                &layout));
+}
+
+static std::vector<SpvReflectInterfaceMismatch> CheckGeneratedInterface(
+    const std::vector<GeneratedInterfaceVariable>& outputs,
+    bool outputs_as_block,
+    const std::vector<GeneratedInterfaceVariable>& inputs,
+    bool inputs_as_block) {
+  spv_reflect::ShaderModule producer(
+      BuildInterfaceShader(SpvExecutionModelVertex, SpvStorageClassOutput,
+                           outputs, outputs_as_block));
+  spv_reflect::ShaderModule consumer(
+      BuildInterfaceShader(SpvExecutionModelFragment, SpvStorageClassInput,
+                           inputs, inputs_as_block));
+  std::vector<SpvReflectInterfaceMismatch> mismatches;
+  EXPECT_EQ(SPV_REFLECT_RESULT_SUCCESS, producer.GetResult());
+  EXPECT_EQ(SPV_REFLECT_RESULT_SUCCESS, consumer.GetResult());
+  uint32_t count = 0;
+  EXPECT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCheckStageInterface(&producer.GetShaderModule(), "main",
+                                          &consumer.GetShaderModule(), "main",
+                                          &count, nullptr));
+  mismatches.resize(count);
+  EXPECT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCheckStageInterface(&producer.GetShaderModule(), "main",
+                                          &consumer.GetShaderModule(), "main",
+                                          &count, mismatches.data()));
+  // The variables belong to the modules, which go away on return.
+  for (SpvReflectInterfaceMismatch& mismatch : mismatches) {
+    mismatch.output_variable = nullptr;
+    mismatch.input_variable = nullptr;
+  }
+  return mismatches;
+}
+
+TEST(SpirvReflectTestCase, CheckStageInterfaceComponents) {
+  // A vec4 read as two vec2s, a mat2 read as two vec2 columns and a float[2]
+  // read as two floats.
+  std::vector<SpvReflectInterfaceMismatch> mismatches =
+      CheckGeneratedInterface({{0, UINT32_MAX, 4, false, 0, 0},
+                               {1, UINT32_MAX, 2, false, 2, 0},
+                               {3, UINT32_MAX, 1, false, 0, 2}},
+                              false,
+                              {{0, 0, 2, false, 0, 0},
+                               {0, 2, 2, false, 0, 0},
+                               {1, UINT32_MAX, 2, false, 0, 0},
+                               {2, UINT32_MAX, 2, false, 0, 0},
+                               {3, UINT32_MAX, 1, false, 0, 0},
+                               {4, UINT32_MAX, 1, false, 0, 0}},
+                              false);
+  EXPECT_TRUE(mismatches.empty());
+
+  // Arrays and matrices take one location per element and column.
+  mismatches = CheckGeneratedInterface({{0, UINT32_MAX, 3, false, 3, 0},
+                                        {3, UINT32_MAX, 4, false, 0, 2}},
+                                       false,
+                                       {{0, UINT32_MAX, 3, false, 3, 0},
+                                        {3, UINT32_MAX, 4, false, 0, 3},
+                                        {6, UINT32_MAX, 1, false, 0, 0}},
+                                       false);
+  ASSERT_EQ(2u, mismatches.size());
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_ARRAY, mismatches[0].type);
+  EXPECT_EQ(3u, mismatches[0].location);
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_MISSING_OUTPUT, mismatches[1].type);
+  EXPECT_EQ(6u, mismatches[1].location);
+
+  // Components must be written with the same type, and all of them.
+  mismatches = CheckGeneratedInterface({{0, 0, 2, false, 0, 0},
+                                        {0, 2, 2, true, 0, 0}},
+                                       false, {{0, 0, 4, false, 0, 0}}, false);
+  ASSERT_EQ(1u, mismatches.size());
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_TYPE, mismatches[0].type);
+  mismatches = CheckGeneratedInterface({{0, 1, 2, false, 0, 0}}, false,
+                                       {{0, 0, 2, false, 0, 0}}, false);
+  ASSERT_EQ(1u, mismatches.size());
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_TYPE, mismatches[0].type);
+  EXPECT_EQ(0u, mismatches[0].component);
+}
+
+TEST(SpirvReflectTestCase, CheckStageInterfaceBlockMembers) {
+  // Block members follow each other from the first member Location.
+  const std::vector<GeneratedInterfaceVariable> members = {
+      {2, UINT32_MAX, 4, false, 0, 0},
+      {UINT32_MAX, UINT32_MAX, 2, false, 0, 2},
+      {7, UINT32_MAX, 1, true, 0, 0}};
+  const std::vector<GeneratedInterfaceVariable> variables = {
+      {2, UINT32_MAX, 4, false, 0, 0},
+      {3, UINT32_MAX, 2, false, 0, 0},
+      {4, UINT32_MAX, 2, false, 0, 0},
+      {7, UINT32_MAX, 1, true, 0, 0}};
+  EXPECT_TRUE(CheckGeneratedInterface(members, true, variables, false).empty());
+  EXPECT_TRUE(CheckGeneratedInterface(variables, false, members, true).empty());
+  EXPECT_TRUE(CheckGeneratedInterface(members, true, members, true).empty());
+
+  std::vector<SpvReflectInterfaceMismatch> mismatches =
+      CheckGeneratedInterface({{2, UINT32_MAX, 4, false, 0, 0}}, false, members,
+                              true);
+  ASSERT_EQ(2u, mismatches.size());
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_MISSING_OUTPUT, mismatches[0].type);
+  EXPECT_EQ(3u, mismatches[0].location);
+  EXPECT_EQ(SPV_REFLECT_INTERFACE_MISMATCH_MISSING_OUTPUT, mismatches[1].type);
+  EXPECT_EQ(7u, mismatches[1].location);
+}
+
+TEST(SpirvReflectTestCase, FlatBlockNestedArrays) {
+  std::vector<uint8_t> spirv = ReadSpirvFile("../tests/hlsl/cbuffer.spv");
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv.size(), spirv.data(), &module));
+  ASSERT_EQ(1u, module.descriptor_binding_count);
+  const SpvReflectBlockVariable& block = module.descriptor_bindings[0].block;
+  SpvReflectFlatBlock flat_block;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateFlatBlock(&block, &flat_block));
+
+  // Material[2][2][3] has 3 + 10 * (8 * 8 + 3) leaves per element, followed
+  // by the 6 remaining members of the cbuffer.
+  EXPECT_EQ(12u * 673u + 6u, flat_block.member_count);
+
+  const SpvReflectBlockVariable& material = block.members[0];
+  const SpvReflectBlockVariable& aux = material.members[3];
+  const SpvReflectBlockVariable& cloth = aux.members[0];
+  const SpvReflectBlockVariable& strengths = cloth.members[1];
+  const SpvReflectBlockVariable& left = strengths.members[4];
+  const uint32_t expected_offset =
+      material.offset + (1 * 6 + 0 * 3 + 2) * material.array.stride +
+      aux.offset + 4 * aux.array.stride + cloth.offset +
+      7 * cloth.array.stride + strengths.offset + left.offset;
+  const char* path =
+      "Material[1][0][2].AuxDatArray[4].ClothProperties[7].Strengths.Left";
+  const SpvReflectFlatBlockMember* p_left = nullptr;
+  for (uint32_t i = 0; i < flat_block.member_count; ++i) {
+    if (strcmp(flat_block.members[i].path, path) == 0) {
+      p_left = &flat_block.members[i];
+    }
+  }
+  ASSERT_NE(nullptr, p_left);
+  EXPECT_EQ(expected_offset, p_left->absolute_offset);
+  EXPECT_EQ(&left, p_left->member);
+  EXPECT_EQ(SPV_REFLECT_TYPE_FLAG_FLOAT, p_left->type_flags);
+
+  const SpvReflectFlatBlockMember& uv_offsets =
+      flat_block.members[flat_block.member_count - 2];
+  EXPECT_STREQ("UvOffsets", uv_offsets.path);
+  EXPECT_EQ(12u, uv_offsets.array_count);
+  EXPECT_EQ(block.members[5].array.stride, uv_offsets.array_stride);
+  EXPECT_EQ(block.members[5].offset, uv_offsets.absolute_offset);
+
+  spvReflectDestroyFlatBlock(&flat_block);
+  spvReflectDestroyShaderModule(&module);
+}
+
+TEST(SpirvReflectTestCase, FlatBlockMemberByPath) {
+  std::vector<uint8_t> spirv = ReadSpirvFile("../tests/hlsl/cbuffer.spv");
+  spv_reflect::ShaderModule module(spirv);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS, module.GetResult());
+  const SpvReflectBlockVariable* p_block =
+      &module.GetShaderModule().descriptor_bindings[0].block;
+
+  SpvReflectFlatBlock flat_block;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateFlatBlock(p_block, &flat_block));
+  const char* path =
+      "Material[1][0][2].AuxDatArray[4].ClothProperties[7].Strengths.Left";
+  uint32_t offset = 0;
+  SpvReflectResult result = SPV_REFLECT_RESULT_NOT_READY;
+  const SpvReflectFlatBlockMember* p_left =
+      spvReflectGetFlatBlockMemberByPath(&flat_block, path, &offset, &result);
+  ASSERT_NE(nullptr, p_left);
+  EXPECT_EQ(SPV_REFLECT_RESULT_SUCCESS, result);
+  EXPECT_STREQ(path, p_left->path);
+  EXPECT_EQ(p_left->absolute_offset, offset);
+
+  // Subscripts into an array leaf resolve to the element's offset.
+  const SpvReflectBlockVariable& uv_offsets = p_block->members[5];
+  const SpvReflectFlatBlockMember* p_uv = spvReflectGetFlatBlockMemberByPath(
+      &flat_block, "UvOffsets[5]", &offset, &result);
+  ASSERT_NE(nullptr, p_uv);
+  EXPECT_EQ(&uv_offsets, p_uv->member);
+  EXPECT_EQ(uv_offsets.offset + 5 * uv_offsets.array.stride, offset);
+  const SpvReflectFlatBlockMember* p_scales =
+      spvReflectGetFlatBlockMemberByPath(
+          &flat_block, "Material[0][1][0].AuxDatArray[9].Scales[7]", &offset,
+          &result);
+  ASSERT_NE(nullptr, p_scales);
+  EXPECT_EQ(p_scales->absolute_offset + 7 * p_scales->array_stride, offset);
+
+  const char* missing_paths[] = {
+      "UvOffsets[12]", "UvOffsets[1][0]", "UvOffsets[]",
+      "Material[2][0][0].Color", "Material[0][0][0]", "Time[0]", "Tim", "",
+  };
+  for (const char* missing_path : missing_paths) {
+    EXPECT_EQ(nullptr, spvReflectGetFlatBlockMemberByPath(
+                           &flat_block, missing_path, nullptr, &result))
+        << missing_path;
+    EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_ELEMENT_NOT_FOUND, result);
+  }
+
+  // The wrapper flattens each block once and answers the same way.
+  uint32_t wrapper_offset = 0;
+  const SpvReflectFlatBlockMember* p_wrapper_left =
+      module.GetBlockMemberByPath(p_block, path, &wrapper_offset, &result);
+  ASSERT_NE(nullptr, p_wrapper_left);
+  EXPECT_EQ(p_left->absolute_offset, wrapper_offset);
+  EXPECT_EQ(p_left->member, p_wrapper_left->member);
+  EXPECT_EQ(p_wrapper_left,
+            module.GetBlockMemberByPath(p_block, path, nullptr, &result));
+  EXPECT_EQ(nullptr,
+            module.GetBlockMemberByPath(nullptr, path, nullptr, &result));
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_NULL_POINTER, result);
+
+  spvReflectDestroyFlatBlock(&flat_block);
+}
+
+TEST(SpirvReflectTestCase, PackPlanRowMajor) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/glsl/matrix_major_order_glsl.spv");
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv.size(), spirv.data(), &module));
+  ASSERT_EQ(1u, module.descriptor_binding_count);
+  const SpvReflectBlockVariable& block = module.descriptor_bindings[0].block;
+  const SpvReflectBlockVariable* p_matrix = nullptr;
+  for (uint32_t i = 0; i < block.member_count; ++i) {
+    if (strcmp(block.members[i].name, "row_major_my_mat_2x3") == 0) {
+      p_matrix = &block.members[i];
+    }
+  }
+  ASSERT_NE(nullptr, p_matrix);
+
+  SpvReflectPackPlan plan;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreatePackPlan(&block, &plan));
+  // Each of the 2 host columns scatters its 3 components across the rows.
+  uint32_t column_ops = 0;
+  for (uint32_t i = 0; i < plan.op_count; ++i) {
+    const SpvReflectPackOp& op = plan.ops[i];
+    if (op.dst_offset >= p_matrix->offset &&
+        op.dst_offset < p_matrix->offset + p_matrix->size) {
+      EXPECT_EQ(4u, op.size);
+      EXPECT_EQ(3u, op.count);
+      EXPECT_EQ(4u, op.src_stride);
+      EXPECT_EQ(p_matrix->numeric.matrix.stride, op.dst_stride);
+      EXPECT_EQ(p_matrix->offset + column_ops * 4, op.dst_offset);
+      ++column_ops;
+    }
+  }
+  EXPECT_EQ(2u, column_ops);
+
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_NULL_POINTER,
+            spvReflectExecutePackPlan(&plan, 1, nullptr, 0, nullptr, 0));
+  EXPECT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectExecutePackPlan(&plan, 0, nullptr, 0, nullptr, 0));
+  spvReflectDestroyPackPlan(&plan);
+  spvReflectDestroyShaderModule(&module);
+}
+
+TEST(SpirvReflectTestCase, DescriptorUpdateTemplateArrays) {
+  std::vector<uint8_t> spirv = ReadSpirvFile("../tests/hlsl/user_type.spv");
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv.size(), spirv.data(), &module));
+  ASSERT_EQ(1u, module.descriptor_set_count);
+  const SpvReflectDescriptorSet& set = module.descriptor_sets[0];
+
+  uint32_t count = 0;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEnumerateDescriptorUpdateTemplateEntries(
+                &set, nullptr, 0, &count, nullptr, nullptr));
+  std::vector<SpvReflectDescriptorUpdateTemplateEntry> entries(count);
+  uint32_t data_size = 0;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEnumerateDescriptorUpdateTemplateEntries(
+                &set, nullptr, 0, &count, entries.data(), &data_size));
+
+  // Each arrayed binding is one entry over consecutive infos.
+  uint32_t expected_size = 0;
+  for (const SpvReflectDescriptorUpdateTemplateEntry& entry : entries) {
+    const SpvReflectDescriptorBinding* p_binding = nullptr;
+    for (uint32_t i = 0; i < set.binding_count; ++i) {
+      if (set.bindings[i]->binding == entry.binding) {
+        p_binding = set.bindings[i];
+        break;
+      }
+    }
+    ASSERT_NE(nullptr, p_binding);
+    EXPECT_EQ(p_binding->count, entry.descriptor_count);
+    EXPECT_EQ(p_binding->descriptor_type, entry.descriptor_type);
+    EXPECT_EQ(0u, entry.array_element);
+    EXPECT_EQ(expected_size, entry.offset);
+    switch (entry.descriptor_type) {
+      case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+      case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+      case SPV_REFLECT_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+        EXPECT_EQ(8u, entry.stride);
+        break;
+      default:
+        EXPECT_EQ(24u, entry.stride);
+        break;
+    }
+    if (strcmp(p_binding->name, "eArr") == 0) {
+      EXPECT_EQ(5u, entry.descriptor_count);
+    }
+    expected_size += entry.descriptor_count * entry.stride;
+  }
+  EXPECT_EQ(expected_size, data_size);
+
+  // Smaller info structs are packed at their own alignment.
+  const SpvReflectDescriptorInfoSizes info_sizes = {4, 12, 4, 4};
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEnumerateDescriptorUpdateTemplateEntries(
+                &set, &info_sizes, 0, &count, entries.data(), &data_size));
+  for (const SpvReflectDescriptorUpdateTemplateEntry& entry : entries) {
+    EXPECT_EQ(0u, entry.offset % 4);
+    EXPECT_TRUE(entry.stride == 4 || entry.stride == 12);
+  }
+  const SpvReflectDescriptorUpdateTemplateEntry& last = entries.back();
+  EXPECT_EQ((last.offset + last.descriptor_count * last.stride + 7) & ~7u,
+            data_size);
+
+  spvReflectDestroyShaderModule(&module);
+}
+
+TEST(SpirvReflectTestCase, UpdateShaderModule) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/cbuffer_unused/cbuffer_unused_001.spv");
+  spv_reflect::ShaderModule module(spirv);
+  ASSERT_EQ(module.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  const SpvReflectTypeDescription* p_type =
+      module.GetDescriptorBinding(0, 0)->type_description;
+
+  // Only the function bodies change, so the types are kept and the block
+  // members point at their decorations in the new code.
+  std::vector<uint32_t> edited = ShiftAndEditFunctions(spirv);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            module.Update(edited.size() * 4, edited.data()));
+  const SpvReflectDescriptorBinding* p_binding =
+      module.GetDescriptorBinding(0, 0);
+  ASSERT_NE(p_binding, nullptr);
+  EXPECT_EQ(p_binding->type_description, p_type);
+  const SpvReflectBlockVariable& member = p_binding->block.members[0];
+  EXPECT_EQ(edited[member.word_offset.offset], member.offset);
+  EXPECT_EQ(edited[member.word_offset.offset - 1],
+            static_cast<uint32_t>(SpvDecorationOffset));
+
+  // A new member offset is a layout change and is parsed in full.
+  for (size_t i = 5; i < edited.size(); i += edited[i] >> 16) {
+    if ((edited[i] & 0xFFFF) == SpvOpMemberDecorate &&
+        edited[i + 3] == SpvDecorationOffset && edited[i + 4] == 128) {
+      edited[i + 4] = 132;
+      break;
+    }
+  }
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            module.Update(edited.size() * 4, edited.data()));
+  const SpvReflectFlatBlockMember* p_member = module.GetBlockMemberByPath(
+      &module.GetDescriptorBinding(0, 0)->block, "Offset");
+  ASSERT_NE(p_member, nullptr);
+  EXPECT_EQ(p_member->absolute_offset, 132u);
+}
+
+static const SpvReflectModuleChange* FindModuleChange(
+    const SpvReflectModuleDiff& diff, SpvReflectModuleChangeObject object,
+    SpvReflectModuleChangeType type) {
+  for (uint32_t i = 0; i < diff.change_count; ++i) {
+    if (diff.changes[i].object == object && diff.changes[i].type == type) {
+      return &diff.changes[i];
+    }
+  }
+  return nullptr;
+}
+
+TEST(SpirvReflectTestCase, DiffShaderModules) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/cbuffer_unused/cbuffer_unused_001.spv");
+  SpvReflectShaderModule old_module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv.size(), spirv.data(),
+                                         &old_module));
+
+  // Move the first member at offset 128 ("Offset") by 4 bytes.
+  std::vector<uint32_t> words(spirv.size() / 4);
+  memcpy(words.data(), spirv.data(), spirv.size());
+  for (size_t i = 5; i < words.size(); i += words[i] >> 16) {
+    if ((words[i] & 0xFFFF) == SpvOpMemberDecorate &&
+        words[i + 3] == SpvDecorationOffset && words[i + 4] == 128) {
+      words[i + 4] = 132;
+      break;
+    }
+  }
+  SpvReflectShaderModule new_module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(words.size() * 4, words.data(),
+                                         &new_module));
+
+  SpvReflectModuleDiff diff;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectDiffShaderModules(&old_module, &new_module, &diff));
+  EXPECT_EQ(diff.rebuild_flags,
+            static_cast<uint32_t>(SPV_REFLECT_MODULE_REBUILD_SHADER_MODULE |
+                                  SPV_REFLECT_MODULE_REBUILD_MATERIAL));
+  const SpvReflectModuleChange* p_change =
+      FindModuleChange(diff, SPV_REFLECT_MODULE_CHANGE_OBJECT_BLOCK_MEMBER,
+                       SPV_REFLECT_MODULE_CHANGE_TYPE_MODIFIED);
+  ASSERT_NE(p_change, nullptr);
+  EXPECT_STREQ(p_change->path, "Offset");
+  EXPECT_EQ(static_cast<const SpvReflectFlatBlockMember*>(p_change->p_old)
+                ->absolute_offset,
+            128u);
+  EXPECT_EQ(static_cast<const SpvReflectFlatBlockMember*>(p_change->p_new)
+                ->absolute_offset,
+            132u);
+  spvReflectDestroyModuleDiff(&diff);
+
+  // Renumbering a binding and moving an input replaces them.
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectChangeDescriptorBindingNumbers(
+                &new_module, &new_module.descriptor_bindings[0], 7,
+                SPV_REFLECT_SET_NUMBER_DONT_CHANGE));
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectChangeInputVariableLocation(
+                &new_module, new_module.input_variables[0], 5));
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectDiffShaderModules(&old_module, &new_module, &diff));
+  EXPECT_EQ(diff.rebuild_flags,
+            static_cast<uint32_t>(SPV_REFLECT_MODULE_REBUILD_SHADER_MODULE |
+                                  SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE |
+                                  SPV_REFLECT_MODULE_REBUILD_PIPELINE_LAYOUT |
+                                  SPV_REFLECT_MODULE_REBUILD_MATERIAL));
+  p_change = FindModuleChange(
+      diff, SPV_REFLECT_MODULE_CHANGE_OBJECT_DESCRIPTOR_BINDING,
+      SPV_REFLECT_MODULE_CHANGE_TYPE_ADDED);
+  ASSERT_NE(p_change, nullptr);
+  EXPECT_EQ(p_change->binding, 7u);
+  p_change =
+      FindModuleChange(diff, SPV_REFLECT_MODULE_CHANGE_OBJECT_INPUT_VARIABLE,
+                       SPV_REFLECT_MODULE_CHANGE_TYPE_REMOVED);
+  ASSERT_NE(p_change, nullptr);
+  EXPECT_EQ(p_change->index, 0u);
+  EXPECT_STREQ(p_change->entry_point, "main");
+  p_change =
+      FindModuleChange(diff, SPV_REFLECT_MODULE_CHANGE_OBJECT_INPUT_VARIABLE,
+                       SPV_REFLECT_MODULE_CHANGE_TYPE_ADDED);
+  ASSERT_NE(p_change, nullptr);
+  EXPECT_EQ(p_change->index, 5u);
+  EXPECT_EQ(p_change->rebuild_flags,
+            static_cast<uint32_t>(SPV_REFLECT_MODULE_REBUILD_PIPELINE_STATE));
+  spvReflectDestroyModuleDiff(&diff);
+
+  spvReflectDestroyShaderModule(&new_module);
+  spvReflectDestroyShaderModule(&old_module);
+}
+
+TEST(SpirvReflectTestCase, JsonWriter) {
+  std::stringstream json;
+  JsonWriter writer(json);
+  writer.BeginObject();
+  writer.StringField("name", "a\"b\\c\n\x01");
+  writer.IntField("built_in", -1);
+  writer.Key("dims");
+  writer.BeginArray();
+  writer.Uint(4);
+  writer.BeginArray();
+  writer.EndArray();
+  writer.Null();
+  writer.EndArray();
+  writer.StringField("semantic", nullptr);
+  writer.Key("empty");
+  writer.BeginObject();
+  writer.EndObject();
+  writer.EndObject();
+  EXPECT_EQ(json.str(),
+            "{\"name\":\"a\\\"b\\\\c\\n\\u0001\",\"built_in\":-1,"
+            "\"dims\":[4,[],null],\"semantic\":null,\"empty\":{}}");
+}
+
+TEST(SpirvReflectTestCase, WriteCppHeaderBlockLayout) {
+  std::vector<uint8_t> spirv = ReadSpirvFile("../tests/hlsl/cbuffer.spv");
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(spirv.size(), spirv.data(), &module));
+  std::stringstream header;
+  WriteCppHeader(module, "cbuffer.spv", "cbuffer.spv", header);
+  const std::string text = header.str();
+  EXPECT_EQ(text.rfind("// Generated by spirv-reflect --emit-cpp from "
+                       "cbuffer.spv. Do not edit.\n",
+                       0),
+            0u);
+  EXPECT_NE(text.find("namespace cbuffer_spv {"), std::string::npos);
+  EXPECT_NE(text.find("struct type_MyCBuffer {"), std::string::npos);
+  EXPECT_NE(text.find("  MaterialData Material[2][2][3];"), std::string::npos);
+  // std140 float arrays have a 16 byte stride.
+  EXPECT_NE(text.find("struct { float value; uint8_t pad[12]; } Scales[8];"),
+            std::string::npos);
+  const SpvReflectBlockVariable& block = module.descriptor_bindings[0].block;
+  EXPECT_NE(text.find("static_assert(sizeof(type_MyCBuffer) == " +
+                      std::to_string(block.padded_size) + ","),
+            std::string::npos);
+  EXPECT_NE(text.find("static_assert(offsetof(type_MyCBuffer, UvOffsets) == " +
+                      std::to_string(block.members[5].offset) + ","),
+            std::string::npos);
+  spvReflectDestroyShaderModule(&module);
+}
+
+TEST(SpirvReflectTestCase, EmbedReflectionCodeChanged) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/glsl/input_attachment.spv");
+  size_t embedded_size = 0;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                      &embedded_size, nullptr));
+  size_t wrong_size = embedded_size - 4;
+  std::vector<uint32_t> embedded(embedded_size / 4);
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_COUNT_MISMATCH,
+            spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                      &wrong_size, embedded.data()));
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                      &embedded_size, embedded.data()));
+
+  // A changed binding no longer matches the hash, so the code is parsed.
+  bool changed = false;
+  for (size_t i = 5; i < embedded.size(); i += embedded[i] >> 16) {
+    if ((embedded[i] & 0xFFFF) == SpvOpDecorate &&
+        embedded[i + 2] == SpvDecorationBinding) {
+      embedded[i + 3] = 17;
+      changed = true;
+      break;
+    }
+  }
+  ASSERT_TRUE(changed);
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(embedded_size, embedded.data(),
+                                         &module));
+  EXPECT_FALSE(module._internal->embedded_reflection_loaded);
+  bool found = false;
+  for (uint32_t i = 0; i < module.descriptor_binding_count; ++i) {
+    found = found || (module.descriptor_bindings[i].binding == 17);
+  }
+  EXPECT_TRUE(found);
+  spvReflectDestroyShaderModule(&module);
+}
+
+// Returns the text of the OpString that starts the payload of
+// spvReflectEmbedReflection, whose snapshot starts with the magic "SRFL".
+static char* FindEmbeddedPayloadText(std::vector<uint32_t>& embedded) {
+  for (size_t i = 5; i < embedded.size(); i += embedded[i] >> 16) {
+    char* text = reinterpret_cast<char*>(&embedded[i + 2]);
+    if ((embedded[i] & 0xFFFF) == SpvOpString &&
+        std::strncmp(text, "U1JGT", 5) == 0) {
+      return text;
+    }
+  }
+  return nullptr;
+}
+
+static const char base64_digits[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static std::vector<uint8_t> DecodeBase64(const std::string& text) {
+  std::vector<uint8_t> data;
+  uint32_t group = 0;
+  uint32_t bits = 0;
+  for (char c : text) {
+    const char* digit = std::strchr(base64_digits, c);
+    if (c == '=' || digit == nullptr) {
+      break;
+    }
+    group = (group << 6) | static_cast<uint32_t>(digit - base64_digits);
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      data.push_back(static_cast<uint8_t>(group >> bits));
+    }
+  }
+  return data;
+}
+
+static std::string EncodeBase64(const std::vector<uint8_t>& data) {
+  std::string text;
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t group = static_cast<uint32_t>(data[i]) << 16;
+    if (i + 1 < data.size()) {
+      group |= static_cast<uint32_t>(data[i + 1]) << 8;
+    }
+    if (i + 2 < data.size()) {
+      group |= data[i + 2];
+    }
+    text += base64_digits[(group >> 18) & 0x3F];
+    text += base64_digits[(group >> 12) & 0x3F];
+    text += (i + 1 < data.size()) ? base64_digits[(group >> 6) & 0x3F] : '=';
+    text += (i + 2 < data.size()) ? base64_digits[group & 0x3F] : '=';
+  }
+  return text;
+}
+
+TEST(SpirvReflectTestCase, EmbedReflectionCorrupted) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/glsl/input_attachment.spv");
+  size_t embedded_size = 0;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                      &embedded_size, nullptr));
+  std::vector<uint32_t> embedded(embedded_size / 4);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                      &embedded_size, embedded.data()));
+
+  // Changing any one character of the payload falls back to parsing.
+  char* text = FindEmbeddedPayloadText(embedded);
+  ASSERT_NE(text, nullptr);
+  for (size_t j = 0; text[j] != 0; ++j) {
+    const char original = text[j];
+    text[j] = (original == 'A') ? '/' : 'A';
+    SpvReflectShaderModule module;
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectCreateShaderModule(embedded_size, embedded.data(),
+                                           &module));
+    EXPECT_FALSE(module._internal->embedded_reflection_loaded) << j;
+    spvReflectDestroyShaderModule(&module);
+    text[j] = original;
+  }
+}
+
+TEST(SpirvReflectTestCase, EmbedReflectionSnapshotCorrupted) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/16bit/vert_in_out_16.spv");
+  size_t embedded_size = 0;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                      &embedded_size, nullptr));
+  std::vector<uint32_t> embedded(embedded_size / 4);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                      &embedded_size, embedded.data()));
+  char* text = FindEmbeddedPayloadText(embedded);
+  ASSERT_NE(text, nullptr);
+  const std::string original = text;
+  const std::vector<uint8_t> snapshot = DecodeBase64(original);
+  ASSERT_EQ(original, EncodeBase64(snapshot));
+
+  // Changing any byte of the snapshot itself, such as one that makes an
+  // array NULL while its count is not 0, falls back to parsing.
+  for (size_t i = 0; i < snapshot.size(); ++i) {
+    std::vector<uint8_t> corrupted = snapshot;
+    corrupted[i] ^= 0xFF;
+    const std::string corrupted_text = EncodeBase64(corrupted);
+    std::memcpy(text, corrupted_text.data(), corrupted_text.size());
+    SpvReflectShaderModule module;
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectCreateShaderModule(embedded_size, embedded.data(),
+                                           &module));
+    EXPECT_FALSE(module._internal->embedded_reflection_loaded) << i;
+    spvReflectDestroyShaderModule(&module);
+  }
+
+  std::memcpy(text, original.data(), original.size());
+  SpvReflectShaderModule module;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectCreateShaderModule(embedded_size, embedded.data(),
+                                         &module));
+  EXPECT_TRUE(module._internal->embedded_reflection_loaded);
+  spvReflectDestroyShaderModule(&module);
+}
+
+// Snapshots are trusted to hold what the parser would create from the same
+// code, so they must change format whenever it changes what it creates.
+// When these hashes change, SPV_REFLECT_PRV_SNAPSHOT_VERSION must be bumped
+// with them.
+TEST(SpirvReflectTestCase, SnapshotFormat) {
+  const std::pair<const char*, uint64_t> expected[] = {
+      {"../tests/glsl/input_attachment.spv",
+       0x2ed8bc108c732b68ull},
+      {"../tests/16bit/vert_in_out_16.spv",
+       0x5aa8905094fd1d39ull},
+      {"../tests/hlsl/counter_buffers.spv",
+       0xb6b414607a4518b1ull},
+      {"../tests/hlsl/semantics.spv",
+       0xf2192d04b1d32db9ull},
+      {"../tests/multi_entrypoint/multi_entrypoint.spv",
+       0xef087bbddf3fedb1ull},
+      {"../tests/spec_constants/test_64bit.spv",
+       0x83b91cb2ee95e1d3ull},
+      {"../tests/cbuffer_unused/cbuffer_unused_001.spv",
+       0xdd6fefff7a4fd38full},
+      {"../tests/variable_access/phy_storage_buffer_used_3.spv",
+       0x171c8b887321d54cull},
+  };
+  for (const auto& shader : expected) {
+    std::vector<uint8_t> spirv = ReadSpirvFile(shader.first);
+    size_t embedded_size = 0;
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                        &embedded_size, nullptr));
+    std::vector<uint8_t> embedded(embedded_size);
+    ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+              spvReflectEmbedReflection(spirv.size(), spirv.data(),
+                                        &embedded_size, embedded.data()));
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t byte : embedded) {
+      hash = (hash ^ byte) * 1099511628211ull;
+    }
+    EXPECT_EQ(shader.second, hash)
+        << shader.first << std::hex << " 0x" << hash;
+  }
+}
+
+TEST(SpirvReflectTestCase, CreateShaderModuleCachedNoCopy) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/glsl/input_attachment.spv");
+  const char* cache_dir = "spirv_reflect_test_cache";
+  spv_reflect::ShaderModule first(spirv.size(), spirv.data(),
+                                  SPV_REFLECT_MODULE_FLAG_NONE, cache_dir);
+  ASSERT_EQ(first.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+
+  // Owning the code or not makes no difference to the entry, and names are
+  // loaded to point into the caller's code.
+  spv_reflect::ShaderModule cached(spirv.size(), spirv.data(),
+                                   SPV_REFLECT_MODULE_FLAG_NO_COPY, cache_dir);
+  ASSERT_EQ(cached.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  const SpvReflectShaderModule& module = cached.GetShaderModule();
+  EXPECT_TRUE(module._internal->cached_reflection_loaded);
+  const uint8_t* p_name =
+      reinterpret_cast<const uint8_t*>(module.entry_point_name);
+  EXPECT_TRUE(p_name >= spirv.data() && p_name < spirv.data() + spirv.size());
+
+  // A cache that cannot be created is not an error.
+  spv_reflect::ShaderModule uncached(spirv.size(), spirv.data(),
+                                     SPV_REFLECT_MODULE_FLAG_NONE,
+                                     "missing/spirv_reflect_test_cache");
+  ASSERT_EQ(uncached.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  EXPECT_FALSE(uncached.GetShaderModule()._internal->cached_reflection_loaded);
+}
+
+// Returns the paths of the files in dir, without . and ..
+static std::vector<std::string> ListFiles(const std::string& dir) {
+  std::vector<std::string> paths;
+#if defined(_MSC_VER)
+  _finddata_t data;
+  intptr_t handle = _findfirst((dir + "/*").c_str(), &data);
+  if (handle != -1) {
+    do {
+      if ((data.attrib & _A_SUBDIR) == 0) {
+        paths.push_back(dir + "/" + data.name);
+      }
+    } while (_findnext(handle, &data) == 0);
+    _findclose(handle);
+  }
+#else
+  DIR* p_dir = opendir(dir.c_str());
+  if (p_dir != nullptr) {
+    for (dirent* p_entry = readdir(p_dir); p_entry != nullptr;
+         p_entry = readdir(p_dir)) {
+      std::string name = p_entry->d_name;
+      if (name != "." && name != "..") {
+        paths.push_back(dir + "/" + name);
+      }
+    }
+    closedir(p_dir);
+  }
+#endif
+  return paths;
+}
+
+TEST(SpirvReflectTestCase, CreateShaderModuleCachedCorrupted) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/glsl/input_attachment.spv");
+  const std::string cache_dir = "spirv_reflect_test_cache_corrupted";
+  for (const std::string& path : ListFiles(cache_dir)) {
+    std::remove(path.c_str());
+  }
+  spv_reflect::ShaderModule first(spirv.size(), spirv.data(),
+                                  SPV_REFLECT_MODULE_FLAG_NONE,
+                                  cache_dir.c_str());
+  ASSERT_EQ(first.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  std::vector<std::string> paths = ListFiles(cache_dir);
+  ASSERT_EQ(1u, paths.size());
+
+  // A file that does not load is a miss: the code is parsed and the file
+  // written again.
+  std::ifstream in(paths[0], std::ios::binary);
+  std::vector<char> valid((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+  in.close();
+  ASSERT_FALSE(valid.empty());
+  std::vector<char> corrupted = valid;
+  corrupted.resize(corrupted.size() / 2);
+  std::ofstream out(paths[0], std::ios::binary | std::ios::trunc);
+  out.write(corrupted.data(), corrupted.size());
+  out.close();
+  spv_reflect::ShaderModule parsed(spirv.size(), spirv.data(),
+                                   SPV_REFLECT_MODULE_FLAG_NONE,
+                                   cache_dir.c_str());
+  ASSERT_EQ(parsed.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  EXPECT_FALSE(parsed.GetShaderModule()._internal->cached_reflection_loaded);
+  EXPECT_EQ(first.GetShaderModule().descriptor_binding_count,
+            parsed.GetShaderModule().descriptor_binding_count);
+
+  spv_reflect::ShaderModule cached(spirv.size(), spirv.data(),
+                                   SPV_REFLECT_MODULE_FLAG_NONE,
+                                   cache_dir.c_str());
+  ASSERT_EQ(cached.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  EXPECT_TRUE(cached.GetShaderModule()._internal->cached_reflection_loaded);
+  std::ifstream rewritten(paths[0], std::ios::binary);
+  EXPECT_EQ(valid, std::vector<char>(std::istreambuf_iterator<char>(rewritten),
+                                     std::istreambuf_iterator<char>()));
+}
+
+TEST(SpirvReflectTestCase, CreateShaderModuleCachedCollision) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/glsl/input_attachment.spv");
+  std::vector<uint8_t> other_spirv =
+      ReadSpirvFile("../tests/16bit/vert_in_out_16.spv");
+  const std::string cache_dir = "spirv_reflect_test_cache_collision";
+  for (const std::string& path : ListFiles(cache_dir)) {
+    std::remove(path.c_str());
+  }
+  spv_reflect::ShaderModule other(other_spirv.size(), other_spirv.data(),
+                                  SPV_REFLECT_MODULE_FLAG_NONE,
+                                  cache_dir.c_str());
+  ASSERT_EQ(other.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  std::vector<std::string> other_paths = ListFiles(cache_dir);
+  ASSERT_EQ(1u, other_paths.size());
+  spv_reflect::ShaderModule first(spirv.size(), spirv.data(),
+                                  SPV_REFLECT_MODULE_FLAG_NONE,
+                                  cache_dir.c_str());
+  ASSERT_EQ(first.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  std::vector<std::string> paths = ListFiles(cache_dir);
+  ASSERT_EQ(2u, paths.size());
+  const std::string& path = paths[0] == other_paths[0] ? paths[1] : paths[0];
+
+  // An entry of other code under this code's name, as if their hashes
+  // collided, is a miss and is written again.
+  std::ifstream in(path, std::ios::binary);
+  std::vector<char> valid((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+  in.close();
+  std::ifstream other_in(other_paths[0], std::ios::binary);
+  std::vector<char> colliding((std::istreambuf_iterator<char>(other_in)),
+                              std::istreambuf_iterator<char>());
+  other_in.close();
+  ASSERT_NE(valid, colliding);
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(colliding.data(), colliding.size());
+  out.close();
+  spv_reflect::ShaderModule parsed(spirv.size(), spirv.data(),
+                                   SPV_REFLECT_MODULE_FLAG_NONE,
+                                   cache_dir.c_str());
+  ASSERT_EQ(parsed.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  EXPECT_FALSE(parsed.GetShaderModule()._internal->cached_reflection_loaded);
+  EXPECT_STREQ(first.GetEntryPointName(), parsed.GetEntryPointName());
+  EXPECT_EQ(first.GetShaderModule().descriptor_binding_count,
+            parsed.GetShaderModule().descriptor_binding_count);
+
+  spv_reflect::ShaderModule cached(spirv.size(), spirv.data(),
+                                   SPV_REFLECT_MODULE_FLAG_NONE,
+                                   cache_dir.c_str());
+  ASSERT_EQ(cached.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  EXPECT_TRUE(cached.GetShaderModule()._internal->cached_reflection_loaded);
+  std::ifstream rewritten(path, std::ios::binary);
+  EXPECT_EQ(valid, std::vector<char>(std::istreambuf_iterator<char>(rewritten),
+                                     std::istreambuf_iterator<char>()));
+}
+
+TEST(SpirvReflectTestCase, DetachCodeUnavailable) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/cbuffer_unused/cbuffer_unused_001.spv");
+  spv_reflect::ShaderModule module(spirv.size(), spirv.data(),
+                                   SPV_REFLECT_MODULE_FLAG_DETACH_CODE);
+  ASSERT_EQ(module.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  const SpvReflectDescriptorBinding* p_binding =
+      module.GetDescriptorBinding(0, 0);
+  ASSERT_NE(p_binding, nullptr);
+  EXPECT_EQ(SPV_REFLECT_RESULT_ERROR_CODE_UNAVAILABLE,
+            module.ChangeDescriptorBindingNumbers(p_binding, 5, 1));
+  EXPECT_EQ(p_binding->binding, 0u);
+
+  // Comparing against a detached module falls back to the code's hashes.
+  spv_reflect::ShaderModule attached(spirv);
+  SpvReflectModuleDiff diff = {};
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            spvReflectDiffShaderModules(&attached.GetShaderModule(),
+                                        &module.GetShaderModule(), &diff));
+  EXPECT_EQ(diff.rebuild_flags & SPV_REFLECT_MODULE_REBUILD_SHADER_MODULE,
+            0u);
+  spvReflectDestroyModuleDiff(&diff);
+
+  // An update parses the new code in full and detaches it again.
+  std::vector<uint32_t> edited = ShiftAndEditFunctions(spirv);
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            module.Update(edited.size() * 4, edited.data()));
+  EXPECT_EQ(module.GetCode(), nullptr);
+  p_binding = module.GetDescriptorBinding(0, 0);
+  ASSERT_NE(p_binding, nullptr);
+  EXPECT_STREQ(p_binding->name, attached.GetDescriptorBinding(0, 0)->name);
+}
+
+// Adds count copies of the variable var_id, which nothing uses, bound from
+// binding 16 on.
+static std::vector<uint32_t> AddUnusedCopies(const std::vector<uint8_t>& spirv,
+                                             uint32_t var_id, uint32_t count) {
+  std::vector<uint32_t> words(spirv.size() / 4);
+  memcpy(words.data(), spirv.data(), spirv.size());
+  std::vector<uint32_t> edited(words.begin(), words.begin() + 5);
+  uint32_t first_id = words[3];
+  edited[3] += count;
+  for (size_t i = 5; i < words.size(); i += words[i] >> 16) {
+    uint32_t word_count = words[i] >> 16;
+    SpvOp op = static_cast<SpvOp>(words[i] & 0xFFFF);
+    bool decorates = (op == SpvOpDecorate) && (words[i + 1] == var_id);
+    bool declares = (op == SpvOpVariable) && (words[i + 2] == var_id);
+    for (uint32_t k = 0; k <= ((decorates || declares) ? count : 0); ++k) {
+      size_t at = edited.size();
+      edited.insert(edited.end(), words.begin() + i,
+                    words.begin() + i + word_count);
+      if (k == 0) {
+        continue;
+      }
+      edited[at + (decorates ? 1 : 2)] = first_id + k - 1;
+      if (decorates && (words[i + 2] == SpvDecorationBinding)) {
+        edited[at + 3] = 15 + k;
+      }
+    }
+  }
+  return edited;
+}
+
+TEST(SpirvReflectTestCase, SharedDescriptorBlocks) {
+  std::vector<uint8_t> spirv =
+      ReadSpirvFile("../tests/cbuffer_unused/cbuffer_unused_001.spv");
+  std::vector<uint32_t> words = AddUnusedCopies(spirv, 6, 2);
+  spv_reflect::ShaderModule module(words);
+  ASSERT_EQ(module.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  const SpvReflectDescriptorBinding* p_used =
+      module.GetDescriptorBinding(0, 0);
+  const SpvReflectDescriptorBinding* p_copy =
+      module.GetDescriptorBinding(16, 0);
+  ASSERT_NE(p_used, nullptr);
+  ASSERT_NE(p_copy, nullptr);
+  ASSERT_NE(module.GetDescriptorBinding(17, 0), nullptr);
+
+  // The unused copies have the same block, unlike the binding they copy.
+  EXPECT_EQ(module.GetDescriptorBinding(17, 0)->block.members,
+            p_copy->block.members);
+  EXPECT_NE(p_copy->block.members, p_used->block.members);
+  ASSERT_EQ(p_copy->block.member_count, p_used->block.member_count);
+  EXPECT_EQ(p_copy->block.members[0].type_description,
+            p_used->block.members[0].type_description);
+  // The copies take the layout computed for the first binding
+  EXPECT_EQ(p_copy->block.size, p_used->block.size);
+  for (uint32_t i = 0; i < p_used->block.member_count; ++i) {
+    EXPECT_EQ(p_copy->block.members[i].absolute_offset,
+              p_used->block.members[i].absolute_offset);
+    EXPECT_EQ(p_copy->block.members[i].size, p_used->block.members[i].size);
+    EXPECT_EQ(p_copy->block.members[i].padded_size,
+              p_used->block.members[i].padded_size);
+  }
+
+  // Blocks stay shared through an update and a detached snapshot.
+  std::string first_member_name = p_used->block.members[0].name;
+  ASSERT_EQ(SPV_REFLECT_RESULT_SUCCESS,
+            module.Update(words.size() * 4, words.data()));
+  EXPECT_EQ(module.GetDescriptorBinding(17, 0)->block.members,
+            module.GetDescriptorBinding(16, 0)->block.members);
+  spv_reflect::ShaderModule detached(words.size() * 4, words.data(),
+                                     SPV_REFLECT_MODULE_FLAG_DETACH_CODE);
+  ASSERT_EQ(detached.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  EXPECT_EQ(detached.GetDescriptorBinding(17, 0)->block.members,
+            detached.GetDescriptorBinding(16, 0)->block.members);
+  EXPECT_STREQ(detached.GetDescriptorBinding(17, 0)->block.members[0].name,
+               first_member_name.c_str());
+}
+
+// A push constant holding a buffer reference to a chain of depth buffer
+// reference structs, each holding a reference to the next one.
+static std::vector<uint32_t> BuildBufferReferenceChain(uint32_t depth) {
+  const uint32_t kVoid = 1, kFunctionType = 2, kMain = 3, kLabel = 4;
+  const uint32_t kUint = 5, kPushStruct = 6, kPushPointer = 7, kPush = 8;
+  const uint32_t kFirstChainId = 9;
+  std::vector<uint32_t> words = {SpvMagicNumber, 0x00010500, 0,
+                                 kFirstChainId + 2 * depth, 0};
+  auto add = [&words](SpvOp op, std::initializer_list<uint32_t> operands) {
+    words.push_back(static_cast<uint32_t>((operands.size() + 1) << 16) | op);
+    words.insert(words.end(), operands);
+  };
+  add(SpvOpCapability, {SpvCapabilityShader});
+  add(SpvOpCapability, {SpvCapabilityPhysicalStorageBufferAddresses});
+  add(SpvOpMemoryModel,
+      {SpvAddressingModelPhysicalStorageBuffer64, SpvMemoryModelGLSL450});
+  add(SpvOpEntryPoint,
+      {SpvExecutionModelGLCompute, kMain, 0x6E69616D, 0, kPush});
+  add(SpvOpExecutionMode, {kMain, SpvExecutionModeLocalSize, 1, 1, 1});
+  for (uint32_t i = 0; i <= depth; ++i) {
+    uint32_t struct_id = (i < depth) ? kFirstChainId + 2 * i : kPushStruct;
+    add(SpvOpDecorate, {struct_id, SpvDecorationBlock});
+    add(SpvOpMemberDecorate, {struct_id, 0, SpvDecorationOffset, 0});
+  }
+  add(SpvOpTypeVoid, {kVoid});
+  add(SpvOpTypeFunction, {kFunctionType, kVoid});
+  add(SpvOpTypeInt, {kUint, 32, 0});
+  // Struct i holds a pointer to struct i + 1, so declare them backwards.
+  for (uint32_t i = depth; i-- > 0;) {
+    uint32_t struct_id = kFirstChainId + 2 * i;
+    add(SpvOpTypeStruct, {struct_id, (i + 1 < depth) ? struct_id + 3 : kUint});
+    add(SpvOpTypePointer,
+        {struct_id + 1, SpvStorageClassPhysicalStorageBuffer, struct_id});
+  }
+  add(SpvOpTypeStruct, {kPushStruct, kFirstChainId + 1});
+  add(SpvOpTypePointer,
+      {kPushPointer, SpvStorageClassPushConstant, kPushStruct});
+  add(SpvOpVariable, {kPushPointer, kPush, SpvStorageClassPushConstant});
+  add(SpvOpFunction, {kVoid, kMain, SpvFunctionControlMaskNone, kFunctionType});
+  add(SpvOpLabel, {kLabel});
+  add(SpvOpReturn, {});
+  add(SpvOpFunctionEnd, {});
+  return words;
+}
+
+TEST(SpirvReflectTestCase, DeepBufferReferenceChain) {
+  // Deeper than the 128 buffer reference types that used to be tracked
+  const uint32_t depth = 300;
+  std::vector<uint32_t> words = BuildBufferReferenceChain(depth);
+  spv_reflect::ShaderModule module(words);
+  ASSERT_EQ(module.GetResult(), SPV_REFLECT_RESULT_SUCCESS);
+  SpvReflectResult result = SPV_REFLECT_RESULT_NOT_READY;
+  const SpvReflectBlockVariable* p_var =
+      module.GetPushConstantBlock(0, &result);
+  ASSERT_EQ(result, SPV_REFLECT_RESULT_SUCCESS);
+  for (uint32_t i = 0; i < depth; ++i) {
+    ASSERT_EQ(p_var->member_count, 1u);
+    p_var = &p_var->members[0];
+    EXPECT_EQ(p_var->size, 8u);
+  }
+  ASSERT_EQ(p_var->member_count, 1u);
+  EXPECT_EQ(p_var->members[0].type_description->op, SpvOpTypeInt);
+  EXPECT_EQ(p_var->members[0].size, 4u);
+}